@@ -8,10 +8,12 @@ COMMON_SRC = \
             $(addprefix common/,$(notdir $(wildcard $(SRC_DIR)/common/*.c))) \
             $(addprefix config/,$(notdir $(wildcard $(SRC_DIR)/config/*.c))) \
             drivers/adc.c \
+            drivers/adc_oversample.c \
             drivers/buf_writer.c \
             drivers/bus.c \
             drivers/bus_i2c_config.c \
             drivers/bus_i2c_busdev.c \
+            drivers/bus_i2c_queue.c \
             drivers/bus_i2c_soft.c \
             drivers/bus_spi.c \
             drivers/bus_spi_config.c \
@@ -66,15 +68,21 @@ COMMON_SRC = \
             drivers/accgyro/gyro_sync.c \
             drivers/pwm_esc_detect.c \
             drivers/pwm_output.c \
+            drivers/dshot_bitbang.c \
+            drivers/dshot_bitbang_buffer.c \
+            drivers/dshot_command.c \
+            drivers/dshot_telemetry.c \
             drivers/rx/rx_spi.c \
             drivers/rx/rx_xn297.c \
             drivers/rx/rx_pwm.c \
             drivers/serial_softserial.c \
+            drivers/serial_softserial_decoder.c \
             fc/fc_core.c \
             fc/fc_rc.c \
             fc/rc_adjustments.c \
             fc/rc_controls.c \
             fc/rc_modes.c \
+            fc/rc_range_table.c \
             flight/position.c \
             flight/failsafe.c \
             flight/gps_rescue.c \
@@ -83,6 +91,7 @@ COMMON_SRC = \
             flight/mixer_tricopter.c \
             flight/pid.c \
             flight/servos.c \
+            flight/servos_table.c \
             flight/servos_tricopter.c \
             interface/cli.c \
             interface/settings.c \
@@ -94,7 +103,9 @@ COMMON_SRC = \
             rx/msp.c \
             rx/pwm.c \
             rx/rx.c \
+            rx/rx_frame_timing.c \
             rx/rx_spi.c \
+            rx/rx_spi_timing.c \
             rx/crsf.c \
             rx/ghst.c \
             rx/sbus.c \
@@ -109,12 +120,16 @@ COMMON_SRC = \
             sensors/acceleration.c \
             sensors/boardalignment.c \
             sensors/compass.c \
+            sensors/compass_calibration.c \
             sensors/gyro.c \
             sensors/gyroanalyse.c \
+            sensors/gyro_spectrum.c \
             sensors/initialisation.c \
             blackbox/blackbox.c \
             blackbox/blackbox_encoding.c \
             blackbox/blackbox_io.c \
+            blackbox/blackbox_burst.c \
+            blackbox/blackbox_governor.c \
             cms/cms.c \
             cms/cms_menu_blackbox.c \
             cms/cms_menu_builtin.c \
@@ -139,6 +154,7 @@ COMMON_SRC = \
             io/dashboard.c \
             io/displayport_max7456.c \
             io/displayport_msp.c \
+            io/displayport_msp_shadow.c \
             io/displayport_oled.c \
             io/displayport_srxl.c \
             io/displayport_crsf.c \
@@ -170,6 +186,7 @@ COMMON_SRC = \
             io/vtx_rtc6705.c \
             io/vtx_smartaudio.c \
             io/vtx_tramp.c \
+            io/vtx_transport.c \
             io/vtx_control.c
 
 COMMON_DEVICE_SRC = \
@@ -227,6 +244,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             flight/imu.c \
             flight/mixer.c \
             flight/pid.c \
+            flight/servos_table.c \
             rx/ibus.c \
             rx/rx.c \
             rx/rx_spi.c \
@@ -242,6 +260,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             sensors/boardalignment.c \
             sensors/gyro.c \
             sensors/gyroanalyse.c \
+            sensors/gyro_spectrum.c \
             $(CMSIS_SRC) \
             $(DEVICE_STDPERIPH_SRC) \
             common/kalman.c \
@@ -296,6 +315,7 @@ SIZE_OPTIMISED_SRC := $(SIZE_OPTIMISED_SRC) \
             io/transponder_ir.c \
             io/usb_cdc_hid.c \
             msp/msp_serial.c \
+            sensors/compass_calibration.c \
             cms/cms.c \
             cms/cms_menu_blackbox.c \
             cms/cms_menu_builtin.c \
@@ -313,6 +333,7 @@ SIZE_OPTIMISED_SRC := $(SIZE_OPTIMISED_SRC) \
             io/vtx_rtc6705.c \
             io/vtx_smartaudio.c \
             io/vtx_tramp.c \
+            io/vtx_transport.c \
             io/vtx_control.c \
             io/spektrum_vtx_control.c \
             pg/pg.h
@@ -323,6 +344,10 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             drivers/bus_i2c_hal.c \
             drivers/bus_spi_ll.c \
             drivers/max7456.c \
+            drivers/dshot_bitbang.c \
+            drivers/dshot_bitbang_buffer.c \
+            drivers/dshot_command.c \
+            drivers/dshot_telemetry.c \
             drivers/pwm_output_dshot.c \
             drivers/pwm_output_dshot_hal.c
 endif #!F3
@@ -353,6 +378,7 @@ SRC += \
             drivers/flash.c \
             drivers/flash_m25p16.c \
             drivers/flash_w25m.c \
+            drivers/flash_w25n01g.c \
             io/flashfs.c \
             pg/flash.c \
             $(MSC_SRC)
@@ -28,8 +28,10 @@
 #ifdef USE_BLACKBOX
 
 #include "blackbox.h"
+#include "blackbox_burst.h"
 #include "blackbox_encoding.h"
 #include "blackbox_fielddefs.h"
+#include "blackbox_governor.h"
 #include "blackbox_io.h"
 
 #include "build/build_config.h"
@@ -69,6 +71,8 @@
 
 #include "rx/rx.h"
 
+#include "scheduler/scheduler.h"
+
 #include "sensors/acceleration.h"
 #include "sensors/barometer.h"
 #include "sensors/battery.h"
@@ -88,13 +92,16 @@
 #define DEFAULT_BLACKBOX_DEVICE     BLACKBOX_DEVICE_SERIAL
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 3);
 
 PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
                   .p_ratio = 32,
                   .device = DEFAULT_BLACKBOX_DEVICE,
                   .record_acc = 1,
-                  .mode = BLACKBOX_MODE_NORMAL
+                  .mode = BLACKBOX_MODE_NORMAL,
+                  .rate_governor = 0,
+                  .burst = 0,
+                  .burst_noise_threshold = 0
                  );
 
 #define BLACKBOX_SHUTDOWN_TIMEOUT_MILLIS 200
@@ -273,6 +280,29 @@ static const blackboxSimpleFieldDefinition_t blackboxSlowFields[] = {
     {"rxFlightChannelsValid", -1, UNSIGNED, PREDICT(0),      ENCODING(TAG2_3S32)}
 };
 
+#ifdef USE_BLACKBOX_BURST
+// Full loop rate snapshot around a trigger, one frame per loop iteration
+static const blackboxSimpleFieldDefinition_t blackboxBurstFields[] = {
+    {"loopIteration", -1, UNSIGNED, PREDICT(0),          ENCODING(UNSIGNED_VB)},
+    {"burstTrigger",  -1, UNSIGNED, PREDICT(0),          ENCODING(UNSIGNED_VB)},
+    {"gyroUnfilt",     0, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"gyroUnfilt",     1, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"gyroUnfilt",     2, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"gyroADC",        0, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"gyroADC",        1, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"gyroADC",        2, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisP",          0, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisP",          1, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisP",          2, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisI",          0, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisI",          1, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisI",          2, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisD",          0, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisD",          1, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)},
+    {"axisD",          2, SIGNED,   PREDICT(0),          ENCODING(SIGNED_VB)}
+};
+#endif
+
 typedef enum BlackboxState {
     BLACKBOX_STATE_DISABLED = 0,
     BLACKBOX_STATE_STOPPED,
@@ -282,6 +312,7 @@ typedef enum BlackboxState {
     BLACKBOX_STATE_SEND_GPS_H_HEADER,
     BLACKBOX_STATE_SEND_GPS_G_HEADER,
     BLACKBOX_STATE_SEND_SLOW_HEADER,
+    BLACKBOX_STATE_SEND_BURST_HEADER,
     BLACKBOX_STATE_SEND_SYSINFO,
     BLACKBOX_STATE_PAUSED,
     BLACKBOX_STATE_RUNNING,
@@ -372,6 +403,13 @@ static uint16_t blackboxIFrameIndex;
 STATIC_UNIT_TESTED int16_t blackboxIInterval = 0;
 // number of flight loop iterations before logging P-frame
 STATIC_UNIT_TESTED int16_t blackboxPInterval = 0;
+// P interval from the configuration, the rate governor may log slower than this
+static int16_t blackboxBasePInterval = 0;
+static blackboxGovernor_t blackboxGovernor;
+#ifdef USE_BLACKBOX_BURST
+static blackboxBurst_t blackboxBurst;
+static uint8_t blackboxBurstConditions;
+#endif
 STATIC_UNIT_TESTED int32_t blackboxSInterval = 0;
 STATIC_UNIT_TESTED int32_t blackboxSlowFrameIterationTimer;
 static bool blackboxLoggedAnyFrames;
@@ -489,6 +527,7 @@ static void blackboxSetState(BlackboxState newState) {
     case BLACKBOX_STATE_SEND_GPS_G_HEADER:
     case BLACKBOX_STATE_SEND_GPS_H_HEADER:
     case BLACKBOX_STATE_SEND_SLOW_HEADER:
+    case BLACKBOX_STATE_SEND_BURST_HEADER:
         xmitState.headerIndex = 0;
         xmitState.u.fieldIndex = -1;
         break;
@@ -792,6 +831,12 @@ static void blackboxStart(void) {
     blackboxBuildConditionCache();
     blackboxModeActivationConditionPresent = isModeActivationConditionPresent(BOXBLACKBOX);
     blackboxResetIterationTimers();
+    blackboxPInterval = blackboxBasePInterval;
+    blackboxGovernorInit(&blackboxGovernor, blackboxBasePInterval, blackboxIInterval);
+#ifdef USE_BLACKBOX_BURST
+    blackboxBurstInit(&blackboxBurst);
+    blackboxBurstConditions = 0;
+#endif
     /*
      * Record the beeper's current idea of the last arming beep time, so that we can detect it changing when
      * it finally plays the beep for this arming event.
@@ -1096,6 +1141,7 @@ static bool blackboxWriteSysinfo(void) {
         BLACKBOX_PRINT_HEADER_LINE("I interval", "%d",                      blackboxIInterval);
         BLACKBOX_PRINT_HEADER_LINE("P interval", "%d",                      blackboxPInterval);
         BLACKBOX_PRINT_HEADER_LINE("P ratio", "%d",                         blackboxConfig()->p_ratio);
+        BLACKBOX_PRINT_HEADER_LINE("rate_governor", "%d",                   blackboxConfig()->rate_governor);
         BLACKBOX_PRINT_HEADER_LINE("minthrottle", "%d",                     motorConfig()->minthrottle);
         BLACKBOX_PRINT_HEADER_LINE("maxthrottle", "%d",                     motorConfig()->maxthrottle);
         BLACKBOX_PRINT_HEADER_LINE("gyro_scale", "0x%x",                     castFloatBytesToInt(1.0f));
@@ -1329,6 +1375,10 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data) {
         blackboxWriteUnsignedVB(data->loggingResume.logIteration);
         blackboxWriteUnsignedVB(data->loggingResume.currentTime);
         break;
+    case FLIGHT_LOG_EVENT_LOGGING_RATE:
+        blackboxWriteUnsignedVB(data->loggingRate.logIteration);
+        blackboxWriteUnsignedVB(data->loggingRate.pInterval);
+        break;
     case FLIGHT_LOG_EVENT_LOG_END:
         blackboxWriteString("End of log");
         blackboxWrite(0);
@@ -1384,6 +1434,98 @@ STATIC_UNIT_TESTED bool blackboxShouldLogGpsHomeFrame(void) {
 }
 #endif // GPS
 
+static bool blackboxIsRateGoverned(void) {
+    return blackboxConfig()->rate_governor && blackboxConfig()->p_ratio != 0;
+}
+
+// Steps the P interval at an I-frame and tells the decoder which iterations carry P-frames from here on
+static void blackboxGovernRate(void) {
+    cfTaskInfo_t pidTaskInfo;
+    getTaskInfo(TASK_GYROPID, &pidTaskInfo);
+    const uint32_t pidLoadPercent = pidTaskInfo.desiredPeriod > 0 ? pidTaskInfo.averageExecutionTime * 100 / pidTaskInfo.desiredPeriod : 0;
+    const uint16_t pInterval = blackboxGovernorUpdate(&blackboxGovernor, MIN(pidLoadPercent, (uint32_t)UINT8_MAX));
+    if (pInterval != blackboxPInterval) {
+        blackboxPInterval = pInterval;
+        flightLogEvent_loggingRate_t rate;
+        rate.logIteration = blackboxIteration;
+        rate.pInterval = pInterval;
+        blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RATE, (flightLogEventData_t *)&rate);
+    }
+}
+
+#ifdef USE_BLACKBOX_BURST
+// Largest 'B' frame: frame type, iteration, trigger and 15 values of up to 3 bytes each
+#define BLACKBOX_BURST_FRAME_MAX_SIZE (1 + 5 + 1 + 15 * 3)
+// Free space to leave for the main frames while the burst is written
+#define BLACKBOX_BURST_MIN_FREE_SPACE 128
+#define BLACKBOX_BURST_FRAMES_PER_ITERATION 2
+
+static int16_t blackboxBurstValue(float value) {
+    return constrain(lrintf(value), INT16_MIN, INT16_MAX);
+}
+
+static uint8_t blackboxBurstCheckConditions(const blackboxBurstSample_t *sample) {
+    uint8_t conditions = 0;
+    if (IS_RC_MODE_ACTIVE(BOXBLACKBOXBURST)) {
+        conditions |= BLACKBOX_BURST_TRIGGER_SWITCH;
+    }
+    if (gyroOverflowDetected()) {
+        conditions |= BLACKBOX_BURST_TRIGGER_GYRO_OVERFLOW;
+    }
+    if (crashRecoveryModeActive()) {
+        conditions |= BLACKBOX_BURST_TRIGGER_CRASH_RECOVERY;
+    }
+    const uint16_t noiseThreshold = blackboxConfig()->burst_noise_threshold;
+    if (noiseThreshold) {
+        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+            if (ABS(sample->gyroUnfilt[i] - sample->gyroADC[i]) > noiseThreshold) {
+                conditions |= BLACKBOX_BURST_TRIGGER_NOISE;
+            }
+        }
+    }
+    return conditions;
+}
+
+// Called once every FC loop, also while paused so the ring is full when logging resumes
+static void blackboxRecordBurst(void) {
+    blackboxBurstSample_t sample;
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        sample.gyroUnfilt[i] = blackboxBurstValue(gyroUnfilteredRate(i));
+        sample.gyroADC[i] = blackboxBurstValue(gyro.gyroADCf[i]);
+        sample.axisP[i] = blackboxBurstValue(pidData[i].P);
+        sample.axisI[i] = blackboxBurstValue(pidData[i].I);
+        sample.axisD[i] = blackboxBurstValue(pidData[i].D);
+    }
+    blackboxBurstRecord(&blackboxBurst, blackboxIteration, &sample);
+    // Only the onset of a condition fires, a held switch or a long crash recovery gives a single burst
+    const uint8_t conditions = blackboxBurstCheckConditions(&sample);
+    blackboxBurstTrigger(&blackboxBurst, conditions & ~blackboxBurstConditions);
+    blackboxBurstConditions = conditions;
+}
+
+static void writeBurstFrames(void) {
+    for (int n = 0; n < BLACKBOX_BURST_FRAMES_PER_ITERATION; n++) {
+        if (blackboxDeviceGetFreeSpace() < BLACKBOX_BURST_FRAME_MAX_SIZE + BLACKBOX_BURST_MIN_FREE_SPACE) {
+            return;
+        }
+        const uint8_t triggers = blackboxBurst.triggers;
+        uint32_t iteration;
+        const blackboxBurstSample_t *sample = blackboxBurstNextSample(&blackboxBurst, &iteration);
+        if (!sample) {
+            return;
+        }
+        blackboxWrite('B');
+        blackboxWriteUnsignedVB(iteration);
+        blackboxWriteUnsignedVB(triggers);
+        blackboxWriteSigned16VBArray(sample->gyroUnfilt, XYZ_AXIS_COUNT);
+        blackboxWriteSigned16VBArray(sample->gyroADC, XYZ_AXIS_COUNT);
+        blackboxWriteSigned16VBArray(sample->axisP, XYZ_AXIS_COUNT);
+        blackboxWriteSigned16VBArray(sample->axisI, XYZ_AXIS_COUNT);
+        blackboxWriteSigned16VBArray(sample->axisD, XYZ_AXIS_COUNT);
+    }
+}
+#endif // USE_BLACKBOX_BURST
+
 // Called once every FC loop in order to keep track of how many FC loop iterations have passed
 STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void) {
     ++blackboxSlowFrameIterationTimer;
@@ -1401,6 +1543,10 @@ STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void) {
 STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs) {
     // Write a keyframe every blackboxIInterval frames so we can resynchronise upon missing frames
     if (blackboxShouldLogIFrame()) {
+        if (blackboxIsRateGoverned()) {
+            blackboxGovernRate();
+            blackboxGovernorSampleFrame(&blackboxGovernor, blackboxDeviceGetFreeSpace());
+        }
         /*
          * Don't log a slow frame if the slow data didn't change ("I" frames are already large enough without adding
          * an additional item to write at the same time). Unless we're *only* logging "I" frames, then we have no choice.
@@ -1418,6 +1564,9 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs) {
              * We assume that slow frames are only interesting in that they aid the interpretation of the main data stream.
              * So only log slow frames during loop iterations where we log a main frame.
              */
+            if (blackboxIsRateGoverned()) {
+                blackboxGovernorSampleFrame(&blackboxGovernor, blackboxDeviceGetFreeSpace());
+            }
             writeSlowFrameIfNeeded();
             loadMainState(currentTimeUs);
             writeInterframe();
@@ -1436,6 +1585,11 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs) {
         }
 #endif
     }
+#ifdef USE_BLACKBOX_BURST
+    if (blackboxConfig()->burst) {
+        writeBurstFrames();
+    }
+#endif
     //Flush every iteration so that our runtime variance is minimized
     blackboxDeviceFlush();
 }
@@ -1516,9 +1670,25 @@ void blackboxUpdate(timeUs_t currentTimeUs) {
         //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
         if (!sendFieldDefinition('S', 0, blackboxSlowFields, blackboxSlowFields + 1, ARRAYLEN(blackboxSlowFields),
                                  NULL, NULL)) {
+#ifdef USE_BLACKBOX_BURST
+            if (blackboxConfig()->burst) {
+                blackboxSetState(BLACKBOX_STATE_SEND_BURST_HEADER);
+                break;
+            }
+#endif
+            blackboxSetState(BLACKBOX_STATE_SEND_SYSINFO);
+        }
+        break;
+#ifdef USE_BLACKBOX_BURST
+    case BLACKBOX_STATE_SEND_BURST_HEADER:
+        blackboxReplenishHeaderBudget();
+        //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
+        if (!sendFieldDefinition('B', 0, blackboxBurstFields, blackboxBurstFields + 1, ARRAYLEN(blackboxBurstFields),
+                                 NULL, NULL)) {
             blackboxSetState(BLACKBOX_STATE_SEND_SYSINFO);
         }
         break;
+#endif
     case BLACKBOX_STATE_SEND_SYSINFO:
         blackboxReplenishHeaderBudget();
         //On entry of this state, xmitState.headerIndex is 0
@@ -1535,6 +1705,11 @@ void blackboxUpdate(timeUs_t currentTimeUs) {
         }
         break;
     case BLACKBOX_STATE_PAUSED:
+#ifdef USE_BLACKBOX_BURST
+        if (blackboxConfig()->burst) {
+            blackboxRecordBurst();
+        }
+#endif
         // Only allow resume to occur during an I-frame iteration, so that we have an "I" base to work from
         if (IS_RC_MODE_ACTIVE(BOXBLACKBOX) && blackboxShouldLogIFrame()) {
             // Write a log entry so the decoder is aware that our large time/iteration skip is intended
@@ -1550,6 +1725,11 @@ void blackboxUpdate(timeUs_t currentTimeUs) {
         break;
     case BLACKBOX_STATE_RUNNING:
         // On entry to this state, blackboxIteration, blackboxPFrameIndex and blackboxIFrameIndex are reset to 0
+#ifdef USE_BLACKBOX_BURST
+        if (blackboxConfig()->burst) {
+            blackboxRecordBurst();
+        }
+#endif
         // Prevent the Pausing of the log on the mode switch if in Motor Test Mode
         if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX) && !startedLoggingInTestMode) {
             blackboxSetState(BLACKBOX_STATE_PAUSED);
@@ -1638,9 +1818,18 @@ int blackboxCalculatePDenom(int rateNum, int rateDenom) {
 }
 
 uint8_t blackboxGetRateDenom(void) {
+    return blackboxBasePInterval;
+}
+
+// P interval currently logged with, differs from the configured one while the rate governor backs off
+uint16_t blackboxGetGovernedPInterval(void) {
     return blackboxPInterval;
 }
 
+uint32_t blackboxGetGovernorOverruns(void) {
+    return blackboxGovernor.overruns;
+}
+
 /**
  * Call during system startup to initialize the blackbox.
  */
@@ -1665,6 +1854,7 @@ void blackboxInit(void) {
     } else {
         blackboxPInterval = blackboxIInterval /  blackboxConfig()->p_ratio;
     }
+    blackboxBasePInterval = blackboxPInterval;
     if (blackboxConfig()->device) {
         blackboxSetState(BLACKBOX_STATE_STOPPED);
     } else {
@@ -47,6 +47,7 @@ typedef enum FlightLogEvent {
     FLIGHT_LOG_EVENT_INFLIGHT_ADJUSTMENT = 13,
     FLIGHT_LOG_EVENT_LOGGING_RESUME = 14,
     FLIGHT_LOG_EVENT_FLIGHTMODE = 30, // Add new event type for flight mode status.
+    FLIGHT_LOG_EVENT_LOGGING_RATE = 31, // P interval changed by the rate governor
     FLIGHT_LOG_EVENT_LOG_END = 255
 } FlightLogEvent;
 
@@ -55,6 +56,9 @@ typedef struct blackboxConfig_s {
     uint8_t device;
     uint8_t record_acc;
     uint8_t mode;
+    uint8_t rate_governor; // lower the logging rate when the device or the PID task can't keep up
+    uint8_t burst; // write full loop rate snapshots around trigger events
+    uint16_t burst_noise_threshold; // deg/s between unfiltered and filtered gyro that triggers a snapshot, 0 = off
 } blackboxConfig_t;
 
 PG_DECLARE(blackboxConfig_t, blackboxConfig);
@@ -67,6 +71,8 @@ void blackboxUpdate(timeUs_t currentTimeUs);
 void blackboxSetStartDateTime(const char *dateTime, timeMs_t timeNowMs);
 int blackboxCalculatePDenom(int rateNum, int rateDenom);
 uint8_t blackboxGetRateDenom(void);
+uint16_t blackboxGetGovernedPInterval(void);
+uint32_t blackboxGetGovernorOverruns(void);
 void blackboxValidateConfig(void);
 void blackboxFinish(void);
 bool blackboxMayEditConfig(void);
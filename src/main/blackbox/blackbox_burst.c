@@ -0,0 +1,93 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Full loop rate ring of gyro and PID samples for the blackbox.
+ *
+ *   The main log is decimated by the P ratio, too coarse to see what happens
+ * in the noise band. This ring keeps the most recent samples of every loop.
+ * When a trigger fires, recording continues for another half ring so the
+ * event sits in the middle, then the ring is frozen and handed out oldest
+ * first to be written as 'B' frames alongside the normal frames. Once the
+ * last sample is out, recording starts over.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/maths.h"
+
+#include "blackbox/blackbox_burst.h"
+
+void blackboxBurstInit(blackboxBurst_t *burst) {
+    memset(burst, 0, sizeof(*burst));
+}
+
+void blackboxBurstRecord(blackboxBurst_t *burst, uint32_t iteration, const blackboxBurstSample_t *sample) {
+    if (burst->state == BLACKBOX_BURST_FROZEN) {
+        return;
+    }
+    burst->ring[burst->head] = *sample;
+    burst->head = (burst->head + 1) % BLACKBOX_BURST_SAMPLES;
+    burst->count = MIN(burst->count + 1, BLACKBOX_BURST_SAMPLES);
+    burst->lastIteration = iteration;
+    if (burst->state == BLACKBOX_BURST_TRIGGERED && --burst->postTrigger == 0) {
+        burst->state = BLACKBOX_BURST_FROZEN;
+        burst->readIndex = 0;
+    }
+}
+
+// returns true if this started a new burst
+bool blackboxBurstTrigger(blackboxBurst_t *burst, uint8_t triggers) {
+    if (!triggers) {
+        return false;
+    }
+    switch (burst->state) {
+    case BLACKBOX_BURST_RECORDING:
+        burst->state = BLACKBOX_BURST_TRIGGERED;
+        burst->postTrigger = BLACKBOX_BURST_POST_TRIGGER_SAMPLES;
+        burst->triggers = triggers;
+        return true;
+    case BLACKBOX_BURST_TRIGGERED:
+        // both events are in this burst already
+        burst->triggers |= triggers;
+        return false;
+    default:
+        return false;
+    }
+}
+
+// returns NULL unless the ring is frozen, the sample stays valid until the next blackboxBurstRecord()
+const blackboxBurstSample_t *blackboxBurstNextSample(blackboxBurst_t *burst, uint32_t *iteration) {
+    if (burst->state != BLACKBOX_BURST_FROZEN) {
+        return NULL;
+    }
+    const uint16_t age = burst->count - 1 - burst->readIndex;
+    const blackboxBurstSample_t *sample = &burst->ring[(burst->head + BLACKBOX_BURST_SAMPLES - 1 - age) % BLACKBOX_BURST_SAMPLES];
+    *iteration = burst->lastIteration - age;
+    if (++burst->readIndex >= burst->count) {
+        burst->state = BLACKBOX_BURST_RECORDING;
+        burst->count = 0;
+        burst->triggers = 0;
+        burst->bursts++;
+    }
+    return sample;
+}
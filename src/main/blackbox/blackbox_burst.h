@@ -0,0 +1,67 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+
+#define BLACKBOX_BURST_SAMPLES 256 // 32ms at 8kHz
+#define BLACKBOX_BURST_POST_TRIGGER_SAMPLES (BLACKBOX_BURST_SAMPLES / 2)
+
+typedef enum {
+    BLACKBOX_BURST_TRIGGER_SWITCH = 1 << 0,
+    BLACKBOX_BURST_TRIGGER_GYRO_OVERFLOW = 1 << 1,
+    BLACKBOX_BURST_TRIGGER_CRASH_RECOVERY = 1 << 2,
+    BLACKBOX_BURST_TRIGGER_NOISE = 1 << 3,
+} blackboxBurstTrigger_e;
+
+typedef enum {
+    BLACKBOX_BURST_RECORDING = 0, // waiting for a trigger
+    BLACKBOX_BURST_TRIGGERED,     // recording the samples after the trigger
+    BLACKBOX_BURST_FROZEN,        // ring is being written to the log
+} blackboxBurstState_e;
+
+typedef struct blackboxBurstSample_s {
+    int16_t gyroUnfilt[XYZ_AXIS_COUNT];
+    int16_t gyroADC[XYZ_AXIS_COUNT];
+    int16_t axisP[XYZ_AXIS_COUNT];
+    int16_t axisI[XYZ_AXIS_COUNT];
+    int16_t axisD[XYZ_AXIS_COUNT];
+} blackboxBurstSample_t;
+
+typedef struct blackboxBurst_s {
+    blackboxBurstSample_t ring[BLACKBOX_BURST_SAMPLES];
+    uint32_t lastIteration;   // loop iteration of the newest sample, samples are one iteration apart
+    uint16_t head;            // slot the next sample goes into
+    uint16_t count;
+    uint16_t postTrigger;     // samples still to record before the ring freezes
+    uint16_t readIndex;       // samples of the frozen ring already handed out
+    uint8_t state;
+    uint8_t triggers;         // blackboxBurstTrigger_e bits that fired this burst
+    uint16_t bursts;          // bursts completely written
+} blackboxBurst_t;
+
+void blackboxBurstInit(blackboxBurst_t *burst);
+void blackboxBurstRecord(blackboxBurst_t *burst, uint32_t iteration, const blackboxBurstSample_t *sample);
+bool blackboxBurstTrigger(blackboxBurst_t *burst, uint8_t triggers);
+const blackboxBurstSample_t *blackboxBurstNextSample(blackboxBurst_t *burst, uint32_t *iteration);
@@ -35,13 +35,13 @@
 #include "common/printf.h"
 
 
-static void _putc(void *p, char c) {
+static void _putw(void *p, const char *data, int len) {
     (void)p;
-    blackboxWrite(c);
+    blackboxWriteData((const uint8_t *)data, len);
 }
 
 static int blackboxPrintfv(const char *fmt, va_list va) {
-    return tfp_format(NULL, _putc, fmt, va);
+    return tfp_format_write(NULL, _putw, fmt, va);
 }
 
 
@@ -97,7 +97,7 @@ void blackboxWriteSignedVBArray(int32_t *array, int count) {
     }
 }
 
-void blackboxWriteSigned16VBArray(int16_t *array, int count) {
+void blackboxWriteSigned16VBArray(const int16_t *array, int count) {
     for (int i = 0; i < count; i++) {
         blackboxWriteSignedVB(array[i]);
     }
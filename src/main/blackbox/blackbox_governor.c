@@ -0,0 +1,77 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Blackbox logging rate governor.
+ *
+ *   The device buffer fill is sampled before every logged frame. At each I-frame
+ * the P-frame interval is doubled if frames went into a nearly full buffer or the
+ * PID task ran out of headroom, and halved back towards the configured interval
+ * once both stayed calm for a while. Changing the interval only at I-frames keeps
+ * every P-frame run decodable.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/maths.h"
+
+#include "blackbox/blackbox_governor.h"
+
+void blackboxGovernorInit(blackboxGovernor_t *governor, uint16_t pInterval, uint16_t iInterval) {
+    memset(governor, 0, sizeof(*governor));
+    governor->basePInterval = pInterval;
+    governor->maxPInterval = MAX(iInterval, pInterval);
+    governor->pInterval = pInterval;
+}
+
+void blackboxGovernorSampleFrame(blackboxGovernor_t *governor, int32_t freeSpace) {
+    governor->bufferSize = MAX(governor->bufferSize, freeSpace);
+    if (governor->bufferSize <= 0) {
+        return;
+    }
+    const uint8_t fill = 100 - (MAX(freeSpace, 0) * 100 / governor->bufferSize);
+    governor->windowPeakFill = MAX(governor->windowPeakFill, fill);
+    if (fill >= BLACKBOX_GOVERNOR_OVERRUN_FILL_PERCENT) {
+        governor->windowOverruns++;
+        governor->overruns++;
+    }
+}
+
+// Called at I-frames, returns the P interval to log with from here on
+uint16_t blackboxGovernorUpdate(blackboxGovernor_t *governor, uint8_t pidLoadPercent) {
+    const bool pressure = governor->windowOverruns > 0 || pidLoadPercent >= BLACKBOX_GOVERNOR_HIGH_LOAD_PERCENT;
+    const bool calm = governor->windowPeakFill < BLACKBOX_GOVERNOR_CALM_FILL_PERCENT && pidLoadPercent < BLACKBOX_GOVERNOR_CALM_LOAD_PERCENT;
+    if (pressure) {
+        governor->calmWindows = 0;
+        governor->pInterval = MIN(governor->pInterval * 2, governor->maxPInterval);
+    } else if (calm) {
+        if (++governor->calmWindows >= BLACKBOX_GOVERNOR_CALM_WINDOWS) {
+            governor->calmWindows = 0;
+            governor->pInterval = MAX(governor->pInterval / 2, governor->basePInterval);
+        }
+    } else {
+        governor->calmWindows = 0;
+    }
+    governor->windowPeakFill = 0;
+    governor->windowOverruns = 0;
+    return governor->pInterval;
+}
@@ -0,0 +1,44 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define BLACKBOX_GOVERNOR_OVERRUN_FILL_PERCENT  90  // a frame written above this buffer fill is likely lost
+#define BLACKBOX_GOVERNOR_CALM_FILL_PERCENT     60
+#define BLACKBOX_GOVERNOR_HIGH_LOAD_PERCENT     90  // PID task execution time of its period
+#define BLACKBOX_GOVERNOR_CALM_LOAD_PERCENT     75
+#define BLACKBOX_GOVERNOR_CALM_WINDOWS          32  // I-frame intervals without pressure before stepping the rate up
+
+typedef struct blackboxGovernor_s {
+    uint16_t basePInterval;     // configured P interval, never logged faster than this
+    uint16_t maxPInterval;      // the I interval, only I-frames are logged at this step
+    uint16_t pInterval;
+    int32_t bufferSize;         // largest free space seen, taken as the size of the device buffer
+    uint8_t windowPeakFill;     // percent, since the last I-frame
+    uint16_t windowOverruns;
+    uint8_t calmWindows;
+    uint32_t overruns;          // frames written into a nearly full buffer since logging started
+} blackboxGovernor_t;
+
+void blackboxGovernorInit(blackboxGovernor_t *governor, uint16_t pInterval, uint16_t iInterval);
+void blackboxGovernorSampleFrame(blackboxGovernor_t *governor, int32_t freeSpace);
+uint16_t blackboxGovernorUpdate(blackboxGovernor_t *governor, uint8_t pidLoadPercent);
@@ -131,6 +131,29 @@ int blackboxWriteString(const char *s) {
     return length;
 }
 
+// Write 'length' bytes to the blackbox device
+void blackboxWriteData(const uint8_t *data, int length) {
+    switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        flashfsWrite(data, length, false); // Write asynchronously
+        break;
+#endif // USE_FLASHFS
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        afatfs_fwrite(blackboxSDCard.logFile, data, length); // Ignore failures due to buffers filling up
+        break;
+#endif // USE_SDCARD
+    case BLACKBOX_DEVICE_SERIAL:
+    default:
+        // not serialWriteBuf(), that waits for room in the transmit buffer
+        for (int i = 0; i < length; i++) {
+            serialWrite(blackboxPort, data[i]);
+        }
+        break;
+    }
+}
+
 /**
  * If there is data waiting to be written to the blackbox device, attempt to write (a portion of) that now.
  *
@@ -481,28 +504,31 @@ unsigned int blackboxGetLogNumber(void) {
 }
 
 /**
- * Call once every loop iteration in order to maintain the global blackboxHeaderBudget with the number of bytes we can
- * transmit this iteration.
+ * Returns the number of bytes that can be written to the device buffers without overflowing them.
  */
-void blackboxReplenishHeaderBudget(void) {
-    int32_t freeSpace;
+int32_t blackboxDeviceGetFreeSpace(void) {
     switch (blackboxConfig()->device) {
     case BLACKBOX_DEVICE_SERIAL:
-        freeSpace = serialTxBytesFree(blackboxPort);
-        break;
+        return serialTxBytesFree(blackboxPort);
 #ifdef USE_FLASHFS
     case BLACKBOX_DEVICE_FLASH:
-        freeSpace = flashfsGetWriteBufferFreeSpace();
-        break;
+        return flashfsGetWriteBufferFreeSpace();
 #endif
 #ifdef USE_SDCARD
     case BLACKBOX_DEVICE_SDCARD:
-        freeSpace = afatfs_getFreeBufferSpace();
-        break;
+        return afatfs_getFreeBufferSpace();
 #endif
     default:
-        freeSpace = 0;
+        return 0;
     }
+}
+
+/**
+ * Call once every loop iteration in order to maintain the global blackboxHeaderBudget with the number of bytes we can
+ * transmit this iteration.
+ */
+void blackboxReplenishHeaderBudget(void) {
+    const int32_t freeSpace = blackboxDeviceGetFreeSpace();
     blackboxHeaderBudget = MIN(MIN(freeSpace, blackboxHeaderBudget + blackboxMaxHeaderBytesPerIteration), BLACKBOX_MAX_ACCUMULATED_HEADER_BUDGET);
 }
 
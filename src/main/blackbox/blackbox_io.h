@@ -43,6 +43,7 @@ extern int32_t blackboxHeaderBudget;
 void blackboxOpen(void);
 void blackboxWrite(uint8_t value);
 int blackboxWriteString(const char *s);
+void blackboxWriteData(const uint8_t *data, int length);
 
 void blackboxDeviceFlush(void);
 bool blackboxDeviceFlushForce(void);
@@ -59,5 +60,6 @@ bool isBlackboxDeviceFull(void);
 bool isBlackboxDeviceWorking(void);
 unsigned int blackboxGetLogNumber(void);
 
+int32_t blackboxDeviceGetFreeSpace(void);
 void blackboxReplenishHeaderBudget(void);
 blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes);
@@ -78,5 +78,9 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     "KALMAN",
     "SMART_SMOOTHING",
     "ANGLE",
-    "HORIZON"
+    "HORIZON",
+    "VTX_TRANSPORT",
+    "DSHOT_RPM_TELEMETRY",
+    "FLASH_NAND",
+    "SOFTSERIAL"
 };
@@ -97,6 +97,10 @@ typedef enum {
     DEBUG_SMART_SMOOTHING,
     DEBUG_ANGLE,
     DEBUG_HORIZON,
+    DEBUG_VTX_TRANSPORT,
+    DEBUG_DSHOT_RPM_TELEMETRY,
+    DEBUG_FLASH_NAND,
+    DEBUG_SOFTSERIAL,
     DEBUG_COUNT
 } debugType_e;
 
@@ -429,6 +429,7 @@ static long cmsx_profileOtherOnExit(const OSD_Entry *self) {
     pidProfile->throttle_boost = cmsx_throttleBoost;
     pidProfile->motor_output_limit = cmsx_motorOutputLimit;
     pidProfile->auto_profile_cell_count = cmsx_autoProfileCellCount;
+    pidMarkProfileDirty(pidProfileIndex);
     pidInitConfig(currentPidProfile);
     initEscEndpoints();
     return 0;
@@ -69,6 +69,7 @@ OSD_Entry menuOsdActiveElemsEntries[] = {
     {"CRSF TX POWER",      OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_CRSF_TX], 0},
     {"CRSF SNR",           OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_CRSF_SNR], 0},
     {"CRSF RSSI",          OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_CRSF_RSSI], 0},
+    {"RX JITTER",          OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_RX_JITTER], 0},
     {"BATTERY VOLTAGE",    OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_MAIN_BATT_VOLTAGE], 0},
     {"BATTERY USAGE",      OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_MAIN_BATT_USAGE], 0},
     {"AVG CELL VOLTAGE",   OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_AVG_CELL_VOLTAGE], 0},
@@ -464,3 +464,51 @@ void quaternionInitVector(quaternion *i) {
     i->y = 0;
     i->z = 0;
 }
+
+// rotation vector (w ignored) to the equivalent unit quaternion
+void quaternionFromRotationVector(quaternion *v, quaternion *q) {
+    const float angle = sqrtf(sq(v->x) + sq(v->y) + sq(v->z));
+    if (angle < 1e-6f) {
+        // small angle approximation
+        q->w = 1.0f;
+        q->x = 0.5f * v->x;
+        q->y = 0.5f * v->y;
+        q->z = 0.5f * v->z;
+    } else {
+        const float s = sinf(0.5f * angle) / angle;
+        q->w = cosf(0.5f * angle);
+        q->x = v->x * s;
+        q->y = v->y * s;
+        q->z = v->z * s;
+    }
+}
+
+// previous is kept, the coning term spans the reset
+void deltaRotationReset(deltaRotation_t *d) {
+    for (int i = 0; i < 3; i++) {
+        d->alpha[i] = 0.0f;
+        d->beta[i] = 0.0f;
+    }
+}
+
+// Savage two-sample style coning update, one cross product per sample:
+// beta += 0.5 * (alpha + previous / 6) x deltaAngle
+void deltaRotationAccumulate(deltaRotation_t *d, const float *deltaAngle) {
+    const float ax = d->alpha[0] + d->previous[0] * (1.0f / 6.0f);
+    const float ay = d->alpha[1] + d->previous[1] * (1.0f / 6.0f);
+    const float az = d->alpha[2] + d->previous[2] * (1.0f / 6.0f);
+    d->beta[0] += 0.5f * (ay * deltaAngle[2] - az * deltaAngle[1]);
+    d->beta[1] += 0.5f * (az * deltaAngle[0] - ax * deltaAngle[2]);
+    d->beta[2] += 0.5f * (ax * deltaAngle[1] - ay * deltaAngle[0]);
+    for (int i = 0; i < 3; i++) {
+        d->alpha[i] += deltaAngle[i];
+        d->previous[i] = deltaAngle[i];
+    }
+}
+
+void deltaRotationGetVector(const deltaRotation_t *d, quaternion *v) {
+    v->w = 0;
+    v->x = d->alpha[0] + d->beta[0];
+    v->y = d->alpha[1] + d->beta[1];
+    v->z = d->alpha[2] + d->beta[2];
+}
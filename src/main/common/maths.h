@@ -181,6 +181,13 @@ typedef struct {
 } quaternionProducts;
 #define QUATERNION_PRODUCTS_INITIALIZE  {.ww=1, .wx=0, .wy=0, .wz=0, .xx=0, .xy=0, .xz=0, .yy=0, .yz=0, .zz=0}
 
+// body frame rotation accumulated from successive delta angles, with coning correction
+typedef struct {
+    float alpha[3];     // sum of delta angles
+    float beta[3];      // coning correction
+    float previous[3];  // last delta angle
+} deltaRotation_t;
+
 void quaternionComputeProducts(quaternion *qIn, quaternionProducts *qPout);
 void quaternionTransformVectorBodyToEarth(quaternion *qVector, quaternion *qReference);
 void quaternionTransformVectorEarthToBody(quaternion *qVector, quaternion *qReference);
@@ -194,3 +201,8 @@ float quaternionNorm(quaternion *q);
 float quaternionModulus(quaternion *q);
 void quaternionInitQuaternion(quaternion *i);
 void quaternionInitVector(quaternion *i);
+void quaternionFromRotationVector(quaternion *v, quaternion *q);
+
+void deltaRotationReset(deltaRotation_t *d);
+void deltaRotationAccumulate(deltaRotation_t *d, const float *deltaAngle);
+void deltaRotationGetVector(const deltaRotation_t *d, quaternion *v);
@@ -33,11 +33,14 @@
 #include <stdint.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
+#include "common/streambuf.h"
 #include "common/utils.h"
 
 #include "drivers/serial.h"
@@ -54,114 +57,171 @@ static serialPort_t *printfSerialPort;
 #ifdef REQUIRE_CC_ARM_PRINTF_SUPPORT
 
 typedef void (*putcf) (void *, char);
+typedef void (*putwf) (void *, const char *, int);
 static putcf stdout_putf;
 static void *stdout_putp;
 
-// print bf, padded from left to at least n characters.
+#define PAD_CHUNK 8
+static const char padSpaces[PAD_CHUNK] = { ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ' };
+static const char padZeros[PAD_CHUNK] = { '0', '0', '0', '0', '0', '0', '0', '0' };
+
+// print the len characters of bf, padded from left to at least n characters.
 // padding is zero ('0') if z!=0, space (' ') otherwise
-static int putchw(void *putp, putcf putf, int n, char z, char *bf) {
-    int written = 0;
-    char fc = z ? '0' : ' ';
-    char ch;
-    char *p = bf;
-    while (*p++ && n > 0)
-        n--;
-    while (n-- > 0) {
-        putf(putp, fc);
-        written++;
+static int putchw(void *putp, putwf putw, int n, char z, const char *bf, int len) {
+    int written = len;
+    if (n > len) {
+        const char *pad = z ? padZeros : padSpaces;
+        written = n;
+        n -= len;
+        while (n > 0) {
+            const int chunk = MIN(n, PAD_CHUNK);
+            putw(putp, pad, chunk);
+            n -= chunk;
+        }
     }
-    while ((ch = *bf++)) {
-        putf(putp, ch);
-        written++;
+    if (len) {
+        putw(putp, bf, len);
     }
     return written;
 }
 
-// retrun number of bytes written
-int tfp_format(void *putp, putcf putf, const char *fmt, va_list va) {
-    char bf[12];
+// digits are produced backwards from end, returns the first one
+static char *ulToDigits(unsigned long num, bool hex, bool uc, char *end) {
+    char *p = end;
+    if (hex) {
+        const char *digits = uc ? "0123456789ABCDEF" : "0123456789abcdef";
+        do {
+            *--p = digits[num & 0xf];
+            num >>= 4;
+        } while (num);
+    } else {
+        do {
+            *--p = '0' + num % 10;
+            num /= 10;
+        } while (num);
+    }
+    return p;
+}
+
+// Formatting core, output goes to putw in runs: literal text between
+// conversions in one call, each conversion as its padding and its digits.
+// returns number of bytes written
+int tfp_format_write(void *putp, putwf putw, const char *fmt, va_list va) {
+    char bf[24];
+    char *const bfEnd = bf + sizeof(bf);
     int written = 0;
     char ch;
-    while ((ch = *(fmt++))) {
-        if (ch != '%') {
-            putf(putp, ch);
-            written++;
-        } else {
-            char lz = 0;
+    while (true) {
+        const char *run = fmt;
+        while (*fmt && *fmt != '%') {
+            fmt++;
+        }
+        if (fmt != run) {
+            putw(putp, run, fmt - run);
+            written += fmt - run;
+        }
+        if (!*fmt) {
+            break;
+        }
+        fmt++;
+        char lz = 0;
 #ifdef  REQUIRE_PRINTF_LONG_SUPPORT
-            char lng = 0;
+        char lng = 0;
 #endif
-            int w = 0;
+        int w = 0;
+        ch = *(fmt++);
+        if (ch == '0') {
             ch = *(fmt++);
-            if (ch == '0') {
-                ch = *(fmt++);
-                lz = 1;
-            }
-            if (ch >= '0' && ch <= '9') {
-                ch = a2i(ch, &fmt, 10, &w);
-            }
-#ifdef  REQUIRE_PRINTF_LONG_SUPPORT
-            if (ch == 'l') {
-                ch = *(fmt++);
-                lng = 1;
-            }
-#endif
-            switch (ch) {
-            case 0:
-                goto abort;
-            case 'u': {
+            lz = 1;
+        }
+        if (ch >= '0' && ch <= '9') {
+            ch = a2i(ch, &fmt, 10, &w);
+        }
 #ifdef  REQUIRE_PRINTF_LONG_SUPPORT
-                if (lng)
-                    uli2a(va_arg(va, unsigned long int), 10, 0, bf);
-                else
+        if (ch == 'l') {
+            ch = *(fmt++);
+            lng = 1;
+        }
 #endif
-                    ui2a(va_arg(va, unsigned int), 10, 0, bf);
-                written += putchw(putp, putf, w, lz, bf);
-                break;
-            }
-            case 'd': {
+        switch (ch) {
+        case 0:
+            goto abort;
+        case 'u':
+        case 'x':
+        case 'X': {
+            unsigned long num;
 #ifdef  REQUIRE_PRINTF_LONG_SUPPORT
-                if (lng)
-                    li2a(va_arg(va, unsigned long int), bf);
-                else
+            if (lng)
+                num = va_arg(va, unsigned long int);
+            else
 #endif
-                    i2a(va_arg(va, int), bf);
-                written += putchw(putp, putf, w, lz, bf);
-                break;
-            }
-            case 'x':
-            case 'X':
+                num = va_arg(va, unsigned int);
+            const char *p = ulToDigits(num, ch != 'u', ch == 'X', bfEnd);
+            written += putchw(putp, putw, w, lz, p, bfEnd - p);
+            break;
+        }
+        case 'd': {
+            long num;
 #ifdef  REQUIRE_PRINTF_LONG_SUPPORT
-                if (lng)
-                    uli2a(va_arg(va, unsigned long int), 16, (ch == 'X'), bf);
-                else
+            if (lng)
+                num = (long)va_arg(va, unsigned long int);
+            else
 #endif
-                    ui2a(va_arg(va, unsigned int), 16, (ch == 'X'), bf);
-                written += putchw(putp, putf, w, lz, bf);
-                break;
-            case 'c':
-                putf(putp, (char) (va_arg(va, int)));
-                written++;
-                break;
-            case 's':
-                written += putchw(putp, putf, w, 0, va_arg(va, char *));
-                break;
-            case '%':
-                putf(putp, ch);
-                written++;
-                break;
-            case 'n':
-                *va_arg(va, int*) = written;
-                break;
-            default:
-                break;
+                num = va_arg(va, int);
+            char *p;
+            if (num < 0) {
+                p = ulToDigits(-(unsigned long)num, false, false, bfEnd);
+                *--p = '-';
+            } else {
+                p = ulToDigits(num, false, false, bfEnd);
             }
+            // zero padding goes in front of the sign, "%04d" of -5 is "00-5"
+            written += putchw(putp, putw, w, lz, p, bfEnd - p);
+            break;
+        }
+        case 'c':
+            bf[0] = (char)(va_arg(va, int));
+            putw(putp, bf, 1);
+            written++;
+            break;
+        case 's': {
+            const char *str = va_arg(va, char *);
+            written += putchw(putp, putw, w, 0, str, strlen(str));
+            break;
+        }
+        case '%':
+            putw(putp, "%", 1);
+            written++;
+            break;
+        case 'n':
+            *va_arg(va, int*) = written;
+            break;
+        default:
+            break;
         }
     }
 abort:
     return written;
 }
 
+typedef struct putcSink_s {
+    void *putp;
+    putcf putf;
+} putcSink_t;
+
+static void putcSinkWrite(void *p, const char *data, int len) {
+    const putcSink_t *sink = p;
+    while (len--) {
+        sink->putf(sink->putp, *data++);
+    }
+}
+
+// retrun number of bytes written
+int tfp_format(void *putp, putcf putf, const char *fmt, va_list va) {
+    putcSink_t sink = { .putp = putp, .putf = putf };
+    return tfp_format_write(&sink, putcSinkWrite, fmt, va);
+}
+
 void init_printf(void *putp, void (*putf) (void *, char)) {
     stdout_putf = putf;
     stdout_putp = putp;
@@ -176,15 +236,37 @@ int tfp_printf(const char *fmt, ...) {
     return written;
 }
 
-static void putcp(void *p, char c) {
-    *(*((char **) p))++ = c;
+static void putMemory(void *p, const char *data, int len) {
+    char **dst = p;
+    memcpy(*dst, data, len);
+    *dst += len;
 }
 
 int tfp_sprintf(char *s, const char *fmt, ...) {
     va_list va;
     va_start(va, fmt);
-    int written = tfp_format(&s, putcp, fmt, va);
-    putcp(&s, 0);
+    int written = tfp_format_write(&s, putMemory, fmt, va);
+    *s = 0;
+    va_end(va);
+    return written;
+}
+
+static void putSbuf(void *p, const char *data, int len) {
+    sbuf_t *dst = p;
+    len = MIN(len, dst->end - dst->ptr);
+    if (len > 0) {
+        memcpy(dst->ptr, data, len);
+        dst->ptr += len;
+    }
+}
+
+// Formats straight into a stream buffer, without a terminating zero. Output
+// beyond the end of the buffer is dropped, the return value is the length
+// the whole output would have had.
+int tfp_sbufprintf(sbuf_t *dst, const char *fmt, ...) {
+    va_list va;
+    va_start(va, fmt);
+    int written = tfp_format_write(dst, putSbuf, fmt, va);
     va_end(va);
     return written;
 }
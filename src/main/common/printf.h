@@ -113,6 +113,10 @@ void init_printf(void *putp, void (*putf) (void *, char));
 int tfp_sprintf(char *s, const char *fmt, ...);
 
 int tfp_format(void *putp, void (*putf) (void *, char), const char *fmt, va_list va);
+int tfp_format_write(void *putp, void (*putw) (void *, const char *, int), const char *fmt, va_list va);
+
+struct sbuf_s;
+int tfp_sbufprintf(struct sbuf_s *dst, const char *fmt, ...);
 
 struct serialPort_s;
 void setPrintfSerialPort(struct serialPort_s *serialPort);
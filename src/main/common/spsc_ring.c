@@ -0,0 +1,121 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/maths.h"
+
+#include "common/spsc_ring.h"
+
+// the other side's index is loaded with acquire so the bytes it published are visible,
+// the own index is stored with release once the bytes are in place
+#define RING_LOAD(x)        __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define RING_STORE(x, v)    __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+
+void spscRingInit(spscRing_t *ring, uint8_t *buffer, uint32_t size) {
+    ring->buffer = buffer;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+uint32_t spscRingUsed(const spscRing_t *ring) {
+    return RING_LOAD(ring->head) - RING_LOAD(ring->tail);
+}
+
+uint32_t spscRingFree(const spscRing_t *ring) {
+    return ring->mask + 1 - spscRingUsed(ring);
+}
+
+// returns the number of bytes queued, less than len if the ring is full
+uint32_t spscRingWrite(spscRing_t *ring, const uint8_t *data, uint32_t len) {
+    const uint32_t head = ring->head;
+    const uint32_t tail = RING_LOAD(ring->tail);
+    len = MIN(len, ring->mask + 1 - (head - tail));
+
+    const uint32_t offset = head & ring->mask;
+    const uint32_t first = MIN(len, ring->mask + 1 - offset);
+    memcpy(&ring->buffer[offset], data, first);
+    memcpy(ring->buffer, data + first, len - first);
+
+    RING_STORE(ring->head, head + len);
+    return len;
+}
+
+bool spscRingPut(spscRing_t *ring, uint8_t ch) {
+    const uint32_t head = ring->head;
+    if (head - RING_LOAD(ring->tail) > ring->mask) {
+        return false;
+    }
+    ring->buffer[head & ring->mask] = ch;
+    RING_STORE(ring->head, head + 1);
+    return true;
+}
+
+uint32_t spscRingRead(spscRing_t *ring, uint8_t *data, uint32_t len) {
+    const uint32_t tail = ring->tail;
+    len = MIN(len, RING_LOAD(ring->head) - tail);
+
+    const uint32_t offset = tail & ring->mask;
+    const uint32_t first = MIN(len, ring->mask + 1 - offset);
+    memcpy(data, &ring->buffer[offset], first);
+    memcpy(data + first, ring->buffer, len - first);
+
+    RING_STORE(ring->tail, tail + len);
+    return len;
+}
+
+bool spscRingGet(spscRing_t *ring, uint8_t *ch) {
+    const uint32_t tail = ring->tail;
+    if (RING_LOAD(ring->head) == tail) {
+        return false;
+    }
+    *ch = ring->buffer[tail & ring->mask];
+    RING_STORE(ring->tail, tail + 1);
+    return true;
+}
+
+// describes the queued bytes as up to two contiguous segments, returns the segment count
+int spscRingPeek(const spscRing_t *ring, const uint8_t *segment[2], uint32_t segmentLen[2]) {
+    const uint32_t tail = ring->tail;
+    const uint32_t len = RING_LOAD(ring->head) - tail;
+    if (len == 0) {
+        return 0;
+    }
+    const uint32_t offset = tail & ring->mask;
+    segment[0] = &ring->buffer[offset];
+    segmentLen[0] = MIN(len, ring->mask + 1 - offset);
+    if (segmentLen[0] == len) {
+        return 1;
+    }
+    segment[1] = ring->buffer;
+    segmentLen[1] = len - segmentLen[0];
+    return 2;
+}
+
+void spscRingConsume(spscRing_t *ring, uint32_t len) {
+    RING_STORE(ring->tail, ring->tail + len);
+}
+
+void spscRingDiscard(spscRing_t *ring) {
+    RING_STORE(ring->tail, RING_LOAD(ring->head));
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Byte ring shared by one producer and one consumer thread without a lock.
+// head is only written by the producer, tail only by the consumer; both run
+// freely and wrap on the power of two size.
+
+typedef struct spscRing_s {
+    uint8_t *buffer;
+    uint32_t mask;          // size - 1, size must be a power of two
+    uint32_t head;
+    uint32_t tail;
+} spscRing_t;
+
+void spscRingInit(spscRing_t *ring, uint8_t *buffer, uint32_t size);
+uint32_t spscRingUsed(const spscRing_t *ring);
+uint32_t spscRingFree(const spscRing_t *ring);
+
+// producer side
+uint32_t spscRingWrite(spscRing_t *ring, const uint8_t *data, uint32_t len);
+bool spscRingPut(spscRing_t *ring, uint8_t ch);
+
+// consumer side
+uint32_t spscRingRead(spscRing_t *ring, uint8_t *data, uint32_t len);
+bool spscRingGet(spscRing_t *ring, uint8_t *ch);
+int spscRingPeek(const spscRing_t *ring, const uint8_t *segment[2], uint32_t segmentLen[2]);
+void spscRingConsume(spscRing_t *ring, uint32_t len);
+void spscRingDiscard(spscRing_t *ring);
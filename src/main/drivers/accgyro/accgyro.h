@@ -74,7 +74,7 @@ typedef struct gyroDev_s {
     busDevice_t bus;
     float scale;                                            // scalefactor
     float gyroZero[XYZ_AXIS_COUNT];
-    float gyroADC[XYZ_AXIS_COUNT];                        // gyro data after calibration and alignment
+    float gyroADC[XYZ_AXIS_COUNT];                        // gyro data in deg/s after calibration and alignment
     float gyroADCf[XYZ_AXIS_COUNT];
     int32_t gyroADCRawPrevious[XYZ_AXIS_COUNT];
     int16_t gyroADCRaw[XYZ_AXIS_COUNT];
@@ -27,10 +27,14 @@
 #ifdef USE_ADC
 
 #include "build/build_config.h"
+#include "build/atomic.h"
 #include "build/debug.h"
 
 #include "drivers/adc_impl.h"
+#include "drivers/adc_oversample.h"
+#include "drivers/dma.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 
 #include "pg/adc.h"
 
@@ -46,6 +50,15 @@ volatile FAST_RAM_ZERO_INIT uint16_t adcValues[ADC_CHANNEL_COUNT];
 volatile uint16_t adcValues[ADC_CHANNEL_COUNT];
 #endif
 
+#ifdef USE_ADC_OVERSAMPLE
+#if defined(STM32F7)
+volatile FAST_RAM_ZERO_INIT uint16_t adcOversampleBuffer[ADC_OVERSAMPLE_BUFFER_SIZE];
+#else
+volatile uint16_t adcOversampleBuffer[ADC_OVERSAMPLE_BUFFER_SIZE];
+#endif
+static adcOversample_t adcOversample;
+#endif
+
 #ifdef USE_ADC_INTERNAL
 uint16_t adcTSCAL1;
 uint16_t adcTSCAL2;
@@ -81,24 +94,65 @@ ADCDevice adcDeviceByInstance(ADC_TypeDef *instance) {
     return ADCINVALID;
 }
 
+static uint16_t adcChannelValue(uint8_t channel) {
+#ifdef USE_ADC_OVERSAMPLE
+    return adcOversample.blockMean[channel];
+#else
+    return adcValues[adcOperatingConfig[channel].dmaIndex];
+#endif
+}
+
 uint16_t adcGetChannel(uint8_t channel) {
+    const uint16_t value = adcChannelValue(channel);
 #ifdef DEBUG_ADC_CHANNELS
+    // logged from the same values the caller gets
     if (adcOperatingConfig[0].enabled) {
-        debug[0] = adcValues[adcOperatingConfig[0].dmaIndex];
+        debug[0] = adcChannelValue(0);
     }
     if (adcOperatingConfig[1].enabled) {
-        debug[1] = adcValues[adcOperatingConfig[1].dmaIndex];
+        debug[1] = adcChannelValue(1);
     }
     if (adcOperatingConfig[2].enabled) {
-        debug[2] = adcValues[adcOperatingConfig[2].dmaIndex];
+        debug[2] = adcChannelValue(2);
     }
     if (adcOperatingConfig[3].enabled) {
-        debug[3] = adcValues[adcOperatingConfig[3].dmaIndex];
+        debug[3] = adcChannelValue(3);
     }
 #endif
-    return adcValues[adcOperatingConfig[channel].dmaIndex];
+    return value;
 }
 
+#ifdef USE_ADC_OVERSAMPLE
+static void adcOversampleDmaIrqHandler(dmaChannelDescriptor_t *descriptor) {
+    // each half is processed while the DMA fills the other one
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_HTIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_HTIF);
+        adcOversampleBlock(&adcOversample, adcOversampleBuffer, ADC_OVERSAMPLE_FRAMES);
+    }
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        adcOversampleBlock(&adcOversample, &adcOversampleBuffer[ADC_OVERSAMPLE_FRAMES * adcOversample.channelCount], ADC_OVERSAMPLE_FRAMES);
+    }
+    DMA_CLEAR_FLAG(descriptor, DMA_IT_TEIF | DMA_IT_DMEIF | DMA_IT_FEIF);
+}
+
+// called by the MCU specific adcInit() before the DMA is started
+void adcOversampleStart(dmaIdentifier_e dmaIdentifier, uint8_t channelCount) {
+    uint8_t dmaIndex[ADC_CHANNEL_COUNT];
+    for (int i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        dmaIndex[i] = adcOperatingConfig[i].enabled ? adcOperatingConfig[i].dmaIndex : ADC_OVERSAMPLE_UNUSED;
+    }
+    adcOversampleInit(&adcOversample, dmaIndex, channelCount);
+    dmaSetHandler(dmaIdentifier, adcOversampleDmaIrqHandler, NVIC_PRIO_ADC_DMA, 0);
+}
+
+void adcGetOversampleTotals(adcOversampleTotals_t *totals) {
+    ATOMIC_BLOCK(NVIC_PRIO_ADC_DMA) {
+        *totals = adcOversample.totals;
+    }
+}
+#endif
+
 // Verify a pin designated by tag has connection to an ADC instance designated by device
 
 bool adcVerifyPin(ioTag_t tag, ADCDevice device) {
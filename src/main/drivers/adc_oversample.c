@@ -0,0 +1,85 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Software oversampling of the circular ADC DMA buffer.
+ *
+ *   The ADC converts continuously into a buffer of 2 * ADC_OVERSAMPLE_FRAMES
+ * frames and the DMA half and full transfer interrupts hand the finished half
+ * to adcOversampleBlock(). Every conversion is added to running totals, so a
+ * reader that differences two reads gets the exact mean over the time between
+ * them instead of one conversion that happens to alias with the ESC PWM
+ * ripple. The product of battery and current is summed per frame as well,
+ * which lets the energy drawn be integrated without assuming that voltage and
+ * current are uncorrelated.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "drivers/adc_oversample.h"
+
+void adcOversampleInit(adcOversample_t *oversample, const uint8_t *dmaIndex, uint8_t channelCount) {
+    memset(oversample, 0, sizeof(*oversample));
+    memcpy(oversample->dmaIndex, dmaIndex, sizeof(oversample->dmaIndex));
+    oversample->channelCount = channelCount;
+}
+
+void adcOversampleBlock(adcOversample_t *oversample, const volatile uint16_t *frames, uint16_t frameCount) {
+    if (!oversample->channelCount || !frameCount) {
+        return;
+    }
+    const uint8_t batteryIndex = oversample->dmaIndex[ADC_BATTERY];
+    const uint8_t currentIndex = oversample->dmaIndex[ADC_CURRENT];
+    const bool power = batteryIndex != ADC_OVERSAMPLE_UNUSED && currentIndex != ADC_OVERSAMPLE_UNUSED;
+    uint32_t blockSum[ADC_CHANNEL_COUNT] = { 0 };
+    uint64_t powerSum = 0;
+    for (int frame = 0; frame < frameCount; frame++) {
+        const volatile uint16_t *sample = &frames[frame * oversample->channelCount];
+        for (int i = 0; i < oversample->channelCount; i++) {
+            blockSum[i] += sample[i];
+        }
+        if (power) {
+            powerSum += (uint32_t)sample[batteryIndex] * sample[currentIndex];
+        }
+    }
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        const uint8_t index = oversample->dmaIndex[channel];
+        if (index == ADC_OVERSAMPLE_UNUSED) {
+            continue;
+        }
+        oversample->totals.sum[channel] += blockSum[index];
+        oversample->blockMean[channel] = (blockSum[index] + frameCount / 2) / frameCount;
+    }
+    oversample->totals.powerSum += powerSum;
+    oversample->totals.frames += frameCount;
+}
+
+// mean conversion value between two reads of the totals, 0 if no block completed in between
+float adcOversampleMean(const adcOversampleTotals_t *now, const adcOversampleTotals_t *before, AdcChannel channel) {
+    const uint32_t frames = now->frames - before->frames;
+    return frames ? (float)(now->sum[channel] - before->sum[channel]) / frames : 0.0f;
+}
+
+float adcOversamplePowerMean(const adcOversampleTotals_t *now, const adcOversampleTotals_t *before) {
+    const uint32_t frames = now->frames - before->frames;
+    return frames ? (float)(now->powerSum - before->powerSum) / frames : 0.0f;
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "drivers/adc.h"
+#ifdef USE_ADC_OVERSAMPLE
+#include "drivers/dma.h"
+#endif
+
+#define ADC_OVERSAMPLE_FRAMES 32    // conversion frames in each half of the circular DMA buffer
+#define ADC_OVERSAMPLE_UNUSED 0xff
+
+// Running totals since init. The sums wrap, only differences between two reads are meaningful.
+typedef struct adcOversampleTotals_s {
+    uint32_t frames;
+    uint32_t sum[ADC_CHANNEL_COUNT];
+    uint64_t powerSum;              // sum of battery * current per frame
+} adcOversampleTotals_t;
+
+typedef struct adcOversample_s {
+    uint8_t channelCount;                   // conversions in one frame
+    uint8_t dmaIndex[ADC_CHANNEL_COUNT];    // position in the frame, ADC_OVERSAMPLE_UNUSED if not converted
+    uint16_t blockMean[ADC_CHANNEL_COUNT];  // mean of the last completed block
+    adcOversampleTotals_t totals;
+} adcOversample_t;
+
+void adcOversampleInit(adcOversample_t *oversample, const uint8_t *dmaIndex, uint8_t channelCount);
+void adcOversampleBlock(adcOversample_t *oversample, const volatile uint16_t *frames, uint16_t frameCount);
+float adcOversampleMean(const adcOversampleTotals_t *now, const adcOversampleTotals_t *before, AdcChannel channel);
+float adcOversamplePowerMean(const adcOversampleTotals_t *now, const adcOversampleTotals_t *before);
+
+#ifdef USE_ADC_OVERSAMPLE
+#define ADC_OVERSAMPLE_BUFFER_SIZE (2 * ADC_OVERSAMPLE_FRAMES * ADC_CHANNEL_COUNT)
+
+extern volatile uint16_t adcOversampleBuffer[ADC_OVERSAMPLE_BUFFER_SIZE];
+
+void adcOversampleStart(dmaIdentifier_e dmaIdentifier, uint8_t channelCount);
+void adcGetOversampleTotals(adcOversampleTotals_t *totals);
+#endif
@@ -40,6 +40,7 @@
 
 #include "adc.h"
 #include "adc_impl.h"
+#include "adc_oversample.h"
 
 #include "pg/adc.h"
 
@@ -251,16 +252,27 @@ void adcInit(const adcConfig_t *config) {
     DMA_StructInit(&DMA_InitStructure);
     DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&adc.ADCx->DR;
     DMA_InitStructure.DMA_Channel = adc.channel;
+#ifdef USE_ADC_OVERSAMPLE
+    // two halves of ADC_OVERSAMPLE_FRAMES frames, summed by the half and full transfer interrupts
+    adcOversampleStart(dmaGetIdentifier(adc.DMAy_Streamx), configuredAdcChannels);
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)adcOversampleBuffer;
+    DMA_InitStructure.DMA_BufferSize = 2 * ADC_OVERSAMPLE_FRAMES * configuredAdcChannels;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+#else
     DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)adcValues;
-    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
     DMA_InitStructure.DMA_BufferSize = configuredAdcChannels;
-    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
     DMA_InitStructure.DMA_MemoryInc = configuredAdcChannels > 1 ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+#endif
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
     DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
     DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
     DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
     DMA_InitStructure.DMA_Priority = DMA_Priority_High;
     DMA_Init(adc.DMAy_Streamx, &DMA_InitStructure);
+#ifdef USE_ADC_OVERSAMPLE
+    DMA_ITConfig(adc.DMAy_Streamx, DMA_IT_HT | DMA_IT_TC, ENABLE);
+#endif
     DMA_Cmd(adc.DMAy_Streamx, ENABLE);
     ADC_SoftwareStartConv(adc.ADCx);
 }
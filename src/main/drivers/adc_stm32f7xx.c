@@ -38,6 +38,7 @@
 
 #include "adc.h"
 #include "adc_impl.h"
+#include "adc_oversample.h"
 
 #include "pg/adc.h"
 
@@ -267,7 +268,11 @@ void adcInit(const adcConfig_t *config) {
     adc.DmaHandle.Init.Channel = adc.channel;
     adc.DmaHandle.Init.Direction = DMA_PERIPH_TO_MEMORY;
     adc.DmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
+#ifdef USE_ADC_OVERSAMPLE
+    adc.DmaHandle.Init.MemInc = DMA_MINC_ENABLE;
+#else
     adc.DmaHandle.Init.MemInc = configuredAdcChannels > 1 ? DMA_MINC_ENABLE : DMA_MINC_DISABLE;
+#endif
     adc.DmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
     adc.DmaHandle.Init.Mode = DMA_CIRCULAR;
@@ -282,7 +287,16 @@ void adcInit(const adcConfig_t *config) {
     }
     __HAL_LINKDMA(&adc.ADCHandle, DMA_Handle, adc.DmaHandle);
     //HAL_CLEANINVALIDATECACHE((uint32_t*)&adcValues, configuredAdcChannels);
-    if (HAL_ADC_Start_DMA(&adc.ADCHandle, (uint32_t*)&adcValues, configuredAdcChannels) != HAL_OK) {
+#ifdef USE_ADC_OVERSAMPLE
+    // HAL_ADC_Start_DMA() enables the half and full transfer interrupts, the handler only looks at the flags
+    adcOversampleStart(dmaGetIdentifier(adc.DMAy_Streamx), configuredAdcChannels);
+    uint32_t *dmaBuffer = (uint32_t*)adcOversampleBuffer;
+    const uint32_t dmaLength = 2 * ADC_OVERSAMPLE_FRAMES * configuredAdcChannels;
+#else
+    uint32_t *dmaBuffer = (uint32_t*)&adcValues;
+    const uint32_t dmaLength = configuredAdcChannels;
+#endif
+    if (HAL_ADC_Start_DMA(&adc.ADCHandle, dmaBuffer, dmaLength) != HAL_OK) {
         /* Start Conversation Error */
     }
 }
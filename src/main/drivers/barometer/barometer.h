@@ -35,7 +35,10 @@ typedef struct baroDev_s {
     baroOpFuncPtr get_ut;
     baroOpFuncPtr start_up;
     baroOpFuncPtr get_up;
+    baroOpFuncPtr read_ut;                  // optional, queues the read that get_ut decodes
+    baroOpFuncPtr read_up;                  // optional, queues the read that get_up decodes
     baroCalculateFuncPtr calculate;
+    i2cJob_t job;                           // bus transaction of the split reads and conversion commands
 } baroDev_t;
 
 #ifndef BARO_I2C_INSTANCE
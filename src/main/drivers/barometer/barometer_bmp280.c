@@ -60,11 +60,13 @@ STATIC_UNIT_TESTED bmp280_calib_param_t bmp280_cal;
 // uncompensated pressure and temperature
 int32_t bmp280_up = 0;
 int32_t bmp280_ut = 0;
+static uint8_t bmp280_data[BMP280_DATA_FRAME_SIZE];   // result of the last data read
 
 static void bmp280_start_ut(baroDev_t *baro);
 static void bmp280_get_ut(baroDev_t *baro);
 static void bmp280_start_up(baroDev_t *baro);
 static void bmp280_get_up(baroDev_t *baro);
+static void bmp280_read_up(baroDev_t *baro);
 
 STATIC_UNIT_TESTED void bmp280_calculate(int32_t *pressure, int32_t *temperature);
 
@@ -120,6 +122,7 @@ bool bmp280Detect(baroDev_t *baro) {
     // only _up part is executed, and gets both temperature and pressure
     baro->start_up = bmp280_start_up;
     baro->get_up = bmp280_get_up;
+    baro->read_up = bmp280_read_up;
     baro->up_delay = ((T_INIT_MAX + T_MEASURE_PER_OSRS_MAX * (((1 << BMP280_TEMPERATURE_OSR) >> 1) + ((1 << BMP280_PRESSURE_OSR) >> 1)) + (BMP280_PRESSURE_OSR ? T_SETUP_PRESSURE_MAX : 0) + 15) / 16) * 1000;
     baro->calculate = bmp280_calculate;
     return true;
@@ -138,13 +141,19 @@ static void bmp280_get_ut(baroDev_t *baro) {
 static void bmp280_start_up(baroDev_t *baro) {
     // start measurement
     // set oversampling + power mode (forced), and start sampling
-    busWriteRegister(&baro->busdev, BMP280_CTRL_MEAS_REG, BMP280_MODE);
+    busWriteRegisterStart(&baro->busdev, &baro->job, BMP280_CTRL_MEAS_REG, BMP280_MODE);
+}
+
+// queued, get_up decodes it once the job is done
+static void bmp280_read_up(baroDev_t *baro) {
+    if (!busReadRegisterBufferStart(&baro->busdev, &baro->job, BMP280_PRESSURE_MSB_REG, bmp280_data, BMP280_DATA_FRAME_SIZE)) {
+        baro->job.status = I2C_JOB_ERROR;
+    }
 }
 
 static void bmp280_get_up(baroDev_t *baro) {
-    uint8_t data[BMP280_DATA_FRAME_SIZE];
-    // read data from sensor
-    busReadRegisterBuffer(&baro->busdev, BMP280_PRESSURE_MSB_REG, data, BMP280_DATA_FRAME_SIZE);
+    UNUSED(baro);
+    const uint8_t *data = bmp280_data;
     bmp280_up = (int32_t)((((uint32_t)(data[0])) << 12) | (((uint32_t)(data[1])) << 4) | ((uint32_t)data[2] >> 4));
     bmp280_ut = (int32_t)((((uint32_t)(data[3])) << 12) | (((uint32_t)(data[4])) << 4) | ((uint32_t)data[5] >> 4));
 }
@@ -52,7 +52,7 @@
 static void ms5611_reset(busDevice_t *busdev);
 static uint16_t ms5611_prom(busDevice_t *busdev, int8_t coef_num);
 STATIC_UNIT_TESTED int8_t ms5611_crc(uint16_t *prom);
-static uint32_t ms5611_read_adc(busDevice_t *busdev);
+static void ms5611_read_adc(baroDev_t *baro);
 static void ms5611_start_ut(baroDev_t *baro);
 static void ms5611_get_ut(baroDev_t *baro);
 static void ms5611_start_up(baroDev_t *baro);
@@ -63,6 +63,7 @@ STATIC_UNIT_TESTED uint32_t ms5611_ut;  // static result of temperature measurem
 STATIC_UNIT_TESTED uint32_t ms5611_up;  // static result of pressure measurement
 STATIC_UNIT_TESTED uint16_t ms5611_c[PROM_NB];  // on-chip ROM
 static uint8_t ms5611_osr = CMD_ADC_4096;
+static uint8_t ms5611_adc[3];   // result of the last ADC read
 
 void ms5611BusInit(busDevice_t *busdev) {
 #ifdef USE_BARO_SPI_MS5611
@@ -117,6 +118,8 @@ bool ms5611Detect(baroDev_t *baro) {
     baro->get_ut = ms5611_get_ut;
     baro->start_up = ms5611_start_up;
     baro->get_up = ms5611_get_up;
+    baro->read_ut = ms5611_read_adc;
+    baro->read_up = ms5611_read_adc;
     baro->calculate = ms5611_calculate;
     return true;
 fail:
@@ -165,26 +168,33 @@ STATIC_UNIT_TESTED int8_t ms5611_crc(uint16_t *prom) {
     return -1;
 }
 
-static uint32_t ms5611_read_adc(busDevice_t *busdev) {
-    uint8_t rxbuf[3];
-    busReadRegisterBuffer(busdev, CMD_ADC_READ, rxbuf, 3); // read ADC
-    return (rxbuf[0] << 16) | (rxbuf[1] << 8) | rxbuf[2];
+// queued, get_ut/get_up decode it once the job is done
+static void ms5611_read_adc(baroDev_t *baro) {
+    if (!busReadRegisterBufferStart(&baro->busdev, &baro->job, CMD_ADC_READ, ms5611_adc, 3)) { // read ADC
+        baro->job.status = I2C_JOB_ERROR;
+    }
+}
+
+static uint32_t ms5611_adc_value(void) {
+    return (ms5611_adc[0] << 16) | (ms5611_adc[1] << 8) | ms5611_adc[2];
 }
 
 static void ms5611_start_ut(baroDev_t *baro) {
-    busWriteRegister(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D2 + ms5611_osr, 1); // D2 (temperature) conversion start!
+    busWriteRegisterStart(&baro->busdev, &baro->job, CMD_ADC_CONV + CMD_ADC_D2 + ms5611_osr, 1); // D2 (temperature) conversion start!
 }
 
 static void ms5611_get_ut(baroDev_t *baro) {
-    ms5611_ut = ms5611_read_adc(&baro->busdev);
+    UNUSED(baro);
+    ms5611_ut = ms5611_adc_value();
 }
 
 static void ms5611_start_up(baroDev_t *baro) {
-    busWriteRegister(&baro->busdev, CMD_ADC_CONV + CMD_ADC_D1 + ms5611_osr, 1); // D1 (pressure) conversion start!
+    busWriteRegisterStart(&baro->busdev, &baro->job, CMD_ADC_CONV + CMD_ADC_D1 + ms5611_osr, 1); // D1 (pressure) conversion start!
 }
 
 static void ms5611_get_up(baroDev_t *baro) {
-    ms5611_up = ms5611_read_adc(&baro->busdev);
+    UNUSED(baro);
+    ms5611_up = ms5611_adc_value();
 }
 
 STATIC_UNIT_TESTED void ms5611_calculate(int32_t *pressure, int32_t *temperature) {
@@ -19,6 +19,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 #include "buf_writer.h"
 
@@ -38,6 +39,23 @@ void bufWriterAppend(bufWriter_t *b, uint8_t ch) {
     }
 }
 
+void bufWriterAppendData(bufWriter_t *b, const void *data, int count) {
+    const uint8_t *src = data;
+    while (count > 0) {
+        int chunk = b->capacity - b->at;
+        if (chunk > count) {
+            chunk = count;
+        }
+        memcpy(&b->data[b->at], src, chunk);
+        b->at += chunk;
+        src += chunk;
+        count -= chunk;
+        if (b->at >= b->capacity) {
+            bufWriterFlush(b);
+        }
+    }
+}
+
 void bufWriterFlush(bufWriter_t *b) {
     if (b->at != 0) {
         b->writer(b->arg, b->data, b->at);
@@ -23,9 +23,12 @@
 
 #include "platform.h"
 
+#include "common/utils.h"
+
 #include "drivers/bus.h"
 #include "drivers/bus_i2c_busdev.h"
 #include "drivers/bus_spi.h"
+#include "drivers/time.h"
 
 bool busWriteRegister(const busDevice_t *busdev, uint8_t reg, uint8_t data) {
 #ifdef USE_DMA_SPI_DEVICE
@@ -91,3 +94,43 @@ uint8_t busReadRegister(const busDevice_t *busdev, uint8_t reg) {
 #endif
 #endif
 }
+
+/*
+ * Split transactions: the Start functions queue the transfer on I2C and return,
+ * the caller checks busJobBusy in a later task invocation before it uses the data.
+ * The other bus types complete the transfer before the Start function returns.
+ * The job and the data buffer must stay valid until the job is no longer busy.
+ */
+bool busReadRegisterBufferStart(const busDevice_t *busdev, i2cJob_t *job, uint8_t reg, uint8_t *data, uint8_t length) {
+#if defined(USE_I2C) && !defined(USE_DMA_SPI_DEVICE)
+    if (busdev->bustype == BUSTYPE_I2C) {
+        i2cJobSetRead(job, busdev->busdev_u.i2c.address, reg, data, length);
+        return i2cSubmit(busdev->busdev_u.i2c.device, job);
+    }
+#endif
+    job->status = busReadRegisterBuffer(busdev, reg, data, length) ? I2C_JOB_DONE : I2C_JOB_ERROR;
+    return true;
+}
+
+bool busWriteRegisterStart(const busDevice_t *busdev, i2cJob_t *job, uint8_t reg, uint8_t data) {
+#if defined(USE_I2C) && !defined(USE_DMA_SPI_DEVICE)
+    if (busdev->bustype == BUSTYPE_I2C) {
+        i2cJobSetWriteByte(job, busdev->busdev_u.i2c.address, reg, data);
+        return i2cSubmit(busdev->busdev_u.i2c.device, job);
+    }
+#endif
+    job->status = busWriteRegister(busdev, reg, data) ? I2C_JOB_DONE : I2C_JOB_ERROR;
+    return true;
+}
+
+// also recovers the bus if the job got stuck on it
+bool busJobBusy(const busDevice_t *busdev, i2cJob_t *job) {
+#if defined(USE_I2C) && !defined(USE_DMA_SPI_DEVICE)
+    if (busdev->bustype == BUSTYPE_I2C && i2cJobIsBusy(job)) {
+        i2cCheckTimeout(busdev->busdev_u.i2c.device, micros());
+    }
+#else
+    UNUSED(busdev);
+#endif
+    return i2cJobIsBusy(job);
+}
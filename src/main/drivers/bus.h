@@ -64,3 +64,7 @@ void targetBusInit(void);
 bool busWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data);
 bool busReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length);
 uint8_t busReadRegister(const busDevice_t *bus, uint8_t reg);
+
+bool busReadRegisterBufferStart(const busDevice_t *bus, i2cJob_t *job, uint8_t reg, uint8_t *data, uint8_t length);
+bool busWriteRegisterStart(const busDevice_t *bus, i2cJob_t *job, uint8_t reg, uint8_t data);
+bool busJobBusy(const busDevice_t *bus, i2cJob_t *job);
@@ -22,6 +22,9 @@
 
 #include "platform.h"
 
+#include "common/time.h"
+
+#include "drivers/bus_i2c_queue.h"
 #include "drivers/io_types.h"
 #include "drivers/rcc_types.h"
 
@@ -63,3 +66,11 @@ bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t data);
 bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg, uint8_t len, uint8_t* buf);
 
 uint16_t i2cGetErrorCounter(void);
+
+#if defined(USE_I2C) && !defined(SOFT_I2C) && (defined(STM32F1) || defined(STM32F4) || defined(STM32F7))
+#define USE_I2C_ASYNC   // jobs are queued and run from the I2C interrupts, elsewhere they complete within i2cSubmit
+#endif
+
+bool i2cSubmit(I2CDevice device, i2cJob_t *job);
+void i2cCheckTimeout(I2CDevice device, timeUs_t currentTimeUs);
+const i2cBusStats_t *i2cGetBusStats(I2CDevice device);
@@ -26,8 +26,11 @@
 
 #if defined(USE_I2C)
 
+#include "common/utils.h"
+
 #include "drivers/bus.h"
 #include "drivers/bus_i2c.h"
+#include "drivers/time.h"
 
 bool i2cBusWriteRegister(const busDevice_t *busdev, uint8_t reg, uint8_t data) {
     return i2cWrite(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, data);
@@ -42,4 +45,40 @@ uint8_t i2cBusReadRegister(const busDevice_t *busdev, uint8_t reg) {
     i2cRead(busdev->busdev_u.i2c.device, busdev->busdev_u.i2c.address, reg, 1, &data);
     return data;
 }
+
+#ifndef USE_I2C_ASYNC
+static i2cQueue_t i2cQueue[I2CDEV_COUNT];
+
+// no interrupt driven engine on this platform, the job is run to completion here and the queue only keeps the statistics
+bool i2cSubmit(I2CDevice device, i2cJob_t *job) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT) {
+        return false;
+    }
+    i2cQueue_t *queue = &i2cQueue[device];
+    if (!i2cQueuePush(queue, job)) {
+        return false;
+    }
+    i2cQueueStart(queue, micros());
+    bool ack;
+    if (job->data.read) {
+        ack = i2cRead(device, job->addr, job->reg, job->data.len, job->data.buffer);
+    } else {
+        ack = i2cWriteBuffer(device, job->addr, job->reg, job->data.len, job->data.buffer);
+    }
+    i2cQueueComplete(queue, ack ? I2C_JOB_DONE : I2C_JOB_ERROR);
+    return true;
+}
+
+void i2cCheckTimeout(I2CDevice device, timeUs_t currentTimeUs) {
+    UNUSED(device);
+    UNUSED(currentTimeUs);
+}
+
+const i2cBusStats_t *i2cGetBusStats(I2CDevice device) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT) {
+        return NULL;
+    }
+    return &i2cQueue[device].stats;
+}
+#endif
 #endif
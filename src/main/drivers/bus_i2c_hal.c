@@ -146,80 +146,194 @@ void i2cSetOverclock(uint8_t OverClock) {
     i2cOverClock = (OverClock) ? true : false;
 }
 
-static bool i2cHandleHardwareFailure(I2CDevice device) {
-    (void)device;
-    i2cErrorCount++;
-    // reinit peripheral + clock out garbage
-    //i2cInit(device);
-    return false;
+static i2cQueue_t i2cQueue[I2CDEV_COUNT];
+
+static void i2cResetPeripheral(I2CDevice device);
+
+// keeps the HAL interrupt handlers and completion callbacks out while the queue is changed from task context
+static void i2cLock(I2CDevice device) {
+    HAL_NVIC_DisableIRQ(i2cDevice[device].hardware->ev_irq);
+    HAL_NVIC_DisableIRQ(i2cDevice[device].hardware->er_irq);
 }
 
-bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data) {
-    if (device == I2CINVALID || device > I2CDEV_COUNT) {
-        return false;
+static void i2cUnlock(I2CDevice device) {
+    HAL_NVIC_EnableIRQ(i2cDevice[device].hardware->ev_irq);
+    HAL_NVIC_EnableIRQ(i2cDevice[device].hardware->er_irq);
+}
+
+static bool i2cDeviceIsReady(I2CDevice device) {
+    return device != I2CINVALID && device < I2CDEV_COUNT && i2cDevice[device].hardware && i2cDevice[device].handle.Instance;
+}
+
+static I2CDevice i2cDeviceByHandle(const I2C_HandleTypeDef *pHandle) {
+    for (int device = 0; device < I2CDEV_COUNT; device++) {
+        if (&i2cDevice[device].handle == pHandle) {
+            return device;
+        }
     }
-    I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
-    if (!pHandle->Instance) {
-        return false;
+    return I2CINVALID;
+}
+
+static void i2cJobComplete(I2CDevice device, i2cJobStatus_e status);
+
+// hands the job at the head of the queue to the HAL interrupt transfer
+static void i2cStartJob(I2CDevice device) {
+    i2cJob_t *job = i2cQueueStart(&i2cQueue[device], micros());
+    if (!job) {
+        return;
     }
+    I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
     HAL_StatusTypeDef status;
-    if (reg_ == 0xFF)
-        status = HAL_I2C_Master_Transmit(pHandle, addr_ << 1, data, len_, I2C_DEFAULT_TIMEOUT);
-    else
-        status = HAL_I2C_Mem_Write(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT, data, len_, I2C_DEFAULT_TIMEOUT);
-    if (status != HAL_OK)
-        return i2cHandleHardwareFailure(device);
-    return true;
+    if (job->reg == I2C_REG_NONE) {
+        if (job->data.read) {
+            status = HAL_I2C_Master_Receive_IT(pHandle, job->addr << 1, job->data.buffer, job->data.len);
+        } else {
+            status = HAL_I2C_Master_Transmit_IT(pHandle, job->addr << 1, job->data.buffer, job->data.len);
+        }
+    } else {
+        if (job->data.read) {
+            status = HAL_I2C_Mem_Read_IT(pHandle, job->addr << 1, job->reg, I2C_MEMADD_SIZE_8BIT, job->data.buffer, job->data.len);
+        } else {
+            status = HAL_I2C_Mem_Write_IT(pHandle, job->addr << 1, job->reg, I2C_MEMADD_SIZE_8BIT, job->data.buffer, job->data.len);
+        }
+    }
+    if (status != HAL_OK) {
+        // HAL_BUSY with the bus held by a slave is left for i2cCheckTimeout, anything else fails the job
+        if (status != HAL_BUSY) {
+            i2cJobComplete(device, I2C_JOB_ERROR);
+        }
+    }
 }
 
-bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data) {
-    return i2cWriteBuffer(device, addr_, reg_, 1, &data);
+// called from the HAL completion callbacks, and from task context with the bus locked
+static void i2cJobComplete(I2CDevice device, i2cJobStatus_e status) {
+    const i2cJob_t *job = i2cQueueHead(&i2cQueue[device]);
+    if (!job || job->status != I2C_JOB_ACTIVE) {
+        return;
+    }
+    if (i2cQueueComplete(&i2cQueue[device], status)) {
+        i2cStartJob(device);
+    }
 }
 
-bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t* buf) {
-    if (device == I2CINVALID || device > I2CDEV_COUNT) {
-        return false;
+static void i2cTransferComplete(I2C_HandleTypeDef *pHandle) {
+    const I2CDevice device = i2cDeviceByHandle(pHandle);
+    if (device != I2CINVALID) {
+        i2cJobComplete(device, I2C_JOB_DONE);
     }
-    I2C_HandleTypeDef *pHandle = &i2cDevice[device].handle;
-    if (!pHandle->Instance) {
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *pHandle) {
+    i2cTransferComplete(pHandle);
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *pHandle) {
+    i2cTransferComplete(pHandle);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *pHandle) {
+    i2cTransferComplete(pHandle);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *pHandle) {
+    i2cTransferComplete(pHandle);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *pHandle) {
+    const I2CDevice device = i2cDeviceByHandle(pHandle);
+    if (device != I2CINVALID) {
+        i2cJobComplete(device, (HAL_I2C_GetError(pHandle) & HAL_I2C_ERROR_AF) ? I2C_JOB_NAK : I2C_JOB_ERROR);
+    }
+}
+
+// drops the job that got stuck, resets the peripheral + clocks out garbage and carries on with the queue,
+// called with the bus locked so the interrupts are left alone
+static void i2cHandleHardwareFailure(I2CDevice device) {
+    i2cErrorCount++;
+    i2cQueueComplete(&i2cQueue[device], I2C_JOB_TIMEOUT);
+    i2cResetPeripheral(device);
+    i2cStartJob(device);
+}
+
+// returns false if the bus is not configured or its queue is full
+bool i2cSubmit(I2CDevice device, i2cJob_t *job) {
+    if (!i2cDeviceIsReady(device)) {
         return false;
     }
-    HAL_StatusTypeDef status;
-    if (reg_ == 0xFF)
-        status = HAL_I2C_Master_Receive(pHandle, addr_ << 1, buf, len, I2C_DEFAULT_TIMEOUT);
-    else
-        status = HAL_I2C_Mem_Read(pHandle, addr_ << 1, reg_, I2C_MEMADD_SIZE_8BIT, buf, len, I2C_DEFAULT_TIMEOUT);
-    if (status != HAL_OK)
-        return i2cHandleHardwareFailure(device);
-    return true;
+    i2cLock(device);
+    const bool queued = i2cQueuePush(&i2cQueue[device], job);
+    if (queued && i2cQueueHead(&i2cQueue[device]) == job) {
+        i2cStartJob(device);
+    }
+    i2cUnlock(device);
+    return queued;
 }
 
-void i2cInit(I2CDevice device) {
-    if (device == I2CINVALID) {
+void i2cCheckTimeout(I2CDevice device, timeUs_t currentTimeUs) {
+    if (!i2cDeviceIsReady(device)) {
         return;
     }
+    i2cLock(device);
+    if (i2cQueueTimedOut(&i2cQueue[device], currentTimeUs)) {
+        i2cHandleHardwareFailure(device);
+    }
+    i2cUnlock(device);
+}
+
+const i2cBusStats_t *i2cGetBusStats(I2CDevice device) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT) {
+        return NULL;
+    }
+    return &i2cQueue[device].stats;
+}
+
+// blocking transfer, waits behind the jobs already queued
+static bool i2cTransfer(I2CDevice device, i2cJob_t *job) {
+    if (!i2cSubmit(device, job)) {
+        return false;
+    }
+    while (i2cJobIsBusy(job)) {
+        // the stuck job may be one queued ahead of ours
+        i2cCheckTimeout(device, micros());
+    }
+    return job->status == I2C_JOB_DONE;
+}
+
+bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data) {
+    i2cJob_t job = { 0 };
+    i2cJobSetWrite(&job, addr_, reg_, data, len_);
+    return i2cTransfer(device, &job);
+}
+
+bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data) {
+    i2cJob_t job = { 0 };
+    i2cJobSetWriteByte(&job, addr_, reg_, data);
+    return i2cTransfer(device, &job);
+}
+
+bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t* buf) {
+    i2cJob_t job = { 0 };
+    i2cJobSetRead(&job, addr_, reg_, buf, len);
+    return i2cTransfer(device, &job);
+}
+
+// brings the peripheral and the pins back to a known state, the interrupt controller is not touched
+static void i2cResetPeripheral(I2CDevice device) {
     i2cDevice_t *pDev = &i2cDevice[device];
-    const i2cHardware_t *hardware = pDev->hardware;
-    if (!hardware) {
-        return;
+    I2C_HandleTypeDef *pHandle = &pDev->handle;
+    if (pHandle->Instance) {
+        HAL_I2C_DeInit(pHandle);
     }
-    IO_t scl = pDev->scl;
-    IO_t sda = pDev->sda;
-    IOInit(scl, OWNER_I2C_SCL, RESOURCE_INDEX(device));
-    IOInit(sda, OWNER_I2C_SDA, RESOURCE_INDEX(device));
-    // Enable RCC
-    RCC_ClockCmd(hardware->rcc, ENABLE);
-    i2cUnstick(scl, sda);
+    i2cUnstick(pDev->scl, pDev->sda);
     // Init pins
 #ifdef STM32F7
-    IOConfigGPIOAF(scl, pDev->pullUp ? IOCFG_I2C_PU : IOCFG_I2C, GPIO_AF4_I2C);
-    IOConfigGPIOAF(sda, pDev->pullUp ? IOCFG_I2C_PU : IOCFG_I2C, GPIO_AF4_I2C);
+    IOConfigGPIOAF(pDev->scl, pDev->pullUp ? IOCFG_I2C_PU : IOCFG_I2C, GPIO_AF4_I2C);
+    IOConfigGPIOAF(pDev->sda, pDev->pullUp ? IOCFG_I2C_PU : IOCFG_I2C, GPIO_AF4_I2C);
 #else
-    IOConfigGPIO(scl, IOCFG_AF_OD);
-    IOConfigGPIO(sda, IOCFG_AF_OD);
+    IOConfigGPIO(pDev->scl, IOCFG_AF_OD);
+    IOConfigGPIO(pDev->sda, IOCFG_AF_OD);
 #endif
     // Init I2C peripheral
-    I2C_HandleTypeDef *pHandle = &pDev->handle;
     memset(pHandle, 0, sizeof(*pHandle));
     pHandle->Instance = pDev->hardware->reg;
     /// TODO: HAL check if I2C timing is correct
@@ -238,6 +352,22 @@ void i2cInit(I2CDevice device) {
     HAL_I2C_Init(pHandle);
     // Enable the Analog I2C Filter
     HAL_I2CEx_ConfigAnalogFilter(pHandle, I2C_ANALOGFILTER_ENABLE);
+}
+
+void i2cInit(I2CDevice device) {
+    if (device == I2CINVALID) {
+        return;
+    }
+    i2cDevice_t *pDev = &i2cDevice[device];
+    const i2cHardware_t *hardware = pDev->hardware;
+    if (!hardware) {
+        return;
+    }
+    IOInit(pDev->scl, OWNER_I2C_SCL, RESOURCE_INDEX(device));
+    IOInit(pDev->sda, OWNER_I2C_SDA, RESOURCE_INDEX(device));
+    // Enable RCC
+    RCC_ClockCmd(hardware->rcc, ENABLE);
+    i2cResetPeripheral(device);
     // Setup interrupt handlers
     HAL_NVIC_SetPriority(hardware->er_irq, NVIC_PRIORITY_BASE(NVIC_PRIO_I2C_ER), NVIC_PRIORITY_SUB(NVIC_PRIO_I2C_ER));
     HAL_NVIC_EnableIRQ(hardware->er_irq);
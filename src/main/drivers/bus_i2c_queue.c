@@ -0,0 +1,132 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Transaction queue of an I2C bus.
+ *
+ *   Sensor drivers submit jobs and pick up the result in a later task
+ * invocation instead of spinning while the bytes are clocked out. The bus
+ * driver starts the job at the head of the queue, completes it from its
+ * interrupt handler and starts the next one from there. The jobs are owned
+ * by the submitter, the queue only holds pointers to them.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "drivers/bus_i2c_queue.h"
+
+void i2cJobSetRead(i2cJob_t *job, uint8_t addr, uint8_t reg, uint8_t *buffer, uint8_t len) {
+    job->addr = addr;
+    job->reg = reg;
+    job->data.buffer = buffer;
+    job->data.len = len;
+    job->data.read = true;
+}
+
+void i2cJobSetWrite(i2cJob_t *job, uint8_t addr, uint8_t reg, uint8_t *buffer, uint8_t len) {
+    job->addr = addr;
+    job->reg = reg;
+    job->data.buffer = buffer;
+    job->data.len = len;
+    job->data.read = false;
+}
+
+void i2cJobSetWriteByte(i2cJob_t *job, uint8_t addr, uint8_t reg, uint8_t data) {
+    job->scratch = data;
+    i2cJobSetWrite(job, addr, reg, &job->scratch, 1);
+}
+
+bool i2cJobIsBusy(const i2cJob_t *job) {
+    return job->status == I2C_JOB_QUEUED || job->status == I2C_JOB_ACTIVE;
+}
+
+void i2cQueueInit(i2cQueue_t *queue) {
+    memset(queue, 0, sizeof(*queue));
+}
+
+// returns false if the queue is full or the job is still in flight
+bool i2cQueuePush(i2cQueue_t *queue, i2cJob_t *job) {
+    if (queue->count == I2C_QUEUE_SIZE || i2cJobIsBusy(job)) {
+        queue->stats.rejected++;
+        return false;
+    }
+    job->status = I2C_JOB_QUEUED;
+    queue->jobs[(queue->head + queue->count) % I2C_QUEUE_SIZE] = job;
+    queue->count++;
+    queue->stats.depth = queue->count;
+    queue->stats.maxDepth = MAX(queue->stats.maxDepth, queue->count);
+    return true;
+}
+
+i2cJob_t *i2cQueueHead(const i2cQueue_t *queue) {
+    return queue->count ? queue->jobs[queue->head] : NULL;
+}
+
+// marks the head job as being on the bus, returns NULL if the queue is empty
+i2cJob_t *i2cQueueStart(i2cQueue_t *queue, timeUs_t currentTimeUs) {
+    i2cJob_t *job = i2cQueueHead(queue);
+    if (job && job->status == I2C_JOB_QUEUED) {
+        job->status = I2C_JOB_ACTIVE;
+        job->startedAtUs = currentTimeUs;
+    }
+    return job;
+}
+
+// finishes the head job and returns the next one to start, NULL if there is none
+i2cJob_t *i2cQueueComplete(i2cQueue_t *queue, i2cJobStatus_e status) {
+    i2cJob_t *job = i2cQueueHead(queue);
+    if (!job) {
+        return NULL;
+    }
+    queue->head = (queue->head + 1) % I2C_QUEUE_SIZE;
+    queue->count--;
+    queue->stats.depth = queue->count;
+    queue->stats.jobs++;
+    switch (status) {
+    case I2C_JOB_NAK:
+        queue->stats.naks++;
+        break;
+    case I2C_JOB_ERROR:
+        queue->stats.errors++;
+        break;
+    case I2C_JOB_TIMEOUT:
+        queue->stats.timeouts++;
+        break;
+    default:
+        break;
+    }
+    job->status = status;
+    if (job->callback) {
+        job->callback(job);
+    }
+    return i2cQueueHead(queue);
+}
+
+bool i2cQueueTimedOut(const i2cQueue_t *queue, timeUs_t currentTimeUs) {
+    const i2cJob_t *job = i2cQueueHead(queue);
+    return job && job->status == I2C_JOB_ACTIVE && cmpTimeUs(currentTimeUs, job->startedAtUs) > I2C_JOB_TIMEOUT_US;
+}
+
@@ -0,0 +1,91 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define I2C_QUEUE_SIZE      8
+#define I2C_REG_NONE        0xFF    // no register address is sent before the data
+#define I2C_JOB_TIMEOUT_US  2000    // a job active for longer than this means the bus is stuck
+
+typedef enum {
+    I2C_JOB_IDLE = 0,
+    I2C_JOB_QUEUED,
+    I2C_JOB_ACTIVE,
+    I2C_JOB_DONE,
+    I2C_JOB_NAK,        // address or data not acknowledged
+    I2C_JOB_ERROR,      // bus error, arbitration lost or overrun
+    I2C_JOB_TIMEOUT,    // bus stuck, the job was dropped and the bus recovered
+} i2cJobStatus_e;
+
+struct i2cJob_s;
+typedef void i2cJobCallbackFn(struct i2cJob_s *job);
+
+// data phase of a transaction, sent or received after the address and register
+typedef struct i2cSegment_s {
+    uint8_t *buffer;
+    uint8_t len;
+    bool read;
+} i2cSegment_t;
+
+// owned by the caller and must stay valid until the job is no longer busy
+typedef struct i2cJob_s {
+    uint8_t addr;                   // 7 bit address
+    uint8_t reg;                    // register address, I2C_REG_NONE for none
+    i2cSegment_t data;
+    uint8_t scratch;                // payload of single byte writes
+    i2cJobCallbackFn *callback;     // called on completion, from interrupt context on the interrupt driven buses
+    void *callbackArg;
+    volatile uint8_t status;        // i2cJobStatus_e
+    timeUs_t startedAtUs;
+} i2cJob_t;
+
+typedef struct i2cBusStats_s {
+    uint32_t jobs;          // completed, successful or not
+    uint32_t naks;
+    uint32_t errors;
+    uint32_t timeouts;
+    uint32_t rejected;      // queue full or job still busy
+    uint8_t depth;
+    uint8_t maxDepth;
+} i2cBusStats_t;
+
+typedef struct i2cQueue_s {
+    i2cJob_t *jobs[I2C_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    i2cBusStats_t stats;
+} i2cQueue_t;
+
+void i2cJobSetRead(i2cJob_t *job, uint8_t addr, uint8_t reg, uint8_t *buffer, uint8_t len);
+void i2cJobSetWrite(i2cJob_t *job, uint8_t addr, uint8_t reg, uint8_t *buffer, uint8_t len);
+void i2cJobSetWriteByte(i2cJob_t *job, uint8_t addr, uint8_t reg, uint8_t data);
+bool i2cJobIsBusy(const i2cJob_t *job);
+
+void i2cQueueInit(i2cQueue_t *queue);
+bool i2cQueuePush(i2cQueue_t *queue, i2cJob_t *job);
+i2cJob_t *i2cQueueHead(const i2cQueue_t *queue);
+i2cJob_t *i2cQueueStart(i2cQueue_t *queue, timeUs_t currentTimeUs);
+i2cJob_t *i2cQueueComplete(i2cQueue_t *queue, i2cJobStatus_e status);
+bool i2cQueueTimedOut(const i2cQueue_t *queue, timeUs_t currentTimeUs);
@@ -51,6 +51,7 @@
 static void i2c_er_handler(I2CDevice device);
 static void i2c_ev_handler(I2CDevice device);
 static void i2cUnstick(IO_t scl, IO_t sda);
+static void i2cResetPeripheral(I2CDevice device);
 
 #ifdef STM32F4
 #define IOCFG_I2C_PU IO_CONFIG(GPIO_Mode_AF, 0, GPIO_OType_OD, GPIO_PuPd_UP)
@@ -153,85 +154,145 @@ void I2C3_EV_IRQHandler(void) {
 }
 #endif
 
-static bool i2cHandleHardwareFailure(I2CDevice device) {
+static i2cQueue_t i2cQueue[I2CDEV_COUNT];
+
+// keeps the event and error handlers out while the queue is changed from task context
+static void i2cLock(I2CDevice device) {
+    NVIC_DisableIRQ(i2cDevice[device].hardware->ev_irq);
+    NVIC_DisableIRQ(i2cDevice[device].hardware->er_irq);
+}
+
+static void i2cUnlock(I2CDevice device) {
+    NVIC_EnableIRQ(i2cDevice[device].hardware->ev_irq);
+    NVIC_EnableIRQ(i2cDevice[device].hardware->er_irq);
+}
+
+static void i2cStartJob(I2CDevice device);
+
+// drops the job that got stuck, resets the peripheral + clocks out garbage and carries on with the queue,
+// called with the bus locked so the interrupts are left alone
+static void i2cHandleHardwareFailure(I2CDevice device) {
     i2cErrorCount++;
-    // reinit peripheral + clock out garbage
-    i2cInit(device);
-    return false;
+    i2cQueueComplete(&i2cQueue[device], I2C_JOB_TIMEOUT);
+    i2cResetPeripheral(device);
+    i2cStartJob(device);
 }
 
-bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data) {
-    if (device == I2CINVALID || device > I2CDEV_COUNT) {
-        return false;
+// loads the job at the head of the queue into the interrupt state machine
+static void i2cStartJob(I2CDevice device) {
+    i2cJob_t *job = i2cQueueStart(&i2cQueue[device], micros());
+    if (!job) {
+        return;
     }
     I2C_TypeDef *I2Cx = i2cDevice[device].reg;
-    if (!I2Cx) {
-        return false;
-    }
     i2cState_t *state = &i2cDevice[device].state;
     uint32_t timeout = I2C_DEFAULT_TIMEOUT;
-    state->addr = addr_ << 1;
-    state->reg = reg_;
-    state->writing = 1;
-    state->reading = 0;
-    state->write_p = data;
-    state->read_p = data;
-    state->bytes = len_;
+    state->addr = job->addr << 1;
+    state->reg = job->reg;
+    state->writing = !job->data.read;
+    state->reading = job->data.read;
+    state->write_p = job->data.buffer;
+    state->read_p = job->data.buffer;
+    state->bytes = job->data.len;
     state->busy = 1;
     state->error = false;
     if (!(I2Cx->CR2 & I2C_IT_EVT)) {                                    // if we are restarting the driver
         if (!(I2Cx->CR1 & I2C_CR1_START)) {                             // ensure sending a start
             while (I2Cx->CR1 & I2C_CR1_STOP && --timeout > 0) {; }     // wait for any stop to finish sending
-            if (timeout == 0)
-                return i2cHandleHardwareFailure(device);
+            if (timeout == 0) {
+                // left for i2cCheckTimeout, recovering from here would recurse
+                return;
+            }
             I2C_GenerateSTART(I2Cx, ENABLE);                            // send the start for the new job
         }
         I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, ENABLE);            // allow the interrupts to fire off again
     }
-    timeout = I2C_DEFAULT_TIMEOUT;
-    while (state->busy && --timeout > 0) {; }
-    if (timeout == 0)
-        return i2cHandleHardwareFailure(device);
-    return !(state->error);
 }
 
-bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data) {
-    return i2cWriteBuffer(device, addr_, reg_, 1, &data);
+// called from the event and error handlers when the job on the bus has finished
+static void i2cJobComplete(I2CDevice device, i2cJobStatus_e status) {
+    const i2cJob_t *job = i2cQueueHead(&i2cQueue[device]);
+    i2cDevice[device].state.busy = 0;
+    if (!job || job->status != I2C_JOB_ACTIVE) {
+        // a late error interrupt after the job was already finished
+        return;
+    }
+    if (i2cQueueComplete(&i2cQueue[device], status)) {
+        i2cStartJob(device);
+    }
 }
 
-bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t* buf) {
-    if (device == I2CINVALID || device > I2CDEV_COUNT) {
+// returns false if the bus is not configured or its queue is full
+bool i2cSubmit(I2CDevice device, i2cJob_t *job) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT || !i2cDevice[device].reg) {
         return false;
     }
-    I2C_TypeDef *I2Cx = i2cDevice[device].reg;
-    if (!I2Cx) {
+    i2cLock(device);
+    const bool queued = i2cQueuePush(&i2cQueue[device], job);
+    if (queued && i2cQueueHead(&i2cQueue[device]) == job) {
+        i2cStartJob(device);
+    }
+    i2cUnlock(device);
+    return queued;
+}
+
+void i2cCheckTimeout(I2CDevice device, timeUs_t currentTimeUs) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT || !i2cDevice[device].reg) {
+        return;
+    }
+    i2cLock(device);
+    if (i2cQueueTimedOut(&i2cQueue[device], currentTimeUs)) {
+        i2cHandleHardwareFailure(device);
+    }
+    i2cUnlock(device);
+}
+
+const i2cBusStats_t *i2cGetBusStats(I2CDevice device) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT) {
+        return NULL;
+    }
+    return &i2cQueue[device].stats;
+}
+
+// blocking transfer, waits behind the jobs already queued
+static bool i2cTransfer(I2CDevice device, i2cJob_t *job) {
+    if (device == I2CINVALID || device >= I2CDEV_COUNT || !i2cDevice[device].reg) {
         return false;
     }
-    i2cState_t *state = &i2cDevice[device].state;
-    uint32_t timeout = I2C_DEFAULT_TIMEOUT;
-    state->addr = addr_ << 1;
-    state->reg = reg_;
-    state->writing = 0;
-    state->reading = 1;
-    state->read_p = buf;
-    state->write_p = buf;
-    state->bytes = len;
-    state->busy = 1;
-    state->error = false;
-    if (!(I2Cx->CR2 & I2C_IT_EVT)) {                                    // if we are restarting the driver
-        if (!(I2Cx->CR1 & I2C_CR1_START)) {                             // ensure sending a start
-            while (I2Cx->CR1 & I2C_CR1_STOP && --timeout > 0) {; }     // wait for any stop to finish sending
-            if (timeout == 0)
-                return i2cHandleHardwareFailure(device);
-            I2C_GenerateSTART(I2Cx, ENABLE);                            // send the start for the new job
+    uint32_t timeout = I2C_DEFAULT_TIMEOUT * (i2cQueue[device].count + 1);
+    if (!i2cSubmit(device, job)) {
+        return false;
+    }
+    while (i2cJobIsBusy(job)) {
+        if (--timeout == 0) {
+            // the stuck job may be one queued ahead of ours
+            i2cLock(device);
+            if (i2cJobIsBusy(job)) {
+                i2cHandleHardwareFailure(device);
+            }
+            i2cUnlock(device);
+            timeout = I2C_DEFAULT_TIMEOUT;
         }
-        I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, ENABLE);            // allow the interrupts to fire off again
     }
-    timeout = I2C_DEFAULT_TIMEOUT;
-    while (state->busy && --timeout > 0) {; }
-    if (timeout == 0)
-        return i2cHandleHardwareFailure(device);
-    return !(state->error);
+    return job->status == I2C_JOB_DONE;
+}
+
+bool i2cWriteBuffer(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len_, uint8_t *data) {
+    i2cJob_t job = { 0 };
+    i2cJobSetWrite(&job, addr_, reg_, data, len_);
+    return i2cTransfer(device, &job);
+}
+
+bool i2cWrite(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t data) {
+    i2cJob_t job = { 0 };
+    i2cJobSetWriteByte(&job, addr_, reg_, data);
+    return i2cTransfer(device, &job);
+}
+
+bool i2cRead(I2CDevice device, uint8_t addr_, uint8_t reg_, uint8_t len, uint8_t* buf) {
+    i2cJob_t job = { 0 };
+    i2cJobSetRead(&job, addr_, reg_, buf, len);
+    return i2cTransfer(device, &job);
 }
 
 static void i2c_er_handler(I2CDevice device) {
@@ -250,7 +311,7 @@ static void i2c_er_handler(I2CDevice device) {
                 while (I2Cx->CR1 & I2C_CR1_START) {; }                         // wait for any start to finish sending
                 I2C_GenerateSTOP(I2Cx, ENABLE);                                 // send stop to finalise bus transaction
                 while (I2Cx->CR1 & I2C_CR1_STOP) {; }                          // wait for stop to finish sending
-                i2cInit(device);                                                // reset and configure the hardware
+                i2cResetPeripheral(device);                                     // reset and configure the hardware
             } else {
                 I2C_GenerateSTOP(I2Cx, ENABLE);                                 // stop to free up the bus
                 I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, DISABLE);           // Disable EVT and ERR interrupts while bus inactive
@@ -258,7 +319,7 @@ static void i2c_er_handler(I2CDevice device) {
         }
     }
     I2Cx->SR1 &= ~(I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR);     // reset all the error bits to clear the interrupt
-    state->busy = 0;
+    i2cJobComplete(device, (SR1Register & I2C_SR1_AF) ? I2C_JOB_NAK : state->error ? I2C_JOB_ERROR : I2C_JOB_DONE);
 }
 
 void i2c_ev_handler(I2CDevice device) {
@@ -357,37 +418,25 @@ void i2c_ev_handler(I2CDevice device) {
         subaddress_sent = 0;                                            // reset this here
         if (final_stop)                                                 // If there is a final stop and no more jobs, bus is inactive, disable interrupts to prevent BTF
             I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, DISABLE);       // Disable EVT and ERR interrupts while bus inactive
-        state->busy = 0;
+        i2cJobComplete(device, state->error ? I2C_JOB_ERROR : I2C_JOB_DONE);
     }
 }
 
-void i2cInit(I2CDevice device) {
-    if (device == I2CINVALID)
-        return;
+// brings the peripheral and the pins back to a known state, the interrupt controller is not touched
+static void i2cResetPeripheral(I2CDevice device) {
     i2cDevice_t *pDev = &i2cDevice[device];
-    const i2cHardware_t *hw = pDev->hardware;
-    if (!hw) {
-        return;
-    }
-    I2C_TypeDef *I2Cx = hw->reg;
-    memset(&pDev->state, 0, sizeof(pDev->state));
-    NVIC_InitTypeDef nvic;
+    I2C_TypeDef *I2Cx = pDev->hardware->reg;
     I2C_InitTypeDef i2cInit;
-    IO_t scl = pDev->scl;
-    IO_t sda = pDev->sda;
-    IOInit(scl, OWNER_I2C_SCL, RESOURCE_INDEX(device));
-    IOInit(sda, OWNER_I2C_SDA, RESOURCE_INDEX(device));
-    // Enable RCC
-    RCC_ClockCmd(hw->rcc, ENABLE);
+    memset(&pDev->state, 0, sizeof(pDev->state));
     I2C_ITConfig(I2Cx, I2C_IT_EVT | I2C_IT_ERR, DISABLE);
-    i2cUnstick(scl, sda);
+    i2cUnstick(pDev->scl, pDev->sda);
     // Init pins
 #ifdef STM32F4
-    IOConfigGPIOAF(scl, pDev->pullUp ? IOCFG_I2C_PU : IOCFG_I2C, pDev->sclAF);
-    IOConfigGPIOAF(sda, pDev->pullUp ? IOCFG_I2C_PU : IOCFG_I2C, pDev->sdaAF);
+    IOConfigGPIOAF(pDev->scl, pDev->pullUp ? IOCFG_I2C_PU : IOCFG_I2C, pDev->sclAF);
+    IOConfigGPIOAF(pDev->sda, pDev->pullUp ? IOCFG_I2C_PU : IOCFG_I2C, pDev->sdaAF);
 #else
-    IOConfigGPIO(scl, IOCFG_I2C);
-    IOConfigGPIO(sda, IOCFG_I2C);
+    IOConfigGPIO(pDev->scl, IOCFG_I2C);
+    IOConfigGPIO(pDev->sda, IOCFG_I2C);
 #endif
     I2C_DeInit(I2Cx);
     I2C_StructInit(&i2cInit);
@@ -405,6 +454,22 @@ void i2cInit(I2CDevice device) {
     I2C_Cmd(I2Cx, ENABLE);
     I2C_Init(I2Cx, &i2cInit);
     I2C_StretchClockCmd(I2Cx, ENABLE);
+}
+
+void i2cInit(I2CDevice device) {
+    if (device == I2CINVALID)
+        return;
+    i2cDevice_t *pDev = &i2cDevice[device];
+    const i2cHardware_t *hw = pDev->hardware;
+    if (!hw) {
+        return;
+    }
+    NVIC_InitTypeDef nvic;
+    IOInit(pDev->scl, OWNER_I2C_SCL, RESOURCE_INDEX(device));
+    IOInit(pDev->sda, OWNER_I2C_SDA, RESOURCE_INDEX(device));
+    // Enable RCC
+    RCC_ClockCmd(hw->rcc, ENABLE);
+    i2cResetPeripheral(device);
     // I2C ER Interrupt
     nvic.NVIC_IRQChannel = hw->er_irq;
     nvic.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(NVIC_PRIO_I2C_ER);
@@ -190,17 +190,26 @@ static void hmc5883SpiInit(busDevice_t *busdev) {
 }
 #endif
 
+static i2cJob_t hmc5883lJob;
+static uint8_t hmc5883lBuf[6];
+
+// returns the sample read since the previous call and queues the next read, the compass task runs far slower than the read takes
 static bool hmc5883lRead(magDev_t *mag, int16_t *magData) {
-    uint8_t buf[6];
     busDevice_t *busdev = &mag->busdev;
-    bool ack = busReadRegisterBuffer(busdev, HMC58X3_REG_DATA, buf, 6);
-    if (!ack) {
+    if (busJobBusy(busdev, &hmc5883lJob)) {
         return false;
     }
-    magData[X] = (int16_t)(buf[0] << 8 | buf[1]);
-    magData[Z] = (int16_t)(buf[2] << 8 | buf[3]);
-    magData[Y] = (int16_t)(buf[4] << 8 | buf[5]);
-    return true;
+    const bool ack = hmc5883lJob.status == I2C_JOB_DONE;
+    if (ack) {
+        magData[X] = (int16_t)(hmc5883lBuf[0] << 8 | hmc5883lBuf[1]);
+        magData[Z] = (int16_t)(hmc5883lBuf[2] << 8 | hmc5883lBuf[3]);
+        magData[Y] = (int16_t)(hmc5883lBuf[4] << 8 | hmc5883lBuf[5]);
+    }
+    if (!busReadRegisterBufferStart(busdev, &hmc5883lJob, HMC58X3_REG_DATA, hmc5883lBuf, sizeof(hmc5883lBuf))) {
+        hmc5883lJob.status = I2C_JOB_ERROR;
+        return false;
+    }
+    return ack;
 }
 
 static bool hmc5883lInit(magDev_t *mag) {
@@ -0,0 +1,280 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * DShot on plain GPIO pins.
+ *
+ *   Instead of one timer channel and DMA stream per motor, the motor pins are
+ * grouped by GPIO port and each port gets one DMA stream that writes the
+ * port's BSRR buffer (see dshot_bitbang_buffer.c), paced by the compare DMA
+ * request of a timer channel running at three times the bit rate. The pacers
+ * are taken from the timer channels of any motor pin, so motors no longer
+ * need a usable DMA stream each and all motors of a port change in the same
+ * bus cycle. There is one DMA interrupt per port and frame. Only DMA2 can
+ * write the GPIO ports, so the pacers have to be TIM1 or TIM8 channels.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_DSHOT_BITBANG
+
+#include "drivers/dma.h"
+#include "drivers/dshot_bitbang.h"
+#include "drivers/dshot_bitbang_buffer.h"
+#include "drivers/io.h"
+#include "drivers/io_impl.h"
+#include "drivers/nvic.h"
+#include "drivers/rcc.h"
+#include "drivers/timer.h"
+
+typedef struct dshotBitbangPort_s {
+    GPIO_TypeDef *gpio;
+    const timerHardware_t *pacer;
+    dshotBitbangBuffer_t buffer;    // in DMA reachable RAM, not FAST_RAM
+} dshotBitbangPort_t;
+
+typedef struct dshotBitbangMotor_s {
+    uint8_t port;
+    uint16_t pin;
+} dshotBitbangMotor_t;
+
+FAST_RAM_ZERO_INIT bool useDshotBitbang;
+
+static dshotBitbangPort_t bbPorts[DSHOT_BITBANG_MAX_PORTS];
+static FAST_RAM_ZERO_INIT uint8_t bbPortCount;
+static FAST_RAM_ZERO_INIT dshotBitbangMotor_t bbMotors[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT TIM_TypeDef *bbTimers[DSHOT_BITBANG_MAX_PORTS];
+static FAST_RAM_ZERO_INIT uint8_t bbTimerCount;
+
+static int dshotBitbangFindPort(GPIO_TypeDef *gpio) {
+    for (int i = 0; i < bbPortCount; i++) {
+        if (bbPorts[i].gpio == gpio) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool dshotBitbangPacerIsUsed(const timerHardware_t *timerHardware) {
+    for (int i = 0; i < bbPortCount; i++) {
+        if (bbPorts[i].pacer && bbPorts[i].pacer->dmaRef == timerHardware->dmaRef) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// only DMA2 has a path to the GPIO ports on the AHB1 bus, the DMA1 peripheral port sits on APB1
+static bool dshotBitbangDmaReachesGpio(const timerHardware_t *timerHardware) {
+    return (uint32_t)timerHardware->dmaRef >= (uint32_t)DMA2_Stream0;
+}
+
+static bool dshotBitbangIsMotorPin(ioTag_t tag, const motorDevConfig_t *motorConfig, uint8_t motorCount) {
+    for (int i = 0; i < motorCount; i++) {
+        if (motorConfig->ioTags[i] == tag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The pacer reprograms the time base of its timer, so no channel of that timer may be
+// in use by anything other than the motors: neither claimed already nor set aside for
+// PPM, PWM input, servos, LED strip, transponder or beeper by the target.
+static bool dshotBitbangTimerIsShared(const TIM_TypeDef *tim, const motorDevConfig_t *motorConfig, uint8_t motorCount) {
+    for (int i = 0; i < (int)USABLE_TIMER_CHANNEL_COUNT; i++) {
+        const timerHardware_t *timHw = &timerHardware[i];
+        if (timHw->tim != tim || dshotBitbangIsMotorPin(timHw->tag, motorConfig, motorCount)) {
+            continue;
+        }
+        if ((timHw->usageFlags & ~TIM_USE_MOTOR) || IOGetOwner(IOGetByTag(timHw->tag)) != OWNER_FREE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// any motor timer channel with a free DMA2 stream on an otherwise unused timer can pace any port
+static const timerHardware_t *dshotBitbangFindPacer(const motorDevConfig_t *motorConfig, uint8_t motorCount) {
+    for (int i = 0; i < motorCount; i++) {
+        const timerHardware_t *timerHardware = timerGetByTag(motorConfig->ioTags[i]);
+        if (timerHardware && timerHardware->dmaRef && dshotBitbangDmaReachesGpio(timerHardware) && !(timerHardware->output & TIMER_OUTPUT_N_CHANNEL)
+            && dmaGetOwner(timerHardware->dmaIrqHandler) == OWNER_FREE && !dshotBitbangPacerIsUsed(timerHardware)
+            && !dshotBitbangTimerIsShared(timerHardware->tim, motorConfig, motorCount)) {
+            return timerHardware;
+        }
+    }
+    return NULL;
+}
+
+static void dshotBitbangDmaIrqHandler(dmaChannelDescriptor_t *descriptor) {
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        const timerHardware_t *pacer = bbPorts[descriptor->userParam].pacer;
+        DMA_Cmd(pacer->dmaRef, DISABLE);
+        TIM_DMACmd(pacer->tim, timerDmaSource(pacer->channel), DISABLE);
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+    }
+}
+
+static void dshotBitbangConfigureTimer(TIM_TypeDef *timer, uint32_t bitRateHz) {
+    for (int i = 0; i < bbTimerCount; i++) {
+        if (bbTimers[i] == timer) {
+            return;
+        }
+    }
+    bbTimers[bbTimerCount++] = timer;
+    RCC_ClockCmd(timerRCC(timer), ENABLE);
+    TIM_Cmd(timer, DISABLE);
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+    TIM_TimeBaseStructure.TIM_Prescaler = 0;
+    TIM_TimeBaseStructure.TIM_Period = lrintf((float)timerClock(timer) / (bitRateHz * DSHOT_BITBANG_PHASES)) - 1;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInit(timer, &TIM_TimeBaseStructure);
+    TIM_ARRPreloadConfig(timer, ENABLE);
+    TIM_Cmd(timer, ENABLE);
+}
+
+static void dshotBitbangConfigurePort(uint8_t portIndex, uint32_t bitRateHz) {
+    dshotBitbangPort_t *port = &bbPorts[portIndex];
+    const timerHardware_t *pacer = port->pacer;
+    dshotBitbangConfigureTimer(pacer->tim, bitRateHz);
+
+    // the channel only raises a DMA request once per slot, its pin is not connected
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;
+    TIM_OCInitStructure.TIM_Pulse = 0;
+    timerOCInit(pacer->tim, pacer->channel, &TIM_OCInitStructure);
+
+    dmaInit(pacer->dmaIrqHandler, OWNER_MOTOR, RESOURCE_INDEX(portIndex));
+    dmaSetHandler(pacer->dmaIrqHandler, dshotBitbangDmaIrqHandler, NVIC_BUILD_PRIORITY(1, 2), portIndex);
+    DMA_Cmd(pacer->dmaRef, DISABLE);
+    DMA_DeInit(pacer->dmaRef);
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_InitStructure.DMA_Channel = pacer->dmaChannel;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&port->gpio->BSRRL;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)port->buffer.words;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStructure.DMA_BufferSize = DSHOT_BITBANG_BUFFER_LEN;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_1QuarterFull;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(pacer->dmaRef, &DMA_InitStructure);
+    DMA_ITConfig(pacer->dmaRef, DMA_IT_TC, ENABLE);
+}
+
+// returns false, leaving the pins untouched, if a port has no pacer, the timer based DShot output is used then
+bool dshotBitbangInit(const motorDevConfig_t *motorConfig, uint8_t motorCount) {
+    bbPortCount = 0;
+    bbTimerCount = 0;
+    for (int i = 0; i < motorCount; i++) {
+        const IO_t io = IOGetByTag(motorConfig->ioTags[i]);
+        if (!io || IOGetOwner(io) != OWNER_FREE) {
+            return false;
+        }
+        int port = dshotBitbangFindPort(IO_GPIO(io));
+        if (port < 0) {
+            if (bbPortCount == DSHOT_BITBANG_MAX_PORTS) {
+                return false;
+            }
+            port = bbPortCount;
+            bbPorts[port].gpio = IO_GPIO(io);
+            bbPorts[port].pacer = NULL;
+            dshotBitbangBufferInit(&bbPorts[port].buffer, motorConfig->motorPwmInversion);
+            bbPortCount++;
+        }
+        dshotBitbangBufferAddPin(&bbPorts[port].buffer, IO_Pin(io));
+        bbMotors[i].port = port;
+        bbMotors[i].pin = IO_Pin(io);
+    }
+    for (int i = 0; i < bbPortCount; i++) {
+        bbPorts[i].pacer = dshotBitbangFindPacer(motorConfig, motorCount);
+        if (!bbPorts[i].pacer) {
+            return false;
+        }
+    }
+
+    // claim the pins before anything touches them, motorDevInit() claims them again for the same owner
+    for (int i = 0; i < motorCount; i++) {
+        IOInit(IOGetByTag(motorConfig->ioTags[i]), OWNER_MOTOR, RESOURCE_INDEX(i));
+    }
+    const uint32_t bitRateHz = getDshotHz(motorConfig->motorPwmProtocol) / (MOTOR_BITLENGTH + 1);
+    for (int i = 0; i < bbPortCount; i++) {
+        dshotBitbangConfigurePort(i, bitRateHz);
+        dshotBitbangBufferClear(&bbPorts[i].buffer);
+    }
+    for (int i = 0; i < motorCount; i++) {
+        const IO_t io = IOGetByTag(motorConfig->ioTags[i]);
+        IOConfigGPIO(io, IO_CONFIG(GPIO_Mode_OUT, GPIO_Speed_50MHz, GPIO_OType_PP, GPIO_PuPd_NOPULL));
+        if (motorConfig->motorPwmInversion) {
+            IOHi(io);
+        } else {
+            IOLo(io);
+        }
+        getMotorDmaOutput(i)->configured = true;
+    }
+    return true;
+}
+
+FAST_CODE void dshotBitbangWritePacket(uint8_t index, uint16_t packet) {
+    const dshotBitbangMotor_t *motor = &bbMotors[index];
+    dshotBitbangBufferSetPacket(&bbPorts[motor->port].buffer, motor->pin, packet);
+}
+
+// the motor gets no frame in this update, the packet it had would otherwise go out again
+FAST_CODE void dshotBitbangSkipPacket(uint8_t index) {
+    const dshotBitbangMotor_t *motor = &bbMotors[index];
+    dshotBitbangBufferSetIdle(&bbPorts[motor->port].buffer, motor->pin);
+}
+
+// sends the frames of all ports, the packets stay in the buffers until they are overwritten
+FAST_CODE void dshotBitbangUpdateComplete(void) {
+    for (int i = 0; i < bbTimerCount; i++) {
+        TIM_SetCounter(bbTimers[i], 0);
+    }
+    for (int i = 0; i < bbPortCount; i++) {
+        const timerHardware_t *pacer = bbPorts[i].pacer;
+        DMA_SetCurrDataCounter(pacer->dmaRef, DSHOT_BITBANG_BUFFER_LEN);
+        DMA_Cmd(pacer->dmaRef, ENABLE);
+        TIM_DMACmd(pacer->tim, timerDmaSource(pacer->channel), ENABLE);
+    }
+}
+
+uint8_t dshotBitbangPortCount(void) {
+    return bbPortCount;
+}
+
+#endif
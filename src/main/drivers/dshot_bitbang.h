@@ -0,0 +1,36 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "drivers/pwm_output.h"
+
+#define DSHOT_BITBANG_MAX_PORTS 6
+
+extern bool useDshotBitbang;
+
+bool dshotBitbangInit(const motorDevConfig_t *motorConfig, uint8_t motorCount);
+void dshotBitbangWritePacket(uint8_t index, uint16_t packet);
+void dshotBitbangSkipPacket(uint8_t index);
+void dshotBitbangUpdateComplete(void);
+uint8_t dshotBitbangPortCount(void);
@@ -0,0 +1,94 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * BSRR buffer for DShot on all motor pins of a GPIO port at once.
+ *
+ *   Each bit is three slots. The first slot starts the pulse on every motor
+ * pin, the second ends it on the pins that send a 0 and the third ends it on
+ * all pins, so a 0 is high for a third of the bit and a 1 for two thirds.
+ * The low half of a BSRR word sets pins and the high half resets them, so one
+ * word per slot drives every pin of the port and pins outside pinMask are
+ * never touched.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "drivers/dshot_bitbang_buffer.h"
+
+static uint32_t pulseStart(const dshotBitbangBuffer_t *buffer, uint16_t pins) {
+    return buffer->inverted ? (uint32_t)pins << 16 : pins;
+}
+
+static uint32_t pulseEnd(const dshotBitbangBuffer_t *buffer, uint16_t pins) {
+    return buffer->inverted ? pins : (uint32_t)pins << 16;
+}
+
+void dshotBitbangBufferInit(dshotBitbangBuffer_t *buffer, bool inverted) {
+    memset(buffer, 0, sizeof(*buffer));
+    buffer->inverted = inverted;
+}
+
+void dshotBitbangBufferAddPin(dshotBitbangBuffer_t *buffer, uint16_t pin) {
+    buffer->pinMask |= pin;
+}
+
+// every pin sends all 0 bits until its first packet is set
+FAST_CODE void dshotBitbangBufferClear(dshotBitbangBuffer_t *buffer) {
+    const uint32_t start = pulseStart(buffer, buffer->pinMask);
+    const uint32_t end = pulseEnd(buffer, buffer->pinMask);
+    uint32_t *word = buffer->words;
+    for (int bit = 0; bit < DSHOT_BITBANG_BITS; bit++) {
+        *word++ = start;
+        *word++ = end;
+        *word++ = end;
+    }
+}
+
+// ends the pulse of the pin in the second slot for 0 bits and holds it through for 1 bits, MSB first
+FAST_CODE void dshotBitbangBufferSetPacket(dshotBitbangBuffer_t *buffer, uint16_t pin, uint16_t packet) {
+    const uint32_t start = pulseStart(buffer, pin);
+    const uint32_t end = pulseEnd(buffer, pin);
+    uint32_t *word = buffer->words;
+    for (int bit = 0; bit < DSHOT_BITBANG_BITS; bit++) {
+        word[0] |= start;
+        if (packet & 0x8000) {
+            word[1] &= ~end;
+        } else {
+            word[1] |= end;
+        }
+        packet <<= 1;
+        word += DSHOT_BITBANG_PHASES;
+    }
+}
+
+// no pulse starts on the pin, it stays at idle level until its next packet is set
+FAST_CODE void dshotBitbangBufferSetIdle(dshotBitbangBuffer_t *buffer, uint16_t pin) {
+    const uint32_t start = pulseStart(buffer, pin);
+    uint32_t *word = buffer->words;
+    for (int bit = 0; bit < DSHOT_BITBANG_BITS; bit++) {
+        *word &= ~start;
+        word += DSHOT_BITBANG_PHASES;
+    }
+}
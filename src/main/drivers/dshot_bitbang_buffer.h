@@ -0,0 +1,41 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DSHOT_BITBANG_PHASES        3   // slots per bit, a 0 is high for one slot and a 1 for two
+#define DSHOT_BITBANG_BITS          16
+#define DSHOT_BITBANG_BUFFER_LEN    (DSHOT_BITBANG_BITS * DSHOT_BITBANG_PHASES)
+
+// BSRR words for one GPIO port, written one per slot by the port's DMA stream
+typedef struct dshotBitbangBuffer_s {
+    uint16_t pinMask;       // motor pins on the port
+    bool inverted;          // pulses are low going
+    uint32_t words[DSHOT_BITBANG_BUFFER_LEN];
+} dshotBitbangBuffer_t;
+
+void dshotBitbangBufferInit(dshotBitbangBuffer_t *buffer, bool inverted);
+void dshotBitbangBufferAddPin(dshotBitbangBuffer_t *buffer, uint16_t pin);
+void dshotBitbangBufferClear(dshotBitbangBuffer_t *buffer);
+void dshotBitbangBufferSetPacket(dshotBitbangBuffer_t *buffer, uint16_t pin, uint16_t packet);
+void dshotBitbangBufferSetIdle(dshotBitbangBuffer_t *buffer, uint16_t pin);
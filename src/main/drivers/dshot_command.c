@@ -0,0 +1,235 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * DShot special commands.
+ *
+ *   Every motor has its own short queue of commands, so a spin direction
+ * change on one motor and a beacon on another run side by side. Commands
+ * are put on the wire by the normal motor update: a motor with nothing
+ * queued keeps getting the mixer output, a motor running a command gets
+ * the command frames, held at stop before and after them, and no frame at
+ * all between repeats so the ESC sees the repeats back to back.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/time.h"
+
+#include "drivers/dshot_command.h"
+
+#define DSHOT_INITIAL_DELAY_US 10000
+#define DSHOT_COMMAND_DELAY_US 1000
+#define DSHOT_BEEP_DELAY_US 100000
+
+typedef enum {
+    DSHOT_COMMAND_STATE_IDLE = 0,   // nothing queued
+    DSHOT_COMMAND_STATE_WAIT_IDLE,  // waiting for the motor to stop
+    DSHOT_COMMAND_STATE_DELAY,      // motor held at stop before the command
+    DSHOT_COMMAND_STATE_SENDING,    // command frames, one per DSHOT_COMMAND_DELAY_US
+    DSHOT_COMMAND_STATE_AFTER,      // motor held at stop after the command
+} dshotCommandState_e;
+
+typedef struct dshotCommandMotor_s {
+    uint8_t queue[DSHOT_COMMAND_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    uint8_t state;
+    uint8_t repeats;        // frames of the head command still to send
+    bool sendNext;          // the next update carries the command
+    bool sent;              // the current update carried the command
+    bool idle;              // the mixer asked for stop in the last update
+    bool idleWhenQueued;    // no need to wait for idle, e.g. the motors are armed right after queueing
+    timeUs_t nextAtUs;
+} dshotCommandMotor_t;
+
+static dshotCommandMotor_t dshotCommandMotors[MAX_SUPPORTED_MOTORS];
+static uint16_t dshotCommandActiveMask;
+
+static uint8_t dshotCommandRepeats(uint8_t command) {
+    switch (command) {
+    case DSHOT_CMD_SPIN_DIRECTION_1:
+    case DSHOT_CMD_SPIN_DIRECTION_2:
+    case DSHOT_CMD_3D_MODE_OFF:
+    case DSHOT_CMD_3D_MODE_ON:
+    case DSHOT_CMD_SAVE_SETTINGS:
+    case DSHOT_CMD_SPIN_DIRECTION_NORMAL:
+    case DSHOT_CMD_SPIN_DIRECTION_REVERSED:
+        return 10;
+    default:
+        return 1;
+    }
+}
+
+static timeUs_t dshotCommandDelayAfter(uint8_t command) {
+    switch (command) {
+    case DSHOT_CMD_BEACON1:
+    case DSHOT_CMD_BEACON2:
+    case DSHOT_CMD_BEACON3:
+    case DSHOT_CMD_BEACON4:
+    case DSHOT_CMD_BEACON5:
+        return DSHOT_BEEP_DELAY_US;
+    default:
+        return DSHOT_COMMAND_DELAY_US;
+    }
+}
+
+static uint8_t dshotCommandHead(const dshotCommandMotor_t *motor) {
+    return motor->queue[motor->head];
+}
+
+static void dshotCommandStart(dshotCommandMotor_t *motor, dshotCommandState_e state, timeUs_t nextAtUs) {
+    motor->state = state;
+    motor->repeats = dshotCommandRepeats(dshotCommandHead(motor));
+    motor->sendNext = false;
+    motor->sent = false;
+    motor->nextAtUs = nextAtUs;
+}
+
+void dshotCommandInit(void) {
+    memset(dshotCommandMotors, 0, sizeof(dshotCommandMotors));
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        dshotCommandMotors[i].idle = true;
+    }
+    dshotCommandActiveMask = 0;
+}
+
+// the same command still waiting behind the head would only play twice
+static bool dshotCommandIsPending(const dshotCommandMotor_t *motor, uint8_t command) {
+    return motor->count > 1 && motor->queue[(motor->head + motor->count - 1) % DSHOT_COMMAND_QUEUE_SIZE] == command;
+}
+
+static void dshotCommandPush(uint8_t index, uint8_t command) {
+    dshotCommandMotor_t *motor = &dshotCommandMotors[index];
+    if (dshotCommandIsPending(motor, command)) {
+        return;
+    }
+    motor->queue[(motor->head + motor->count) % DSHOT_COMMAND_QUEUE_SIZE] = command;
+    if (motor->count++ == 0) {
+        // the delay starts on the next update, the time is not known here
+        dshotCommandStart(motor, DSHOT_COMMAND_STATE_WAIT_IDLE, 0);
+        motor->idleWhenQueued = motor->idle;
+        dshotCommandActiveMask |= 1 << index;
+    }
+}
+
+// queues the command for one motor or ALL_MOTORS, returns false if a queue is full
+bool dshotCommandWrite(uint8_t index, uint8_t motorCount, uint8_t command) {
+    if (command > DSHOT_MAX_COMMAND || motorCount > MAX_SUPPORTED_MOTORS || (index != ALL_MOTORS && index >= motorCount)) {
+        return false;
+    }
+    for (int i = 0; i < motorCount; i++) {
+        if ((index == i || index == ALL_MOTORS) && dshotCommandMotors[i].count == DSHOT_COMMAND_QUEUE_SIZE && !dshotCommandIsPending(&dshotCommandMotors[i], command)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < motorCount; i++) {
+        if (index == i || index == ALL_MOTORS) {
+            dshotCommandPush(i, command);
+        }
+    }
+    return true;
+}
+
+bool dshotCommandIsQueued(void) {
+    return dshotCommandActiveMask;
+}
+
+bool dshotCommandIsQueuedFor(uint8_t index) {
+    return dshotCommandActiveMask & (1 << index);
+}
+
+// returns the value to send for the motor, DSHOT_COMMAND_SKIP_FRAME if it gets no frame
+FAST_CODE int dshotCommandApply(uint8_t index, uint16_t value) {
+    dshotCommandMotor_t *motor = &dshotCommandMotors[index];
+    motor->idle = value == DSHOT_CMD_MOTOR_STOP;
+    switch (motor->state) {
+    case DSHOT_COMMAND_STATE_DELAY:
+    case DSHOT_COMMAND_STATE_AFTER:
+        return DSHOT_CMD_MOTOR_STOP;
+    case DSHOT_COMMAND_STATE_SENDING:
+        if (motor->sendNext) {
+            motor->sent = true;
+            return dshotCommandHead(motor);
+        }
+        return DSHOT_COMMAND_SKIP_FRAME;
+    default:
+        return value;
+    }
+}
+
+static void dshotCommandPop(uint8_t index, timeUs_t currentTimeUs) {
+    dshotCommandMotor_t *motor = &dshotCommandMotors[index];
+    motor->head = (motor->head + 1) % DSHOT_COMMAND_QUEUE_SIZE;
+    if (--motor->count) {
+        // the motor is still held at stop, the next command only needs the short gap
+        dshotCommandStart(motor, DSHOT_COMMAND_STATE_DELAY, currentTimeUs + DSHOT_COMMAND_DELAY_US);
+    } else {
+        motor->state = DSHOT_COMMAND_STATE_IDLE;
+        dshotCommandActiveMask &= ~(1 << index);
+    }
+}
+
+// advances the command sequences, called once per motor update after all motors were written
+FAST_CODE void dshotCommandUpdate(timeUs_t currentTimeUs) {
+    for (int i = 0; dshotCommandActiveMask >> i; i++) {
+        dshotCommandMotor_t *motor = &dshotCommandMotors[i];
+        const bool due = cmpTimeUs(currentTimeUs, motor->nextAtUs) >= 0;
+        switch (motor->state) {
+        case DSHOT_COMMAND_STATE_WAIT_IDLE:
+            if (motor->idle || motor->idleWhenQueued) {
+                motor->state = DSHOT_COMMAND_STATE_DELAY;
+                motor->nextAtUs = currentTimeUs + DSHOT_INITIAL_DELAY_US;
+            }
+            break;
+        case DSHOT_COMMAND_STATE_DELAY:
+            if (due) {
+                motor->state = DSHOT_COMMAND_STATE_SENDING;
+                motor->sendNext = true;
+            }
+            break;
+        case DSHOT_COMMAND_STATE_SENDING:
+            if (motor->sent) {
+                motor->sent = false;
+                motor->sendNext = false;
+                if (--motor->repeats) {
+                    motor->nextAtUs = currentTimeUs + DSHOT_COMMAND_DELAY_US;
+                } else {
+                    motor->state = DSHOT_COMMAND_STATE_AFTER;
+                    motor->nextAtUs = currentTimeUs + dshotCommandDelayAfter(dshotCommandHead(motor));
+                }
+            } else if (due) {
+                motor->sendNext = true;
+            }
+            break;
+        case DSHOT_COMMAND_STATE_AFTER:
+            if (due) {
+                dshotCommandPop(i, currentTimeUs);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Decoder for the eRPM reply of bidirectional DShot.
+ *
+ *   After each inverted command frame the ESC answers on the same wire with
+ * 21 bits: a start bit followed by 16 bits of data, GCR coded to 20 bits, where
+ * every 1 is a level change. The timer captures both edges of the reply, so
+ * the distance between two captures is the number of bits until the next 1.
+ * The data is eeem mmmm mmmm cccc, the electrical period in us is m << e and
+ * the checksum is the inverted xor of the nibbles.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/maths.h"
+
+#include "drivers/dshot_telemetry.h"
+
+#define DSHOT_TELEMETRY_BITS    21
+#define DSHOT_TELEMETRY_STOPPED 0x0fff  // longest period, the motor does not turn
+
+static const uint8_t gcrDecode[32] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 10, 11, 0, 13, 14, 15,
+    0, 0, 2, 3, 0, 5, 6, 7, 0, 0, 8, 1, 0, 4, 12, 0
+};
+
+// returns eRPM / 100, or DSHOT_TELEMETRY_INVALID for a missing or corrupt reply
+uint16_t dshotTelemetryDecode(const uint32_t *edges, uint8_t count, uint16_t bitTicks) {
+    if (count < 2) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+    uint32_t value = 0;
+    int bits = 0;
+    for (int i = 1; i <= count && bits < DSHOT_TELEMETRY_BITS; i++) {
+        int len;
+        if (i < count) {
+            // captures come from a 16 bit counter
+            const uint16_t ticks = edges[i] - edges[i - 1];
+            len = (ticks + bitTicks / 2) / bitTicks;
+            if (len == 0) {
+                return DSHOT_TELEMETRY_INVALID;
+            }
+            // the edge back to idle lands after the frame, it only lengthens the last run
+            len = MIN(len, DSHOT_TELEMETRY_BITS - bits);
+        } else {
+            // no edge ends the frame, the remaining bits are 0
+            len = DSHOT_TELEMETRY_BITS - bits;
+        }
+        value = (value << len) | (1 << (len - 1));
+        bits += len;
+    }
+
+    uint32_t decoded = 0;
+    for (int nibble = 3; nibble >= 0; nibble--) {
+        decoded = (decoded << 4) | gcrDecode[(value >> (nibble * 5)) & 0x1f];
+    }
+    uint32_t csum = decoded ^ (decoded >> 8);
+    csum ^= csum >> 4;
+    if ((csum & 0xf) != 0xf) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+    decoded >>= 4;
+    if (decoded == DSHOT_TELEMETRY_STOPPED) {
+        return 0;
+    }
+    const uint32_t periodUs = (decoded & 0x1ff) << (decoded >> 9);
+    if (!periodUs) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+    return (1000000 * 60 / 100 + periodUs / 2) / periodUs;
+}
+
+void dshotTelemetryReset(dshotTelemetryMotorState_t *state) {
+    memset(state, 0, sizeof(*state));
+}
+
+void dshotTelemetryUpdate(dshotTelemetryMotorState_t *state, uint16_t value) {
+    state->replies++;
+    state->windowReplies++;
+    if (value == DSHOT_TELEMETRY_INVALID) {
+        state->errors++;
+        state->windowErrors++;
+        if (state->missed < DSHOT_TELEMETRY_STALE_REPLIES) {
+            state->missed++;
+        }
+        if (state->missed >= DSHOT_TELEMETRY_STALE_REPLIES) {
+            state->valid = false;
+        }
+    } else {
+        state->erpm = value;
+        state->missed = 0;
+        state->valid = true;
+    }
+    if (state->windowReplies >= DSHOT_TELEMETRY_ERROR_WINDOW) {
+        state->errorPermille = state->windowErrors * 1000 / state->windowReplies;
+        state->windowReplies = 0;
+        state->windowErrors = 0;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DSHOT_TELEMETRY_INVALID         0xffff
+#define DSHOT_TELEMETRY_INPUT_LEN       32      // capture slots, a reply has at most 21 edges
+#define DSHOT_TELEMETRY_BIT_TICKS       16      // the reply runs at 5/4 of the command bitrate, 20 timer ticks per command bit
+#define DSHOT_TELEMETRY_ERROR_WINDOW    1000    // replies per error rate window
+#define DSHOT_TELEMETRY_STALE_REPLIES   10      // consecutive bad replies before the eRPM is dropped
+
+typedef struct dshotTelemetryMotorState_s {
+    uint32_t replies;           // capture windows decoded since boot
+    uint32_t errors;            // of which were missing or corrupt
+    uint16_t erpm;              // eRPM / 100 of the last valid reply
+    uint16_t errorPermille;     // bad replies in the last complete window
+    uint16_t windowReplies;
+    uint16_t windowErrors;
+    uint8_t missed;             // consecutive bad replies
+    bool valid;
+} dshotTelemetryMotorState_t;
+
+uint16_t dshotTelemetryDecode(const uint32_t *edges, uint8_t count, uint16_t bitTicks);
+void dshotTelemetryReset(dshotTelemetryMotorState_t *state);
+void dshotTelemetryUpdate(dshotTelemetryMotorState_t *state, uint16_t value);
@@ -165,6 +165,12 @@ void EXTIRelease(IO_t io) {
     rec->handler = NULL;
 }
 
+// false if another driver already has a handler on the EXTI line of this pin
+bool EXTIIsFree(IO_t io) {
+    const int chIdx = IO_GPIOPinIdx(io);
+    return chIdx >= 0 && !extiChannelRecs[chIdx].handler;
+}
+
 void EXTIEnable(IO_t io, bool enable) {
 #if defined(STM32F1) || defined(STM32F4) || defined(STM32F7)
     uint32_t extiLine = IO_EXTI_Line(io);
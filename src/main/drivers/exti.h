@@ -40,4 +40,5 @@ void EXTIConfig(IO_t io, extiCallbackRec_t *cb, int irqPriority, ioConfig_t conf
 void EXTIConfig(IO_t io, extiCallbackRec_t *cb, int irqPriority, EXTITrigger_TypeDef trigger);
 #endif
 void EXTIRelease(IO_t io);
+bool EXTIIsFree(IO_t io);
 void EXTIEnable(IO_t io, bool enable);
@@ -31,6 +31,7 @@
 #include "flash_impl.h"
 #include "flash_m25p16.h"
 #include "flash_w25m.h"
+#include "flash_w25n01g.h"
 #include "drivers/bus_spi.h"
 #include "drivers/io.h"
 #include "drivers/time.h"
@@ -67,13 +68,12 @@ bool flashInit(const flashConfig_t *flashConfig) {
     spiSetDivisor(busdev->busdev_u.spi.instance, SPI_CLOCK_STANDARD * 2);
 #endif
     flashDevice.busdev = busdev;
-    const uint8_t out[] = { SPIFLASH_INSTRUCTION_RDID, 0, 0, 0 };
+    const uint8_t out[] = { SPIFLASH_INSTRUCTION_RDID, 0, 0, 0, 0 };
     delay(50); // short delay required after initialisation of SPI device instance.
     /* Just in case transfer fails and writes nothing, so we don't try to verify the ID against random garbage
      * from the stack:
      */
-    uint8_t in[4];
-    in[1] = 0;
+    uint8_t in[5] = { 0 };
     // Clearing the CS bit terminates the command early so we don't have to read the chip UID:
     spiBusTransfer(busdev, out, in, sizeof(out));
     // Manufacturer, memory type, and capacity
@@ -83,6 +83,18 @@ bool flashInit(const flashConfig_t *flashConfig) {
         return true;
     }
 #endif
+#ifdef USE_FLASH_W25M
+    if (w25m_detect(&flashDevice, chipID)) {
+        return true;
+    }
+#endif
+    // SPI NAND parts clock out a dummy byte before the ID
+    chipID = (in[2] << 16) | (in[3] << 8) | (in[4]);
+#ifdef USE_FLASH_W25N01G
+    if (w25n01g_detect(&flashDevice, chipID)) {
+        return true;
+    }
+#endif
 #ifdef USE_FLASH_W25M
     if (w25m_detect(&flashDevice, chipID)) {
         return true;
@@ -129,7 +141,9 @@ int flashReadBytes(uint32_t address, uint8_t *buffer, int length) {
 }
 
 void flashFlush(void) {
-    flashDevice.vTable->flush(&flashDevice);
+    if (flashDevice.vTable->flush) {
+        flashDevice.vTable->flush(&flashDevice);
+    }
 }
 
 static const flashGeometry_t noFlashGeometry = {
@@ -142,4 +156,12 @@ const flashGeometry_t *flashGetGeometry(void) {
     }
     return &noFlashGeometry;
 }
+
+// Factory marked or worn out NAND block, never true for NOR devices
+bool flashIsBadBlock(uint16_t block) {
+    if (flashDevice.vTable && flashDevice.vTable->isBadBlock) {
+        return flashDevice.vTable->isBadBlock(&flashDevice, block);
+    }
+    return false;
+}
 #endif // USE_FLASH
@@ -38,6 +38,7 @@ typedef struct flashDevice_s {
     // for writes. This allows us to avoid polling for writable status
     // when it is definitely ready already.
     bool couldBeBusy;
+    void *driverState; // per die state of drivers that need more than the above
 } flashDevice_t;
 
 typedef struct flashVTable_s {
@@ -52,4 +53,5 @@ typedef struct flashVTable_s {
     void (*flush)(flashDevice_t *fdevice);
     int (*readBytes)(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer, int length);
     const flashGeometry_t *(*getGeometry)(flashDevice_t *fdevice);
+    bool (*isBadBlock)(flashDevice_t *fdevice, uint16_t block); // NAND only
 } flashVTable_t;
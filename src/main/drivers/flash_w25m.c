@@ -43,12 +43,14 @@
 
 #include "flash_m25p16.h"
 #include "flash_w25m.h"
+#include "flash_w25n01g.h"
 
 #include "pg/flash.h"
 
 #define W25M_INSTRUCTION_SOFTWARE_DIE_SELECT         0xC2
 
 #define JEDEC_ID_WINBOND_W25M512                     0xEF7119 // W25Q256 x 2
+#define JEDEC_ID_WINBOND_W25M02G                     0xEFAB21 // W25N01G x 2
 
 static const flashVTable_t w25m_vTable;
 
@@ -104,6 +106,20 @@ bool w25m_detect(flashDevice_t *fdevice, uint32_t chipID) {
         }
         fdevice->geometry.flashType = FLASH_TYPE_NOR;
         break;
+#ifdef USE_FLASH_W25N01G
+    case JEDEC_ID_WINBOND_W25M02G:
+        // W25N01G x 2
+        dieCount = 2;
+        for (int die = 0 ; die < dieCount ; die++) {
+            w25m_dieSelect(fdevice->busdev, die);
+            dieDevice[die].busdev = fdevice->busdev;
+            if (!w25n01g_detect(&dieDevice[die], JEDEC_ID_WINBOND_W25N01GV)) {
+                return false;
+            }
+        }
+        fdevice->geometry.flashType = FLASH_TYPE_NAND;
+        break;
+#endif
     default:
         // Not a valid W25M series device
         fdevice->geometry.sectors = 0;
@@ -112,7 +128,7 @@ bool w25m_detect(flashDevice_t *fdevice, uint32_t chipID) {
         fdevice->geometry.totalSize = 0;
         return false;
     }
-    fdevice->geometry.sectors = dieDevice[0].geometry.sectors;
+    fdevice->geometry.sectors = dieDevice[0].geometry.sectors * dieCount;
     fdevice->geometry.sectorSize = dieDevice[0].geometry.sectorSize;
     fdevice->geometry.pagesPerSector = dieDevice[0].geometry.pagesPerSector;
     fdevice->geometry.pageSize = dieDevice[0].geometry.pageSize;
@@ -183,10 +199,29 @@ int w25m_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer, in
     return length;
 }
 
+void w25m_flush(flashDevice_t *fdevice) {
+    for (int dieNumber = 0 ; dieNumber < dieCount ; dieNumber++) {
+        if (dieDevice[dieNumber].vTable->flush) {
+            w25m_dieSelect(fdevice->busdev, dieNumber);
+            dieDevice[dieNumber].vTable->flush(&dieDevice[dieNumber]);
+        }
+    }
+}
+
 const flashGeometry_t* w25m_getGeometry(flashDevice_t *fdevice) {
     return &fdevice->geometry;
 }
 
+bool w25m_isBadBlock(flashDevice_t *fdevice, uint16_t block) {
+    UNUSED(fdevice);
+    const uint16_t dieBlocks = dieDevice[0].geometry.sectors;
+    const int dieNumber = block / dieBlocks;
+    if (dieNumber >= dieCount || !dieDevice[dieNumber].vTable->isBadBlock) {
+        return false;
+    }
+    return dieDevice[dieNumber].vTable->isBadBlock(&dieDevice[dieNumber], block % dieBlocks);
+}
+
 static const flashVTable_t w25m_vTable = {
     .isReady = w25m_isReady,
     .waitForReady = w25m_waitForReady,
@@ -196,7 +231,9 @@ static const flashVTable_t w25m_vTable = {
     .pageProgramContinue = w25m_pageProgramContinue,
     .pageProgramFinish = w25m_pageProgramFinish,
     .pageProgram = w25m_pageProgram,
+    .flush = w25m_flush,
     .readBytes = w25m_readBytes,
     .getGeometry = w25m_getGeometry,
+    .isBadBlock = w25m_isBadBlock,
 };
 #endif
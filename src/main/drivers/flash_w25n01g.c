@@ -0,0 +1,499 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Winbond W25N01GV SPI NAND flash driver.
+ *
+ * The device reads and programs whole 2KB pages through an on-chip data
+ * buffer and erases 128KB blocks. Writes are loaded into the buffer with
+ * "load program data" for the first chunk of a page and "random load" for
+ * the following ones, and the page is only programmed once it is full or
+ * flushed, so flashfs can keep writing in small pieces. Reads leave the
+ * page in the buffer so consecutive reads of the same page skip the array
+ * read. A read of another page while one is being written keeps the
+ * loaded data in RAM and loads it back afterwards.
+ *
+ * Blocks with a factory bad block marker are found at detect time. Blocks
+ * that fail to erase later are marked the same way, so they stay retired
+ * across reboots. flashfs skips them through flashIsBadBlock().
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "build/debug.h"
+
+#ifdef USE_FLASH_W25N01G
+
+#include "common/maths.h"
+
+#include "drivers/bus_spi.h"
+#include "drivers/flash.h"
+#include "drivers/flash_impl.h"
+#include "drivers/io.h"
+#include "drivers/time.h"
+
+#include "pg/flash.h"
+
+#include "flash_w25n01g.h"
+
+#define W25N01G_INSTRUCTION_DEVICE_RESET        0xFF
+#define W25N01G_INSTRUCTION_READ_STATUS_REG     0x0F
+#define W25N01G_INSTRUCTION_WRITE_STATUS_REG    0x1F
+#define W25N01G_INSTRUCTION_WRITE_ENABLE        0x06
+#define W25N01G_INSTRUCTION_BLOCK_ERASE         0xD8
+#define W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD   0x02
+#define W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD 0x84
+#define W25N01G_INSTRUCTION_PROGRAM_EXECUTE     0x10
+#define W25N01G_INSTRUCTION_PAGE_DATA_READ      0x13
+#define W25N01G_INSTRUCTION_READ_DATA           0x03
+
+#define W25N01G_PROT_REG                        0xA0
+#define W25N01G_CONF_REG                        0xB0
+#define W25N01G_STAT_REG                        0xC0
+
+#define W25N01G_CONFIG_ECC_ENABLE               (1 << 4)
+#define W25N01G_CONFIG_BUFFER_READ_MODE         (1 << 3)
+
+#define W25N01G_STATUS_FLAG_ECC_MASK            (3 << 4)
+#define W25N01G_STATUS_FLAG_ECC_CORRECTED       (1 << 4)
+#define W25N01G_STATUS_PROGRAM_FAIL             (1 << 3)
+#define W25N01G_STATUS_ERASE_FAIL               (1 << 2)
+#define W25N01G_STATUS_FLAG_BUSY                (1 << 0)
+
+#define W25N01G_BLOCK_COUNT                     1024
+#define W25N01G_PAGES_PER_BLOCK                 64
+#define W25N01G_PAGE_SIZE                       2048
+#define W25N01G_BAD_BLOCK_MARKER_COLUMN         W25N01G_PAGE_SIZE // first byte of the spare area
+#define W25N01G_NO_PAGE                         UINT32_MAX
+
+// two dies in a W25M02G
+#define W25N01G_MAX_DIES                        2
+
+#define W25N01G_TIMEOUT_RESET_MS                2   // tRSTmax = 500us
+#define W25N01G_TIMEOUT_PAGE_READ_MS            2   // tRDmax = 60us with ECC enabled
+#define W25N01G_TIMEOUT_PAGE_PROGRAM_MS         2   // tPPmax = 700us
+#define W25N01G_TIMEOUT_BLOCK_ERASE_MS          15  // tBEmax = 10ms
+
+STATIC_ASSERT(W25N01G_PAGE_SIZE <= FLASH_MAX_PAGE_SIZE, W25N01G_PAGESIZE_too_large);
+
+typedef enum {
+    W25N01G_OP_NONE = 0,
+    W25N01G_OP_READ,
+    W25N01G_OP_PROGRAM,
+    W25N01G_OP_ERASE,
+    W25N01G_OP_MARK,
+} w25n01gOp_e;
+
+typedef struct w25n01gState_s {
+    uint8_t badBlocks[W25N01G_BLOCK_COUNT / 8];
+    uint32_t bufferPage;        // page held in the data buffer for reading, W25N01G_NO_PAGE if none
+    uint32_t programPage;       // page being assembled in the data buffer
+    bool programLoaded;         // the data buffer holds data for programPage that isn't programmed yet
+    bool markPending;           // bad block marker waits for the data buffer to be free
+    uint16_t markBlock;
+    uint16_t pendingBlock;      // block of the erase in flight
+    w25n01gOp_e pendingOp;      // operation to check once the device is no longer busy
+} w25n01gState_t;
+
+static w25n01gState_t dieState[W25N01G_MAX_DIES];
+static uint8_t dieCount;
+
+// the loaded part of a page being written, while a read of another page has the data buffer
+static uint8_t programData[W25N01G_PAGE_SIZE];
+
+// totals over all dies, for DEBUG_FLASH_NAND
+static uint16_t eccCorrectedCount;
+static uint16_t eccFailedCount;
+static uint16_t writeFailedCount;
+static uint16_t badBlockCount;
+
+static const flashVTable_t w25n01g_vTable;
+
+static w25n01gState_t *w25n01g_state(flashDevice_t *fdevice) {
+    return fdevice->driverState;
+}
+
+static void w25n01g_disable(busDevice_t *bus) {
+    IOHi(bus->busdev_u.spi.csnPin);
+    __NOP();
+}
+
+static void w25n01g_enable(busDevice_t *bus) {
+    __NOP();
+    IOLo(bus->busdev_u.spi.csnPin);
+}
+
+static void w25n01g_transfer(busDevice_t *bus, const uint8_t *txData, uint8_t *rxData, int len) {
+    w25n01g_enable(bus);
+    spiTransfer(bus->busdev_u.spi.instance, txData, rxData, len);
+    w25n01g_disable(bus);
+}
+
+static void w25n01g_performOneByteCommand(busDevice_t *bus, uint8_t command) {
+    w25n01g_enable(bus);
+    spiTransferByte(bus->busdev_u.spi.instance, command);
+    w25n01g_disable(bus);
+}
+
+static void w25n01g_performCommandWithPageAddress(busDevice_t *bus, uint8_t command, uint32_t pageAddress) {
+    const uint8_t out[] = { command, 0, (pageAddress >> 8) & 0xff, pageAddress & 0xff };
+    w25n01g_transfer(bus, out, NULL, sizeof(out));
+}
+
+static uint8_t w25n01g_readRegister(busDevice_t *bus, uint8_t reg) {
+    const uint8_t command[3] = { W25N01G_INSTRUCTION_READ_STATUS_REG, reg, 0 };
+    uint8_t in[3];
+    w25n01g_transfer(bus, command, in, sizeof(command));
+    return in[2];
+}
+
+static void w25n01g_writeRegister(busDevice_t *bus, uint8_t reg, uint8_t data) {
+    const uint8_t command[3] = { W25N01G_INSTRUCTION_WRITE_STATUS_REG, reg, data };
+    w25n01g_transfer(bus, command, NULL, sizeof(command));
+}
+
+static void w25n01g_writeEnable(flashDevice_t *fdevice) {
+    w25n01g_performOneByteCommand(fdevice->busdev, W25N01G_INSTRUCTION_WRITE_ENABLE);
+}
+
+static void w25n01g_startOperation(flashDevice_t *fdevice, w25n01gOp_e op) {
+    w25n01g_state(fdevice)->pendingOp = op;
+    fdevice->couldBeBusy = true;
+}
+
+static bool w25n01g_isBadBlock(flashDevice_t *fdevice, uint16_t block) {
+    if (block >= W25N01G_BLOCK_COUNT) {
+        return true;
+    }
+    return w25n01g_state(fdevice)->badBlocks[block / 8] & (1 << (block % 8));
+}
+
+static void w25n01g_setBadBlock(flashDevice_t *fdevice, uint16_t block) {
+    w25n01g_state(fdevice)->badBlocks[block / 8] |= 1 << (block % 8);
+    badBlockCount++;
+    DEBUG_SET(DEBUG_FLASH_NAND, 3, badBlockCount);
+}
+
+static void w25n01g_loadProgramData(flashDevice_t *fdevice, uint8_t command, uint16_t column, const uint8_t *data, int length) {
+    const uint8_t out[] = { command, column >> 8, column & 0xff };
+    w25n01g_writeEnable(fdevice);
+    w25n01g_enable(fdevice->busdev);
+    spiTransfer(fdevice->busdev->busdev_u.spi.instance, out, NULL, sizeof(out));
+    spiTransfer(fdevice->busdev->busdev_u.spi.instance, data, NULL, length);
+    w25n01g_disable(fdevice->busdev);
+    w25n01g_state(fdevice)->bufferPage = W25N01G_NO_PAGE;
+}
+
+// Zero the marker in the spare area of the first page, like the factory does
+static void w25n01g_writeBadBlockMarker(flashDevice_t *fdevice) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    static const uint8_t marker[2] = { 0, 0 };
+    state->markPending = false;
+    w25n01g_loadProgramData(fdevice, W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD, W25N01G_BAD_BLOCK_MARKER_COLUMN, marker, sizeof(marker));
+    w25n01g_writeEnable(fdevice);
+    w25n01g_performCommandWithPageAddress(fdevice->busdev, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, state->markBlock * W25N01G_PAGES_PER_BLOCK);
+    w25n01g_startOperation(fdevice, W25N01G_OP_MARK);
+}
+
+// Look at the outcome of the operation that just finished
+static void w25n01g_checkResult(flashDevice_t *fdevice, uint8_t status) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    switch (state->pendingOp) {
+    case W25N01G_OP_READ:
+        if ((status & W25N01G_STATUS_FLAG_ECC_MASK) == W25N01G_STATUS_FLAG_ECC_CORRECTED) {
+            eccCorrectedCount++;
+            DEBUG_SET(DEBUG_FLASH_NAND, 0, eccCorrectedCount);
+        } else if (status & W25N01G_STATUS_FLAG_ECC_MASK) {
+            // the data is still returned, the blackbox decoder resyncs on the next frame
+            eccFailedCount++;
+            DEBUG_SET(DEBUG_FLASH_NAND, 1, eccFailedCount);
+        }
+        break;
+    case W25N01G_OP_PROGRAM:
+        if (status & W25N01G_STATUS_PROGRAM_FAIL) {
+            writeFailedCount++;
+            DEBUG_SET(DEBUG_FLASH_NAND, 2, writeFailedCount);
+        }
+        break;
+    case W25N01G_OP_ERASE:
+        if (status & W25N01G_STATUS_ERASE_FAIL) {
+            writeFailedCount++;
+            DEBUG_SET(DEBUG_FLASH_NAND, 2, writeFailedCount);
+            // retire the block, the marker needs the data buffer so it may have to wait for a page being written
+            w25n01g_setBadBlock(fdevice, state->pendingBlock);
+            state->markBlock = state->pendingBlock;
+            state->markPending = true;
+        }
+        break;
+    default:
+        break;
+    }
+    state->pendingOp = W25N01G_OP_NONE;
+}
+
+static bool w25n01g_isReady(flashDevice_t *fdevice) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    if (fdevice->couldBeBusy) {
+        const uint8_t status = w25n01g_readRegister(fdevice->busdev, W25N01G_STAT_REG);
+        if (status & W25N01G_STATUS_FLAG_BUSY) {
+            return false;
+        }
+        fdevice->couldBeBusy = false;
+        w25n01g_checkResult(fdevice, status);
+    }
+    if (state->markPending && !state->programLoaded) {
+        w25n01g_writeBadBlockMarker(fdevice);
+        return false;
+    }
+    return true;
+}
+
+static bool w25n01g_waitForReady(flashDevice_t *fdevice, uint32_t timeoutMillis) {
+    uint32_t time = millis();
+    while (!w25n01g_isReady(fdevice)) {
+        if (millis() - time > timeoutMillis) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void w25n01g_deviceReset(flashDevice_t *fdevice) {
+    w25n01g_performOneByteCommand(fdevice->busdev, W25N01G_INSTRUCTION_DEVICE_RESET);
+    w25n01g_startOperation(fdevice, W25N01G_OP_NONE);
+    w25n01g_waitForReady(fdevice, W25N01G_TIMEOUT_RESET_MS);
+    // all blocks come up write protected
+    w25n01g_writeRegister(fdevice->busdev, W25N01G_PROT_REG, 0);
+    // buffer read mode, so reads stop at the end of the page instead of streaming on
+    w25n01g_writeRegister(fdevice->busdev, W25N01G_CONF_REG, W25N01G_CONFIG_ECC_ENABLE | W25N01G_CONFIG_BUFFER_READ_MODE);
+}
+
+// Move a page from the array to the data buffer, skipped if it is there already
+static bool w25n01g_readPageToBuffer(flashDevice_t *fdevice, uint32_t page) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    if (state->bufferPage == page) {
+        return true;
+    }
+    if (!w25n01g_waitForReady(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS)) {
+        return false;
+    }
+    w25n01g_performCommandWithPageAddress(fdevice->busdev, W25N01G_INSTRUCTION_PAGE_DATA_READ, page);
+    w25n01g_startOperation(fdevice, W25N01G_OP_READ);
+    if (!w25n01g_waitForReady(fdevice, W25N01G_TIMEOUT_PAGE_READ_MS)) {
+        return false;
+    }
+    state->bufferPage = page;
+    return true;
+}
+
+static void w25n01g_readBuffer(flashDevice_t *fdevice, uint16_t column, uint8_t *buffer, int length) {
+    const uint8_t command[4] = { W25N01G_INSTRUCTION_READ_DATA, column >> 8, column & 0xff, 0 };
+    w25n01g_enable(fdevice->busdev);
+    spiTransfer(fdevice->busdev->busdev_u.spi.instance, command, NULL, sizeof(command));
+    spiTransfer(fdevice->busdev->busdev_u.spi.instance, NULL, buffer, length);
+    w25n01g_disable(fdevice->busdev);
+}
+
+static void w25n01g_scanBadBlocks(flashDevice_t *fdevice) {
+    // about 100us per block, so some 100ms at boot
+    for (int block = 0; block < W25N01G_BLOCK_COUNT; block++) {
+        uint8_t marker = 0;
+        if (w25n01g_readPageToBuffer(fdevice, block * W25N01G_PAGES_PER_BLOCK)) {
+            w25n01g_readBuffer(fdevice, W25N01G_BAD_BLOCK_MARKER_COLUMN, &marker, sizeof(marker));
+        }
+        if (marker != 0xFF) {
+            w25n01g_setBadBlock(fdevice, block);
+        }
+    }
+}
+
+bool w25n01g_detect(flashDevice_t *fdevice, uint32_t chipID) {
+    switch (chipID) {
+    case JEDEC_ID_WINBOND_W25N01GV:
+        fdevice->geometry.sectors = W25N01G_BLOCK_COUNT;
+        fdevice->geometry.pagesPerSector = W25N01G_PAGES_PER_BLOCK;
+        fdevice->geometry.pageSize = W25N01G_PAGE_SIZE;
+        break;
+    default:
+        // Unsupported chip or not an SPI NAND flash
+        fdevice->geometry.sectors = 0;
+        fdevice->geometry.pagesPerSector = 0;
+        fdevice->geometry.sectorSize = 0;
+        fdevice->geometry.totalSize = 0;
+        return false;
+    }
+    if (dieCount >= W25N01G_MAX_DIES) {
+        return false;
+    }
+    w25n01gState_t *state = &dieState[dieCount++];
+    memset(state, 0, sizeof(*state));
+    state->bufferPage = W25N01G_NO_PAGE;
+    fdevice->driverState = state;
+    fdevice->geometry.flashType = FLASH_TYPE_NAND;
+    fdevice->geometry.sectorSize = fdevice->geometry.pagesPerSector * fdevice->geometry.pageSize;
+    fdevice->geometry.totalSize = fdevice->geometry.sectorSize * fdevice->geometry.sectors;
+    w25n01g_deviceReset(fdevice);
+    w25n01g_scanBadBlocks(fdevice);
+    fdevice->vTable = &w25n01g_vTable;
+    return true;
+}
+
+static void w25n01g_programExecute(flashDevice_t *fdevice) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    w25n01g_waitForReady(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS);
+    // an erase in between clears the write enable latch set by the data load
+    w25n01g_writeEnable(fdevice);
+    w25n01g_performCommandWithPageAddress(fdevice->busdev, W25N01G_INSTRUCTION_PROGRAM_EXECUTE, state->programPage);
+    state->programLoaded = false;
+    w25n01g_startOperation(fdevice, W25N01G_OP_PROGRAM);
+}
+
+/**
+ * Erase the block at the given byte offset. The erase runs in the background, a failed erase retires the block.
+ */
+static void w25n01g_eraseSector(flashDevice_t *fdevice, uint32_t address) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    const uint32_t block = address / fdevice->geometry.sectorSize;
+    w25n01g_waitForReady(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS);
+    if (w25n01g_isBadBlock(fdevice, block)) {
+        return;
+    }
+    w25n01g_writeEnable(fdevice);
+    w25n01g_performCommandWithPageAddress(fdevice->busdev, W25N01G_INSTRUCTION_BLOCK_ERASE, block * W25N01G_PAGES_PER_BLOCK);
+    state->pendingBlock = block;
+    if (state->bufferPage / W25N01G_PAGES_PER_BLOCK == block) {
+        state->bufferPage = W25N01G_NO_PAGE;
+    }
+    w25n01g_startOperation(fdevice, W25N01G_OP_ERASE);
+}
+
+// There is no chip erase on NAND, this takes several seconds
+static void w25n01g_eraseCompletely(flashDevice_t *fdevice) {
+    for (int block = 0; block < W25N01G_BLOCK_COUNT; block++) {
+        w25n01g_eraseSector(fdevice, block * fdevice->geometry.sectorSize);
+    }
+}
+
+static void w25n01g_pageProgramBegin(flashDevice_t *fdevice, uint32_t address) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    if (state->programLoaded && address / W25N01G_PAGE_SIZE != state->programPage) {
+        // the previous page was left unfinished by a seek, commit it first
+        w25n01g_programExecute(fdevice);
+    }
+    fdevice->currentWriteAddress = address;
+}
+
+static void w25n01g_pageProgramContinue(flashDevice_t *fdevice, const uint8_t *data, int length) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    const uint16_t column = fdevice->currentWriteAddress % W25N01G_PAGE_SIZE;
+    // a plain load resets the rest of the buffer to 0xFF, a random load keeps what is loaded already
+    const uint8_t command = state->programLoaded ? W25N01G_INSTRUCTION_RANDOM_PROGRAM_DATA_LOAD : W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD;
+    w25n01g_waitForReady(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS);
+    w25n01g_loadProgramData(fdevice, command, column, data, length);
+    state->programPage = fdevice->currentWriteAddress / W25N01G_PAGE_SIZE;
+    state->programLoaded = true;
+    fdevice->currentWriteAddress += length;
+}
+
+static void w25n01g_pageProgramFinish(flashDevice_t *fdevice) {
+    if (w25n01g_state(fdevice)->programLoaded && fdevice->currentWriteAddress % W25N01G_PAGE_SIZE == 0) {
+        w25n01g_programExecute(fdevice);
+    }
+}
+
+/**
+ * Write bytes to a flash page. Address must not cross a page boundary.
+ *
+ * The data is collected in the device's data buffer and programmed once the page is complete or on flush, a page
+ * can only be programmed once between erases.
+ */
+static void w25n01g_pageProgram(flashDevice_t *fdevice, uint32_t address, const uint8_t *data, int length) {
+    w25n01g_pageProgramBegin(fdevice, address);
+    w25n01g_pageProgramContinue(fdevice, data, length);
+    w25n01g_pageProgramFinish(fdevice);
+}
+
+// Program a partly filled page, the rest of it stays erased
+static void w25n01g_flush(flashDevice_t *fdevice) {
+    if (w25n01g_state(fdevice)->programLoaded) {
+        w25n01g_programExecute(fdevice);
+    }
+}
+
+/**
+ * Read `length` bytes into the provided `buffer` from the flash starting from the given `address`.
+ *
+ * The number of bytes actually read is returned, which can be zero if an error or timeout occurred.
+ */
+static int w25n01g_readBytes(flashDevice_t *fdevice, uint32_t address, uint8_t *buffer, int length) {
+    w25n01gState_t *state = w25n01g_state(fdevice);
+    if (state->programLoaded && address / W25N01G_PAGE_SIZE <= state->programPage && state->programPage <= (address + length - 1) / W25N01G_PAGE_SIZE) {
+        // the page being written is read back, program what there is of it
+        w25n01g_flush(fdevice);
+    }
+    // the page read replaces the data buffer contents, so the data loaded for another page is kept aside meanwhile
+    const uint16_t loadedLength = state->programLoaded ? fdevice->currentWriteAddress - state->programPage * W25N01G_PAGE_SIZE : 0;
+    if (loadedLength > 0) {
+        w25n01g_waitForReady(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS);
+        w25n01g_readBuffer(fdevice, 0, programData, loadedLength);
+    }
+    int bytesRead = 0;
+    while (bytesRead < length) {
+        const uint32_t page = address / W25N01G_PAGE_SIZE;
+        const uint16_t column = address % W25N01G_PAGE_SIZE;
+        const int transferLength = MIN(length - bytesRead, W25N01G_PAGE_SIZE - column);
+        if (!w25n01g_readPageToBuffer(fdevice, page)) {
+            bytesRead = 0;
+            break;
+        }
+        w25n01g_readBuffer(fdevice, column, buffer + bytesRead, transferLength);
+        bytesRead += transferLength;
+        address += transferLength;
+    }
+    if (loadedLength > 0) {
+        w25n01g_waitForReady(fdevice, W25N01G_TIMEOUT_BLOCK_ERASE_MS);
+        w25n01g_loadProgramData(fdevice, W25N01G_INSTRUCTION_PROGRAM_DATA_LOAD, 0, programData, loadedLength);
+    }
+    return bytesRead;
+}
+
+static const flashGeometry_t* w25n01g_getGeometry(flashDevice_t *fdevice) {
+    return &fdevice->geometry;
+}
+
+static const flashVTable_t w25n01g_vTable = {
+    .isReady = w25n01g_isReady,
+    .waitForReady = w25n01g_waitForReady,
+    .eraseSector = w25n01g_eraseSector,
+    .eraseCompletely = w25n01g_eraseCompletely,
+    .pageProgramBegin = w25n01g_pageProgramBegin,
+    .pageProgramContinue = w25n01g_pageProgramContinue,
+    .pageProgramFinish = w25n01g_pageProgramFinish,
+    .pageProgram = w25n01g_pageProgram,
+    .flush = w25n01g_flush,
+    .readBytes = w25n01g_readBytes,
+    .getGeometry = w25n01g_getGeometry,
+    .isBadBlock = w25n01g_isBadBlock,
+};
+#endif
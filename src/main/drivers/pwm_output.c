@@ -26,11 +26,14 @@
 #include "platform.h"
 #include "drivers/time.h"
 
+#include "common/maths.h"
+
 #include "pg/pinio.h"
 #include "pg/piniobox.h"
 
 #include "interface/msp_box.h"
 
+#include "drivers/dshot_bitbang.h"
 #include "drivers/io.h"
 #include "pwm_output.h"
 #include "timer.h"
@@ -43,20 +46,6 @@ static FAST_RAM_ZERO_INIT pwmCompleteWriteFn *pwmCompleteWrite = NULL;
 
 #ifdef USE_DSHOT
 FAST_RAM_ZERO_INIT loadDmaBufferFn *loadDmaBuffer;
-#define DSHOT_INITIAL_DELAY_US 10000
-#define DSHOT_COMMAND_DELAY_US 1000
-#define DSHOT_ESCINFO_DELAY_US 12000
-#define DSHOT_BEEP_DELAY_US 100000
-
-typedef struct dshotCommandControl_s {
-    timeUs_t nextCommandAtUs;
-    timeUs_t delayAfterCommandUs;
-    bool waitingForIdle;
-    uint8_t repeats;
-    uint8_t command[MAX_SUPPORTED_MOTORS];
-} dshotCommandControl_t;
-
-static dshotCommandControl_t dshotCommandControl;
 #endif
 
 #ifdef USE_SERVOS
@@ -73,6 +62,9 @@ static bool isDshot = false;
 #ifdef USE_DSHOT_DMAR
 FAST_RAM_ZERO_INIT bool useBurstDshot = false;
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+FAST_RAM_ZERO_INIT bool useDshotTelemetry = false;
+#endif
 
 static void pwmOCConfig(TIM_TypeDef *tim, uint8_t channel, uint16_t value, uint8_t output) {
 #if defined(USE_HAL_DRIVER)
@@ -270,6 +262,16 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
         if (motorConfig->useBurstDshot) {
             useBurstDshot = true;
         }
+#endif
+#ifdef USE_DSHOT_BITBANG
+        useDshotBitbang = motorConfig->useDshotBitbang && dshotBitbangInit(motorConfig, MIN(motorCount, MAX_SUPPORTED_MOTORS));
+#endif
+#ifdef USE_DSHOT_TELEMETRY
+        // the reply is captured per channel, burst mode shares one DMA stream between the channels of a timer
+        useDshotTelemetry = motorConfig->useDshotTelemetry && !useBurstDshot;
+#ifdef USE_DSHOT_BITBANG
+        useDshotTelemetry = useDshotTelemetry && !useDshotBitbang;
+#endif
 #endif
         break;
 #endif
@@ -278,6 +280,11 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
         pwmWrite = &pwmWriteStandard;
         pwmCompleteWrite = useUnsyncedPwm ? &pwmCompleteWriteUnused : &pwmCompleteOneshotMotorUpdate;
     }
+#ifdef USE_DSHOT
+    else {
+        dshotCommandInit();
+    }
+#endif
     for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
         const ioTag_t tag = motorConfig->ioTags[motorIndex];
         const timerHardware_t *timerHardware = timerGetByTag(tag);
@@ -290,6 +297,13 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
         }
         motors[motorIndex].io = IOGetByTag(tag);
         IOInit(motors[motorIndex].io, OWNER_MOTOR, RESOURCE_INDEX(motorIndex));
+#ifdef USE_DSHOT_BITBANG
+        if (useDshotBitbang) {
+            // pins and DMA were set up by dshotBitbangInit
+            motors[motorIndex].enabled = true;
+            continue;
+        }
+#endif
 #ifdef USE_DSHOT
         if (isDshot) {
             pwmDshotMotorHardwareConfig(timerHardware,
@@ -363,112 +377,16 @@ uint32_t getDshotHz(motorPwmProtocolTypes_e pwmProtocolType) {
     }
 }
 
-bool allMotorsAreIdle(uint8_t motorCount) {
-    bool allMotorsIdle = true;
-    for (unsigned i = 0; i < motorCount; i++) {
-        const motorDmaOutput_t *motor = getMotorDmaOutput(i);
-        if (motor->value) {
-            allMotorsIdle = false;
-        }
-    }
-    return allMotorsIdle;
-}
-
-FAST_CODE bool pwmDshotCommandIsQueued(void) {
-    return dshotCommandControl.nextCommandAtUs;
-}
-
-FAST_CODE bool pwmDshotCommandIsProcessing(void) {
-    return dshotCommandControl.nextCommandAtUs && !dshotCommandControl.waitingForIdle && dshotCommandControl.repeats > 0;
-}
-
-void pwmWriteDshotCommand(uint8_t index, uint8_t motorCount, uint8_t command, bool blocking) {
-    timeUs_t timeNowUs = micros();
-    if (!isMotorProtocolDshot() || (command > DSHOT_MAX_COMMAND) || pwmDshotCommandIsQueued()) {
-        return;
-    }
-    uint8_t repeats = 1;
-    timeUs_t delayAfterCommandUs = DSHOT_COMMAND_DELAY_US;
-    switch (command) {
-    case DSHOT_CMD_SPIN_DIRECTION_1:
-    case DSHOT_CMD_SPIN_DIRECTION_2:
-    case DSHOT_CMD_3D_MODE_OFF:
-    case DSHOT_CMD_3D_MODE_ON:
-    case DSHOT_CMD_SAVE_SETTINGS:
-    case DSHOT_CMD_SPIN_DIRECTION_NORMAL:
-    case DSHOT_CMD_SPIN_DIRECTION_REVERSED:
-        repeats = 10;
-        break;
-    case DSHOT_CMD_BEACON1:
-    case DSHOT_CMD_BEACON2:
-    case DSHOT_CMD_BEACON3:
-    case DSHOT_CMD_BEACON4:
-    case DSHOT_CMD_BEACON5:
-        delayAfterCommandUs = DSHOT_BEEP_DELAY_US;
-        break;
-    default:
-        break;
-    }
-    if (blocking) {
-        delayMicroseconds(DSHOT_INITIAL_DELAY_US - DSHOT_COMMAND_DELAY_US);
-        for (; repeats; repeats--) {
-            delayMicroseconds(DSHOT_COMMAND_DELAY_US);
-            for (uint8_t i = 0; i < motorCount; i++) {
-                if ((i == index) || (index == ALL_MOTORS)) {
-                    motorDmaOutput_t *const motor = getMotorDmaOutput(i);
-                    motor->requestTelemetry = true;
-                    pwmWriteDshotInt(i, command);
-                }
-            }
-            pwmCompleteDshotMotorUpdate(0);
-        }
-        delayMicroseconds(delayAfterCommandUs);
-    } else {
-        dshotCommandControl.repeats = repeats;
-        dshotCommandControl.nextCommandAtUs = timeNowUs + DSHOT_INITIAL_DELAY_US;
-        dshotCommandControl.delayAfterCommandUs = delayAfterCommandUs;
-        for (unsigned i = 0; i < motorCount; i++) {
-            if (index == i || index == ALL_MOTORS) {
-                dshotCommandControl.command[i] = command;
-            } else {
-                dshotCommandControl.command[i] = DSHOT_CMD_MOTOR_STOP;
-            }
-        }
-        dshotCommandControl.waitingForIdle = !allMotorsAreIdle(motorCount);
-    }
-}
-
-uint8_t pwmGetDshotCommand(uint8_t index) {
-    return dshotCommandControl.command[index];
-}
-
-FAST_CODE_NOINLINE bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount) {
-    timeUs_t timeNowUs = micros();
-    if (dshotCommandControl.waitingForIdle) {
-        if (allMotorsAreIdle(motorCount)) {
-            dshotCommandControl.nextCommandAtUs = timeNowUs + DSHOT_INITIAL_DELAY_US;
-            dshotCommandControl.waitingForIdle = false;
-        }
-        // Send normal motor output while waiting for motors to go idle
-        return true;
-    }
-    if (cmpTimeUs(timeNowUs, dshotCommandControl.nextCommandAtUs) < 0) {
-        //Skip motor update because it isn't time yet for a new command
-        return false;
-    }
-    //Timed motor update happening with dshot command
-    if (dshotCommandControl.repeats > 0) {
-        dshotCommandControl.repeats--;
-        if (dshotCommandControl.repeats > 0) {
-            dshotCommandControl.nextCommandAtUs = timeNowUs + DSHOT_COMMAND_DELAY_US;
-        } else {
-            dshotCommandControl.nextCommandAtUs = timeNowUs + dshotCommandControl.delayAfterCommandUs;
-        }
-    } else {
-        dshotCommandControl.nextCommandAtUs = 0;
+#ifdef USE_DSHOT_DMAR
+// the burst rewrites the CCR of every channel on the timer, a motor that skips its frame
+// gets a flat line at idle level instead of its last frame again
+FAST_CODE void pwmDshotClearBurstSlot(motorDmaOutput_t *const motor) {
+    uint32_t *slot = &motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)];
+    for (int i = 0; i < DSHOT_DMA_BUFFER_SIZE; i++) {
+        slot[i * 4] = 0;
     }
-    return true;
 }
+#endif
 
 FAST_CODE uint16_t prepareDshotPacket(motorDmaOutput_t *const motor) {
     uint16_t packet = (motor->value << 1) | (motor->requestTelemetry ? 1 : 0);
@@ -480,6 +398,12 @@ FAST_CODE uint16_t prepareDshotPacket(motorDmaOutput_t *const motor) {
         csum ^=  csum_data;   // xor data by nibbles
         csum_data >>= 4;
     }
+#ifdef USE_DSHOT_TELEMETRY
+    // an inverted checksum asks the ESC for the bidirectional reply
+    if (useDshotTelemetry) {
+        csum = ~csum;
+    }
+#endif
     csum &= 0xf;
     // append checksum
     packet = (packet << 4) | csum;
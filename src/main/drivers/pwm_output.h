@@ -22,15 +22,12 @@
 
 #include "platform.h"
 
+#include "drivers/dshot_command.h"
+#include "drivers/dshot_telemetry.h"
 #include "drivers/io_types.h"
 #include "drivers/pwm_output_counts.h"
 #include "drivers/timer.h"
 
-
-#define ALL_MOTORS 255
-
-#define DSHOT_MAX_COMMAND 47
-
 #define MOTOR_OUTPUT_LIMIT_PERCENT_MIN 1
 #define MOTOR_OUTPUT_LIMIT_PERCENT_MAX 100
 
@@ -38,45 +35,6 @@
 #define DSHOT_MAX_THROTTLE     2047
 #define DSHOT_3D_FORWARD_MIN_THROTTLE 1048
 
-/*
-  DshotSettingRequest (KISS24). Spin direction, 3d and save Settings reqire 10 requests.. and the TLM Byte must always be high if 1-47 are used to send settings
-
-  3D Mode:
-  0 = stop
-  48   (low) - 1047 (high) -> negative direction
-  1048 (low) - 2047 (high) -> positive direction
- */
-
-typedef enum {
-    DSHOT_CMD_MOTOR_STOP = 0,
-    DSHOT_CMD_BEACON1,
-    DSHOT_CMD_BEACON2,
-    DSHOT_CMD_BEACON3,
-    DSHOT_CMD_BEACON4,
-    DSHOT_CMD_BEACON5,
-    DSHOT_CMD_ESC_INFO, // V2 includes settings
-    DSHOT_CMD_SPIN_DIRECTION_1,
-    DSHOT_CMD_SPIN_DIRECTION_2,
-    DSHOT_CMD_3D_MODE_OFF,
-    DSHOT_CMD_3D_MODE_ON,
-    DSHOT_CMD_SETTINGS_REQUEST, // Currently not implemented
-    DSHOT_CMD_SAVE_SETTINGS,
-    DSHOT_CMD_SPIN_DIRECTION_NORMAL = 20,
-    DSHOT_CMD_SPIN_DIRECTION_REVERSED = 21,
-    DSHOT_CMD_LED0_ON, // BLHeli32 only
-    DSHOT_CMD_LED1_ON, // BLHeli32 only
-    DSHOT_CMD_LED2_ON, // BLHeli32 only
-    DSHOT_CMD_LED3_ON, // BLHeli32 only
-    DSHOT_CMD_LED0_OFF, // BLHeli32 only
-    DSHOT_CMD_LED1_OFF, // BLHeli32 only
-    DSHOT_CMD_LED2_OFF, // BLHeli32 only
-    DSHOT_CMD_LED3_OFF, // BLHeli32 only
-    DSHOT_CMD_AUDIO_STREAM_MODE_ON_OFF = 30, // KISS audio Stream mode on/Off
-    DSHOT_CMD_SILENT_MODE_ON_OFF = 31, // KISS silent Mode on/Off
-    DSHOT_CMD_MAX = 47
-} dshotCommands_e;
-
-
 typedef enum {
     PWM_TYPE_STANDARD = 0,
     PWM_TYPE_ONESHOT125,
@@ -150,6 +108,11 @@ typedef struct {
 #else
     uint8_t dmaBuffer[DSHOT_DMA_BUFFER_SIZE];
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+    bool hasTelemetry;          // the channel can capture, complementary outputs cannot
+    volatile bool isInput;      // capturing the eRPM reply
+    uint32_t dmaInputBuffer[DSHOT_TELEMETRY_INPUT_LEN];
+#endif
 } motorDmaOutput_t;
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index);
@@ -180,9 +143,14 @@ typedef struct motorDevConfig_s {
     uint8_t  useUnsyncedPwm;
     uint8_t  useBurstDshot;
     ioTag_t  ioTags[MAX_SUPPORTED_MOTORS];
+    uint8_t  useDshotTelemetry;             // bidirectional DShot, the ESC replies with its eRPM after every frame
+    uint8_t  useDshotBitbang;               // DShot from GPIO port writes, one DMA stream per port instead of per motor
 } motorDevConfig_t;
 
 extern bool useBurstDshot;
+#ifdef USE_DSHOT_TELEMETRY
+extern bool useDshotTelemetry;
+#endif
 
 void motorDevInit(const motorDevConfig_t *motorDevConfig, uint16_t idlePulse, uint8_t motorCount);
 
@@ -207,17 +175,18 @@ uint16_t prepareDshotPacket(motorDmaOutput_t *const motor);
 extern loadDmaBufferFn *loadDmaBuffer;
 
 uint32_t getDshotHz(motorPwmProtocolTypes_e pwmProtocolType);
-void pwmWriteDshotCommandControl(uint8_t index);
-void pwmWriteDshotCommand(uint8_t index, uint8_t motorCount, uint8_t command, bool blocking);
 void pwmWriteDshotInt(uint8_t index, uint16_t value);
 void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t motorIndex, motorPwmProtocolTypes_e pwmProtocolType, uint8_t output);
 void pwmCompleteDshotMotorUpdate(uint8_t motorCount);
+#ifdef USE_DSHOT_DMAR
+void pwmDshotClearBurstSlot(motorDmaOutput_t *const motor);
+#endif
 
-bool pwmDshotCommandIsQueued(void);
-bool pwmDshotCommandIsProcessing(void);
-uint8_t pwmGetDshotCommand(uint8_t index);
-bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount);
-
+#ifdef USE_DSHOT_TELEMETRY
+void pwmStartDshotMotorUpdate(uint8_t motorCount);
+uint16_t getDshotTelemetry(uint8_t index);
+const dshotTelemetryMotorState_t *getDshotTelemetryState(uint8_t index);
+#endif
 #endif
 
 #ifdef USE_BEEPER
@@ -28,6 +28,8 @@
 
 #include "build/debug.h"
 
+#include "drivers/dshot_bitbang.h"
+#include "drivers/dshot_telemetry.h"
 #include "drivers/io.h"
 #include "timer.h"
 #if defined(STM32F4)
@@ -49,6 +51,95 @@ motorDmaOutput_t *getMotorDmaOutput(uint8_t index) {
     return &dmaMotors[index];
 }
 
+#ifdef USE_DSHOT_TELEMETRY
+// what the channel and its DMA stream are set back to after each reply
+static DMA_InitTypeDef dshotTelemetryDmaOutput[MAX_SUPPORTED_MOTORS];
+static TIM_OCInitTypeDef dshotTelemetryOcOutput[MAX_SUPPORTED_MOTORS];
+static dshotTelemetryMotorState_t dshotTelemetryStates[MAX_SUPPORTED_MOTORS];
+
+static void pwmDshotDisableDma(DMA_Stream_TypeDef *dmaRef) {
+    DMA_Cmd(dmaRef, DISABLE);
+    while (DMA_GetCmdStatus(dmaRef) != DISABLE);
+}
+
+// called from the DMA interrupt once the frame is out, the reply follows about 30us later
+static void pwmDshotSetDirectionInput(motorDmaOutput_t *const motor, uint8_t motorIndex) {
+    const timerHardware_t *timerHardware = motor->timerHardware;
+    TIM_TypeDef *timer = timerHardware->tim;
+    DMA_Stream_TypeDef *dmaRef = timerHardware->dmaRef;
+    pwmDshotDisableDma(dmaRef);
+    TIM_ICInitTypeDef TIM_ICInitStructure;
+    TIM_ICStructInit(&TIM_ICInitStructure);
+    TIM_ICInitStructure.TIM_Channel = timerHardware->channel;
+    TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+    TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    TIM_ICInitStructure.TIM_ICFilter = 2;
+    TIM_ICInit(timer, &TIM_ICInitStructure);
+    // free running, the decoder works on the differences of the captures
+    TIM_SetAutoreload(timer, 0xffff);
+    DMA_InitTypeDef DMA_InitStructure = dshotTelemetryDmaOutput[motorIndex];
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)motor->dmaInputBuffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_BufferSize = DSHOT_TELEMETRY_INPUT_LEN;
+    DMA_Init(dmaRef, &DMA_InitStructure);
+    motor->isInput = true;
+    DMA_Cmd(dmaRef, ENABLE);
+    TIM_DMACmd(timer, motor->timerDmaSource, ENABLE);
+}
+
+static void pwmDshotSetDirectionOutput(motorDmaOutput_t *const motor, uint8_t motorIndex) {
+    const timerHardware_t *timerHardware = motor->timerHardware;
+    TIM_TypeDef *timer = timerHardware->tim;
+    timerOCInit(timer, timerHardware->channel, &dshotTelemetryOcOutput[motorIndex]);
+    // both edge capture set CCxNP, which has to be clear on an output channel
+    timer->CCER &= ~(TIM_CCER_CC1NP << timerHardware->channel);
+    timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
+    // idle level until the first bit of the next frame is loaded
+    *timerChCCR(timerHardware) = 0;
+    DMA_Init(timerHardware->dmaRef, &dshotTelemetryDmaOutput[motorIndex]);
+    DMA_ITConfig(timerHardware->dmaRef, DMA_IT_TC, ENABLE);
+    motor->isInput = false;
+}
+
+// decodes the replies captured since the last frame and gets the channels ready to send the next one
+FAST_CODE void pwmStartDshotMotorUpdate(uint8_t motorCount) {
+    for (int i = 0; i < motorCount; i++) {
+        motorDmaOutput_t *const motor = &dmaMotors[i];
+        if (!motor->configured || !motor->isInput) {
+            continue;
+        }
+        DMA_Stream_TypeDef *dmaRef = motor->timerHardware->dmaRef;
+        TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, DISABLE);
+        pwmDshotDisableDma(dmaRef);
+        const uint8_t edges = DSHOT_TELEMETRY_INPUT_LEN - DMA_GetCurrDataCounter(dmaRef);
+        dshotTelemetryUpdate(&dshotTelemetryStates[i], dshotTelemetryDecode(motor->dmaInputBuffer, edges, DSHOT_TELEMETRY_BIT_TICKS));
+        if (i < DEBUG16_VALUE_COUNT) {
+            DEBUG_SET(DEBUG_DSHOT_RPM_TELEMETRY, i, getDshotTelemetry(i));
+        }
+        pwmDshotSetDirectionOutput(motor, i);
+    }
+    for (int i = 0; i < dmaMotorTimerCount; i++) {
+        TIM_TypeDef *timer = dmaMotorTimers[i].timer;
+        if (timer->ARR != MOTOR_BITLENGTH) {
+            // the update event loads the bit period at once instead of after the counter wraps
+            TIM_SetAutoreload(timer, MOTOR_BITLENGTH);
+            TIM_GenerateEvent(timer, TIM_EventSource_Update);
+        }
+    }
+}
+
+// eRPM / 100, 0 while no recent reply was valid
+uint16_t getDshotTelemetry(uint8_t index) {
+    return dshotTelemetryStates[index].valid ? dshotTelemetryStates[index].erpm : 0;
+}
+
+const dshotTelemetryMotorState_t *getDshotTelemetryState(uint8_t index) {
+    return &dshotTelemetryStates[index];
+}
+#endif
+
 uint8_t getTimerIndex(TIM_TypeDef *timer) {
     for (int i = 0; i < dmaMotorTimerCount; i++) {
         if (dmaMotorTimers[i].timer == timer) {
@@ -65,14 +156,34 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value) {
         return;
     }
     /*If there is a command ready to go overwrite the value and send that instead*/
-    if (pwmDshotCommandIsProcessing()) {
-        value = pwmGetDshotCommand(index);
+    const int output = dshotCommandApply(index, value);
+    if (output == DSHOT_COMMAND_SKIP_FRAME) {
+#ifdef USE_DSHOT_BITBANG
+        if (useDshotBitbang) {
+            dshotBitbangSkipPacket(index);
+        } else
+#endif
+#ifdef USE_DSHOT_DMAR
+        if (useBurstDshot) {
+            pwmDshotClearBurstSlot(motor);
+        }
+#endif
+        return;
+    }
+    if (output != value) {
+        value = output;
         if (value) {
             motor->requestTelemetry = true;
         }
     }
     motor->value = value;
     uint16_t packet = prepareDshotPacket(motor);
+#ifdef USE_DSHOT_BITBANG
+    if (useDshotBitbang) {
+        dshotBitbangWritePacket(index, packet);
+        return;
+    }
+#endif
     uint8_t bufferSize;
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
@@ -90,12 +201,16 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value) {
 
 void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
     UNUSED(motorCount);
-    /* If there is a dshot command loaded up, time it correctly with motor update*/
-    if (pwmDshotCommandIsQueued()) {
-        if (!pwmDshotCommandOutputIsEnabled(motorCount)) {
-            return;
-        }
+    /* Step the queued dshot commands along with the motor update*/
+    if (dshotCommandIsQueued()) {
+        dshotCommandUpdate(micros());
     }
+#ifdef USE_DSHOT_BITBANG
+    if (useDshotBitbang) {
+        dshotBitbangUpdateComplete();
+        return;
+    }
+#endif
     for (int i = 0; i < dmaMotorTimerCount; i++) {
 #ifdef USE_DSHOT_DMAR
         if (useBurstDshot) {
@@ -116,6 +231,13 @@ void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
 static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor) {
     if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
         motorDmaOutput_t * const motor = &dmaMotors[descriptor->userParam];
+#ifdef USE_DSHOT_TELEMETRY
+        if (motor->isInput) {
+            // more edges than a reply has, the decoder will reject it
+            DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+            return;
+        }
+#endif
 #ifdef USE_DSHOT_DMAR
         if (useBurstDshot) {
             DMA_Cmd(motor->timerHardware->dmaTimUPRef, DISABLE);
@@ -126,6 +248,11 @@ static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor) {
             DMA_Cmd(motor->timerHardware->dmaRef, DISABLE);
             TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, DISABLE);
         }
+#ifdef USE_DSHOT_TELEMETRY
+        if (useDshotTelemetry && motor->hasTelemetry) {
+            pwmDshotSetDirectionInput(motor, descriptor->userParam);
+        }
+#endif
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
     }
 }
@@ -160,6 +287,15 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     // However, since the initialization is idempotent, it is left as is in a favor of flash space (for now).
     const uint8_t timerIndex = getTimerIndex(timer);
     const bool configureTimer = (timerIndex == dmaMotorTimerCount - 1);
+#ifdef USE_DSHOT_TELEMETRY
+    // the line idles high and the ESC pulls it low for both the frame and the reply
+    if (useDshotTelemetry) {
+        output ^= TIMER_OUTPUT_INVERTED;
+    }
+    motor->hasTelemetry = useDshotTelemetry && !(output & TIMER_OUTPUT_N_CHANNEL);
+    motor->isInput = false;
+    dshotTelemetryReset(&dshotTelemetryStates[motorIndex]);
+#endif
     IOConfigGPIOAF(motorIO, IO_CONFIG(GPIO_Mode_AF, GPIO_Speed_50MHz, GPIO_OType_PP, GPIO_PuPd_UP), timerHardware->alternateFunction);
     if (configureTimer) {
         TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
@@ -185,6 +321,9 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
         TIM_OCInitStructure.TIM_OCPolarity =  (output & TIMER_OUTPUT_INVERTED) ? TIM_OCPolarity_Low : TIM_OCPolarity_High;
     }
     TIM_OCInitStructure.TIM_Pulse = 0;
+#ifdef USE_DSHOT_TELEMETRY
+    dshotTelemetryOcOutput[motorIndex] = TIM_OCInitStructure;
+#endif
     timerOCInit(timer, timerHardware->channel, &TIM_OCInitStructure);
     timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
     if (output & TIMER_OUTPUT_N_CHANNEL) {
@@ -262,6 +401,9 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
         DMA_InitStructure.DMA_Priority = DMA_Priority_High;
     }
     // XXX Consolidate common settings in the next refactor
+#ifdef USE_DSHOT_TELEMETRY
+    dshotTelemetryDmaOutput[motorIndex] = DMA_InitStructure;
+#endif
     DMA_Init(dmaRef, &DMA_InitStructure);
     DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
     motor->configured = true;
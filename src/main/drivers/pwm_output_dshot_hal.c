@@ -58,8 +58,17 @@ FAST_CODE void pwmWriteDshotInt(uint8_t index, uint16_t value) {
         return;
     }
     /*If there is a command ready to go overwrite the value and send that instead*/
-    if (pwmDshotCommandIsProcessing()) {
-        value = pwmGetDshotCommand(index);
+    const int output = dshotCommandApply(index, value);
+    if (output == DSHOT_COMMAND_SKIP_FRAME) {
+#ifdef USE_DSHOT_DMAR
+        if (useBurstDshot) {
+            pwmDshotClearBurstSlot(motor);
+        }
+#endif
+        return;
+    }
+    if (output != value) {
+        value = output;
         if (value) {
             motor->requestTelemetry = true;
         }
@@ -83,11 +92,9 @@ FAST_CODE void pwmWriteDshotInt(uint8_t index, uint16_t value) {
 
 FAST_CODE void pwmCompleteDshotMotorUpdate(uint8_t motorCount) {
     UNUSED(motorCount);
-    /* If there is a dshot command loaded up, time it correctly with motor update*/
-    if (pwmDshotCommandIsQueued()) {
-        if (!pwmDshotCommandOutputIsEnabled(motorCount)) {
-            return;
-        }
+    /* Step the queued dshot commands along with the motor update*/
+    if (dshotCommandIsQueued()) {
+        dshotCommandUpdate(micros());
     }
     for (int i = 0; i < dmaMotorTimerCount; i++) {
 #ifdef USE_DSHOT_DMAR
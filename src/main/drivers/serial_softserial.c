@@ -21,6 +21,17 @@
 /*
  * Cleanflight (or Baseflight): original
  * jflyper: Mono-timer and single-wire half-duplex
+ *
+ * Ports without a receive callback only timestamp the RX edges in the
+ * capture interrupt and decode them when the port is read, see
+ * serial_softserial_decoder.c. The bit clock keeps running through the
+ * received bytes, so receiving no longer disturbs a transmission on the
+ * same timer. Ports with a callback decode bit by bit in the interrupt.
+ *
+ * When the TX pin has a timer channel with a free DMA stream (F3/F4), the
+ * channel is run in output compare and its compare DMA request writes a
+ * forced active/inactive level into CCMR at every bit boundary, so the TX
+ * waveform is timed by the timer rather than by the overflow interrupt.
  */
 
 #include <stdbool.h>
@@ -37,12 +48,14 @@
 
 #include "common/utils.h"
 
+#include "drivers/dma.h"
 #include "drivers/nvic.h"
 #include "drivers/io.h"
 #include "timer.h"
 
 #include "serial.h"
 #include "serial_softserial.h"
+#include "serial_softserial_decoder.h"
 
 #include "fc/config.h" //!!TODO remove this dependency
 
@@ -55,6 +68,18 @@
 #define MAX_SOFTSERIAL_PORTS 1
 #endif
 
+#if !defined(USE_HAL_DRIVER) && (defined(STM32F3) || defined(STM32F4)) && (defined(USE_DSHOT) || defined(USE_LED_STRIP) || defined(USE_TRANSPONDER))
+#define USE_SOFTSERIAL_TX_DMA
+// bytes per DMA transfer, each followed by one idle bit so the last stop bit completes before the transfer ends
+#define TX_DMA_BYTES 16
+#define TX_DMA_BITS (TX_DMA_BYTES * TX_TOTAL_BITS + 1)
+#if defined(STM32F4)
+typedef uint16_t timCCMR_t;
+#else
+typedef uint32_t timCCMR_t;
+#endif
+#endif
+
 typedef enum {
     TIMER_MODE_SINGLE,
     TIMER_MODE_DUAL,
@@ -96,8 +121,21 @@ typedef struct softSerial_s {
     uint8_t          softSerialPortIndex;
     timerMode_e      timerMode;
 
+    bool             rxEdgeDecoding;
+    uint8_t          rxEdgeLevel;       // line level after the next captured edge
+    uint32_t         bitTicks;
+    volatile uint32_t bitClock;         // bit periods since the port was opened
+    softSerialDecoder_t rxDecoder;
+
     timerOvrHandlerRec_t overCb;
     timerCCHandlerRec_t edgeCb;
+
+#ifdef USE_SOFTSERIAL_TX_DMA
+    const timerHardware_t *txTimerHardware; // TX channel driven by DMA, NULL for the interrupt bit clock
+    volatile timCCMR_t *txCcmr;
+    uint8_t          txCcmrShift;
+    timCCMR_t        txDmaBuffer[TX_DMA_BITS];
+#endif
 } softSerial_t;
 
 static const struct serialPortVTable softSerialVTable; // Forward
@@ -126,6 +164,12 @@ static void serialEnableCC(softSerial_t *softSerial) {
 #endif
 }
 
+static void serialEdgeCaptureReset(softSerial_t *softSerial) {
+    // the line idles high, so the first edge to capture is the falling edge of a start bit
+    timerChConfigIC(softSerial->timerHardware, (softSerial->port.options & SERIAL_INVERTED) ? ICPOLARITY_RISING : ICPOLARITY_FALLING, 0);
+    softSerial->rxEdgeLevel = 0;
+}
+
 static void serialInputPortActivate(softSerial_t *softSerial) {
     if (softSerial->port.options & SERIAL_INVERTED) {
 #ifdef STM32F1
@@ -145,6 +189,15 @@ static void serialInputPortActivate(softSerial_t *softSerial) {
     softSerial->rxActive = true;
     softSerial->isSearchingForStartBit = true;
     softSerial->rxBitIndex = 0;
+    if (softSerial->rxEdgeDecoding) {
+        serialEdgeCaptureReset(softSerial);
+    }
+#ifdef USE_SOFTSERIAL_TX_DMA
+    else if (softSerial->txTimerHardware == softSerial->timerHardware) {
+        // the DMA transmit left the shared channel in output compare mode, wait for a start bit again
+        timerChConfigIC(softSerial->timerHardware, (softSerial->port.options & SERIAL_INVERTED) ? ICPOLARITY_RISING : ICPOLARITY_FALLING, 0);
+    }
+#endif
     // Enable input capture
     serialEnableCC(softSerial);
 }
@@ -160,7 +213,37 @@ static void serialInputPortDeActivate(softSerial_t *softSerial) {
     softSerial->rxActive = false;
 }
 
+#ifdef USE_SOFTSERIAL_TX_DMA
+static timCCMR_t serialTxCcmrLevel(const softSerial_t *softSerial, timCCMR_t ccmr, uint8_t state) {
+    ccmr &= ~((TIM_CCMR1_OC1M_0 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2) << softSerial->txCcmrShift);
+    return ccmr | ((state ? TIM_ForcedAction_Active : TIM_ForcedAction_InActive) << softSerial->txCcmrShift);
+}
+
+static void serialTxDmaOutputActivate(softSerial_t *softSerial) {
+    const timerHardware_t *txTimer = softSerial->txTimerHardware;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
+    TIM_OCInitStructure.TIM_OCIdleState = TIM_OCIdleState_Set;
+    TIM_OCInitStructure.TIM_OCPolarity = (softSerial->port.options & SERIAL_INVERTED) ? TIM_OCPolarity_Low : TIM_OCPolarity_High;
+    // compare at the start of each bit period, which is where the DMA writes the next level
+    TIM_OCInitStructure.TIM_Pulse = 0;
+    timerOCInit(txTimer->tim, txTimer->channel, &TIM_OCInitStructure);
+    timerOCPreloadConfig(txTimer->tim, txTimer->channel, TIM_OCPreload_Disable);
+    *softSerial->txCcmr = serialTxCcmrLevel(softSerial, *softSerial->txCcmr, 1);
+    TIM_CtrlPWMOutputs(txTimer->tim, ENABLE);
+    IOConfigGPIOAF(softSerial->txIO, IOCFG_AF_PP, txTimer->alternateFunction);
+}
+#endif
+
 static void serialOutputPortActivate(softSerial_t *softSerial) {
+#ifdef USE_SOFTSERIAL_TX_DMA
+    if (softSerial->txTimerHardware) {
+        serialTxDmaOutputActivate(softSerial);
+        return;
+    }
+#endif
 #ifdef STM32F1
     IOConfigGPIO(softSerial->txIO, IOCFG_OUT_PP);
 #else
@@ -186,7 +269,8 @@ static bool isTimerPeriodTooLarge(uint32_t timerPeriod) {
     return timerPeriod > 0xFFFF;
 }
 
-static void serialTimerConfigureTimebase(const timerHardware_t *timerHardwarePtr, uint32_t baud) {
+// returns the timer ticks of one bit period
+static uint32_t serialTimerConfigureTimebase(const timerHardware_t *timerHardwarePtr, uint32_t baud) {
     uint32_t baseClock = timerClock(timerHardwarePtr->tim);
     uint32_t clock = baseClock;
     uint32_t timerPeriod;
@@ -201,7 +285,65 @@ static void serialTimerConfigureTimebase(const timerHardware_t *timerHardwarePtr
         }
     } while (isTimerPeriodTooLarge(timerPeriod));
     timerConfigure(timerHardwarePtr, timerPeriod, baseClock);
+    return timerPeriod;
+}
+
+#ifdef USE_SOFTSERIAL_TX_DMA
+static void serialTxDmaIrqHandler(dmaChannelDescriptor_t *descriptor) {
+    if (DMA_GET_FLAG_STATUS(descriptor, DMA_IT_TCIF)) {
+        softSerial_t *softSerial = &softSerialPorts[descriptor->userParam];
+        const timerHardware_t *txTimer = softSerial->txTimerHardware;
+        DMA_Cmd(descriptor->ref, DISABLE);
+        DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
+        TIM_DMACmd(txTimer->tim, timerDmaSource(txTimer->channel), DISABLE);
+        softSerial->isTransmittingData = false;
+    }
+}
+
+// use DMA for TX if the TX channel has a stream that nothing else has claimed
+static void serialTxDmaInit(softSerial_t *softSerial, const timerHardware_t *txTimer) {
+    softSerial->txTimerHardware = NULL;
+    if (!txTimer || !txTimer->dmaRef || (txTimer->output & TIMER_OUTPUT_N_CHANNEL)) {
+        return;
+    }
+    const uint8_t resourceIndex = RESOURCE_INDEX(softSerial->softSerialPortIndex + RESOURCE_SOFT_OFFSET);
+    const dmaIdentifier_e dmaIdentifier = dmaGetIdentifier(txTimer->dmaRef);
+    const resourceOwner_e dmaOwner = dmaGetOwner(dmaIdentifier);
+    if (dmaOwner != OWNER_FREE && !(dmaOwner == OWNER_SERIAL_TX && dmaGetResourceIndex(dmaIdentifier) == resourceIndex)) {
+        return;
+    }
+    softSerial->txTimerHardware = txTimer;
+    softSerial->txCcmr = (txTimer->channel & TIM_Channel_3) ? (volatile timCCMR_t *)&txTimer->tim->CCMR2 : (volatile timCCMR_t *)&txTimer->tim->CCMR1;
+    softSerial->txCcmrShift = (txTimer->channel & TIM_Channel_2) ? 8 : 0;
+    dmaInit(dmaIdentifier, OWNER_SERIAL_TX, resourceIndex);
+    dmaSetHandler(dmaIdentifier, serialTxDmaIrqHandler, NVIC_PRIO_SOFTSERIAL_TXDMA, softSerial->softSerialPortIndex);
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_Cmd(txTimer->dmaRef, DISABLE);
+    DMA_DeInit(txTimer->dmaRef);
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)softSerial->txCcmr;
+    DMA_InitStructure.DMA_BufferSize = TX_DMA_BITS;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+#if defined(STM32F4)
+    DMA_InitStructure.DMA_Channel = txTimer->dmaChannel;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)softSerial->txDmaBuffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+#else
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)softSerial->txDmaBuffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+#endif
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_Init(txTimer->dmaRef, &DMA_InitStructure);
+    DMA_ITConfig(txTimer->dmaRef, DMA_IT_TC, ENABLE);
 }
+#endif
 
 static void resetBuffers(softSerial_t *softSerial) {
     softSerial->port.rxBufferSize = SOFTSERIAL_BUFFER_SIZE;
@@ -273,8 +415,11 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
     softSerial->receiveErrors = 0;
     softSerial->rxActive = false;
     softSerial->isTransmittingData = false;
+    softSerial->rxEdgeDecoding = (mode & MODE_RX) && !rxCallback;
+    softSerial->bitClock = 0;
     // Configure master timer (on RX); time base and input capture
-    serialTimerConfigureTimebase(softSerial->timerHardware, baud);
+    softSerial->bitTicks = serialTimerConfigureTimebase(softSerial->timerHardware, baud);
+    softSerialDecoderInit(&softSerial->rxDecoder, softSerial->bitTicks);
     timerChConfigIC(softSerial->timerHardware, (options & SERIAL_INVERTED) ? ICPOLARITY_RISING : ICPOLARITY_FALLING, 0);
     // Initialize callbacks
     timerChCCHandlerInit(&softSerial->edgeCb, onSerialRxPinChange);
@@ -294,6 +439,14 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
     }
 #ifdef USE_HAL_DRIVER
     softSerial->timerHandle = timerFindTimerHandle(softSerial->timerHardware->tim);
+#endif
+#ifdef USE_SOFTSERIAL_TX_DMA
+    if (mode & MODE_TX) {
+        // the TX pin's own channel: the master timer unless RX has a separate pin
+        serialTxDmaInit(softSerial, ((options & SERIAL_BIDIR) || !(mode & MODE_RX)) ? softSerial->timerHardware : softSerial->exTimerHardware);
+    } else {
+        softSerial->txTimerHardware = NULL;
+    }
 #endif
     if (!(options & SERIAL_BIDIR)) {
         serialOutputPortActivate(softSerial);
@@ -308,8 +461,62 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
  * Serial Engine
  */
 
+#ifdef USE_SOFTSERIAL_TX_DMA
+static void serialTxDmaStart(softSerial_t *softSerial) {
+    const timerHardware_t *txTimer = softSerial->txTimerHardware;
+    const timCCMR_t ccmr = *softSerial->txCcmr;
+    const timCCMR_t mark = serialTxCcmrLevel(softSerial, ccmr, 1);
+    const timCCMR_t space = serialTxCcmrLevel(softSerial, ccmr, 0);
+    unsigned bits = 0;
+    while (!isSoftSerialTransmitBufferEmpty((serialPort_t *)softSerial) && bits + TX_TOTAL_BITS < TX_DMA_BITS) {
+        uint8_t byteToSend = softSerial->port.txBuffer[softSerial->port.txBufferTail++];
+        if (softSerial->port.txBufferTail >= softSerial->port.txBufferSize) {
+            softSerial->port.txBufferTail = 0;
+        }
+        // stop bit (1) + data bits (MSB to LSB) + start bit (0), sent LSB first
+        uint16_t frame = (1 << (TX_TOTAL_BITS - 1)) | (byteToSend << 1);
+        for (unsigned i = 0; i < TX_TOTAL_BITS; i++) {
+            softSerial->txDmaBuffer[bits++] = (frame & 1) ? mark : space;
+            frame >>= 1;
+        }
+    }
+    softSerial->txDmaBuffer[bits++] = mark;
+    softSerial->isTransmittingData = true;
+    DMA_SetCurrDataCounter(txTimer->dmaRef, bits);
+    TIM_DMACmd(txTimer->tim, timerDmaSource(txTimer->channel), ENABLE);
+    DMA_Cmd(txTimer->dmaRef, ENABLE);
+}
+
+static void processTxDmaState(softSerial_t *softSerial) {
+    if (softSerial->isTransmittingData) {
+        // the DMA owns the line until the transfer completes
+        return;
+    }
+    if (isSoftSerialTransmitBufferEmpty((serialPort_t *)softSerial)) {
+        if (!softSerial->rxActive && softSerial->port.options & SERIAL_BIDIR) {
+            serialOutputPortDeActivate(softSerial);
+            serialInputPortActivate(softSerial);
+        }
+        return;
+    }
+    if (softSerial->rxActive && (softSerial->port.options & SERIAL_BIDIR)) {
+        // Half-duplex: turn the line around and start on the next bit, as below
+        serialInputPortDeActivate(softSerial);
+        serialOutputPortActivate(softSerial);
+        return;
+    }
+    serialTxDmaStart(softSerial);
+}
+#endif
+
 void processTxState(softSerial_t *softSerial) {
     uint8_t mask;
+#ifdef USE_SOFTSERIAL_TX_DMA
+    if (softSerial->txTimerHardware) {
+        processTxDmaState(softSerial);
+        return;
+    }
+#endif
     if (!softSerial->isTransmittingData) {
         if (isSoftSerialTransmitBufferEmpty((serialPort_t *)softSerial)) {
             // Transmit buffer empty.
@@ -379,6 +586,12 @@ void prepareForNextRxByte(softSerial_t *softSerial) {
 #define STOP_BIT_MASK (1 << 0)
 #define START_BIT_MASK (1 << (RX_TOTAL_BITS - 1))
 
+static void storeRxByte(uint8_t rxByte, void *data) {
+    softSerial_t *softSerial = data;
+    softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
+    softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+}
+
 void extractAndStoreRxByte(softSerial_t *softSerial) {
     if ((softSerial->port.mode & MODE_RX) == 0) {
         return;
@@ -393,8 +606,7 @@ void extractAndStoreRxByte(softSerial_t *softSerial) {
     if (softSerial->port.rxCallback) {
         softSerial->port.rxCallback(rxByte, softSerial->port.rxCallbackData);
     } else {
-        softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
-        softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+        storeRxByte(rxByte, softSerial);
     }
 }
 
@@ -419,17 +631,52 @@ void processRxState(softSerial_t *softSerial) {
 void onSerialTimerOverflow(timerOvrHandlerRec_t *cbRec, captureCompare_t capture) {
     UNUSED(capture);
     softSerial_t *self = container_of(cbRec, softSerial_t, overCb);
+    self->bitClock++;
     if (self->port.mode & MODE_TX)
         processTxState(self);
-    if (self->port.mode & MODE_RX)
+    if ((self->port.mode & MODE_RX) && !self->rxEdgeDecoding)
         processRxState(self);
 }
 
+// time in bit clock ticks of a timer count taken now or captured by the timer
+static uint32_t serialBitClockTime(const softSerial_t *self, uint16_t count) {
+    uint32_t bitClock = self->bitClock;
+    if ((self->timerHardware->tim->SR & TIM_SR_UIF) && count < self->bitTicks / 2) {
+        // the count wrapped and the overflow handler has not run yet
+        bitClock++;
+    }
+    return bitClock * self->bitTicks + count;
+}
+
+static void serialRecordRxEdge(softSerial_t *self, captureCompare_t capture) {
+    const timerHardware_t *timerHardware = self->timerHardware;
+    softSerialDecoderPushEdge(&self->rxDecoder, serialBitClockTime(self, capture), self->rxEdgeLevel);
+    // capture the opposite edge next
+    self->rxEdgeLevel = !self->rxEdgeLevel;
+    timerHardware->tim->CCER ^= TIM_CCER_CC1P << timerHardware->channel;
+}
+
+static void serialDecodeRxEdges(softSerial_t *self) {
+    uint32_t now;
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        now = serialBitClockTime(self, self->timerHardware->tim->CNT);
+    }
+    softSerialDecoderProcess(&self->rxDecoder, now, storeRxByte, self);
+    // edges lost when the port is not polled often enough for the baud rate
+    DEBUG_SET(DEBUG_SOFTSERIAL, 2 * self->softSerialPortIndex, self->rxDecoder.edgeOverruns);
+    DEBUG_SET(DEBUG_SOFTSERIAL, 2 * self->softSerialPortIndex + 1, self->rxDecoder.framingErrors);
+}
+
 void onSerialRxPinChange(timerCCHandlerRec_t *cbRec, captureCompare_t capture) {
     UNUSED(capture);
     softSerial_t *self = container_of(cbRec, softSerial_t, edgeCb);
     bool inverted = self->port.options & SERIAL_INVERTED;
-    if ((self->port.mode & MODE_RX) == 0) {
+    if ((self->port.mode & MODE_RX) == 0 || !self->rxActive) {
+        // half-duplex TX compares on this channel
+        return;
+    }
+    if (self->rxEdgeDecoding) {
+        serialRecordRxEdge(self, capture);
         return;
     }
     if (self->isSearchingForStartBit) {
@@ -484,6 +731,9 @@ uint32_t softSerialRxBytesWaiting(const serialPort_t *instance) {
         return 0;
     }
     softSerial_t *s = (softSerial_t *)instance;
+    if (s->rxEdgeDecoding) {
+        serialDecodeRxEdges(s);
+    }
     return (s->port.rxBufferHead - s->port.rxBufferTail) & (s->port.rxBufferSize - 1);
 }
 
@@ -520,7 +770,8 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch) {
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate) {
     softSerial_t *softSerial = (softSerial_t *)s;
     softSerial->port.baudRate = baudRate;
-    serialTimerConfigureTimebase(softSerial->timerHardware, baudRate);
+    softSerial->bitTicks = serialTimerConfigureTimebase(softSerial->timerHardware, baudRate);
+    softSerialDecoderInit(&softSerial->rxDecoder, softSerial->bitTicks);
 }
 
 void softSerialSetMode(serialPort_t *instance, portMode_e mode) {
@@ -0,0 +1,106 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Software UART receive decoder.
+ *
+ *   The interrupt only timestamps the line edges. Bytes are rebuilt later
+ * by sampling the line level in the middle of each bit, counted from the
+ * falling edge of the start bit. A byte that ends with high bits has no
+ * closing edge, so it completes once the decoder is given a time past its
+ * stop bit.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "drivers/serial_softserial_decoder.h"
+
+#define EDGE_INDEX_MASK (SOFTSERIAL_EDGE_BUFFER_SIZE - 1)
+#define EDGE_LEVEL_MASK 1
+
+void softSerialDecoderInit(softSerialDecoder_t *decoder, uint32_t bitTicks) {
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->bitTicks = bitTicks;
+    decoder->level = 1;
+}
+
+// called from the input capture interrupt
+void softSerialDecoderPushEdge(softSerialDecoder_t *decoder, uint32_t time, uint8_t level) {
+    const uint8_t head = decoder->edgeHead;
+    const uint8_t next = (head + 1) & EDGE_INDEX_MASK;
+    if (next == decoder->edgeTail) {
+        decoder->edgeOverruns++;
+        return;
+    }
+    decoder->edges[head] = (time & ~EDGE_LEVEL_MASK) | (level & EDGE_LEVEL_MASK);
+    decoder->edgeHead = next;
+}
+
+// samples the bits of the current frame that lie before time, the line held its level up to then
+static uint32_t decodeUntil(softSerialDecoder_t *decoder, uint32_t time, softSerialRxByteFn *rxByteFn, void *data) {
+    while (decoder->inFrame) {
+        const uint32_t sampleAt = decoder->frameStart + (2 * decoder->bitIndex + 1) * decoder->bitTicks / 2;
+        if ((int32_t)(time - sampleAt) <= 0) {
+            return 0;
+        }
+        if (decoder->level) {
+            decoder->frameBits |= 1 << decoder->bitIndex;
+        }
+        decoder->bitIndex++;
+        if (decoder->bitIndex == 1 && (decoder->frameBits & 1)) {
+            // the start bit was a glitch
+            decoder->framingErrors++;
+            decoder->inFrame = false;
+        } else if (decoder->bitIndex == SOFTSERIAL_FRAME_BITS) {
+            decoder->inFrame = false;
+            if (decoder->frameBits & (1 << (SOFTSERIAL_FRAME_BITS - 1))) {
+                rxByteFn((decoder->frameBits >> 1) & 0xFF, data);
+                return 1;
+            }
+            decoder->framingErrors++;
+        }
+    }
+    return 0;
+}
+
+// decodes all recorded edges, returns the number of bytes passed to rxByteFn
+uint32_t softSerialDecoderProcess(softSerialDecoder_t *decoder, uint32_t now, softSerialRxByteFn *rxByteFn, void *data) {
+    uint32_t count = 0;
+    uint8_t tail = decoder->edgeTail;
+    while (tail != decoder->edgeHead) {
+        const uint32_t edge = decoder->edges[tail];
+        tail = (tail + 1) & EDGE_INDEX_MASK;
+        const uint32_t time = edge & ~EDGE_LEVEL_MASK;
+        count += decodeUntil(decoder, time, rxByteFn, data);
+        decoder->level = edge & EDGE_LEVEL_MASK;
+        if (!decoder->inFrame && !decoder->level) {
+            decoder->inFrame = true;
+            decoder->frameStart = time;
+            decoder->frameBits = 0;
+            decoder->bitIndex = 0;
+        }
+    }
+    decoder->edgeTail = tail;
+    // edges recorded after now was taken are already decoded, sampling stops at the last of them
+    count += decodeUntil(decoder, now, rxByteFn, data);
+    return count;
+}
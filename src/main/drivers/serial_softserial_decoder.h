@@ -0,0 +1,50 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SOFTSERIAL_EDGE_BUFFER_SIZE 128 // power of 2, a byte has at most 10 edges
+#define SOFTSERIAL_FRAME_BITS       10  // start bit, 8 data bits, stop bit
+
+typedef void softSerialRxByteFn(uint8_t byte, void *data);
+
+// Receive edges recorded by the input capture interrupt and decoded from a
+// task. Each edge holds its time in bit clock ticks with the line level
+// after the edge in bit 0, 1 being the idle level.
+typedef struct softSerialDecoder_s {
+    volatile uint32_t edges[SOFTSERIAL_EDGE_BUFFER_SIZE];
+    volatile uint8_t edgeHead;  // written by the interrupt
+    volatile uint8_t edgeTail;  // written by the decoder
+    uint32_t bitTicks;
+    uint32_t frameStart;
+    uint16_t frameBits;
+    uint8_t bitIndex;
+    uint8_t level;
+    bool inFrame;
+    uint16_t edgeOverruns;
+    uint16_t framingErrors;
+} softSerialDecoder_t;
+
+void softSerialDecoderInit(softSerialDecoder_t *decoder, uint32_t bitTicks);
+void softSerialDecoderPushEdge(softSerialDecoder_t *decoder, uint32_t time, uint8_t level);
+uint32_t softSerialDecoderProcess(softSerialDecoder_t *decoder, uint32_t now, softSerialRxByteFn *rxByteFn, void *data);
@@ -27,12 +27,18 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/uio.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "io/serial.h"
@@ -51,10 +57,18 @@ static void onData(dyad_Event *e) {
     tcpPort_t* s = (tcpPort_t*)(e->udata);
     tcpDataIn(s, (uint8_t*)e->data, e->size);
 }
+// dyad closes its socket before the close event fires, the writers only ever use
+// the port's own copy, which is released here under the lock
 static void onClose(dyad_Event *e) {
     tcpPort_t* s = (tcpPort_t*)(e->udata);
-    s->clientCount--;
+    pthread_mutex_lock(&s->connLock);
+    if (s->connFd >= 0) {
+        close(s->connFd);
+        s->connFd = -1;
+    }
     s->conn = NULL;
+    pthread_mutex_unlock(&s->connLock);
+    s->clientCount--;
     fprintf(stderr, "[CLS]UART%u: %d,%d\n", s->id + 1, s->connected, s->clientCount);
     if (s->clientCount == 0) {
         s->connected = false;
@@ -70,33 +84,76 @@ static void onAccept(dyad_Event *e) {
     }
     s->clientCount++;
     fprintf(stderr, "[NEW]UART%u: %d,%d\n", s->id + 1, s->connected, s->clientCount);
+    pthread_mutex_lock(&s->connLock);
     s->conn = e->remote;
+    s->connFd = dup((int)dyad_getSocket(e->remote));
+    pthread_mutex_unlock(&s->connLock);
     dyad_setNoDelay(e->remote, 1);
     dyad_setTimeout(e->remote, 120);
     dyad_addListener(e->remote, DYAD_EVENT_DATA, onData, e->udata);
     dyad_addListener(e->remote, DYAD_EVENT_CLOSE, onClose, e->udata);
 }
+
+// SITL_PTY holds the UART numbers to expose as pseudo terminals, e.g. "1,3"
+static bool tcpUsePty(int id) {
+    const char *list = getenv("SITL_PTY");
+    while (list && *list) {
+        char *end;
+        const long uart = strtol(list, &end, 10);
+        if (end == list) {
+            end++;
+        } else if (uart == id + 1) {
+            return true;
+        }
+        list = end;
+    }
+    return false;
+}
+
+static bool tcpOpenPty(tcpPort_t *s) {
+    const int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        fprintf(stderr, "pty for UART%u failed - %d\n", s->id + 1, errno);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    s->ptyFd = fd;
+    fprintf(stderr, "UART%u on %s\n", s->id + 1, ptsname(fd));
+    return true;
+}
+
 static tcpPort_t* tcpReconfigure(tcpPort_t *s, int id) {
     if (tcpPortInitialized[id]) {
         fprintf(stderr, "port is already initialized!\n");
         return s;
     }
-    if (pthread_mutex_init(&s->txLock, NULL) != 0) {
-        fprintf(stderr, "TX mutex init failed - %d\n", errno);
-        // TODO: clean up & re-init
-        return NULL;
-    }
-    if (pthread_mutex_init(&s->rxLock, NULL) != 0) {
-        fprintf(stderr, "RX mutex init failed - %d\n", errno);
-        // TODO: clean up & re-init
+    if (pthread_mutex_init(&s->connLock, NULL) != 0) {
+        fprintf(stderr, "connection mutex init failed - %d\n", errno);
         return NULL;
     }
+    spscRingInit(&s->rxRing, s->rxBuffer, RX_BUFFER_SIZE);
+    spscRingInit(&s->txRing, s->txBuffer, TX_BUFFER_SIZE);
     tcpStart = true;
     tcpPortInitialized[id] = true;
     s->connected = false;
     s->clientCount = 0;
     s->id = id;
     s->conn = NULL;
+    s->connFd = -1;
+    s->serv = NULL;
+    s->ptyFd = -1;
+    if (tcpUsePty(id) && tcpOpenPty(s)) {
+        s->connected = true;
+        return s;
+    }
     s->serv = dyad_newStream();
     dyad_setNoDelay(s->serv, 1);
     dyad_addListener(s->serv, DYAD_EVENT_ACCEPT, onAccept, s);
@@ -118,7 +175,7 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
     if (!s)
         return NULL;
     s->port.vTable = &tcpVTable;
-    // common serial initialisation code should move to serialPort::init()
+    // the rings keep their own indexes, the port only advertises the sizes
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
     s->port.rxBufferSize = RX_BUFFER_SIZE;
@@ -135,98 +192,137 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
 }
 
 uint32_t tcpTotalRxBytesWaiting(const serialPort_t *instance) {
-    tcpPort_t *s = (tcpPort_t*)instance;
-    uint32_t count;
-    pthread_mutex_lock(&s->rxLock);
-    if (s->port.rxBufferHead >= s->port.rxBufferTail) {
-        count = s->port.rxBufferHead - s->port.rxBufferTail;
-    } else {
-        count = s->port.rxBufferSize + s->port.rxBufferHead - s->port.rxBufferTail;
-    }
-    pthread_mutex_unlock(&s->rxLock);
-    return count;
+    const tcpPort_t *s = (const tcpPort_t*)instance;
+    return spscRingUsed(&s->rxRing);
 }
 
 uint32_t tcpTotalTxBytesFree(const serialPort_t *instance) {
-    tcpPort_t *s = (tcpPort_t*)instance;
-    uint32_t bytesUsed;
-    pthread_mutex_lock(&s->txLock);
-    if (s->port.txBufferHead >= s->port.txBufferTail) {
-        bytesUsed = s->port.txBufferHead - s->port.txBufferTail;
-    } else {
-        bytesUsed = s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
-    }
-    uint32_t bytesFree = (s->port.txBufferSize - 1) - bytesUsed;
-    pthread_mutex_unlock(&s->txLock);
-    return bytesFree;
+    const tcpPort_t *s = (const tcpPort_t*)instance;
+    return spscRingFree(&s->txRing);
 }
 
 bool isTcpTransmitBufferEmpty(const serialPort_t *instance) {
-    tcpPort_t *s = (tcpPort_t *)instance;
-    pthread_mutex_lock(&s->txLock);
-    bool isEmpty = s->port.txBufferTail == s->port.txBufferHead;
-    pthread_mutex_unlock(&s->txLock);
-    return isEmpty;
+    const tcpPort_t *s = (const tcpPort_t *)instance;
+    return spscRingUsed(&s->txRing) == 0;
 }
 
 uint8_t tcpRead(serialPort_t *instance) {
-    uint8_t ch;
     tcpPort_t *s = (tcpPort_t *)instance;
-    pthread_mutex_lock(&s->rxLock);
-    ch = s->port.rxBuffer[s->port.rxBufferTail];
-    if (s->port.rxBufferTail + 1 >= s->port.rxBufferSize) {
-        s->port.rxBufferTail = 0;
-    } else {
-        s->port.rxBufferTail++;
-    }
-    pthread_mutex_unlock(&s->rxLock);
+    uint8_t ch = 0;
+    spscRingGet(&s->rxRing, &ch);
     return ch;
 }
 
+// Writes only fill the ring, tcpPortsUpdate() hands them to the socket once per
+// scheduler pass. A full ring is flushed on the spot so big bursts still get out.
 void tcpWrite(serialPort_t *instance, uint8_t ch) {
     tcpPort_t *s = (tcpPort_t *)instance;
-    pthread_mutex_lock(&s->txLock);
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
+    if (!spscRingPut(&s->txRing, ch)) {
+        tcpDataOut(s);
+        if (!spscRingPut(&s->txRing, ch)) {
+            s->txDropped++;
+        }
     }
-    pthread_mutex_unlock(&s->txLock);
-    tcpDataOut(s);
+}
+
+static void tcpWriteBuf(serialPort_t *instance, const void *data, int count) {
+    tcpPort_t *s = (tcpPort_t *)instance;
+    const uint8_t *p = data;
+    while (count > 0) {
+        const uint32_t written = spscRingWrite(&s->txRing, p, count);
+        p += written;
+        count -= written;
+        if (count > 0) {
+            const uint32_t used = spscRingUsed(&s->txRing);
+            tcpDataOut(s);
+            if (spscRingUsed(&s->txRing) == used) {
+                // peer is not draining, drop the rest
+                s->txDropped += count;
+                break;
+            }
+        }
+    }
+}
+
+static void tcpBeginWrite(serialPort_t *instance) {
+    tcpPort_t *s = (tcpPort_t *)instance;
+    s->writeDepth++;
+}
+
+// a finished frame goes out early only when it would otherwise crowd the ring
+static void tcpEndWrite(serialPort_t *instance) {
+    tcpPort_t *s = (tcpPort_t *)instance;
+    if (s->writeDepth > 0 && --s->writeDepth == 0 && spscRingUsed(&s->txRing) > TX_BUFFER_SIZE / 2) {
+        tcpDataOut(s);
+    }
+}
+
+static ssize_t tcpPortWritev(tcpPort_t *s, const struct iovec *iov, int count) {
+    if (s->ptyFd >= 0) {
+        return writev(s->ptyFd, iov, count);
+    }
+    // the dyad thread may be closing the connection, hold the lock across the write
+    pthread_mutex_lock(&s->connLock);
+    ssize_t written = -1;
+    errno = ENOTCONN;
+    if (s->connFd >= 0) {
+        written = writev(s->connFd, iov, count);
+    }
+    pthread_mutex_unlock(&s->connLock);
+    return written;
 }
 
 void tcpDataOut(tcpPort_t *instance) {
     tcpPort_t *s = (tcpPort_t *)instance;
-    if (s->conn == NULL) return;
-    pthread_mutex_lock(&s->txLock);
-    if (s->port.txBufferHead < s->port.txBufferTail) {
-        // send data till end of buffer
-        int chunk = s->port.txBufferSize - s->port.txBufferTail;
-        dyad_write(s->conn, (const void *)&s->port.txBuffer[s->port.txBufferTail], chunk);
-        s->port.txBufferTail = 0;
+    const uint8_t *segment[2];
+    uint32_t segmentLen[2];
+    const int count = spscRingPeek(&s->txRing, segment, segmentLen);
+    if (count == 0) {
+        return;
+    }
+    struct iovec iov[2];
+    for (int i = 0; i < count; i++) {
+        iov[i].iov_base = (void *)segment[i];
+        iov[i].iov_len = segmentLen[i];
+    }
+    const ssize_t written = tcpPortWritev(s, iov, count);
+    if (written > 0) {
+        spscRingConsume(&s->txRing, written);
+    } else if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        // nobody listens, stale replies would only confuse the next client
+        spscRingDiscard(&s->txRing);
     }
-    int chunk = s->port.txBufferHead - s->port.txBufferTail;
-    if (chunk)
-        dyad_write(s->conn, (const void*)&s->port.txBuffer[s->port.txBufferTail], chunk);
-    s->port.txBufferTail = s->port.txBufferHead;
-    pthread_mutex_unlock(&s->txLock);
 }
 
 void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size) {
     tcpPort_t *s = (tcpPort_t *)instance;
-    pthread_mutex_lock(&s->rxLock);
-    while (size--) {
-//        printf("%c", *ch);
-        s->port.rxBuffer[s->port.rxBufferHead] = *(ch++);
-        if (s->port.rxBufferHead + 1 >= s->port.rxBufferSize) {
-            s->port.rxBufferHead = 0;
-        } else {
-            s->port.rxBufferHead++;
+    const uint32_t queued = spscRingWrite(&s->rxRing, ch, size);
+    s->rxDropped += size - queued;
+}
+
+static void tcpPtyIn(tcpPort_t *s) {
+    uint8_t buf[256];
+    uint32_t room;
+    ssize_t len;
+    while ((room = spscRingFree(&s->rxRing)) > 0 && (len = read(s->ptyFd, buf, MIN(sizeof(buf), room))) > 0) {
+        tcpDataIn(s, buf, len);
+    }
+}
+
+// called once per main loop pass
+void tcpPortsUpdate(void) {
+    for (int i = 0; i < SERIAL_PORT_COUNT; i++) {
+        if (!tcpPortInitialized[i]) {
+            continue;
+        }
+        tcpPort_t *s = &tcpSerialPorts[i];
+        if (s->ptyFd >= 0) {
+            tcpPtyIn(s);
+        }
+        if (spscRingUsed(&s->txRing)) {
+            tcpDataOut(s);
         }
     }
-    pthread_mutex_unlock(&s->rxLock);
-//    printf("\n");
 }
 
 static const struct serialPortVTable tcpVTable = {
@@ -239,7 +335,7 @@ static const struct serialPortVTable tcpVTable = {
     .setMode = NULL,
     .setCtrlLineStateCb = NULL,
     .setBaudRateCb = NULL,
-    .writeBuf = NULL,
-    .beginWrite = NULL,
-    .endWrite = NULL,
+    .writeBuf = tcpWriteBuf,
+    .beginWrite = tcpBeginWrite,
+    .endWrite = tcpEndWrite,
 };
@@ -24,18 +24,30 @@
 #include <pthread.h>
 #include "dyad.h"
 
-#define RX_BUFFER_SIZE    1400
-#define TX_BUFFER_SIZE    1400
+#include "common/spsc_ring.h"
+
+#include "drivers/serial.h"
+
+// ring sizes, powers of two
+#define RX_BUFFER_SIZE    2048
+#define TX_BUFFER_SIZE    4096
 
 typedef struct {
     serialPort_t port;
     uint8_t rxBuffer[RX_BUFFER_SIZE];
     uint8_t txBuffer[TX_BUFFER_SIZE];
 
+    spscRing_t rxRing;      // filled by the dyad thread, drained by the main loop
+    spscRing_t txRing;      // filled by the main loop, drained by tcpPortsUpdate()
+
     dyad_Stream *serv;
     dyad_Stream *conn;
-    pthread_mutex_t txLock;
-    pthread_mutex_t rxLock;
+    pthread_mutex_t connLock;   // guards connFd between the dyad thread and the writers
+    int connFd;             // copy of the client socket owned by the port, -1 when nobody is connected
+    int ptyFd;              // -1 unless the port is a pseudo terminal
+    uint8_t writeDepth;
+    uint32_t rxDropped;
+    uint32_t txDropped;
     bool connected;
     uint16_t clientCount;
     uint8_t id;
@@ -46,6 +58,7 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
 // tcpPort API
 void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size);
 void tcpDataOut(tcpPort_t *instance);
+void tcpPortsUpdate(void);
 
 bool tcpIsStart(void);
 bool* tcpGetUsed(void);
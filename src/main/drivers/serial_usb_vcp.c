@@ -20,13 +20,16 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "platform.h"
 
 #ifdef USE_VCP
 
 #include "build/build_config.h"
+#include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/io.h"
@@ -62,6 +65,7 @@ USBD_HandleTypeDef USBD_Device;
 
 
 #define USB_TIMEOUT  50
+#define USB_TX_STATS_WINDOW_MS 1000
 
 static vcpPort_t vcpPort;
 
@@ -89,11 +93,6 @@ static void usbVcpSetBaudRateCb(serialPort_t *instance, void (*cb)(serialPort_t
     CDC_SetBaudRateCb((void (*)(void *context, uint32_t baud))cb, (void *)context);
 }
 
-static bool isUsbVcpTransmitBufferEmpty(const serialPort_t *instance) {
-    UNUSED(instance);
-    return true;
-}
-
 static uint32_t usbVcpAvailable(const serialPort_t *instance) {
     UNUSED(instance);
     return CDC_Receive_BytesAvailable();
@@ -108,50 +107,109 @@ static uint8_t usbVcpRead(serialPort_t *instance) {
     }
 }
 
-static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count) {
-    UNUSED(instance);
-    if (!(usbIsConnected() && usbIsConfigured())) {
-        return;
+// Also called with no bytes when the stats are read, so the rate falls to zero on an idle port
+static void usbVcpCountTx(vcpPort_t *port, uint32_t bytes) {
+    port->txStats.bytes += bytes;
+    port->txWindowBytes += bytes;
+    const uint32_t now = millis();
+    const uint32_t windowMs = now - port->txWindowStartMs;
+    if (windowMs >= USB_TX_STATS_WINDOW_MS) {
+        port->txStats.bytesPerSecond = port->txWindowBytes * 1000 / windowMs;
+        port->txWindowBytes = 0;
+        port->txWindowStartMs = now;
+        DEBUG_SET(DEBUG_USB, 2, port->txStats.bytesPerSecond / 1024);
+        DEBUG_SET(DEBUG_USB, 3, port->txStats.dropped);
     }
-    uint32_t start = millis();
-    const uint8_t *p = data;
-    while (count > 0) {
-        uint32_t txed = CDC_Send_DATA(p, count);
-        count -= txed;
-        p += txed;
+}
+
+// Sends what the USB stack takes without waiting, returns true once the draining buffer is empty
+static bool usbVcpDrain(vcpPort_t *port) {
+    const uint8_t drain = port->txFill ^ 1;
+    const uint16_t count = port->txAt[drain] - port->txDrained;
+    if (count > 0) {
+        if (usbIsConnected() && usbIsConfigured()) {
+            const uint32_t txed = CDC_Send_DATA(&port->txBuf[drain][port->txDrained], MIN(count, CDC_Send_FreeBytes()));
+            port->txDrained += txed;
+            usbVcpCountTx(port, txed);
+        } else {
+            port->txStats.dropped += count;
+            port->txDrained = port->txAt[drain];
+        }
+    }
+    if (port->txDrained < port->txAt[drain]) {
+        return false;
+    }
+    port->txAt[drain] = 0;
+    port->txDrained = 0;
+    return true;
+}
+
+static bool usbVcpWaitDrained(vcpPort_t *port) {
+    const uint32_t start = millis();
+    while (!usbVcpDrain(port)) {
         if (millis() - start > USB_TIMEOUT) {
-            break;
+            const uint8_t drain = port->txFill ^ 1;
+            port->txStats.dropped += port->txAt[drain] - port->txDrained;
+            port->txAt[drain] = 0;
+            port->txDrained = 0;
+            return false;
         }
     }
+    return true;
+}
+
+// Starts draining the filled buffer, the other one takes the next writes
+static void usbVcpSwap(vcpPort_t *port) {
+    if (!usbVcpDrain(port)) {
+        port->txStats.stalls++;
+        usbVcpWaitDrained(port);
+    }
+    port->txFill ^= 1;
+    usbVcpDrain(port);
 }
 
 static bool usbVcpFlush(vcpPort_t *port) {
-    uint32_t count = port->txAt;
-    port->txAt = 0;
-    if (count == 0) {
-        return true;
-    }
-    if (!usbIsConnected() || !usbIsConfigured()) {
-        return false;
+    usbVcpSwap(port);
+    return usbVcpWaitDrained(port);
+}
+
+// Moves buffered bytes along without waiting, so callers polling for an empty buffer see it drain
+static bool isUsbVcpTransmitBufferEmpty(const serialPort_t *instance) {
+    UNUSED(instance);
+    vcpPort_t *port = &vcpPort;
+    if (usbVcpDrain(port) && port->txAt[port->txFill] > 0) {
+        port->txFill ^= 1;
+        usbVcpDrain(port);
     }
-    uint32_t start = millis();
-    uint8_t *p = port->txBuf;
+    return port->txAt[0] == 0 && port->txAt[1] == 0;
+}
+
+static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count) {
+    vcpPort_t *port = container_of(instance, vcpPort_t, port);
+    const uint8_t *p = data;
     while (count > 0) {
-        uint32_t txed = CDC_Send_DATA(p, count);
-        count -= txed;
-        p += txed;
-        if (millis() - start > USB_TIMEOUT) {
-            break;
+        uint16_t *txAt = &port->txAt[port->txFill];
+        const int len = MIN(count, USB_VCP_TX_BUFFER_SIZE - *txAt);
+        memcpy(&port->txBuf[port->txFill][*txAt], p, len);
+        *txAt += len;
+        p += len;
+        count -= len;
+        if (*txAt >= USB_VCP_TX_BUFFER_SIZE) {
+            usbVcpSwap(port);
         }
     }
-    return count == 0;
+    if (!port->buffering) {
+        usbVcpFlush(port);
+    }
 }
 
 static void usbVcpWrite(serialPort_t *instance, uint8_t c) {
     vcpPort_t *port = container_of(instance, vcpPort_t, port);
-    port->txBuf[port->txAt++] = c;
-    if (!port->buffering || port->txAt >= ARRAYLEN(port->txBuf)) {
+    port->txBuf[port->txFill][port->txAt[port->txFill]++] = c;
+    if (!port->buffering) {
         usbVcpFlush(port);
+    } else if (port->txAt[port->txFill] >= USB_VCP_TX_BUFFER_SIZE) {
+        usbVcpSwap(port);
     }
 }
 
@@ -242,4 +300,9 @@ uint32_t usbVcpGetBaudRate(serialPort_t *instance) {
 uint8_t usbVcpIsConnected(void) {
     return usbIsConnected();
 }
+
+const vcpTxStats_t *usbVcpGetTxStats(void) {
+    usbVcpCountTx(&vcpPort, 0);
+    return &vcpPort.txStats;
+}
 #endif
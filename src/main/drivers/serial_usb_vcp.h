@@ -30,17 +30,33 @@
 extern USBD_HandleTypeDef  USBD_Device;
 #endif
 
+#define USB_VCP_TX_BUFFER_SIZE 256 // multiple of the 64 byte bulk packet
+
+typedef struct {
+    uint32_t bytes;             // handed to the USB stack
+    uint32_t dropped;           // lost to a timeout or a missing host
+    uint32_t stalls;            // writes that had to wait for the other buffer to drain
+    uint32_t bytesPerSecond;    // over the last complete second
+} vcpTxStats_t;
+
 typedef struct {
     serialPort_t port;
 
-    // Buffer used during bulk writes.
-    uint8_t txBuf[20];
-    uint8_t txAt;
+    // Ping-pong buffers, one is filled while the other drains into the USB stack.
+    uint8_t txBuf[2][USB_VCP_TX_BUFFER_SIZE];
+    uint16_t txAt[2];
+    uint16_t txDrained;         // bytes of the draining buffer already sent
+    uint8_t txFill;             // index of the buffer being filled
     // Set if the port is in bulk write mode and can buffer.
     bool buffering;
+
+    vcpTxStats_t txStats;
+    uint32_t txWindowBytes;
+    uint32_t txWindowStartMs;
 } vcpPort_t;
 
 serialPort_t *usbVcpOpen(void);
 struct serialPort_s;
 uint32_t usbVcpGetBaudRate(struct serialPort_s *instance);
 uint8_t usbVcpIsConnected(void);
+const vcpTxStats_t *usbVcpGetTxStats(void);
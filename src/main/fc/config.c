@@ -243,6 +243,7 @@ static void validateAndFixConfig(void) {
               || rxConfig()->rcInterpolationChannels == INTERPOLATION_CHANNELS_RPT)) {
         for (unsigned i = 0; i < PID_PROFILE_COUNT; i++) {
             pidProfilesMutable(i)->throttle_boost = 0;
+            pidMarkProfileDirty(i);
         }
     }
 #endif
@@ -270,6 +271,7 @@ static void validateAndFixConfig(void) {
 
     if (currentPidProfile->horizonTransition >= currentPidProfile->horizon_tilt_effect) {
         pidProfilesMutable(systemConfig()->pidProfileIndex)->horizonTransition = MAX(currentPidProfile->horizon_tilt_effect - 20, 0);
+        pidMarkProfileDirty(systemConfig()->pidProfileIndex);
     }
 // clear features that are not supported.
 // I have kept them all here in one place, some could be moved to sections of code above.
@@ -574,9 +576,8 @@ void changePidProfile(uint8_t pidProfileIndex) {
     if (pidProfileIndex < PID_PROFILE_COUNT) {
         systemConfigMutable()->pidProfileIndex = pidProfileIndex;
         loadPidProfile();
-        pidInit(currentPidProfile);
+        pidSwitchProfile(pidProfileIndex);
         initEscEndpoints();
-        mixerInitProfile();
     }
     beeperConfirmationBeeps(pidProfileIndex + 1);
 }
@@ -147,6 +147,7 @@
 #include "sensors/compass.h"
 #include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_spectrum.h"
 #include "sensors/initialisation.h"
 #include "sensors/sensors.h"
 
@@ -446,6 +447,9 @@ void init(void) {
     if (sensors(SENSOR_ACC)) {
         accInitFilters();
     }
+#ifdef USE_GYRO_SPECTRUM
+    gyroSpectrumInit(gyro.targetLooptime);
+#endif
 #ifdef USE_PID_AUDIO
     pidAudioInit();
 #endif
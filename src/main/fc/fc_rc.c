@@ -294,7 +294,11 @@ FAST_CODE uint8_t processRcInterpolation(void) {
 
 void updateRcRefreshRate(timeUs_t currentTimeUs) {
     static timeUs_t lastRxTimeUs;
-    timeDelta_t refreshRateUs = cmpTimeUs(currentTimeUs, lastRxTimeUs); // calculate a delta here if not supplied by the protocol
+    // frame to frame time from the receiver, so RX task latency does not show up as jitter
+    timeDelta_t refreshRateUs = rxGetFrameDelta();
+    if (refreshRateUs == 0) {
+        refreshRateUs = cmpTimeUs(currentTimeUs, lastRxTimeUs); // calculate a delta here if not supplied by the receiver
+    }
     lastRxTimeUs = currentTimeUs;
     currentRxRefreshRate = constrain(refreshRateUs, 1000, 30000);
 }
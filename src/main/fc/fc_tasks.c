@@ -36,6 +36,7 @@
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/camera_control.h"
 #include "drivers/compass/compass.h"
+#include "drivers/flash.h"
 #include "drivers/dma_spi.h"
 #include "drivers/sensor.h"
 #include "drivers/serial.h"
@@ -71,6 +72,7 @@
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
 #include "io/dashboard.h"
+#include "io/flashfs.h"
 #include "io/gps.h"
 #include "io/ledstrip.h"
 #include "io/osd.h"
@@ -95,6 +97,7 @@
 #include "sensors/compass.h"
 #include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_spectrum.h"
 #include "sensors/sensors.h"
 #include "sensors/rangefinder.h"
 
@@ -325,6 +328,12 @@ void fcTasksInit(void) {
 #ifdef USE_BEESIGN
     setTaskEnabled(TASK_BEESIGN, true);
 #endif
+#ifdef USE_GYRO_SPECTRUM
+    setTaskEnabled(TASK_GYRO_SPECTRUM, gyroSpectrumIsEnabled());
+#endif
+#if defined(USE_FLASHFS) && defined(USE_FLASH_W25N01G)
+    setTaskEnabled(TASK_FLASHFS, flashfsGetGeometry()->flashType == FLASH_TYPE_NAND);
+#endif
 #ifdef USE_CMS
 #ifdef USE_MSP_DISPLAYPORT
     setTaskEnabled(TASK_CMS, true);
@@ -629,5 +638,23 @@ FAST_RAM cfTask_t cfTasks[TASK_COUNT] = {
     },
 #endif
 
+#ifdef USE_GYRO_SPECTRUM
+    [TASK_GYRO_SPECTRUM] = {
+        .taskName = "GYRO_SPECTRUM",
+        .taskFunc = gyroSpectrumUpdate,
+        .desiredPeriod = TASK_PERIOD_HZ(500),       // one axis of a window per run
+        .staticPriority = TASK_PRIORITY_IDLE
+    },
+#endif
+
+#if defined(USE_FLASHFS) && defined(USE_FLASH_W25N01G)
+    [TASK_FLASHFS] = {
+        .taskName = "FLASHFS",
+        .taskFunc = flashfsEraseUpdate,
+        .desiredPeriod = TASK_PERIOD_HZ(250),       // a block erase takes 2-10ms
+        .staticPriority = TASK_PRIORITY_LOW
+    },
+#endif
+
 #endif
 };
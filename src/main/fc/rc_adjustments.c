@@ -48,6 +48,7 @@
 #include "fc/config.h"
 #include "fc/controlrate_profile.h"
 #include "fc/rc_controls.h"
+#include "fc/rc_range_table.h"
 #include "fc/fc_rc.h"
 
 #include "pg/pg.h"
@@ -568,6 +569,12 @@ static uint8_t applySelectAdjustment(adjustmentFunction_e adjustmentFunction, ui
 
 #define RESET_FREQUENCY_2HZ (1000 / 2)
 
+static rcRangeTable_t adjustmentRangeTable;
+
+static bool isAdjustmentRangeActive(int index) {
+    return adjustmentRangeTable.active & (1U << index);
+}
+
 void processRcAdjustments(controlRateConfig_t *controlRateConfig) {
     const uint32_t now = millis();
     int newValue = -1;
@@ -639,7 +646,7 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig) {
         if ((rcData[channelIndex] != lastRcData[index]) &&
                 adjustmentRange->adjustmentCenter &&
                 (adjustmentConfig->mode == ADJUSTMENT_MODE_STEP) &&
-                isRangeActive(adjustmentRange->auxChannelIndex, &adjustmentRange->range)) {
+                isAdjustmentRangeActive(index)) {
             int value = (((rcData[channelIndex] - PWM_RANGE_MIDDLE) * adjustmentRange->adjustmentScale) / (PWM_RANGE_MIDDLE - PWM_RANGE_MIN)) + adjustmentRange->adjustmentCenter;
             lastRcData[index] = rcData[channelIndex];
             applyAbsoluteAdjustment(controlRateConfig, adjustmentRange->adjustmentFunction, value);
@@ -648,15 +655,36 @@ void processRcAdjustments(controlRateConfig_t *controlRateConfig) {
     }
 }
 
+// compiles the ranges into the channel lookup, call after they changed
+void analyzeAdjustmentRanges(void) {
+    rcRangeTableReset(&adjustmentRangeTable);
+    for (int index = 0; index < MAX_ADJUSTMENT_RANGE_COUNT; index++) {
+        const adjustmentRange_t * const adjustmentRange = adjustmentRanges(index);
+        if (adjustmentRange->adjustmentFunction != ADJUSTMENT_NONE) {
+            rcRangeTableAdd(&adjustmentRangeTable, index, adjustmentRange->auxChannelIndex, &adjustmentRange->range);
+        }
+    }
+    rcRangeTableBuild(&adjustmentRangeTable);
+}
+
 void resetAdjustmentStates(void) {
     memset(adjustmentStates, 0, sizeof(adjustmentStates));
+    // the slots have to be configured again from the current switch positions
+    analyzeAdjustmentRanges();
 }
 
 void updateAdjustmentStates(void) {
+    if (!adjustmentRangeTable.built) {
+        analyzeAdjustmentRanges();
+    }
+    // slots stay configured, so only ranges that became active need a look
+    if (!rcRangeTableUpdate(&adjustmentRangeTable, &rcData[NON_AUX_CHANNEL_COUNT])) {
+        return;
+    }
     for (int index = 0; index < MAX_ADJUSTMENT_RANGE_COUNT; index++) {
         const adjustmentRange_t * const adjustmentRange = adjustmentRanges(index);
         // Only use slots if center value has not been specified, otherwise apply values directly (scaled) from aux channel
-        if (isRangeActive(adjustmentRange->auxChannelIndex, &adjustmentRange->range) &&
+        if (isAdjustmentRangeActive(index) &&
                 (adjustmentRange->adjustmentCenter == 0)) {
             const adjustmentConfig_t *adjustmentConfig = &defaultAdjustmentConfigs[adjustmentRange->adjustmentFunction - ADJUSTMENT_FUNCTION_CONFIG_INDEX_OFFSET];
             configureAdjustment(adjustmentRange->adjustmentIndex, adjustmentRange->auxSwitchChannelIndex, adjustmentConfig);
@@ -45,6 +45,7 @@
 #include "fc/config.h"
 #include "fc/fc_core.h"
 #include "fc/rc_controls.h"
+#include "fc/rc_modes.h"
 #include "fc/fc_rc.h"
 #include "fc/runtime_config.h"
 
@@ -365,4 +366,5 @@ int32_t getRcStickDeflection(int32_t axis, uint16_t midrc) {
 
 void rcControlsInit(void) {
     isUsingSticksToArm = !isModeActivationConditionPresent(BOXARM);
+    analyzeModeActivationConditions();
 }
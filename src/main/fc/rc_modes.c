@@ -26,6 +26,7 @@
 
 #include "common/bitarray.h"
 #include "common/maths.h"
+#include "common/utils.h"
 
 #include "drivers/time.h"
 
@@ -33,6 +34,7 @@
 
 #include "fc/config.h"
 #include "fc/rc_controls.h"
+#include "fc/rc_range_table.h"
 
 #include "io/piniobox.h"
 
@@ -75,57 +77,140 @@ bool isRangeActive(uint8_t auxChannelIndex, const channelRange_t *range) {
             channelValue < 900 + (range->endStep * 25));
 }
 
-void updateMasksForMac(const modeActivationCondition_t *mac, boxBitmask_t *andMask, boxBitmask_t *newMask) {
+// result of one mode with plain OR/AND conditions, see updateMasksForMac() for the rules
+typedef struct modeActivationLogic_s {
+    boxId_e modeId;
+    bool hasAnd;
+    uint32_t orMacs;        // conditions before the first AND condition
+    uint32_t andMacs;       // the first AND condition and all after it
+} modeActivationLogic_t;
+
+static rcRangeTable_t modeRangeTable;
+static modeActivationLogic_t modeLogics[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+static uint8_t modeLogicCount;
+static uint32_t stickyMacs;
+static uint32_t linkedMacs;
+
+static bool isMacActive(int macIndex) {
+    return modeRangeTable.active & (1U << macIndex);
+}
+
+static void updateMasksForMac(const modeActivationCondition_t *mac, bool bAct, boxBitmask_t *andMask, boxBitmask_t *newMask) {
     bool bAnd = (mac->modeLogic == MODELOGIC_AND) || bitArrayGet(andMask, mac->modeId);
-    bool bAct = isRangeActive(mac->auxChannelIndex, &mac->range);
     if (bAnd)
         bitArraySet(andMask, mac->modeId);
     if (bAnd != bAct)
         bitArraySet(newMask, mac->modeId);
 }
 
-void updateMasksForStickyModes(const modeActivationCondition_t *mac, boxBitmask_t *andMask, boxBitmask_t *newMask) {
+static void updateMasksForStickyModes(const modeActivationCondition_t *mac, bool bAct, boxBitmask_t *andMask, boxBitmask_t *newMask) {
     if (IS_RC_MODE_ACTIVE(mac->modeId)) {
         bitArrayClr(andMask, mac->modeId);
         bitArraySet(newMask, mac->modeId);
     } else {
         if (bitArrayGet(&stickyModesEverDisabled, mac->modeId)) {
-            updateMasksForMac(mac, andMask, newMask);
+            updateMasksForMac(mac, bAct, andMask, newMask);
         } else {
-            if (micros() >= STICKY_MODE_BOOT_DELAY_US && !isRangeActive(mac->auxChannelIndex, &mac->range)) {
+            if (micros() >= STICKY_MODE_BOOT_DELAY_US && !bAct) {
                 bitArraySet(&stickyModesEverDisabled, mac->modeId);
             }
         }
     }
 }
 
-void updateActivatedModes(void) {
-    boxBitmask_t newMask, andMask, stickyModes;
-    memset(&andMask, 0, sizeof(andMask));
-    memset(&newMask, 0, sizeof(newMask));
+static modeActivationLogic_t *findModeLogic(boxId_e modeId) {
+    for (int i = 0; i < modeLogicCount; i++) {
+        if (modeLogics[i].modeId == modeId) {
+            return &modeLogics[i];
+        }
+    }
+    modeActivationLogic_t *logic = &modeLogics[modeLogicCount++];
+    memset(logic, 0, sizeof(*logic));
+    logic->modeId = modeId;
+    return logic;
+}
+
+// compiles the conditions into the channel lookup and the per mode logic, call after they changed
+void analyzeModeActivationConditions(void) {
+    boxBitmask_t stickyModes;
     memset(&stickyModes, 0, sizeof(stickyModes));
     bitArraySet(&stickyModes, BOXPARALYZE);
-    // determine which conditions set/clear the mode
+    rcRangeTableReset(&modeRangeTable);
+    modeLogicCount = 0;
+    stickyMacs = 0;
+    linkedMacs = 0;
     for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
         const modeActivationCondition_t *mac = modeActivationConditions(i);
-        // Skip linked macs for now to fully determine target states
         if (mac->linkedTo) {
+            // linked conditions copy their target after all others are resolved
+            if (mac->modeId < CHECKBOX_ITEM_COUNT && mac->linkedTo < CHECKBOX_ITEM_COUNT) {
+                linkedMacs |= 1U << i;
+            }
+            continue;
+        }
+        if (mac->modeId >= CHECKBOX_ITEM_COUNT) {
             continue;
         }
+        rcRangeTableAdd(&modeRangeTable, i, mac->auxChannelIndex, &mac->range);
         if (bitArrayGet(&stickyModes, mac->modeId)) {
-            updateMasksForStickyModes(mac, &andMask, &newMask);
-        } else if (mac->modeId < CHECKBOX_ITEM_COUNT) {
-            updateMasksForMac(mac, &andMask, &newMask);
+            stickyMacs |= 1U << i;
+            continue;
+        }
+        // conditions that can never be active still count for the AND logic
+        modeActivationLogic_t *logic = findModeLogic(mac->modeId);
+        if (mac->modeLogic == MODELOGIC_AND) {
+            logic->hasAnd = true;
+        }
+        if (logic->hasAnd) {
+            logic->andMacs |= 1U << i;
+        } else {
+            logic->orMacs |= 1U << i;
+        }
+    }
+    rcRangeTableBuild(&modeRangeTable);
+}
+
+void updateActivatedModes(void) {
+    if (!modeRangeTable.built) {
+        analyzeModeActivationConditions();
+    }
+    // only channels that crossed into another segment change the result, sticky modes also depend on time
+    if (!rcRangeTableUpdate(&modeRangeTable, &rcData[NON_AUX_CHANNEL_COUNT]) && !stickyMacs) {
+        return;
+    }
+    const uint32_t activeMacs = modeRangeTable.active;
+    boxBitmask_t newMask;
+    memset(&newMask, 0, sizeof(newMask));
+    for (int i = 0; i < modeLogicCount; i++) {
+        const modeActivationLogic_t *logic = &modeLogics[i];
+        // OR: any condition active. AND: none before the first AND and all after it active
+        const bool active = logic->hasAnd
+            ? !(activeMacs & logic->orMacs) && (activeMacs & logic->andMacs) == logic->andMacs
+            : (activeMacs & logic->orMacs);
+        if (active) {
+            bitArraySet(&newMask, logic->modeId);
+        }
+    }
+    if (stickyMacs) {
+        boxBitmask_t stickyMask, andMask;
+        memset(&stickyMask, 0, sizeof(stickyMask));
+        memset(&andMask, 0, sizeof(andMask));
+        for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
+            if (stickyMacs & (1U << i)) {
+                updateMasksForStickyModes(modeActivationConditions(i), isMacActive(i), &andMask, &stickyMask);
+            }
+        }
+        bitArrayXor(&stickyMask, sizeof(stickyMask), &stickyMask, &andMask);
+        for (unsigned i = 0; i < ARRAYLEN(newMask.bits); i++) {
+            newMask.bits[i] |= stickyMask.bits[i];
         }
     }
-    bitArrayXor(&newMask, sizeof(&newMask), &newMask, &andMask);
     // Update linked modes
-    for (int i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
-        const modeActivationCondition_t *mac = modeActivationConditions(i);
-        if (!mac->linkedTo) {
-            continue;
+    for (int i = 0; linkedMacs >> i; i++) {
+        if (linkedMacs & (1U << i)) {
+            const modeActivationCondition_t *mac = modeActivationConditions(i);
+            bitArrayCopy(&newMask, mac->linkedTo, mac->modeId);
         }
-        bitArrayCopy(&newMask, mac->linkedTo, mac->modeId);
     }
     rcModeUpdate(&newMask);
 }
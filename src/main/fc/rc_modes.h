@@ -74,6 +74,7 @@ typedef enum {
     BOXUSER3,
     BOXUSER4,
     BOXPIDAUDIO,
+    BOXBLACKBOXBURST,
     CHECKBOX_ITEM_COUNT
 } boxId_e;
 
@@ -129,6 +130,7 @@ void rcModeUpdate(boxBitmask_t *newState);
 bool isAirmodeActive(void);
 
 bool isRangeActive(uint8_t auxChannelIndex, const channelRange_t *range);
+void analyzeModeActivationConditions(void);
 void updateActivatedModes(void);
 bool isModeActivationConditionPresent(boxId_e modeId);
 void removeModeActivationCondition(boxId_e modeId);
@@ -0,0 +1,121 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Channel range lookup for the mode activation conditions and adjustment ranges.
+ *
+ *   The ranges are compiled when the configuration is loaded. Every aux
+ * channel used by a range gets a table from channel step to segment, where
+ * a segment is a run of steps with the same set of active ranges. At run
+ * time a channel costs one lookup, and the active mask is only rebuilt
+ * when a channel moved into another segment.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "fc/rc_range_table.h"
+
+void rcRangeTableReset(rcRangeTable_t *table) {
+    memset(table, 0, sizeof(*table));
+}
+
+static int rcRangeTableSlot(rcRangeTable_t *table, uint8_t auxChannelIndex) {
+    for (int slot = 0; slot < table->channelCount; slot++) {
+        if (table->channels[slot] == auxChannelIndex) {
+            return slot;
+        }
+    }
+    table->channels[table->channelCount] = auxChannelIndex;
+    return table->channelCount++;
+}
+
+// ranges that can never be active are not stored, returns false if the range is not tracked
+bool rcRangeTableAdd(rcRangeTable_t *table, uint8_t bit, uint8_t auxChannelIndex, const channelRange_t *range) {
+    if (!IS_RANGE_USABLE(range) || auxChannelIndex >= MAX_AUX_CHANNEL_COUNT
+        || bit >= RC_RANGE_TABLE_MAX_RANGES || table->rangeCount >= RC_RANGE_TABLE_MAX_RANGES) {
+        return false;
+    }
+    rcRangeTableEntry_t *entry = &table->ranges[table->rangeCount++];
+    entry->bit = bit;
+    entry->slot = rcRangeTableSlot(table, auxChannelIndex);
+    entry->range = *range;
+    return true;
+}
+
+static uint32_t rcRangeTableMaskAt(const rcRangeTable_t *table, uint8_t slot, uint8_t step) {
+    uint32_t mask = 0;
+    for (int i = 0; i < table->rangeCount; i++) {
+        const rcRangeTableEntry_t *entry = &table->ranges[i];
+        if (entry->slot == slot && step >= entry->range.startStep && step < entry->range.endStep) {
+            mask |= 1U << entry->bit;
+        }
+    }
+    return mask;
+}
+
+void rcRangeTableBuild(rcRangeTable_t *table) {
+    table->segmentCount = 0;
+    for (int slot = 0; slot < table->channelCount; slot++) {
+        uint32_t previous = 0;
+        for (int step = 0; step < RC_RANGE_TABLE_STEP_COUNT; step++) {
+            const uint32_t mask = rcRangeTableMaskAt(table, slot, step);
+            if (step == 0 || mask != previous) {
+                table->segments[table->segmentCount++] = mask;
+                previous = mask;
+            }
+            table->segmentOfStep[slot][step] = table->segmentCount - 1;
+        }
+        table->currentSegment[slot] = RC_RANGE_TABLE_NO_SEGMENT;
+    }
+    table->active = 0;
+    table->built = true;
+    // the first update reports a change so the users start from the new configuration
+    table->dirty = true;
+}
+
+// auxChannels points at the first aux channel, returns true if the active mask changed
+bool rcRangeTableUpdate(rcRangeTable_t *table, const int16_t *auxChannels) {
+    bool moved = false;
+    for (int slot = 0; slot < table->channelCount; slot++) {
+        const uint16_t channelValue = constrain(auxChannels[table->channels[slot]], CHANNEL_RANGE_MIN, CHANNEL_RANGE_MAX - 1);
+        const uint8_t segment = table->segmentOfStep[slot][(channelValue - CHANNEL_RANGE_MIN) / 25];
+        if (segment != table->currentSegment[slot]) {
+            table->currentSegment[slot] = segment;
+            moved = true;
+        }
+    }
+    if (!moved && !table->dirty) {
+        return false;
+    }
+    uint32_t active = 0;
+    for (int slot = 0; slot < table->channelCount; slot++) {
+        active |= table->segments[table->currentSegment[slot]];
+    }
+    const bool changed = active != table->active || table->dirty;
+    table->active = active;
+    table->dirty = false;
+    return changed;
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "fc/rc_modes.h"
+
+#include "rx/rx.h"
+
+#define RC_RANGE_TABLE_MAX_RANGES       32  // one bit each in the active mask
+#define RC_RANGE_TABLE_STEP_COUNT       MAX_MODE_RANGE_STEP
+// every range splits its channel in at most two more places
+#define RC_RANGE_TABLE_SEGMENT_COUNT    (2 * RC_RANGE_TABLE_MAX_RANGES + MAX_AUX_CHANNEL_COUNT)
+#define RC_RANGE_TABLE_NO_SEGMENT       0xFF
+
+typedef struct rcRangeTableEntry_s {
+    uint8_t bit;
+    uint8_t slot;
+    channelRange_t range;
+} rcRangeTableEntry_t;
+
+// Channel ranges compiled into per aux channel lookup tables. Each channel
+// step maps to a segment, each segment holds the ranges active in it.
+typedef struct rcRangeTable_s {
+    uint8_t rangeCount;
+    rcRangeTableEntry_t ranges[RC_RANGE_TABLE_MAX_RANGES];
+    uint8_t channelCount;
+    uint8_t channels[MAX_AUX_CHANNEL_COUNT];                 // aux channel of each slot
+    uint8_t segmentOfStep[MAX_AUX_CHANNEL_COUNT][RC_RANGE_TABLE_STEP_COUNT];
+    uint8_t currentSegment[MAX_AUX_CHANNEL_COUNT];
+    uint8_t segmentCount;
+    uint32_t segments[RC_RANGE_TABLE_SEGMENT_COUNT];
+    uint32_t active;        // bit per range that contains its channel value
+    bool built;
+    bool dirty;             // built but not evaluated yet
+} rcRangeTable_t;
+
+void rcRangeTableReset(rcRangeTable_t *table);
+bool rcRangeTableAdd(rcRangeTable_t *table, uint8_t bit, uint8_t auxChannelIndex, const channelRange_t *range);
+void rcRangeTableBuild(rcRangeTable_t *table);
+bool rcRangeTableUpdate(rcRangeTable_t *table, const int16_t *auxChannels);
@@ -253,7 +253,7 @@ static void applySensorCorrection(quaternion *vError) {
 #endif
 }
 
-static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError, float spinTrust) {
+static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vGyroRotation, quaternion *vError, float spinTrust) {
     quaternion vKpKi = VECTOR_INITIALIZE;
     static quaternion vIntegralFB = VECTOR_INITIALIZE;
     quaternion qBuff, qDiff;
@@ -273,14 +273,11 @@ static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError,
     vKpKi.y += dcmKpGain * vError->y * spinTrust + vIntegralFB.y;
     vKpKi.z += dcmKpGain * vError->z * spinTrust + vIntegralFB.z;
     // vGyro integration
-    // PCDM Acta Mech 224, 3091–3109 (2013)
+    // the gyro task pre-integrates the rotation vector with coning correction at full loop rate
     const float vGyroModulus = quaternionModulus(vGyro);
     // reduce gyro noise integration integrate only above vGyroStdDevModulus
     if (vGyroModulus > vGyroStdDevModulus) {
-        qDiff.w = cosf(vGyroModulus * 0.5f * dt);
-        qDiff.x = sinf(vGyroModulus * 0.5f * dt) * (vGyro->x / vGyroModulus);
-        qDiff.y = sinf(vGyroModulus * 0.5f * dt) * (vGyro->y / vGyroModulus);
-        qDiff.z = sinf(vGyroModulus * 0.5f * dt) * (vGyro->z / vGyroModulus);
+        quaternionFromRotationVector(vGyroRotation, &qDiff);
         quaternionMultiply(&qAttitude, &qDiff, &qAttitude);
     }
     // vKpKi integration
@@ -337,8 +334,9 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs) {
 #endif
     quaternion vError = VECTOR_INITIALIZE;
     quaternion vGyroAverage;
+    quaternion vGyroRotation;
     quaternion vAccAverage;
-    gyroGetAverage(&vGyroAverage);
+    gyroGetDeltaRotation(&vGyroRotation, &vGyroAverage);
     accGetAverage(&vAccAverage);
     DEBUG_SET(DEBUG_IMU, DEBUG_IMU2, lrintf((quaternionModulus(&vAccAverage) / acc.dev.acc_1G) * 1000));
 
@@ -349,7 +347,7 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs) {
         applyAccError(&vAccAverage, &vError);
     }
     applySensorCorrection(&vError);
-    imuMahonyAHRSupdate(deltaT * 1e-6f, &vGyroAverage, &vError, spinTrust);
+    imuMahonyAHRSupdate(deltaT * 1e-6f, &vGyroAverage, &vGyroRotation, &vError, spinTrust);
     imuUpdateEulerAngles();
 #endif
 #if defined(USE_ALT_HOLD)
@@ -80,7 +80,7 @@ PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
                   .crashflip_power_percent = 70,
                  );
 
-PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 3);
 
 void pgResetFn_motorConfig(motorConfig_t *motorConfig) {
 #ifdef BRUSHED_MOTORS
@@ -496,6 +496,11 @@ void mixerResetDisarmedMotors(void) {
 
 void writeMotors(void) {
     if (pwmAreMotorsEnabled()) {
+#ifdef USE_DSHOT_TELEMETRY
+        if (useDshotTelemetry) {
+            pwmStartDshotMotorUpdate(motorCount);
+        }
+#endif
         for (int i = 0; i < motorCount; i++) {
             pwmWriteMotor(i, motor[i]);
         }
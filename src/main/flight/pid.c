@@ -192,6 +192,11 @@ void resetPidProfile(pidProfile_t *pidProfile) {
     .emuGravityGain = 100,
     .angle_filter = 100,
                 );
+    // only the PG copy has a runtime block, defaults copies are ignored
+    const ptrdiff_t index = pidProfile - pidProfiles(0);
+    if (index >= 0 && index < PID_PROFILE_COUNT) {
+        pidMarkProfileDirty(index);
+    }
 }
 
 void pgResetFn_pidProfiles(pidProfile_t *pidProfiles) {
@@ -217,6 +222,62 @@ typedef union dtermLowpass_u {
     biquadFilter_t biquadFilter;
 } dtermLowpass_t;
 
+typedef struct pidCoefficient_s {
+    float Kp;
+    float Ki;
+    float Kd;
+    float Kf;
+} pidCoefficient_t;
+
+// Everything derived from a pid profile, precomputed for every profile at init and on
+// config change so that switching profiles is a pointer swap. The filters in here only
+// provide coefficients, the filter state lives in the runtime filters below.
+typedef struct pidProfileRuntime_s {
+    pidCoefficient_t pidCoefficient[XYZ_AXIS_COUNT];
+    float directFFYaw;
+    float maxVelocity[XYZ_AXIS_COUNT];
+    float feathered_pids;
+    float smart_dterm_smoothing[XYZ_AXIS_COUNT];
+    float setPointPTransition[XYZ_AXIS_COUNT];
+    float setPointITransition[XYZ_AXIS_COUNT];
+    float setPointDTransition[XYZ_AXIS_COUNT];
+    float dtermBoostMultiplier, dtermBoostLimitPercent;
+    float P_angle_low, D_angle_low, P_angle_high, D_angle_high, F_angle, DF_angle_low, DF_angle_high, horizonTransition, horizonCutoffDegrees, horizonStrength;
+    float ITermWindupPointInv;
+    timeDelta_t crashTimeLimitUs;
+    timeDelta_t crashTimeDelayUs;
+    int32_t crashRecoveryAngleDeciDegrees;
+    float crashRecoveryRate;
+    float crashDtermThreshold;
+    float crashGyroThreshold;
+    float crashSetpointThreshold;
+    float crashLimitYaw;
+    float itermLimit;
+    float axisLockMultiplier;
+    float throttleBoost;
+    bool itermRotation;
+    uint8_t itermRelaxCutoff;
+    uint8_t itermRelaxCutoffYaw;
+    float iDecay;
+
+    filterApplyFnPtr dtermLowpassApplyFn;
+    dtermLowpass_t dtermLowpass[XYZ_AXIS_COUNT];
+    filterApplyFnPtr dtermLowpass2ApplyFn;
+    dtermLowpass_t dtermLowpass2[XYZ_AXIS_COUNT];
+    filterApplyFnPtr angleSetpointFilterApplyFn;
+    pt1Filter_t angleSetpointFilter[2];
+    filterApplyFnPtr dtermABGapplyFn;
+    alphaBetaGammaFilter_t dtermABG[XYZ_AXIS_COUNT];
+    pt1Filter_t axisLockLpf[XYZ_AXIS_COUNT];
+    pt1Filter_t windupLpf[XYZ_AXIS_COUNT];
+    pt1Filter_t throttleLpf;
+} pidProfileRuntime_t;
+
+static pidProfileRuntime_t pidProfileRuntime[PID_PROFILE_COUNT];
+static bool pidProfileRuntimeDirty[PID_PROFILE_COUNT];      // profile edited since its block was built
+static FAST_RAM_ZERO_INIT const pidProfileRuntime_t *pidRuntime;
+static FAST_RAM_ZERO_INIT uint8_t pidRuntimeIndex;
+
 static FAST_RAM_ZERO_INIT float previousPidSetpoint[XYZ_AXIS_COUNT];
 static FAST_RAM filterApplyFnPtr dtermLowpassApplyFn = nullFilterApply;
 static FAST_RAM_ZERO_INIT dtermLowpass_t dtermLowpass[XYZ_AXIS_COUNT];
@@ -229,15 +290,11 @@ static FAST_RAM_ZERO_INIT alphaBetaGammaFilter_t dtermABG[XYZ_AXIS_COUNT];
 
 #if defined(USE_ITERM_RELAX)
 static FAST_RAM_ZERO_INIT pt1Filter_t windupLpf[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT uint8_t itermRelaxCutoff;
-static FAST_RAM_ZERO_INIT uint8_t itermRelaxCutoffYaw;
 #endif
 
 static FAST_RAM_ZERO_INIT pt1Filter_t emuGravityThrottleLpf;
 static FAST_RAM_ZERO_INIT pt1Filter_t axisLockLpf[XYZ_AXIS_COUNT];
 
-static FAST_RAM_ZERO_INIT float iDecay;
-
 #ifdef USE_RC_SMOOTHING_FILTER
 static FAST_RAM_ZERO_INIT pt1Filter_t setpointDerivativePt1[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT biquadFilter_t setpointDerivativeBiquad[XYZ_AXIS_COUNT];
@@ -246,66 +303,143 @@ static FAST_RAM_ZERO_INIT uint8_t rcSmoothingDebugAxis;
 static FAST_RAM_ZERO_INIT uint8_t rcSmoothingFilterType;
 #endif // USE_RC_SMOOTHING_FILTER
 
-void pidInitFilters(const pidProfile_t *pidProfile) {
+static void pidBuildRuntimeFilters(pidProfileRuntime_t *runtime, const pidProfile_t *pidProfile) {
     BUILD_BUG_ON(FD_YAW != 2);                             // ensure yaw axis is 2
     const uint32_t pidFrequencyNyquist = pidFrequency / 2; // No rounding needed
-    dtermLowpassApplyFn = nullFilterApply;
-    dtermLowpass2ApplyFn = nullFilterApply;
-    angleSetpointFilterApplyFn = nullFilterApply;
+    runtime->dtermLowpassApplyFn = nullFilterApply;
+    runtime->dtermLowpass2ApplyFn = nullFilterApply;
+    runtime->angleSetpointFilterApplyFn = nullFilterApply;
+    runtime->dtermABGapplyFn = nullFilterApply;
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
         if (pidProfile->dFilter[axis].dLpf && pidProfile->dFilter[axis].dLpf <= pidFrequencyNyquist) {
             switch (pidProfile->dterm_filter_type) {
             case FILTER_PT1:
-                dtermLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-                pt1FilterInit(&dtermLowpass[axis].pt1Filter, pt1FilterGain(pidProfile->dFilter[axis].dLpf, dT));
+                runtime->dtermLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
+                pt1FilterInit(&runtime->dtermLowpass[axis].pt1Filter, pt1FilterGain(pidProfile->dFilter[axis].dLpf, dT));
                 break;
             case FILTER_BIQUAD:
             default:
-                dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApply;
-                biquadFilterInitLPF(&dtermLowpass[axis].biquadFilter, pidProfile->dFilter[axis].dLpf, targetPidLooptime);
+                runtime->dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApply;
+                biquadFilterInitLPF(&runtime->dtermLowpass[axis].biquadFilter, pidProfile->dFilter[axis].dLpf, targetPidLooptime);
                 break;
             }
         }
         if (pidProfile->dFilter[axis].dLpf2 && pidProfile->dFilter[axis].dLpf2 <= pidFrequencyNyquist) {
             switch (pidProfile->dterm_filter_type) {
             case FILTER_PT1:
-                dtermLowpass2ApplyFn = (filterApplyFnPtr)pt1FilterApply;
-                pt1FilterInit(&dtermLowpass2[axis].pt1Filter, pt1FilterGain(pidProfile->dFilter[axis].dLpf2, dT));
+                runtime->dtermLowpass2ApplyFn = (filterApplyFnPtr)pt1FilterApply;
+                pt1FilterInit(&runtime->dtermLowpass2[axis].pt1Filter, pt1FilterGain(pidProfile->dFilter[axis].dLpf2, dT));
                 break;
             case FILTER_BIQUAD:
             default:
-                dtermLowpass2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
-                biquadFilterInitLPF(&dtermLowpass2[axis].biquadFilter, pidProfile->dFilter[axis].dLpf2, targetPidLooptime);
+                runtime->dtermLowpass2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
+                biquadFilterInitLPF(&runtime->dtermLowpass2[axis].biquadFilter, pidProfile->dFilter[axis].dLpf2, targetPidLooptime);
                 break;
             }
         }
-        if (pidProfile->angle_filter) {
-            angleSetpointFilterApplyFn = (filterApplyFnPtr)pt1FilterApply;
-            pt1FilterInit(&angleSetpointFilter[axis], pt1FilterGain(pidProfile->angle_filter, dT));
+        if (pidProfile->angle_filter && axis != FD_YAW) {
+            runtime->angleSetpointFilterApplyFn = (filterApplyFnPtr)pt1FilterApply;
+            pt1FilterInit(&runtime->angleSetpointFilter[axis], pt1FilterGain(pidProfile->angle_filter, dT));
         }
         if (pidProfile->dterm_ABG_alpha) {
-            dtermABGapplyFn = (filterApplyFnPtr)alphaBetaGammaApply;
-            ABGInit(&dtermABG[axis], pidProfile->dterm_ABG_alpha, pidProfile->dterm_ABG_boost, pidProfile->dterm_ABG_half_life, dT);
+            runtime->dtermABGapplyFn = (filterApplyFnPtr)alphaBetaGammaApply;
+            ABGInit(&runtime->dtermABG[axis], pidProfile->dterm_ABG_alpha, pidProfile->dterm_ABG_boost, pidProfile->dterm_ABG_half_life, dT);
         }
     }
 #if defined(USE_THROTTLE_BOOST)
-    pt1FilterInit(&throttleLpf, pt1FilterGain(pidProfile->throttle_boost_cutoff, dT));
+    pt1FilterInit(&runtime->throttleLpf, pt1FilterGain(pidProfile->throttle_boost_cutoff, dT));
 #endif
-
-    pt1FilterInit(&emuGravityThrottleLpf, pt1FilterGain(EMU_GRAVITY_THROTTLE_FILTER_CUTOFF, dT));
-
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-        pt1FilterInit(&axisLockLpf[i], pt1FilterGain(pidProfile->axis_lock_hz, dT));
+        pt1FilterInit(&runtime->axisLockLpf[i], pt1FilterGain(pidProfile->axis_lock_hz, dT));
 #if defined(USE_ITERM_RELAX)
         if (i != FD_YAW) {
-            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, dT));
+            pt1FilterInit(&runtime->windupLpf[i], pt1FilterGain(runtime->itermRelaxCutoff, dT));
         } else {
-            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoffYaw, dT));
+            pt1FilterInit(&runtime->windupLpf[i], pt1FilterGain(runtime->itermRelaxCutoffYaw, dT));
         }
 #endif
     }
 }
 
+static void dtermLowpassCopyCoefficients(filterApplyFnPtr applyFn, dtermLowpass_t *dst, const dtermLowpass_t *src) {
+    if (applyFn == (filterApplyFnPtr)pt1FilterApply) {
+        dst->pt1Filter.k = src->pt1Filter.k;
+    } else if (applyFn == (filterApplyFnPtr)biquadFilterApply) {
+        dst->biquadFilter.b0 = src->biquadFilter.b0;
+        dst->biquadFilter.b1 = src->biquadFilter.b1;
+        dst->biquadFilter.b2 = src->biquadFilter.b2;
+        dst->biquadFilter.a1 = src->biquadFilter.a1;
+        dst->biquadFilter.a2 = src->biquadFilter.a2;
+    }
+}
+
+static void ABGCopyCoefficients(alphaBetaGammaFilter_t *dst, const alphaBetaGammaFilter_t *src) {
+    dst->a = src->a;
+    dst->b = src->b;
+    dst->g = src->g;
+    dst->e = src->e;
+    dst->dT = src->dT;
+    dst->dT2 = src->dT2;
+    dst->dT3 = src->dT3;
+    dst->halfLife = src->halfLife;
+    dst->boost = src->boost;
+    dst->boostFilter.k = src->boostFilter.k;
+}
+
+// Loads the runtime filters from the precomputed ones. Filters that keep their type only
+// take the new coefficients and carry their state over, the others start from scratch.
+static void pidApplyRuntimeFilters(const pidProfileRuntime_t *runtime, bool keepState) {
+    const bool keepLowpassState = keepState && runtime->dtermLowpassApplyFn == dtermLowpassApplyFn;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        if (keepLowpassState) {
+            dtermLowpassCopyCoefficients(dtermLowpassApplyFn, &dtermLowpass[axis], &runtime->dtermLowpass[axis]);
+        } else {
+            dtermLowpass[axis] = runtime->dtermLowpass[axis];
+        }
+    }
+    dtermLowpassApplyFn = runtime->dtermLowpassApplyFn;
+
+    const bool keepLowpass2State = keepState && runtime->dtermLowpass2ApplyFn == dtermLowpass2ApplyFn;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        if (keepLowpass2State) {
+            dtermLowpassCopyCoefficients(dtermLowpass2ApplyFn, &dtermLowpass2[axis], &runtime->dtermLowpass2[axis]);
+        } else {
+            dtermLowpass2[axis] = runtime->dtermLowpass2[axis];
+        }
+    }
+    dtermLowpass2ApplyFn = runtime->dtermLowpass2ApplyFn;
+
+    const bool keepAngleState = keepState && runtime->angleSetpointFilterApplyFn == angleSetpointFilterApplyFn;
+    for (int axis = FD_ROLL; axis < FD_YAW; axis++) {
+        if (keepAngleState) {
+            angleSetpointFilter[axis].k = runtime->angleSetpointFilter[axis].k;
+        } else {
+            angleSetpointFilter[axis] = runtime->angleSetpointFilter[axis];
+        }
+    }
+    angleSetpointFilterApplyFn = runtime->angleSetpointFilterApplyFn;
+
+    const bool keepABGState = keepState && runtime->dtermABGapplyFn == dtermABGapplyFn;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        if (keepABGState) {
+            ABGCopyCoefficients(&dtermABG[axis], &runtime->dtermABG[axis]);
+        } else {
+            dtermABG[axis] = runtime->dtermABG[axis];
+        }
+    }
+    dtermABGapplyFn = runtime->dtermABGapplyFn;
+
+    // single pole filters always keep their state
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        pt1FilterUpdateCutoff(&axisLockLpf[axis], runtime->axisLockLpf[axis].k);
+#if defined(USE_ITERM_RELAX)
+        pt1FilterUpdateCutoff(&windupLpf[axis], runtime->windupLpf[axis].k);
+#endif
+    }
+#if defined(USE_THROTTLE_BOOST)
+    pt1FilterUpdateCutoff(&throttleLpf, runtime->throttleLpf.k);
+#endif
+}
 
 
 #ifdef USE_RC_SMOOTHING_FILTER
@@ -343,39 +477,11 @@ void pidUpdateSetpointDerivativeLpf(uint16_t filterCutoff) {
 }
 #endif // USE_RC_SMOOTHING_FILTER
 
-typedef struct pidCoefficient_s {
-    float Kp;
-    float Ki;
-    float Kd;
-    float Kf;
-} pidCoefficient_t;
-
-static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float directFF[3];
-static FAST_RAM_ZERO_INIT float maxVelocity[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT float feathered_pids;
-static FAST_RAM_ZERO_INIT float smart_dterm_smoothing[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT float setPointPTransition[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT float setPointITransition[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT float setPointDTransition[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT float dtermBoostMultiplier, dtermBoostLimitPercent;
-static FAST_RAM_ZERO_INIT float P_angle_low, D_angle_low, P_angle_high, D_angle_high, F_angle, DF_angle_low, DF_angle_high, horizonTransition, horizonCutoffDegrees, horizonStrength;
-static FAST_RAM_ZERO_INIT float ITermWindupPointInv;
-static FAST_RAM_ZERO_INIT timeDelta_t crashTimeLimitUs;
-static FAST_RAM_ZERO_INIT timeDelta_t crashTimeDelayUs;
-static FAST_RAM_ZERO_INIT int32_t crashRecoveryAngleDeciDegrees;
-static FAST_RAM_ZERO_INIT float crashRecoveryRate;
-static FAST_RAM_ZERO_INIT float crashDtermThreshold;
-static FAST_RAM_ZERO_INIT float crashGyroThreshold;
-static FAST_RAM_ZERO_INIT float crashSetpointThreshold;
-static FAST_RAM_ZERO_INIT float crashLimitYaw;
-static FAST_RAM_ZERO_INIT float itermLimit;
-static FAST_RAM_ZERO_INIT float axisLockMultiplier;
 #if defined(USE_THROTTLE_BOOST)
 FAST_RAM_ZERO_INIT float throttleBoost;
 pt1Filter_t throttleLpf;
 #endif
-static FAST_RAM_ZERO_INIT bool itermRotation;
 static FAST_RAM_ZERO_INIT float temporaryIterm[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float emuGravityThrottleHpf;
 
@@ -389,68 +495,136 @@ void pidUpdateEmuGravityThrottleFilter(float throttle) {
       emuGravityThrottleHpf = throttle - pt1FilterApply(&emuGravityThrottleLpf, throttle);
 }
 
-void pidInitConfig(const pidProfile_t *pidProfile) {
+static void pidBuildRuntimeConfig(pidProfileRuntime_t *runtime, const pidProfile_t *pidProfile) {
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P;
-        pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I;
-        pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D;
-        setPointPTransition[axis] = pidProfile->setPointPTransition[axis] / 100.0f;
-        setPointITransition[axis] = pidProfile->setPointITransition[axis] / 100.0f;
-        setPointDTransition[axis] = pidProfile->setPointDTransition[axis] / 100.0f;
-        smart_dterm_smoothing[axis] = pidProfile->dFilter[axis].smartSmoothing;
-    }
-    directFF[0] = DIRECT_FF_SCALE * pidProfile->directFF_yaw;
-    DF_angle_low = DIRECT_FF_SCALE * pidProfile->pid[PID_LEVEL_LOW].I;
-    DF_angle_high = DIRECT_FF_SCALE * pidProfile->pid[PID_LEVEL_HIGH].I;
-    feathered_pids = pidProfile->feathered_pids / 100.0f;
-    dtermBoostMultiplier = (pidProfile->dtermBoost * pidProfile->dtermBoost / 1000000) * 0.003;
-    dtermBoostLimitPercent = pidProfile->dtermBoostLimit / 100.0f;
-    P_angle_low = pidProfile->pid[PID_LEVEL_LOW].P * 0.1f;
-    D_angle_low = pidProfile->pid[PID_LEVEL_LOW].D * 0.00002428571f;
-    P_angle_high = pidProfile->pid[PID_LEVEL_HIGH].P * 0.1f;
-    D_angle_high = pidProfile->pid[PID_LEVEL_HIGH].D * 0.00002428571f;
-    F_angle = pidProfile->pid[PID_LEVEL_LOW].F * 0.00000125f;
-    horizonTransition = (float)pidProfile->horizonTransition;
-    horizonCutoffDegrees = pidProfile->horizon_tilt_effect;
-    horizonStrength = pidProfile->horizonStrength / 50.0f;
-    maxVelocity[FD_ROLL] = maxVelocity[FD_PITCH] = pidProfile->rateAccelLimit * 100 * dT;
-    maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * dT;
-    ITermWindupPointInv = 0.0f;
+        runtime->pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P;
+        runtime->pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I;
+        runtime->pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D;
+        runtime->setPointPTransition[axis] = pidProfile->setPointPTransition[axis] / 100.0f;
+        runtime->setPointITransition[axis] = pidProfile->setPointITransition[axis] / 100.0f;
+        runtime->setPointDTransition[axis] = pidProfile->setPointDTransition[axis] / 100.0f;
+        runtime->smart_dterm_smoothing[axis] = pidProfile->dFilter[axis].smartSmoothing;
+    }
+    runtime->directFFYaw = DIRECT_FF_SCALE * pidProfile->directFF_yaw;
+    runtime->DF_angle_low = DIRECT_FF_SCALE * pidProfile->pid[PID_LEVEL_LOW].I;
+    runtime->DF_angle_high = DIRECT_FF_SCALE * pidProfile->pid[PID_LEVEL_HIGH].I;
+    runtime->feathered_pids = pidProfile->feathered_pids / 100.0f;
+    runtime->dtermBoostMultiplier = (pidProfile->dtermBoost * pidProfile->dtermBoost / 1000000) * 0.003;
+    runtime->dtermBoostLimitPercent = pidProfile->dtermBoostLimit / 100.0f;
+    runtime->P_angle_low = pidProfile->pid[PID_LEVEL_LOW].P * 0.1f;
+    runtime->D_angle_low = pidProfile->pid[PID_LEVEL_LOW].D * 0.00002428571f;
+    runtime->P_angle_high = pidProfile->pid[PID_LEVEL_HIGH].P * 0.1f;
+    runtime->D_angle_high = pidProfile->pid[PID_LEVEL_HIGH].D * 0.00002428571f;
+    runtime->F_angle = pidProfile->pid[PID_LEVEL_LOW].F * 0.00000125f;
+    runtime->horizonTransition = (float)pidProfile->horizonTransition;
+    runtime->horizonCutoffDegrees = pidProfile->horizon_tilt_effect;
+    runtime->horizonStrength = pidProfile->horizonStrength / 50.0f;
+    runtime->maxVelocity[FD_ROLL] = runtime->maxVelocity[FD_PITCH] = pidProfile->rateAccelLimit * 100 * dT;
+    runtime->maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * dT;
+    runtime->ITermWindupPointInv = 0.0f;
     if (pidProfile->itermWindupPointPercent != 0) {
         const float itermWindupPoint = pidProfile->itermWindupPointPercent / 100.0f;
-        ITermWindupPointInv = 1.0f / itermWindupPoint;
-    }
-    crashTimeLimitUs = pidProfile->crash_time * 1000;
-    crashTimeDelayUs = pidProfile->crash_delay * 1000;
-    crashRecoveryAngleDeciDegrees = pidProfile->crash_recovery_angle * 10;
-    crashRecoveryRate = pidProfile->crash_recovery_rate;
-    crashGyroThreshold = pidProfile->crash_gthreshold;
-    crashDtermThreshold = pidProfile->crash_dthreshold;
-    crashSetpointThreshold = pidProfile->crash_setpoint_threshold;
-    crashLimitYaw = pidProfile->crash_limit_yaw;
-    itermLimit = pidProfile->itermLimit;
+        runtime->ITermWindupPointInv = 1.0f / itermWindupPoint;
+    }
+    runtime->crashTimeLimitUs = pidProfile->crash_time * 1000;
+    runtime->crashTimeDelayUs = pidProfile->crash_delay * 1000;
+    runtime->crashRecoveryAngleDeciDegrees = pidProfile->crash_recovery_angle * 10;
+    runtime->crashRecoveryRate = pidProfile->crash_recovery_rate;
+    runtime->crashGyroThreshold = pidProfile->crash_gthreshold;
+    runtime->crashDtermThreshold = pidProfile->crash_dthreshold;
+    runtime->crashSetpointThreshold = pidProfile->crash_setpoint_threshold;
+    runtime->crashLimitYaw = pidProfile->crash_limit_yaw;
+    runtime->itermLimit = pidProfile->itermLimit;
+    runtime->throttleBoost = pidProfile->throttle_boost * 0.1f;
+    runtime->itermRotation = pidProfile->iterm_rotation;
+    runtime->itermRelaxCutoff = pidProfile->iterm_relax_cutoff;
+    runtime->itermRelaxCutoffYaw = pidProfile->iterm_relax_cutoff_yaw;
+    runtime->iDecay = (float)pidProfile->i_decay;
+    runtime->axisLockMultiplier = pidProfile->axis_lock_multiplier / 100.0f;
+}
+
+static uint8_t pidProfileIndex(const pidProfile_t *pidProfile) {
+    const ptrdiff_t index = pidProfile - pidProfiles(0);
+    return (index >= 0 && index < PID_PROFILE_COUNT) ? index : 0;
+}
+
+static void pidActivateRuntimeConfig(void) {
+    directFF[0] = pidRuntime->directFFYaw;
 #if defined(USE_THROTTLE_BOOST)
-    throttleBoost = pidProfile->throttle_boost * 0.1f;
+    throttleBoost = pidRuntime->throttleBoost;
 #endif
-    itermRotation = pidProfile->iterm_rotation;
-#if defined(USE_ITERM_RELAX)
-    itermRelaxCutoff = pidProfile->iterm_relax_cutoff;
-    itermRelaxCutoffYaw = pidProfile->iterm_relax_cutoff_yaw;
-#endif
-    iDecay = (float)pidProfile->i_decay;
-    axisLockMultiplier = pidProfile->axis_lock_multiplier / 100.0f;
     mixerInitProfile();
 }
 
+void pidInitFilters(const pidProfile_t *pidProfile) {
+    const uint8_t index = pidProfileIndex(pidProfile);
+    pidBuildRuntimeFilters(&pidProfileRuntime[index], pidProfile);
+    if (index == pidRuntimeIndex) {
+        pidApplyRuntimeFilters(&pidProfileRuntime[index], false);
+    }
+    pt1FilterInit(&emuGravityThrottleLpf, pt1FilterGain(EMU_GRAVITY_THROTTLE_FILTER_CUTOFF, dT));
+}
+
+static void pidBuildRuntime(uint8_t index) {
+    pidBuildRuntimeConfig(&pidProfileRuntime[index], pidProfiles(index));
+    pidBuildRuntimeFilters(&pidProfileRuntime[index], pidProfiles(index));
+    pidProfileRuntimeDirty[index] = false;
+}
+
+// Called by everything that writes a profile without rebuilding it (CLI set, PG reset,
+// CMS), the block is rebuilt when the profile is next initialised or switched to.
+void pidMarkProfileDirty(uint8_t pidProfileIndex) {
+    if (pidProfileIndex < PID_PROFILE_COUNT) {
+        pidProfileRuntimeDirty[pidProfileIndex] = true;
+    }
+}
+
+static void pidRefreshRuntime(uint8_t index) {
+    if (pidProfileRuntimeDirty[index]) {
+        pidBuildRuntime(index);
+    }
+}
+
+void pidInitConfig(const pidProfile_t *pidProfile) {
+    const uint8_t index = pidProfileIndex(pidProfile);
+    for (int i = 0; i < PID_PROFILE_COUNT; i++) {
+        pidRefreshRuntime(i);
+    }
+    pidBuildRuntimeConfig(&pidProfileRuntime[index], pidProfile);
+    pidRuntimeIndex = index;
+    pidRuntime = &pidProfileRuntime[index];
+    pidActivateRuntimeConfig();
+}
+
 void pidInit(const pidProfile_t *pidProfile) {
     pidSetTargetLooptime(gyro.targetLooptime * pidConfig()->pid_process_denom); // Initialize pid looptime
-    pidInitFilters(pidProfile);
-    pidInitConfig(pidProfile);
+    for (int i = 0; i < PID_PROFILE_COUNT; i++) {
+        pidBuildRuntime(i);
+    }
+    pidRuntimeIndex = pidProfileIndex(pidProfile);
+    pidRuntime = &pidProfileRuntime[pidRuntimeIndex];
+    pidApplyRuntimeFilters(pidRuntime, false);
+    pt1FilterInit(&emuGravityThrottleLpf, pt1FilterGain(EMU_GRAVITY_THROTTLE_FILTER_CUTOFF, dT));
+    pidActivateRuntimeConfig();
+}
+
+// Switches to a profile precomputed by pidInit(), keeping the state of compatible filters
+void pidSwitchProfile(uint8_t pidProfileIndex) {
+    if (pidProfileIndex >= PID_PROFILE_COUNT || !pidRuntime) {
+        return;
+    }
+    pidRefreshRuntime(pidProfileIndex);
+    const pidProfileRuntime_t *runtime = &pidProfileRuntime[pidProfileIndex];
+    pidApplyRuntimeFilters(runtime, true);
+    pidRuntimeIndex = pidProfileIndex;
+    pidRuntime = runtime;
+    pidActivateRuntimeConfig();
 }
 
 void pidCopyProfile(uint8_t dstPidProfileIndex, uint8_t srcPidProfileIndex) {
     if ((dstPidProfileIndex < PID_PROFILE_COUNT - 1 && srcPidProfileIndex < PID_PROFILE_COUNT - 1) && dstPidProfileIndex != srcPidProfileIndex) {
         memcpy(pidProfilesMutable(dstPidProfileIndex), pidProfilesMutable(srcPidProfileIndex), sizeof(pidProfile_t));
+        pidBuildRuntime(dstPidProfileIndex);
     }
 }
 
@@ -462,15 +636,15 @@ static float calcHorizonLevelStrength(void) {
     DEBUG_SET(DEBUG_HORIZON, 0, lrintf(howUpsideDown() * 1000));
     DEBUG_SET(DEBUG_HORIZON, 1, lrintf(currentInclination * 10));
     // Used as a factor in the numerator of inclinationLevelRatio - this will cause the entry point of the fade of leveling strength to be adjustable via horizon transition in configurator for RACEMODEhorizon
-    const float racemodeHorizonTransitionFactor = horizonCutoffDegrees / (horizonCutoffDegrees - horizonTransition);
+    const float racemodeHorizonTransitionFactor = pidRuntime->horizonCutoffDegrees / (pidRuntime->horizonCutoffDegrees - pidRuntime->horizonTransition);
     // Used as a factor in the numerator of inclinationLevelRatio - this will cause the fade of leveling strength to start at levelAngleLimit for RACEMODEangle
     // horizonTiltExpertMode:  0 = RACEMODEangle - ANGLE LIMIT BEHAVIOUR ON ROLL AXIS
     //                         1 = RACEMODEhorizon - HORIZON TYPE BEHAVIOUR ON ROLL AXIS
     //determines the leveling strength of RACEMODEhorizon
-    if (horizonCutoffDegrees > 0 && horizonTransition < horizonCutoffDegrees) {
+    if (pidRuntime->horizonCutoffDegrees > 0 && pidRuntime->horizonTransition < pidRuntime->horizonCutoffDegrees) {
         //if racemode_tilt_effect>0 and if horizonTransition<racemode_tilt_effect
         //causes leveling to fade from horizonTransition angle to horizonCutoffDegrees  where leveling goes to zero
-        const float inclinationLevelRatio = constrainf(((horizonCutoffDegrees - currentInclination) * racemodeHorizonTransitionFactor) / horizonCutoffDegrees, 0, 1);
+        const float inclinationLevelRatio = constrainf(((pidRuntime->horizonCutoffDegrees - currentInclination) * racemodeHorizonTransitionFactor) / pidRuntime->horizonCutoffDegrees, 0, 1);
         // apply inclination ratio to horizonLevelStrength which lowers leveling to zero as a function of angle and regardless of stick position
         horizonLevelStrength = inclinationLevelRatio;
     } else {
@@ -500,7 +674,7 @@ static float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPit
 #ifdef USE_GPS_RESCUE
     angle += gpsRescueAngle[axis] / 100; // ANGLE IS IN CENTIDEGREES
 #endif
-    f_term_low = (angle - previousAngle[axis]) * F_angle / dT;
+    f_term_low = (angle - previousAngle[axis]) * pidRuntime->F_angle / dT;
 
     previousAngle[axis] = angle;
     angle = constrainf(angle, -pidProfile->levelAngleLimit, pidProfile->levelAngleLimit);
@@ -523,11 +697,11 @@ static float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPit
     const float errorAnglePercent = fabsf(errorAngle / 90.0f);
 
     // ANGLE mode - control is angle based
-    p_term_low = (1 - errorAnglePercent) * errorAngle * P_angle_low;
-    p_term_high = errorAnglePercent * errorAngle * P_angle_high;
+    p_term_low = (1 - errorAnglePercent) * errorAngle * pidRuntime->P_angle_low;
+    p_term_high = errorAnglePercent * errorAngle * pidRuntime->P_angle_high;
 
-    d_term_low = (1 - errorAnglePercent) * (attitudePrevious[axis] - getAngleModeAngles(axis)) *  D_angle_low;
-    d_term_high = errorAnglePercent * (attitudePrevious[axis] - getAngleModeAngles(axis)) *  D_angle_high;
+    d_term_low = (1 - errorAnglePercent) * (attitudePrevious[axis] - getAngleModeAngles(axis)) *  pidRuntime->D_angle_low;
+    d_term_high = errorAnglePercent * (attitudePrevious[axis] - getAngleModeAngles(axis)) *  pidRuntime->D_angle_high;
     attitudePrevious[axis] = getAngleModeAngles(axis);
 
     currentPidSetpoint = p_term_low + p_term_high;
@@ -537,11 +711,11 @@ static float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPit
         // HORIZON mode - mix of ANGLE and ACRO modes
         // mix in errorAngle to currentPidSetpoint to add a little auto-level feel
         const float horizonLevelStrength = calcHorizonLevelStrength();
-        currentPidSetpoint = ((getSetpointRate(axis) * (1 - horizonLevelStrength)) + getSetpointRate(axis)) * 0.5f + (currentPidSetpoint * horizonLevelStrength * horizonStrength);
+        currentPidSetpoint = ((getSetpointRate(axis) * (1 - horizonLevelStrength)) + getSetpointRate(axis)) * 0.5f + (currentPidSetpoint * horizonLevelStrength * pidRuntime->horizonStrength);
     }
     currentPidSetpoint = angleSetpointFilterApplyFn((filter_t *)&angleSetpointFilter[axis], currentPidSetpoint);
-    directFF[axis] = (1 - fabsf(errorAnglePercent)) * DF_angle_low;
-    directFF[axis] += fabsf(errorAnglePercent) * DF_angle_high;
+    directFF[axis] = (1 - fabsf(errorAnglePercent)) * pidRuntime->DF_angle_low;
+    directFF[axis] += fabsf(errorAnglePercent) * pidRuntime->DF_angle_high;
 
     return currentPidSetpoint;
 }
@@ -549,8 +723,8 @@ static float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPit
 static float accelerationLimit(int axis, float currentPidSetpoint) {
     static float previousSetpoint[XYZ_AXIS_COUNT];
     const float currentVelocity = currentPidSetpoint - previousSetpoint[axis];
-    if (ABS(currentVelocity) > maxVelocity[axis]) {
-        currentPidSetpoint = (currentVelocity > 0) ? previousSetpoint[axis] + maxVelocity[axis] : previousSetpoint[axis] - maxVelocity[axis];
+    if (ABS(currentVelocity) > pidRuntime->maxVelocity[axis]) {
+        currentPidSetpoint = (currentVelocity > 0) ? previousSetpoint[axis] + pidRuntime->maxVelocity[axis] : previousSetpoint[axis] - pidRuntime->maxVelocity[axis];
     }
     previousSetpoint[axis] = currentPidSetpoint;
     return currentPidSetpoint;
@@ -561,18 +735,18 @@ static timeUs_t crashDetectedAtUs;
 static void handleCrashRecovery(
     const pidCrashRecovery_e crash_recovery, const rollAndPitchTrims_t *angleTrim,
     const int axis, const timeUs_t currentTimeUs, const float gyroRate, float *currentPidSetpoint, float *errorRate) {
-    if (inCrashRecoveryMode && cmpTimeUs(currentTimeUs, crashDetectedAtUs) > crashTimeDelayUs) {
+    if (inCrashRecoveryMode && cmpTimeUs(currentTimeUs, crashDetectedAtUs) > pidRuntime->crashTimeDelayUs) {
         if (crash_recovery == PID_CRASH_RECOVERY_BEEP) {
             BEEP_ON;
         }
         if (axis == FD_YAW) {
-            *errorRate = constrainf(*errorRate, -crashLimitYaw, crashLimitYaw);
+            *errorRate = constrainf(*errorRate, -pidRuntime->crashLimitYaw, pidRuntime->crashLimitYaw);
         } else {
             // on roll and pitch axes calculate currentPidSetpoint and errorRate to level the aircraft to recover from crash
             if (sensors(SENSOR_ACC)) {
                 // errorAngle is deviation from horizontal
                 const float errorAngle = -(attitude.raw[axis] - angleTrim->raw[axis]) / 10.0f;
-                *currentPidSetpoint = errorAngle * P_angle_low;
+                *currentPidSetpoint = errorAngle * pidRuntime->P_angle_low;
                 *errorRate = *currentPidSetpoint - gyroRate;
             }
         }
@@ -580,16 +754,16 @@ static void handleCrashRecovery(
         // and ITerm windup during crash recovery can be extreme, especially on yaw axis
         temporaryIterm[axis] = 0.0f;
         if (
-            cmpTimeUs(currentTimeUs, crashDetectedAtUs) > crashTimeLimitUs ||
+            cmpTimeUs(currentTimeUs, crashDetectedAtUs) > pidRuntime->crashTimeLimitUs ||
             (getControllerMixRange() < 1.0f &&
-             ABS(gyro.gyroADCf[FD_ROLL]) < crashRecoveryRate &&
-             ABS(gyro.gyroADCf[FD_PITCH]) < crashRecoveryRate &&
-             ABS(gyro.gyroADCf[FD_YAW]) < crashRecoveryRate
+             ABS(gyro.gyroADCf[FD_ROLL]) < pidRuntime->crashRecoveryRate &&
+             ABS(gyro.gyroADCf[FD_PITCH]) < pidRuntime->crashRecoveryRate &&
+             ABS(gyro.gyroADCf[FD_YAW]) < pidRuntime->crashRecoveryRate
             )
         ) {
             if (sensors(SENSOR_ACC)) {
                 // check aircraft nearly level
-                if (ABS(attitude.raw[FD_ROLL] - angleTrim->raw[FD_ROLL]) < crashRecoveryAngleDeciDegrees && ABS(attitude.raw[FD_PITCH] - angleTrim->raw[FD_PITCH]) < crashRecoveryAngleDeciDegrees) {
+                if (ABS(attitude.raw[FD_ROLL] - angleTrim->raw[FD_ROLL]) < pidRuntime->crashRecoveryAngleDeciDegrees && ABS(attitude.raw[FD_PITCH] - angleTrim->raw[FD_PITCH]) < pidRuntime->crashRecoveryAngleDeciDegrees) {
                     inCrashRecoveryMode = false;
                     BEEP_OFF;
                 }
@@ -608,11 +782,11 @@ static void detectAndSetCrashRecovery(
     // no point in trying to recover if the crash is so severe that the gyro overflows
     if ((crash_recovery || FLIGHT_MODE(GPS_RESCUE_MODE)) && !gyroOverflowDetected()) {
         if (ARMING_FLAG(ARMED)) {
-            if (getControllerMixRange() >= 1.0f && !inCrashRecoveryMode && ABS(delta) > crashDtermThreshold && ABS(errorRate) > crashGyroThreshold && ABS(getSetpointRate(axis)) < crashSetpointThreshold) {
+            if (getControllerMixRange() >= 1.0f && !inCrashRecoveryMode && ABS(delta) > pidRuntime->crashDtermThreshold && ABS(errorRate) > pidRuntime->crashGyroThreshold && ABS(getSetpointRate(axis)) < pidRuntime->crashSetpointThreshold) {
                 inCrashRecoveryMode = true;
                 crashDetectedAtUs = currentTimeUs;
             }
-            if (inCrashRecoveryMode && cmpTimeUs(currentTimeUs, crashDetectedAtUs) < crashTimeDelayUs && (ABS(errorRate) < crashGyroThreshold || ABS(getSetpointRate(axis)) > crashSetpointThreshold)) {
+            if (inCrashRecoveryMode && cmpTimeUs(currentTimeUs, crashDetectedAtUs) < pidRuntime->crashTimeDelayUs && (ABS(errorRate) < pidRuntime->crashGyroThreshold || ABS(getSetpointRate(axis)) > pidRuntime->crashSetpointThreshold)) {
                 inCrashRecoveryMode = false;
                 BEEP_OFF;
             }
@@ -636,7 +810,7 @@ static void rotateVector(float v[XYZ_AXIS_COUNT], float rotation[XYZ_AXIS_COUNT]
 }
 
 static void rotateITermAndAxisError() {
-    if (itermRotation) {
+    if (pidRuntime->itermRotation) {
         const float gyroToAngle = dT * RAD;
         float rotationRads[XYZ_AXIS_COUNT];
         for (int i = FD_ROLL; i <= FD_YAW; i++) {
@@ -667,7 +841,7 @@ static FAST_RAM_ZERO_INIT timeUs_t crashDetectedAtUs;
 void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs) {
     float axisLock[XYZ_AXIS_COUNT];
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        axisLock[axis] = pt1FilterApply(&axisLockLpf[axis], stickMovement[axis]) * axisLockMultiplier;
+        axisLock[axis] = pt1FilterApply(&axisLockLpf[axis], stickMovement[axis]) * pidRuntime->axisLockMultiplier;
     }
 
     scaledAxisPid[ROLL] = constrainf(1 - axisLock[PITCH] - axisLock[YAW] + axisLock[ROLL], 0.0f, 1.0f);
@@ -676,8 +850,8 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
 
     // gradually scale back integration when above windup point
     float dynCi = dT;
-    if (ITermWindupPointInv != 0.0f) {
-        dynCi *= constrainf((1.0f - getControllerMixRange()) * ITermWindupPointInv, 0.0f, 1.0f);
+    if (pidRuntime->ITermWindupPointInv != 0.0f) {
+        dynCi *= constrainf((1.0f - getControllerMixRange()) * pidRuntime->ITermWindupPointInv, 0.0f, 1.0f);
     }
     float errorRate;
     // ----------PID controller----------
@@ -689,7 +863,7 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
             errorAccelerator = 1.0f + fabsf(emuGravityThrottleHpf) * 0.1f * (pidProfile->emuGravityGain);
         }
         float currentPidSetpoint = getSetpointRate(axis);
-        if (maxVelocity[axis]) {
+        if (pidRuntime->maxVelocity[axis]) {
             currentPidSetpoint = accelerationLimit(axis, currentPidSetpoint);
         }
         // Yaw control is GYRO based, direct sticks control is applied to rate PID
@@ -752,7 +926,7 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
         float iterm          = temporaryIterm[axis];
 #if defined(USE_ITERM_RELAX)
         float itermRelaxFactor;
-        if ((itermRelaxCutoff && axis != FD_YAW) || (itermRelaxCutoffYaw && axis == FD_YAW)) {
+        if ((pidRuntime->itermRelaxCutoff && axis != FD_YAW) || (pidRuntime->itermRelaxCutoffYaw && axis == FD_YAW)) {
             const float setpointLpf = pt1FilterApply(&windupLpf[axis], currentPidSetpoint);
             const float setpointHpf = fabsf(currentPidSetpoint - setpointLpf);
             if (axis != FD_YAW) {
@@ -771,34 +945,34 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
         }
 #endif // USE_ITERM_RELAX
         // -----calculate P component
-        pidData[axis].P = (pidCoefficient[axis].Kp * (boostedErrorRate + errorRate));
+        pidData[axis].P = (pidRuntime->pidCoefficient[axis].Kp * (boostedErrorRate + errorRate));
         // -----calculate I component
         //float iterm = constrainf(pidData[axis].I + (pidCoefficient[axis].Ki * errorRate) * dynCi, -itermLimit, itermLimit);
-        float iDecayMultiplier = iDecay;
-        float ITermNew = pidCoefficient[axis].Ki * itermErrorRate * dynCi;
+        float iDecayMultiplier = pidRuntime->iDecay;
+        float ITermNew = pidRuntime->pidCoefficient[axis].Ki * itermErrorRate * dynCi;
         if (ITermNew != 0.0f) {
             if (SIGN(iterm) != SIGN(ITermNew)) {
                 // at low iterm iDecayMultiplier will be 1 and at high iterm it will be equivilant to iDecay
-                iDecayMultiplier = 1.0f + (iDecay - 1.0f) * constrainf(iterm / pidProfile->i_decay_cutoff, 0.0f, 1.0f);
+                iDecayMultiplier = 1.0f + (pidRuntime->iDecay - 1.0f) * constrainf(iterm / pidProfile->i_decay_cutoff, 0.0f, 1.0f);
                 const float newVal = ITermNew * iDecayMultiplier;
                 if (fabs(iterm) > fabs(newVal)) {
                     ITermNew = newVal;
                 }
             }
         }
-        iterm = constrainf(iterm + ITermNew, -itermLimit, itermLimit);
+        iterm = constrainf(iterm + ITermNew, -pidRuntime->itermLimit, pidRuntime->itermLimit);
         if (!mixerIsOutputSaturated(axis, errorRate) || ABS(iterm) < ABS(temporaryIterm[axis])) {
             // Only increase ITerm if output is not saturated
             temporaryIterm[axis] = iterm;
         }
         // -----calculate D component
-        if (pidCoefficient[axis].Kd > 0) {
+        if (pidRuntime->pidCoefficient[axis].Kd > 0) {
             //filter Kd properly, no setpoint filtering
             const float pureError = errorRate - previousError[axis];
             const float pureMeasurement = -(gyroRate - previousMeasurement[axis]);
             previousMeasurement[axis] = gyroRate;
             previousError[axis] = errorRate;
-            float dDelta = ((feathered_pids * pureMeasurement) + ((1 - feathered_pids) * pureError)) * pidFrequency; //calculating the dterm determine how much is calculated using measurement vs error
+            float dDelta = ((pidRuntime->feathered_pids * pureMeasurement) + ((1 - pidRuntime->feathered_pids) * pureError)) * pidFrequency; //calculating the dterm determine how much is calculated using measurement vs error
             //filter the dterm
             dDelta = dtermLowpassApplyFn((filter_t *)&dtermLowpass[axis], dDelta);
             dDelta = dtermLowpass2ApplyFn((filter_t *)&dtermLowpass2[axis], dDelta);
@@ -814,15 +988,15 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
             }
             //dterm boost, similar to emuboost
             float boostedDtermRate;
-            boostedDtermRate = (dDelta * fabsf(dDelta)) * dtermBoostMultiplier;
-            if (fabsf(dDelta * dtermBoostLimitPercent) < fabsf(boostedDtermRate)) {
-                boostedDtermRate = dDelta * dtermBoostLimitPercent;
+            boostedDtermRate = (dDelta * fabsf(dDelta)) * pidRuntime->dtermBoostMultiplier;
+            if (fabsf(dDelta * pidRuntime->dtermBoostLimitPercent) < fabsf(boostedDtermRate)) {
+                boostedDtermRate = dDelta * pidRuntime->dtermBoostLimitPercent;
             }
             dDelta += boostedDtermRate;
-            dDelta = pidCoefficient[axis].Kd * dDelta;
+            dDelta = pidRuntime->pidCoefficient[axis].Kd * dDelta;
             float dDeltaMultiplier;
-            if (smart_dterm_smoothing[axis] > 0) {
-                dDeltaMultiplier = constrainf(fabsf((dDelta + previousdDelta[axis]) / (4 * smart_dterm_smoothing[axis])) + 0.5, 0.5f, 1.0f); //smooth transition from 0.5-1.0f for the multiplier.
+            if (pidRuntime->smart_dterm_smoothing[axis] > 0) {
+                dDeltaMultiplier = constrainf(fabsf((dDelta + previousdDelta[axis]) / (4 * pidRuntime->smart_dterm_smoothing[axis])) + 0.5, 0.5f, 1.0f); //smooth transition from 0.5-1.0f for the multiplier.
                 dDelta = dDelta * dDeltaMultiplier;
                 previousdDelta[axis] = dDelta;
                 DEBUG_SET(DEBUG_SMART_SMOOTHING, axis, dDeltaMultiplier * 1000.0f);
@@ -868,9 +1042,9 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
 
         // applying SetPointAttenuation
         // SPA boost if SPA > 100 SPA cut if SPA < 100
-        float setPointPAttenuation = 1 + (getRcDeflectionAbs(axis) * (setPointPTransition[axis] - 1));
-        float setPointIAttenuation = 1 + (getRcDeflectionAbs(axis) * (setPointITransition[axis] - 1));
-        float setPointDAttenuation = 1 + (getRcDeflectionAbs(axis) * (setPointDTransition[axis] - 1));
+        float setPointPAttenuation = 1 + (getRcDeflectionAbs(axis) * (pidRuntime->setPointPTransition[axis] - 1));
+        float setPointIAttenuation = 1 + (getRcDeflectionAbs(axis) * (pidRuntime->setPointITransition[axis] - 1));
+        float setPointDAttenuation = 1 + (getRcDeflectionAbs(axis) * (pidRuntime->setPointDTransition[axis] - 1));
         pidData[axis].P *= setPointPAttenuation;
         pidData[axis].I = temporaryIterm[axis] * setPointIAttenuation; // you can't use pidData[axis].I to calculate iterm or with tpa you get issues
         pidData[axis].D *= setPointDAttenuation;
@@ -194,7 +194,9 @@ void pidResetITerm(void);
 void pidStabilisationState(pidStabilisationState_e pidControllerState);
 void pidInitFilters(const pidProfile_t *pidProfile);
 void pidInitConfig(const pidProfile_t *pidProfile);
+void pidMarkProfileDirty(uint8_t pidProfileIndex);
 void pidInit(const pidProfile_t *pidProfile);
+void pidSwitchProfile(uint8_t pidProfileIndex);
 void pidCopyProfile(uint8_t dstPidProfileIndex, uint8_t srcPidProfileIndex);
 bool crashRecoveryModeActive(void);
 void pidInitSetpointDerivativeLpf(uint16_t filterCutoff, uint8_t debugAxis, uint8_t filterType);
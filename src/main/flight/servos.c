@@ -49,6 +49,7 @@
 #include "flight/mixer.h"
 #include "flight/pid.h"
 #include "flight/servos.h"
+#include "flight/servos_table.h"
 
 #include "io/gimbal.h"
 
@@ -93,8 +94,13 @@ int16_t servo[MAX_SUPPORTED_SERVOS];
 
 static uint8_t servoRuleCount = 0;
 static servoMixer_t currentServoMixer[MAX_SERVO_RULES];
+static servoTable_t mixerTable;
 static int useServo;
 
+// servo[] index for each servo output in use by the mixer mode
+static uint8_t servoOutputMap[MAX_SUPPORTED_SERVOS];
+static uint8_t servoOutputCount;
+
 
 #define COUNT_SERVO_RULES(rules) (sizeof(rules) / sizeof(servoMixer_t))
 // mixer rule format servo, input, rate, speed, min, max, box
@@ -241,6 +247,51 @@ void loadCustomServoMixer(void) {
         currentServoMixer[i] = *customServoMixers(i);
         servoRuleCount++;
     }
+    servosCompileMixer();
+}
+
+// to be called whenever the rules or the servo parameters change
+void servosCompileMixer(void) {
+    servoTableCompile(&mixerTable, currentServoMixer, servoRuleCount, servoParams(0));
+}
+
+static void servoMapOutputs(uint8_t first, uint8_t last) {
+    for (int i = first; i <= last; i++) {
+        servoOutputMap[servoOutputCount++] = i;
+    }
+}
+
+static void servoConfigureOutputMap(void) {
+    servoOutputCount = 0;
+    switch (currentMixerMode) {
+    case MIXER_TRI:
+    case MIXER_CUSTOM_TRI:
+        servoMapOutputs(SERVO_RUDDER, SERVO_RUDDER);
+        break;
+    case MIXER_FLYING_WING:
+        servoMapOutputs(SERVO_FLAPPERON_1, SERVO_FLAPPERON_2);
+        break;
+    case MIXER_CUSTOM_AIRPLANE:
+    case MIXER_AIRPLANE:
+        servoMapOutputs(SERVO_PLANE_INDEX_MIN, SERVO_PLANE_INDEX_MAX);
+        break;
+#ifdef USE_UNCOMMON_MIXERS
+    case MIXER_BICOPTER:
+        servoMapOutputs(SERVO_BICOPTER_LEFT, SERVO_BICOPTER_RIGHT);
+        break;
+    case MIXER_HELI_120_CCPM:
+        servoMapOutputs(SERVO_HELI_LEFT, SERVO_HELI_RUD);
+        break;
+    case MIXER_DUALCOPTER:
+        servoMapOutputs(SERVO_DUALCOPTER_LEFT, SERVO_DUALCOPTER_RIGHT);
+        break;
+    case MIXER_SINGLECOPTER:
+        servoMapOutputs(SERVO_SINGLECOPTER_INDEX_MIN, SERVO_SINGLECOPTER_INDEX_MAX);
+        break;
+#endif // USE_UNCOMMON_MIXERS
+    default:
+        break;
+    }
 }
 
 void servoConfigureOutput(void) {
@@ -266,6 +317,8 @@ void servoConfigureOutput(void) {
             loadCustomServoMixer();
         }
     }
+    servoConfigureOutputMap();
+    servosCompileMixer();
 }
 
 
@@ -300,54 +353,11 @@ static void filterServos(void);
 void writeServos(void) {
     servoTable();
     filterServos();
+    // tricopter tail servo only moves when armed, unless the unarmed flag is set
+    const bool killServos = mixerIsTricopter() && !servosTricopterIsEnabledServoUnarmed() && !ARMING_FLAG(ARMED);
     uint8_t servoIndex = 0;
-    switch (currentMixerMode) {
-    case MIXER_TRI:
-    case MIXER_CUSTOM_TRI:
-        if (servosTricopterIsEnabledServoUnarmed()) {
-            // if unarmed flag set, we always move servo
-            pwmWriteServo(servoIndex++, servo[SERVO_RUDDER]);
-        } else {
-            // otherwise, only move servo when copter is armed
-            if (ARMING_FLAG(ARMED))
-                pwmWriteServo(servoIndex++, servo[SERVO_RUDDER]);
-            else
-                pwmWriteServo(servoIndex++, 0); // kill servo signal completely.
-        }
-        break;
-    case MIXER_FLYING_WING:
-        pwmWriteServo(servoIndex++, servo[SERVO_FLAPPERON_1]);
-        pwmWriteServo(servoIndex++, servo[SERVO_FLAPPERON_2]);
-        break;
-    case MIXER_CUSTOM_AIRPLANE:
-    case MIXER_AIRPLANE:
-        for (int i = SERVO_PLANE_INDEX_MIN; i <= SERVO_PLANE_INDEX_MAX; i++) {
-            pwmWriteServo(servoIndex++, servo[i]);
-        }
-        break;
-#ifdef USE_UNCOMMON_MIXERS
-    case MIXER_BICOPTER:
-        pwmWriteServo(servoIndex++, servo[SERVO_BICOPTER_LEFT]);
-        pwmWriteServo(servoIndex++, servo[SERVO_BICOPTER_RIGHT]);
-        break;
-    case MIXER_HELI_120_CCPM:
-        pwmWriteServo(servoIndex++, servo[SERVO_HELI_LEFT]);
-        pwmWriteServo(servoIndex++, servo[SERVO_HELI_RIGHT]);
-        pwmWriteServo(servoIndex++, servo[SERVO_HELI_TOP]);
-        pwmWriteServo(servoIndex++, servo[SERVO_HELI_RUD]);
-        break;
-    case MIXER_DUALCOPTER:
-        pwmWriteServo(servoIndex++, servo[SERVO_DUALCOPTER_LEFT]);
-        pwmWriteServo(servoIndex++, servo[SERVO_DUALCOPTER_RIGHT]);
-        break;
-    case MIXER_SINGLECOPTER:
-        for (int i = SERVO_SINGLECOPTER_INDEX_MIN; i <= SERVO_SINGLECOPTER_INDEX_MAX; i++) {
-            pwmWriteServo(servoIndex++, servo[i]);
-        }
-        break;
-#endif // USE_UNCOMMON_MIXERS
-    default:
-        break;
+    for (; servoIndex < servoOutputCount; servoIndex++) {
+        pwmWriteServo(servoIndex, killServos ? 0 : servo[servoOutputMap[servoIndex]]);
     }
     // Two servos for SERVO_TILT, if enabled
     if (feature(FEATURE_SERVO_TILT) || currentMixerMode == MIXER_GIMBAL) {
@@ -361,26 +371,35 @@ void writeServos(void) {
     }
 }
 
+#define STABILIZED_INPUTS ((1 << INPUT_STABILIZED_ROLL) | (1 << INPUT_STABILIZED_PITCH) | (1 << INPUT_STABILIZED_YAW))
+
 void servoMixer(void) {
     int16_t input[INPUT_SOURCE_COUNT]; // Range [-500:+500]
-    static int16_t currentOutput[MAX_SERVO_RULES];
-    if (FLIGHT_MODE(PASSTHRU_MODE)) {
-        // Direct passthru from RX
-        input[INPUT_STABILIZED_ROLL] = rcCommand[ROLL];
-        input[INPUT_STABILIZED_PITCH] = rcCommand[PITCH];
-        input[INPUT_STABILIZED_YAW] = rcCommand[YAW];
-    } else {
-        // Assisted modes (gyro only or gyro+acc according to AUX configuration in Gui
-        input[INPUT_STABILIZED_ROLL] = pidData[FD_ROLL].Sum * PID_SERVO_MIXER_SCALING;
-        input[INPUT_STABILIZED_PITCH] = pidData[FD_PITCH].Sum * PID_SERVO_MIXER_SCALING;
-        input[INPUT_STABILIZED_YAW] = pidData[FD_YAW].Sum * PID_SERVO_MIXER_SCALING;
-        // Reverse yaw servo when inverted in 3D mode
-        if (feature(FEATURE_3D) && (rcData[THROTTLE] < rxConfig()->midrc)) {
-            input[INPUT_STABILIZED_YAW] *= -1;
+    const uint16_t usedInputs = mixerTable.usedInputs;
+    // only the inputs some rule reads are filled in
+    if (usedInputs & STABILIZED_INPUTS) {
+        if (FLIGHT_MODE(PASSTHRU_MODE)) {
+            // Direct passthru from RX
+            input[INPUT_STABILIZED_ROLL] = rcCommand[ROLL];
+            input[INPUT_STABILIZED_PITCH] = rcCommand[PITCH];
+            input[INPUT_STABILIZED_YAW] = rcCommand[YAW];
+        } else {
+            // Assisted modes (gyro only or gyro+acc according to AUX configuration in Gui
+            input[INPUT_STABILIZED_ROLL] = pidData[FD_ROLL].Sum * PID_SERVO_MIXER_SCALING;
+            input[INPUT_STABILIZED_PITCH] = pidData[FD_PITCH].Sum * PID_SERVO_MIXER_SCALING;
+            input[INPUT_STABILIZED_YAW] = pidData[FD_YAW].Sum * PID_SERVO_MIXER_SCALING;
+            // Reverse yaw servo when inverted in 3D mode
+            if (feature(FEATURE_3D) && (rcData[THROTTLE] < rxConfig()->midrc)) {
+                input[INPUT_STABILIZED_YAW] *= -1;
+            }
         }
     }
-    input[INPUT_GIMBAL_PITCH] = scaleRange(attitude.values.pitch, -1800, 1800, -500, +500);
-    input[INPUT_GIMBAL_ROLL] = scaleRange(attitude.values.roll, -1800, 1800, -500, +500);
+    if (usedInputs & (1 << INPUT_GIMBAL_PITCH)) {
+        input[INPUT_GIMBAL_PITCH] = scaleRange(attitude.values.pitch, -1800, 1800, -500, +500);
+    }
+    if (usedInputs & (1 << INPUT_GIMBAL_ROLL)) {
+        input[INPUT_GIMBAL_ROLL] = scaleRange(attitude.values.roll, -1800, 1800, -500, +500);
+    }
     input[INPUT_STABILIZED_THROTTLE] = motor[0] - 1000 - 500;  // Since it derives from rcCommand or mincommand and must be [-500:+500]
     // center the RC input value around the RC middle value
     // by subtracting the RC middle value from the RC input value, we get:
@@ -388,43 +407,22 @@ void servoMixer(void) {
     // 2000 - 1500 = +500
     // 1500 - 1500 = 0
     // 1000 - 1500 = -500
-    input[INPUT_RC_ROLL]     = rcData[ROLL]     - rxConfig()->midrc;
-    input[INPUT_RC_PITCH]    = rcData[PITCH]    - rxConfig()->midrc;
-    input[INPUT_RC_YAW]      = rcData[YAW]      - rxConfig()->midrc;
-    input[INPUT_RC_THROTTLE] = rcData[THROTTLE] - rxConfig()->midrc;
-    input[INPUT_RC_AUX1]     = rcData[AUX1]     - rxConfig()->midrc;
-    input[INPUT_RC_AUX2]     = rcData[AUX2]     - rxConfig()->midrc;
-    input[INPUT_RC_AUX3]     = rcData[AUX3]     - rxConfig()->midrc;
-    input[INPUT_RC_AUX4]     = rcData[AUX4]     - rxConfig()->midrc;
-    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
-        servo[i] = 0;
-    }
-    // mix servos according to rules
-    for (int i = 0; i < servoRuleCount; i++) {
-        // consider rule if no box assigned or box is active
-        if (currentServoMixer[i].box == 0 || IS_RC_MODE_ACTIVE(BOXSERVO1 + currentServoMixer[i].box - 1)) {
-            uint8_t target = currentServoMixer[i].targetChannel;
-            uint8_t from = currentServoMixer[i].inputSource;
-            uint16_t servo_width = servoParams(target)->max - servoParams(target)->min;
-            int16_t min = currentServoMixer[i].min * servo_width / 100 - servo_width / 2;
-            int16_t max = currentServoMixer[i].max * servo_width / 100 - servo_width / 2;
-            if (currentServoMixer[i].speed == 0)
-                currentOutput[i] = input[from];
-            else {
-                if (currentOutput[i] < input[from])
-                    currentOutput[i] = constrain(currentOutput[i] + currentServoMixer[i].speed, currentOutput[i], input[from]);
-                else if (currentOutput[i] > input[from])
-                    currentOutput[i] = constrain(currentOutput[i] - currentServoMixer[i].speed, input[from], currentOutput[i]);
-            }
-            servo[target] += servoDirection(target, from) * constrain(((int32_t)currentOutput[i] * currentServoMixer[i].rate) / 100, min, max);
-        } else {
-            currentOutput[i] = 0;
+    const uint16_t midrc = rxConfig()->midrc;
+    input[INPUT_RC_ROLL]     = rcData[ROLL]     - midrc;
+    input[INPUT_RC_PITCH]    = rcData[PITCH]    - midrc;
+    input[INPUT_RC_YAW]      = rcData[YAW]      - midrc;
+    input[INPUT_RC_THROTTLE] = rcData[THROTTLE] - midrc;
+    input[INPUT_RC_AUX1]     = rcData[AUX1]     - midrc;
+    input[INPUT_RC_AUX2]     = rcData[AUX2]     - midrc;
+    input[INPUT_RC_AUX3]     = rcData[AUX3]     - midrc;
+    input[INPUT_RC_AUX4]     = rcData[AUX4]     - midrc;
+    uint8_t activeBoxes = 0;
+    for (int i = 0; i < MAX_SERVO_BOXES; i++) {
+        if (IS_RC_MODE_ACTIVE(BOXSERVO1 + i)) {
+            activeBoxes |= 1 << i;
         }
     }
-    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
-        servo[i] = ((int32_t)servoParams(i)->rate * servo[i]) / 100L;
-        servo[i] += determineServoMiddleOrForwardFromChannel(i);
-    }
+    servoTableApply(&mixerTable, input, activeBoxes, rcData, rxRuntimeConfig.channelCount, servo);
 }
 
 
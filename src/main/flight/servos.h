@@ -25,7 +25,7 @@
 #include "drivers/pwm_output.h"
 
 // These must be consecutive, see 'reversedSources'
-enum {
+typedef enum {
     INPUT_STABILIZED_ROLL = 0,
     INPUT_STABILIZED_PITCH,
     INPUT_STABILIZED_YAW,
@@ -141,6 +141,7 @@ void servoMixerLoadMix(int index);
 void loadCustomServoMixer(void);
 int servoDirection(int servoIndex, int fromChannel);
 void servoConfigureOutput(void);
+void servosCompileMixer(void);
 void servosInit(void);
 void servosFilterInit(void);
 void servoMixer(void);
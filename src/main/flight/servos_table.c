@@ -0,0 +1,93 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_SERVOS
+
+#include "common/maths.h"
+
+#include "flight/servos_table.h"
+
+void servoTableCompile(servoTable_t *table, const servoMixer_t *rules, uint8_t ruleCount, const servoParam_t *params) {
+    table->ruleCount = MIN(ruleCount, MAX_SERVO_RULES);
+    table->usedInputs = 0;
+    for (int i = 0; i < table->ruleCount; i++) {
+        const servoMixer_t *rule = &rules[i];
+        servoTableRule_t *compiled = &table->rules[i];
+        memset(compiled, 0, sizeof(*compiled));
+        if (rule->targetChannel >= MAX_SUPPORTED_SERVOS || rule->inputSource >= INPUT_SOURCE_COUNT || rule->box > MAX_SERVO_BOXES) {
+            // nothing sane to read or write, leave the rule switched off
+            compiled->boxMask = SERVO_TABLE_BOX_NEVER;
+            continue;
+        }
+        const servoParam_t *param = &params[rule->targetChannel];
+        // same integer arithmetic as the per loop calculation this replaces, including the truncation
+        const uint16_t servoWidth = param->max - param->min;
+        compiled->min = rule->min * servoWidth / 100 - servoWidth / 2;
+        compiled->max = rule->max * servoWidth / 100 - servoWidth / 2;
+        compiled->rate = rule->rate;
+        compiled->speed = rule->speed;
+        compiled->target = rule->targetChannel;
+        compiled->from = rule->inputSource;
+        compiled->sign = (param->reversedSources & (1 << rule->inputSource)) ? -1 : 0;
+        compiled->boxMask = rule->box ? 1 << (rule->box - 1) : 0;
+        table->usedInputs |= 1 << rule->inputSource;
+    }
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        table->outputs[i].middle = params[i].middle;
+        table->outputs[i].rate = params[i].rate;
+        table->outputs[i].forwardFromChannel = params[i].forwardFromChannel;
+    }
+}
+
+// activeBoxes has bit n set while BOXSERVO1 + n is active
+void servoTableApply(servoTable_t *table, const int16_t *input, uint8_t activeBoxes, const int16_t *rcData, uint8_t channelCount, int16_t *servoOut) {
+    int16_t mix[MAX_SUPPORTED_SERVOS] = { 0 };
+    for (int i = 0; i < table->ruleCount; i++) {
+        const servoTableRule_t *rule = &table->rules[i];
+        int16_t *output = &table->currentOutput[i];
+        if (rule->boxMask & ~activeBoxes) {
+            *output = 0;
+            continue;
+        }
+        const int16_t target = input[rule->from];
+        if (rule->speed == 0) {
+            *output = target;
+        } else if (*output < target) {
+            *output = MIN(*output + rule->speed, target);
+        } else if (*output > target) {
+            *output = MAX(*output - rule->speed, target);
+        }
+        const int value = constrain(((int32_t)*output * rule->rate) / 100, rule->min, rule->max);
+        mix[rule->target] += (value ^ rule->sign) - rule->sign;
+    }
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        const servoTableOutput_t *out = &table->outputs[i];
+        const int16_t scaled = ((int32_t)out->rate * mix[i]) / 100L;
+        servoOut[i] = scaled + (out->forwardFromChannel < channelCount ? rcData[out->forwardFromChannel] : out->middle);
+    }
+}
+
+#endif // USE_SERVOS
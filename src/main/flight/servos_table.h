@@ -0,0 +1,58 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "flight/servos.h"
+
+// Servo mixer rules resolved against the servo parameters once at config time,
+// so the PID loop only adds up clamped and scaled inputs.
+
+#define SERVO_TABLE_BOX_NEVER 0x80     // invalid rule, never active
+
+typedef struct servoTableRule_s {
+    int16_t min;                        // rule limits in servo units
+    int16_t max;
+    int8_t rate;
+    uint8_t speed;
+    uint8_t target;
+    uint8_t from;
+    int8_t sign;                        // 0 or -1, applied as (value ^ sign) - sign
+    uint8_t boxMask;                    // BOXSERVOn bits that must be active, 0 = always
+} servoTableRule_t;
+
+typedef struct servoTableOutput_s {
+    int16_t middle;
+    int8_t rate;
+    uint8_t forwardFromChannel;         // CHANNEL_FORWARDING_DISABLED (0xFF) never matches
+} servoTableOutput_t;
+
+typedef struct servoTable_s {
+    servoTableRule_t rules[MAX_SERVO_RULES];
+    servoTableOutput_t outputs[MAX_SUPPORTED_SERVOS];
+    int16_t currentOutput[MAX_SERVO_RULES]; // speed limited rule inputs, kept across recompiles
+    uint16_t usedInputs;                // bit per input source read by a rule
+    uint8_t ruleCount;
+} servoTable_t;
+
+void servoTableCompile(servoTable_t *table, const servoMixer_t *rules, uint8_t ruleCount, const servoParam_t *params);
+void servoTableApply(servoTable_t *table, const int16_t *input, uint8_t activeBoxes, const int16_t *rcData, uint8_t channelCount, int16_t *servoOut);
@@ -81,6 +81,7 @@ extern uint8_t __config_end;
 #include "drivers/sensor.h"
 #include "drivers/serial.h"
 #include "drivers/serial_escserial.h"
+#include "drivers/serial_usb_vcp.h"
 #include "drivers/sound_beeper.h"
 #include "drivers/stack_check.h"
 #include "drivers/system.h"
@@ -176,7 +177,12 @@ static serialPort_t *cliPort;
 // Space required to set array parameters
 #define CLI_IN_BUFFER_SIZE 256
 #endif
+// Output is flushed when the buffer fills, once a command is done and before blocking
+#ifdef MINIMAL_CLI
 #define CLI_OUT_BUFFER_SIZE 64
+#else
+#define CLI_OUT_BUFFER_SIZE 256
+#endif
 
 static bufWriter_t *cliWriter;
 static uint8_t cliWriteBuffer[sizeof(*cliWriter) + CLI_OUT_BUFFER_SIZE];
@@ -296,7 +302,6 @@ static void cliPrint(const char *str) {
             bufWriterAppend(cliWriter, *str++);
         }
     }
-    bufWriterFlush(cliWriter);
 }
 
 static void cliPrintLinefeed(void) {
@@ -320,8 +325,8 @@ static void cliPrintHashLine(const char *str) {
 }
 #endif
 
-static void cliPutp(void *p, char ch) {
-    bufWriterAppend(p, ch);
+static void cliPutw(void *p, const char *data, int len) {
+    bufWriterAppendData(p, data, len);
 }
 
 typedef enum {
@@ -335,8 +340,7 @@ typedef enum {
 } dumpFlags_e;
 
 static void cliPrintfva(const char *format, va_list va) {
-    tfp_format(cliWriter, cliPutp, format, va);
-    bufWriterFlush(cliWriter);
+    tfp_format_write(cliWriter, cliPutw, format, va);
 }
 
 static bool cliDumpPrintLinef(uint8_t dumpMask, bool equalsDefault, const char *format, ...) {
@@ -460,50 +464,26 @@ static void printValuePointer(const clivalue_t *var, const void *valuePointer, b
 }
 
 
-static bool valuePtrEqualsDefault(const clivalue_t *var, const void *ptr, const void *ptrDefault) {
-    bool result = true;
-    int elementCount = 1;
-    uint32_t mask = 0xffffffff;
-    if ((var->type & VALUE_MODE_MASK) == MODE_ARRAY) {
-        elementCount = var->config.array.length;
-    }
-    if ((var->type & VALUE_MODE_MASK) == MODE_BITSET) {
-        mask = 1 << var->config.bitpos;
-    }
-    for (int i = 0; i < elementCount; i++) {
-        switch (var->type & VALUE_TYPE_MASK) {
-        case VAR_UINT8:
-            result = result && (((uint8_t *)ptr)[i] & mask) == (((uint8_t *)ptrDefault)[i] & mask);
-            break;
-        case VAR_INT8:
-            result = result && ((int8_t *)ptr)[i] == ((int8_t *)ptrDefault)[i];
-            break;
-        case VAR_UINT16:
-            result = result && (((int16_t *)ptr)[i] & mask) == (((int16_t *)ptrDefault)[i] & mask);
-            break;
-        case VAR_INT16:
-            result = result && ((int16_t *)ptr)[i] == ((int16_t *)ptrDefault)[i];
-            break;
-        case VAR_UINT32:
-            result = result && (((uint32_t *)ptr)[i] & mask) == (((uint32_t *)ptrDefault)[i] & mask);
-            break;
-        }
+static uint8_t valueElementSize(const clivalue_t *var) {
+    switch (var->type & VALUE_TYPE_MASK) {
+    case VAR_UINT16:
+    case VAR_INT16:
+        return 2;
+    case VAR_UINT32:
+        return 4;
+    default:
+        return 1;
     }
-    for (int i = 0; i < elementCount; i++) {
-        switch (var->type & VALUE_TYPE_MASK) {
-        case VAR_UINT8:
-            result = result && ((uint8_t *)ptr)[i] == ((uint8_t *)ptrDefault)[i];
-            break;
-        case VAR_INT8:
-            result = result && ((int8_t *)ptr)[i] == ((int8_t *)ptrDefault)[i];
-            break;
-        case VAR_UINT16:
-        case VAR_INT16:
-            result = result && ((int16_t *)ptr)[i] == ((int16_t *)ptrDefault)[i];
-            break;
-        }
+}
+
+STATIC_UNIT_TESTED bool valuePtrEqualsDefault(const clivalue_t *var, const void *ptr, const void *ptrDefault) {
+    if ((var->type & (VALUE_TYPE_MASK | VALUE_MODE_MASK)) == (VAR_UINT32 | MODE_BITSET)) {
+        const uint32_t mask = 1 << var->config.bitpos;
+        return ((*(uint32_t *)ptr ^ *(uint32_t *)ptrDefault) & mask) == 0;
     }
-    return (result);
+    // bitsets in narrower fields compare the whole field
+    const int elementCount = ((var->type & VALUE_MODE_MASK) == MODE_ARRAY) ? var->config.array.length : 1;
+    return memcmp(ptr, ptrDefault, elementCount * valueElementSize(var)) == 0;
 }
 
 static uint8_t getPidProfileIndexToUse() {
@@ -541,8 +521,7 @@ const void *cliGetDefaultPointer(const clivalue_t *value) {
     return rec->address + getValueOffset(value);
 }
 
-static void dumpPgValue(const clivalue_t *value, uint8_t dumpMask) {
-    const pgRegistry_t *pg = pgFind(value->pgn);
+static void dumpPgValue(const clivalue_t *value, const pgRegistry_t *pg, uint8_t dumpMask) {
 #ifdef DEBUG
     if (!pg) {
         cliPrintLinef("VALUE %s ERROR", value->name);
@@ -565,13 +544,18 @@ static void dumpPgValue(const clivalue_t *value, uint8_t dumpMask) {
     }
 }
 
-static void dumpAllValues(uint16_t valueSection, uint8_t dumpMask) {
+STATIC_UNIT_TESTED void dumpAllValues(uint16_t valueSection, uint8_t dumpMask) {
+    const pgRegistry_t *pg = NULL;
     for (uint32_t i = 0; i < valueTableEntryCount; i++) {
         const clivalue_t *value = &valueTable[i];
-        bufWriterFlush(cliWriter);
-        if ((value->type & VALUE_SECTION_MASK) == valueSection) {
-            dumpPgValue(value, dumpMask);
+        if ((value->type & VALUE_SECTION_MASK) != valueSection) {
+            continue;
         }
+        // values of a group are listed together, so the registry is searched once per group
+        if (!pg || pgN(pg) != value->pgn) {
+            pg = pgFind(value->pgn);
+        }
+        dumpPgValue(value, pg, dumpMask);
     }
 }
 
@@ -916,6 +900,7 @@ static void cliAux(char *cmdline) {
             } else if (validArgumentCount != 6) {
                 memset(mac, 0, sizeof(modeActivationCondition_t));
             }
+            rcControlsInit();
             cliPrintLinef( "aux %u %u %u %u %u %u %u",
                            i,
                            mac->modeId,
@@ -1144,6 +1129,7 @@ static void cliSerialPassthrough(char *cmdline) {
         serialSetCtrlLineStateCb(cliPort, cbCtrlLine, (void *)(intptr_t)(pinioDtr - 1));
     }
 #endif /* USE_PINIO */
+    bufWriterFlush(cliWriter);
     serialPassthrough(cliPort, passThroughPort, NULL, NULL);
 }
 #endif
@@ -1230,6 +1216,7 @@ static void cliAdjustmentRange(char *cmdline) {
             }
             if (validArgumentCount != 6) {
                 memset(ar, 0, sizeof(adjustmentRange_t));
+                analyzeAdjustmentRanges();
                 cliShowParseError();
                 return;
             }
@@ -1248,6 +1235,7 @@ static void cliAdjustmentRange(char *cmdline) {
                 ar->adjustmentScale = val;
                 validArgumentCount++;
             }
+            analyzeAdjustmentRanges();
             cliDumpPrintLinef(0, false, format,
                               i,
                               ar->adjustmentIndex,
@@ -1684,6 +1672,7 @@ static void cliServo(char *cmdline) {
         servo->middle = arguments[MIDDLE];
         servo->rate = arguments[RATE];
         servo->forwardFromChannel = arguments[FORWARD];
+        servosCompileMixer();
         cliDumpPrintLinef(0, false, format,
                           i,
                           servo->min,
@@ -1744,6 +1733,7 @@ static void cliServoMix(char *cmdline) {
         for (uint32_t i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
             servoParamsMutable(i)->reversedSources = 0;
         }
+        servosCompileMixer();
     } else if (strncasecmp(cmdline, "load", 4) == 0) {
         const char *ptr = nextArg(cmdline);
         if (ptr) {
@@ -1796,6 +1786,7 @@ static void cliServoMix(char *cmdline) {
             } else {
                 servoParamsMutable(args[SERVO])->reversedSources &= ~(1 << args[INPUT]);
             }
+            servosCompileMixer();
         } else {
             cliShowParseError();
             return;
@@ -2640,6 +2631,7 @@ static void cliExit(char *cmdline) {
 #ifdef USE_GPS
 static void cliGpsPassthrough(char *cmdline) {
     UNUSED(cmdline);
+    bufWriterFlush(cliWriter);
     gpsEnablePassthrough(cliPort);
 }
 #endif
@@ -2827,16 +2819,63 @@ void printEscInfo(const uint8_t *escInfoBuffer, uint8_t bytesRead) {
     }
 }
 
-static void executeEscInfoCommand(uint8_t escIndex) {
-    cliPrintLinef("Info for ESC %d:", escIndex);
-    uint8_t escInfoBuffer[ESC_INFO_BLHELI32_EXPECTED_FRAME_SIZE];
-    startEscDataRead(escInfoBuffer, ESC_INFO_BLHELI32_EXPECTED_FRAME_SIZE);
-    pwmWriteDshotCommand(escIndex, getMotorCount(), DSHOT_CMD_ESC_INFO, true);
-    delay(10);
-    printEscInfo(escInfoBuffer, getNumberEscBytesRead());
+// ESC info replies are collected by the ESC sensor task, cliProcess() prints them one motor at a time
+static struct {
+    uint8_t frame[ESC_INFO_BLHELI32_EXPECTED_FRAME_SIZE];
+    uint8_t motor;
+    uint8_t lastMotor;
+    bool active;
+    bool requested;
+} cliEscInfo;
+
+static void cliEscInfoStart(uint8_t escIndex) {
+    cliEscInfo.motor = escIndex == ALL_MOTORS ? 0 : escIndex;
+    cliEscInfo.lastMotor = escIndex == ALL_MOTORS ? getMotorCount() - 1 : escIndex;
+    cliEscInfo.requested = false;
+    cliEscInfo.active = true;
+}
+
+static void cliEscInfoUpdate(void) {
+    if (!cliEscInfo.active || escSensorInfoIsPending()) {
+        return;
+    }
+    if (cliEscInfo.requested) {
+        printEscInfo(cliEscInfo.frame, getNumberEscBytesRead());
+        cliEscInfo.requested = false;
+        if (cliEscInfo.motor++ == cliEscInfo.lastMotor) {
+            cliEscInfo.active = false;
+            return;
+        }
+    }
+    cliPrintLinef("Info for ESC %d:", cliEscInfo.motor);
+    memset(cliEscInfo.frame, 0, sizeof(cliEscInfo.frame));
+    if (!escSensorRequestInfo(cliEscInfo.motor, cliEscInfo.frame, sizeof(cliEscInfo.frame))) {
+        cliPrintLine("No Info.");
+        cliEscInfo.active = false;
+        return;
+    }
+    cliEscInfo.requested = true;
 }
 #endif // USE_ESC_SENSOR && USE_ESC_SENSOR_INFO
 
+#ifdef USE_DSHOT_TELEMETRY
+static void cliDshotTelemetryInfo(char *cmdline) {
+    UNUSED(cmdline);
+    if (!useDshotTelemetry) {
+        cliPrintLine("Dshot telemetry not enabled");
+        return;
+    }
+    cliPrintLine("Motor    eRPM     RPM  Replies  Errors  Err%");
+    cliPrintLine("=====  ======  ======  =======  ======  ====");
+    for (int i = 0; i < getMotorCount(); i++) {
+        const dshotTelemetryMotorState_t *state = getDshotTelemetryState(i);
+        const int erpm = getDshotTelemetry(i) * 100;
+        cliPrintLinef("%5d  %6d  %6d  %7d  %6d  %2d.%d", i, erpm, erpm * 2 / motorConfig()->motorPoleCount,
+                      state->replies, state->errors, state->errorPermille / 10, state->errorPermille % 10);
+    }
+}
+#endif
+
 static void cliDshotProg(char *cmdline) {
     if (isEmpty(cmdline) || motorConfig()->dev.motorPwmProtocol < PWM_TYPE_DSHOT150) {
         cliShowParseError();
@@ -2846,7 +2885,6 @@ static void cliDshotProg(char *cmdline) {
     char *pch = strtok_r(cmdline, " ", &saveptr);
     int pos = 0;
     int escIndex = 0;
-    bool firstCommand = true;
     while (pch != NULL) {
         switch (pos) {
         case 0:
@@ -2858,34 +2896,29 @@ static void cliDshotProg(char *cmdline) {
         default: {
             int command = atoi(pch);
             if (command >= 0 && command < DSHOT_MIN_THROTTLE) {
-                if (firstCommand) {
-                    pwmDisableMotors();
-                    if (command == DSHOT_CMD_ESC_INFO) {
-                        delay(5); // Wait for potential ESC telemetry transmission to finish
-                    } else {
-                        delay(1);
-                    }
-                    firstCommand = false;
-                }
                 if (command != DSHOT_CMD_ESC_INFO) {
-                    pwmWriteDshotCommand(escIndex, getMotorCount(), command, true);
+                    // sent by the motor updates, later commands follow in order
+                    if (!dshotCommandWrite(escIndex, getMotorCount(), command)) {
+                        cliPrintErrorLinef("Command queue full: %d", command);
+                        return;
+                    }
+                    cliPrintLinef("Command Queued: %d", command);
                 } else {
 #if defined(USE_ESC_SENSOR) && defined(USE_ESC_SENSOR_INFO)
                     if (feature(FEATURE_ESC_SENSOR)) {
-                        if (escIndex != ALL_MOTORS) {
-                            executeEscInfoCommand(escIndex);
-                        } else {
-                            for (uint8_t i = 0; i < getMotorCount(); i++) {
-                                executeEscInfoCommand(i);
-                            }
+                        // queued behind the earlier commands, the replies are printed as they come in
+                        if (cliEscInfo.active) {
+                            cliPrintErrorLinef("ESC info already running");
+                            return;
                         }
+                        cliEscInfoStart(escIndex);
+                        cliPrintLinef("Command Queued: %d", command);
                     } else
 #endif
                     {
                         cliPrintLine("Not supported.");
                     }
                 }
-                cliPrintLinef("Command Sent: %d", command);
             } else {
                 cliPrintErrorLinef("Invalid command. Range: 1 - %d.", DSHOT_MIN_THROTTLE - 1);
             }
@@ -2895,7 +2928,6 @@ static void cliDshotProg(char *cmdline) {
         pos++;
         pch = strtok_r(NULL, " ", &saveptr);
     }
-    pwmEnableMotors();
 }
 #endif // USE_DSHOT
 
@@ -2940,6 +2972,7 @@ static void cliEscPassthrough(char *cmdline) {
         pos++;
         pch = strtok_r(NULL, " ", &saveptr);
     }
+    bufWriterFlush(cliWriter);
     escEnablePassthrough(cliPort, escIndex, mode);
 }
 #endif
@@ -3501,6 +3534,9 @@ STATIC_UNIT_TESTED void cliSet(char *cmdline) {
                 break;
                 }
                 if (valueChanged) {
+                    if ((val->type & VALUE_SECTION_MASK) == PROFILE_VALUE) {
+                        pidMarkProfileDirty(getPidProfileIndexToUse());
+                    }
                     cliPrintf("%s set to ", val->name);
                     cliPrintVar(val, 0);
                 } else {
@@ -3577,6 +3613,20 @@ static void cliStatus(char *cmdline) {
 #define CONFIG_SIZE (&__config_end - &__config_start)
 #endif
     cliPrintLinef("I2C Errors: %d, config size: %d, max available config: %d", i2cErrorCounter, getEEPROMConfigSize(), CONFIG_SIZE);
+#ifdef USE_I2C
+    for (int device = 0; device < I2CDEV_COUNT; device++) {
+        const i2cBusStats_t *i2cStats = i2cGetBusStats(device);
+        if (i2cStats && i2cStats->jobs) {
+            cliPrintLinef("I2C%d jobs: %u, queue: %d (max %d), NAKs: %u, errors: %u, timeouts: %u, rejected: %u",
+                          I2C_DEV_TO_CFG(device), i2cStats->jobs, i2cStats->depth, i2cStats->maxDepth,
+                          i2cStats->naks, i2cStats->errors, i2cStats->timeouts, i2cStats->rejected);
+        }
+    }
+#endif
+#ifdef USE_VCP
+    const vcpTxStats_t *vcpTxStats = usbVcpGetTxStats();
+    cliPrintLinef("USB TX: %d bytes/s, %d bytes, dropped: %d, stalls: %d", vcpTxStats->bytesPerSecond, vcpTxStats->bytes, vcpTxStats->dropped, vcpTxStats->stalls);
+#endif
     const int gyroRate = getTaskDeltaTime(TASK_GYROPID) == 0 ? 0 : (int)(1000000.0f / ((float)getTaskDeltaTime(TASK_GYROPID)));
     const int rxRate = currentRxRefreshRate == 0 ? 0 : (int)(1000000.0f / ((float)currentRxRefreshRate));
     const int systemRate = getTaskDeltaTime(TASK_SYSTEM) == 0 ? 0 : (int)(1000000.0f / ((float)getTaskDeltaTime(TASK_SYSTEM)));
@@ -4335,6 +4385,9 @@ const clicmd_t cmdTable[] = {
 #endif
 #ifdef USE_DSHOT
     CLI_COMMAND_DEF("dshotprog", "program DShot ESC(s)", "<index> <command>+", cliDshotProg),
+#endif
+#ifdef USE_DSHOT_TELEMETRY
+    CLI_COMMAND_DEF("dshot_telemetry_info", "show bidirectional DShot telemetry", NULL, cliDshotTelemetryInfo),
 #endif
     CLI_COMMAND_DEF("dump", "dump configuration",
                     "[master|profile|rates|all] {defaults}", cliDump),
@@ -4475,6 +4528,9 @@ void cliProcess(void) {
     if (!cliWriter) {
         return;
     }
+#if defined(USE_DSHOT) && defined(USE_ESC_SENSOR) && defined(USE_ESC_SENSOR_INFO)
+    cliEscInfoUpdate();
+#endif
     // Be a little bit tricky.  Flush the last inputs buffer, if any.
     bufWriterFlush(cliWriter);
     while (serialRxBytesWaiting(cliPort)) {
@@ -4569,6 +4625,7 @@ void cliProcess(void) {
             cliWrite(c);
         }
     }
+    bufWriterFlush(cliWriter);
 }
 
 void cliEnter(serialPort_t *serialPort) {
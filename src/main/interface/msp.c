@@ -109,6 +109,7 @@
 #include "pg/vcd.h"
 
 #include "rx/rx.h"
+#include "rx/rx_frame_timing.h"
 #include "rx/msp.h"
 
 #include "scheduler/scheduler.h"
@@ -121,6 +122,7 @@
 #include "sensors/esc_sensor.h"
 #include "sensors/compass.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_spectrum.h"
 #include "sensors/rangefinder.h"
 #include "sensors/sensors.h"
 
@@ -509,6 +511,7 @@ bool mspCommonProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst, mspPostProcessFnPtr
         sbufWriteU8(dst, (uint8_t)getBatteryState());
         // Additional battery voltage field (DJI osd etc) (in 0.01V steps)
         sbufWriteU16(dst, getBatteryVoltage() * 10);
+        sbufWriteU32(dst, getMWhDrawn()); // milliwatt hours drawn from battery, 0 when the meter cannot measure power
         break;
     }
     case MSP_VOLTAGE_METERS: {
@@ -818,6 +821,16 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst) {
             sbufWriteU16(dst, rcData[i]);
         }
         break;
+    case MSP_RX_TIMING: {
+        const rxFrameTiming_t *timing = rxGetFrameTiming();
+        sbufWriteU16(dst, MIN(timing->frameDeltaUs, UINT16_MAX));
+        sbufWriteU16(dst, rxFrameTimingAverageUs(timing));
+        sbufWriteU16(dst, rxFrameTimingJitterUs(timing));
+        sbufWriteU16(dst, timing->maxJitterUs);
+        sbufWriteU32(dst, timing->frameCount);
+        sbufWriteU8(dst, rxHasFrameTimestamps());
+    }
+    break;
     case MSP_ATTITUDE:
         sbufWriteU16(dst, attitude.values.roll);
         sbufWriteU16(dst, attitude.values.pitch);
@@ -1121,12 +1134,18 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst) {
         sbufWriteU8(dst, 1); // Rate numerator, not used anymore
         sbufWriteU8(dst, blackboxGetRateDenom());
         sbufWriteU16(dst, blackboxConfig()->p_ratio);
+        sbufWriteU8(dst, blackboxConfig()->rate_governor);
+        sbufWriteU16(dst, blackboxGetGovernedPInterval()); // achieved rate is 1 / (looptime * P interval)
+        sbufWriteU32(dst, blackboxGetGovernorOverruns());
 #else
         sbufWriteU8(dst, 0); // Blackbox not supported
         sbufWriteU8(dst, 0);
         sbufWriteU8(dst, 0);
         sbufWriteU8(dst, 0);
         sbufWriteU16(dst, 0);
+        sbufWriteU8(dst, 0);
+        sbufWriteU16(dst, 0);
+        sbufWriteU32(dst, 0);
 #endif
         break;
     case MSP_SDCARD_SUMMARY:
@@ -1353,6 +1372,27 @@ static mspResult_e mspFcProcessOutCommandWithArg(uint8_t cmdMSP, sbuf_t *src, sb
         serializeBoxReply(dst, page, &serializeBoxPermanentIdFn);
     }
     break;
+#endif
+#ifdef USE_GYRO_SPECTRUM
+    case MSP_GYRO_SPECTRUM: {
+        // one throttle row per request, levels in 0.5dB steps
+        const gyroSpectrumMap_t *map = gyroSpectrumGetMap();
+        const uint8_t row = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+        if (!gyroSpectrumIsEnabled() || row >= map->throttleBins) {
+            return MSP_RESULT_ERROR;
+        }
+        sbufWriteU16(dst, gyroSpectrumSampleRateHz());
+        sbufWriteU8(dst, map->freqBins);
+        sbufWriteU8(dst, map->throttleBins);
+        sbufWriteU8(dst, row);
+        sbufWriteU16(dst, map->windows[row]);
+        for (int source = 0; source < GYRO_SPECTRUM_SOURCE_COUNT; source++) {
+            for (int bin = 0; bin < map->freqBins; bin++) {
+                sbufWriteU8(dst, gyroSpectrumMapLevel(map, row, source, bin));
+            }
+        }
+    }
+    break;
 #endif
     case MSP_REBOOT:
         if (sbufBytesRemaining(src)) {
@@ -1536,6 +1576,7 @@ mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src) {
                 adjRange->range.endStep = sbufReadU8(src);
                 adjRange->adjustmentFunction = sbufReadU8(src);
                 adjRange->auxSwitchChannelIndex = sbufReadU8(src);
+                analyzeAdjustmentRanges();
             } else {
                 return MSP_RESULT_ERROR;
             }
@@ -1665,6 +1706,7 @@ mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src) {
             servoParamsMutable(i)->rate = sbufReadU8(src);
             servoParamsMutable(i)->forwardFromChannel = sbufReadU8(src);
             servoParamsMutable(i)->reversedSources = sbufReadU32(src);
+            servosCompileMixer();
         }
 #endif
         break;
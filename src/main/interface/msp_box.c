@@ -24,6 +24,8 @@
 
 #include "platform.h"
 
+#include "blackbox/blackbox.h"
+
 #include "common/bitarray.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
@@ -95,6 +97,7 @@ static const box_t boxes[CHECKBOX_ITEM_COUNT] = {
     { BOXPARALYZE, "PARALYZE", 45 },
     { BOXGPSRESCUE, "GPS RESCUE", 46 },
     { BOXNFEMODE, "NFE RACE MODE", 47 },
+    { BOXBLACKBOXBURST, "BLACKBOX BURST", 48 },
 };
 
 // mask of enabled IDs, calculated on startup based on enabled features. boxId_e is used as bit index
@@ -197,6 +200,11 @@ void initActiveBoxIds(void) {
 #ifdef USE_FLASHFS
     BME(BOXBLACKBOXERASE);
 #endif
+#ifdef USE_BLACKBOX_BURST
+    if (blackboxConfig()->burst) {
+        BME(BOXBLACKBOXBURST);
+    }
+#endif
 #endif
     BME(BOXFPVANGLEMIX);
     if (feature(FEATURE_3D)) {
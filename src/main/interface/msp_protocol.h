@@ -321,6 +321,8 @@
 
 #define MSP_SET_GPS_RESCUE       233  // GPS Rescues's angle, initialAltitude, descentDistance, rescueGroundSpeed, sanityChecks and minSats
 #define MSP_SET_GPS_RESCUE_PIDS  234    //in message          GPS Rescues's throttleP and velocity PIDS + yaw P
+#define MSP_GYRO_SPECTRUM        235    //out message         Gyro noise spectrum map, one throttle row per request
+#define MSP_RX_TIMING            236    //out message         RX frame interval, average, jitter, max jitter and frame count
 // #define MSP_BIND                 240    //in message          no param
 // #define MSP_ALARMS               242
 
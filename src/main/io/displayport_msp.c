@@ -27,6 +27,7 @@
 
 #ifdef USE_MSP_DISPLAYPORT
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "pg/pg.h"
@@ -38,13 +39,32 @@
 #include "interface/msp_protocol.h"
 
 #include "io/displayport_msp.h"
+#include "io/displayport_msp_shadow.h"
 
 #include "msp/msp_serial.h"
 
 // no template required since defaults are zero
 PG_REGISTER(displayPortProfile_t, displayPortProfileMsp, PG_DISPLAY_PORT_MSP_CONFIG, 0);
 
+PG_REGISTER_WITH_RESET_TEMPLATE(displayPortMspConfig_t, displayPortMspConfig, PG_DISPLAY_PORT_MSP_TX_CONFIG, 0);
+
+PG_RESET_TEMPLATE(displayPortMspConfig_t, displayPortMspConfig,
+                  .byteBudget = 240,
+                  .batch = 0,
+                 );
+
+#define MSP_OSD_MAX_STRING_LENGTH   30
+#define MSP_DP_WRITE_STRING         3
+// records of row, col, attribute, length and the characters, the id sits well above the standard
+// subcommands (0 heartbeat to 6 sys and the ones added after it) so it never aliases one of them
+#define MSP_DP_BATCH_WRITE          0x40
+#define MSP_DP_BATCH_RECORD_HEADER  4
+#define MSP_DP_BATCH_PAYLOAD_SIZE   250
+#define MSP_V1_FRAME_OVERHEAD       6   // $M> length command ... checksum
+#define MSP_SHADOW_MAX_RUNS         40
+
 static displayPort_t mspDisplayPort;
+static mspShadow_t mspShadow;
 
 #ifdef USE_CLI
 extern uint8_t cliMode;
@@ -69,8 +89,15 @@ static int heartbeat(displayPort_t *displayPort) {
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
+static int clearRemote(displayPort_t *displayPort) {
+    uint8_t subcmd[] = { 2 };
+    mspShadowRemoteCleared(&mspShadow);
+    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+}
+
+// the display content is unknown after it was taken over, start from a cleared one
 static int grab(displayPort_t *displayPort) {
-    return heartbeat(displayPort);
+    return heartbeat(displayPort) + clearRemote(displayPort);
 }
 
 static int release(displayPort_t *displayPort) {
@@ -78,14 +105,92 @@ static int release(displayPort_t *displayPort) {
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
+// the OSD clears and redraws every refresh, only the canvas is cleared and drawScreen sends the difference
 static int clearScreen(displayPort_t *displayPort) {
-    uint8_t subcmd[] = { 2 };
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+    UNUSED(displayPort);
+    mspShadowClear(&mspShadow);
+    return 0;
+}
+
+static int sendRuns(displayPort_t *displayPort, const mspShadowRun_t *runs, uint8_t runCount) {
+    int ret = 0;
+    for (int i = 0; i < runCount; i++) {
+        uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
+        buf[0] = MSP_DP_WRITE_STRING;
+        buf[1] = runs[i].row;
+        buf[2] = runs[i].col;
+        buf[3] = 0;
+        memcpy(&buf[4], runs[i].chars, runs[i].len);
+        const int written = output(displayPort, MSP_DISPLAYPORT, buf, runs[i].len + 4);
+        if (written > 0) {
+            mspShadowRunSent(&mspShadow, &runs[i]);
+        }
+        ret += written;
+    }
+    return ret;
+}
+
+// marks the runs in the frame as sent once output() took it
+static int sendBatch(displayPort_t *displayPort, uint8_t *buf, int len, const mspShadowRun_t *runs, uint8_t runCount) {
+    const int written = output(displayPort, MSP_DISPLAYPORT, buf, len);
+    if (written > 0) {
+        for (int i = 0; i < runCount; i++) {
+            mspShadowRunSent(&mspShadow, &runs[i]);
+        }
+    }
+    return written;
+}
+
+static int sendRunsBatched(displayPort_t *displayPort, const mspShadowRun_t *runs, uint8_t runCount) {
+    uint8_t buf[MSP_DP_BATCH_PAYLOAD_SIZE];
+    int ret = 0;
+    int len = 0;
+    int first = 0;
+    for (int i = 0; i < runCount; i++) {
+        if (len && len + MSP_DP_BATCH_RECORD_HEADER + runs[i].len > MSP_DP_BATCH_PAYLOAD_SIZE) {
+            ret += sendBatch(displayPort, buf, len, &runs[first], i - first);
+            len = 0;
+            first = i;
+        }
+        if (len == 0) {
+            buf[len++] = MSP_DP_BATCH_WRITE;
+        }
+        buf[len++] = runs[i].row;
+        buf[len++] = runs[i].col;
+        buf[len++] = 0;
+        buf[len++] = runs[i].len;
+        memcpy(&buf[len], runs[i].chars, runs[i].len);
+        len += runs[i].len;
+    }
+    if (len) {
+        ret += sendBatch(displayPort, buf, len, &runs[first], runCount - first);
+    }
+    return ret;
 }
 
 static int drawScreen(displayPort_t *displayPort) {
+    const displayPortMspConfig_t *config = displayPortMspConfig();
     uint8_t subcmd[] = { 4 };
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+    // leave room for the draw command itself
+    const uint32_t txFree = mspSerialTxBytesFree();
+    const uint32_t drawSize = MSP_V1_FRAME_OVERHEAD + sizeof(subcmd);
+    uint32_t budget = MIN(config->byteBudget, txFree > drawSize ? txFree - drawSize : 0);
+    mspShadowLimits_t limits = {
+        .runOverhead = MSP_V1_FRAME_OVERHEAD + 4,
+        .maxRunLen = MSP_OSD_MAX_STRING_LENGTH,
+        .maxRuns = MSP_SHADOW_MAX_RUNS,
+    };
+    if (config->batch) {
+        const uint32_t frames = (budget + MSP_DP_BATCH_PAYLOAD_SIZE - 1) / MSP_DP_BATCH_PAYLOAD_SIZE;
+        const uint32_t frameOverhead = frames * (MSP_V1_FRAME_OVERHEAD + 1);
+        budget = budget > frameOverhead ? budget - frameOverhead : 0;
+        limits.runOverhead = MSP_DP_BATCH_RECORD_HEADER;
+    }
+    limits.budget = budget;
+    mspShadowRun_t runs[MSP_SHADOW_MAX_RUNS];
+    const uint8_t runCount = mspShadowCollect(&mspShadow, &limits, runs);
+    int ret = config->batch ? sendRunsBatched(displayPort, runs, runCount) : sendRuns(displayPort, runs, runCount);
+    return ret + output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
 static int screenSize(const displayPort_t *displayPort) {
@@ -93,25 +198,15 @@ static int screenSize(const displayPort_t *displayPort) {
 }
 
 static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, const char *string) {
-#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
-    uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
-    int len = strlen(string);
-    if (len >= MSP_OSD_MAX_STRING_LENGTH) {
-        len = MSP_OSD_MAX_STRING_LENGTH;
-    }
-    buf[0] = 3;
-    buf[1] = row;
-    buf[2] = col;
-    buf[3] = 0;
-    memcpy(&buf[4], string, len);
-    return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
+    UNUSED(displayPort);
+    mspShadowWrite(&mspShadow, col, row, string);
+    return 0;
 }
 
 static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t c) {
-    char buf[2];
-    buf[0] = c;
-    buf[1] = 0;
-    return writeString(displayPort, col, row, buf); //!!TODO - check if there is a direct MSP command to do this
+    UNUSED(displayPort);
+    mspShadowWriteChar(&mspShadow, col, row, c);
+    return 0;
 }
 
 static bool isTransferInProgress(const displayPort_t *displayPort) {
@@ -127,6 +222,8 @@ static bool isSynced(const displayPort_t *displayPort) {
 static void resync(displayPort_t *displayPort) {
     displayPort->rows = 13 + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
     displayPort->cols = 30 + displayPortProfileMsp()->colAdjust;
+    mspShadowInit(&mspShadow, displayPort->rows, displayPort->cols);
+    clearRemote(displayPort);
     drawScreen(displayPort);
 }
 
@@ -25,5 +25,12 @@
 
 PG_DECLARE(displayPortProfile_t, displayPortProfileMsp);
 
+typedef struct displayPortMspConfig_s {
+    uint16_t byteBudget;    // bytes sent per screen update, changes that do not fit wait for the next one
+    uint8_t batch;          // pack the changed runs into batch write frames, the display has to support them
+} displayPortMspConfig_t;
+
+PG_DECLARE(displayPortMspConfig_t, displayPortMspConfig);
+
 struct displayPort_s;
 struct displayPort_s *displayPortMspInit(void);
@@ -0,0 +1,176 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Shadow canvas of the MSP displayport.
+ *
+ *   The OSD redraws the whole screen on every refresh. The writes land in the
+ * canvas and only the characters that differ from what the display already
+ * shows are sent when the screen is drawn. Changed characters close to each
+ * other are merged into one run when the unchanged gap costs less than the
+ * overhead of another run. Rows are visited by priority, the row that has
+ * been waiting with unsent changes for the most frames goes first and the top
+ * row wins a tie. Runs are collected until the byte budget of the frame is
+ * used up, a row that did not fit only gets older, so no part of the screen
+ * starves behind text that changes on every frame. With nothing left to
+ * change, one row per frame is resent in full so a display that lost its
+ * state catches up.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "io/displayport_msp_shadow.h"
+
+void mspShadowInit(mspShadow_t *shadow, uint8_t rows, uint8_t cols) {
+    memset(shadow, 0, sizeof(*shadow));
+    shadow->rows = rows < MSP_SHADOW_MAX_ROWS ? rows : MSP_SHADOW_MAX_ROWS;
+    shadow->cols = cols < MSP_SHADOW_MAX_COLS ? cols : MSP_SHADOW_MAX_COLS;
+    mspShadowClear(shadow);
+    mspShadowRemoteCleared(shadow);
+}
+
+void mspShadowClear(mspShadow_t *shadow) {
+    memset(shadow->canvas, MSP_SHADOW_BLANK, sizeof(shadow->canvas));
+}
+
+// the display was told to clear itself
+void mspShadowRemoteCleared(mspShadow_t *shadow) {
+    memset(shadow->remote, MSP_SHADOW_BLANK, sizeof(shadow->remote));
+}
+
+void mspShadowWrite(mspShadow_t *shadow, uint8_t col, uint8_t row, const char *string) {
+    if (row >= shadow->rows) {
+        return;
+    }
+    for (uint8_t *c = &shadow->canvas[row][col]; col < shadow->cols && *string; col++) {
+        *c++ = *string++;
+    }
+}
+
+void mspShadowWriteChar(mspShadow_t *shadow, uint8_t col, uint8_t row, uint8_t c) {
+    if (row < shadow->rows && col < shadow->cols) {
+        shadow->canvas[row][col] = c;
+    }
+}
+
+static bool mspShadowChanged(const mspShadow_t *shadow, uint8_t row, uint8_t col) {
+    return shadow->canvas[row][col] != shadow->remote[row][col];
+}
+
+static void mspShadowAddRun(mspShadow_t *shadow, mspShadowRun_t *run, uint8_t row, uint8_t col, uint8_t len) {
+    run->row = row;
+    run->col = col;
+    run->len = len;
+    run->chars = &shadow->canvas[row][col];
+}
+
+// the display took the run, a run that was not sent is collected again on the next frame
+void mspShadowRunSent(mspShadow_t *shadow, const mspShadowRun_t *run) {
+    memcpy(&shadow->remote[run->row][run->col], run->chars, run->len);
+}
+
+// returns false when the budget ran out before the row was done
+static bool mspShadowCollectRow(mspShadow_t *shadow, uint8_t row, const mspShadowLimits_t *limits, mspShadowRun_t *runs, uint8_t *runCount, uint16_t *budget) {
+    uint8_t col = 0;
+    while (col < shadow->cols) {
+        if (!mspShadowChanged(shadow, row, col)) {
+            col++;
+            continue;
+        }
+        // extend the run over unchanged gaps that are cheaper than starting another run
+        uint8_t end = col + 1;
+        for (uint8_t c = end; c < shadow->cols && c - col < limits->maxRunLen && c - end < limits->runOverhead; c++) {
+            if (mspShadowChanged(shadow, row, c)) {
+                end = c + 1;
+            }
+        }
+        const uint8_t len = end - col;
+        if (*runCount == limits->maxRuns || limits->runOverhead + len > *budget) {
+            return false;
+        }
+        mspShadowAddRun(shadow, &runs[(*runCount)++], row, col, len);
+        *budget -= limits->runOverhead + len;
+        col = end;
+    }
+    return true;
+}
+
+static void mspShadowCollectRefresh(mspShadow_t *shadow, const mspShadowLimits_t *limits, mspShadowRun_t *runs, uint8_t *runCount, uint16_t budget) {
+    const uint8_t chunks = (shadow->cols + limits->maxRunLen - 1) / limits->maxRunLen;
+    if (*runCount + chunks > limits->maxRuns || chunks * limits->runOverhead + shadow->cols > budget) {
+        return;
+    }
+    const uint8_t row = shadow->refreshRow;
+    for (uint8_t col = 0; col < shadow->cols; col += limits->maxRunLen) {
+        const uint8_t len = shadow->cols - col < limits->maxRunLen ? shadow->cols - col : limits->maxRunLen;
+        mspShadowAddRun(shadow, &runs[(*runCount)++], row, col, len);
+    }
+    shadow->refreshRow = (row + 1) % shadow->rows;
+}
+
+static bool mspShadowRowChanged(const mspShadow_t *shadow, uint8_t row) {
+    return memcmp(shadow->canvas[row], shadow->remote[row], shadow->cols) != 0;
+}
+
+// ages the rows with pending changes and sorts them oldest first, returns how many there are
+static uint8_t mspShadowPrioritize(mspShadow_t *shadow, uint8_t *order) {
+    uint8_t count = 0;
+    for (uint8_t row = 0; row < shadow->rows; row++) {
+        if (!mspShadowRowChanged(shadow, row)) {
+            shadow->rowAge[row] = 0;
+            continue;
+        }
+        if (shadow->rowAge[row] < UINT8_MAX) {
+            shadow->rowAge[row]++;
+        }
+        // insertion sort, rows arrive top first so equal ages keep their screen order
+        uint8_t i = count++;
+        for (; i > 0 && shadow->rowAge[order[i - 1]] < shadow->rowAge[row]; i--) {
+            order[i] = order[i - 1];
+        }
+        order[i] = row;
+    }
+    return count;
+}
+
+// fills runs with what has to be sent to bring the display up to date, as far as the limits allow
+uint8_t mspShadowCollect(mspShadow_t *shadow, const mspShadowLimits_t *limits, mspShadowRun_t *runs) {
+    uint8_t runCount = 0;
+    uint16_t budget = limits->budget;
+    if (shadow->rows == 0 || limits->maxRunLen == 0) {
+        return 0;
+    }
+    uint8_t order[MSP_SHADOW_MAX_ROWS];
+    const uint8_t pendingRows = mspShadowPrioritize(shadow, order);
+    for (int i = 0; i < pendingRows; i++) {
+        if (!mspShadowCollectRow(shadow, order[i], limits, runs, &runCount, &budget)) {
+            return runCount;
+        }
+        shadow->rowAge[order[i]] = 0;
+    }
+    if (runCount == 0) {
+        mspShadowCollectRefresh(shadow, limits, runs, &runCount, budget);
+    }
+    return runCount;
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MSP_SHADOW_MAX_ROWS 18
+#define MSP_SHADOW_MAX_COLS 60
+#define MSP_SHADOW_BLANK    ' '
+
+// characters to send, chars points into the canvas and is valid until the next write
+typedef struct mspShadowRun_s {
+    uint8_t row;
+    uint8_t col;
+    uint8_t len;
+    const uint8_t *chars;
+} mspShadowRun_t;
+
+typedef struct mspShadowLimits_s {
+    uint16_t budget;        // bytes available for the runs including their overhead
+    uint8_t runOverhead;    // bytes added to every run on the wire
+    uint8_t maxRunLen;
+    uint8_t maxRuns;
+} mspShadowLimits_t;
+
+typedef struct mspShadow_s {
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t refreshRow;     // next row resent in full when nothing changed
+    uint8_t rowAge[MSP_SHADOW_MAX_ROWS];    // frames the row has been waiting with changes not sent
+    uint8_t canvas[MSP_SHADOW_MAX_ROWS][MSP_SHADOW_MAX_COLS];   // what the OSD drew
+    uint8_t remote[MSP_SHADOW_MAX_ROWS][MSP_SHADOW_MAX_COLS];   // what the display shows
+} mspShadow_t;
+
+void mspShadowInit(mspShadow_t *shadow, uint8_t rows, uint8_t cols);
+void mspShadowClear(mspShadow_t *shadow);
+void mspShadowRemoteCleared(mspShadow_t *shadow);
+void mspShadowWrite(mspShadow_t *shadow, uint8_t col, uint8_t row, const char *string);
+void mspShadowWriteChar(mspShadow_t *shadow, uint8_t col, uint8_t row, uint8_t c);
+uint8_t mspShadowCollect(mspShadow_t *shadow, const mspShadowLimits_t *limits, mspShadowRun_t *runs);
+void mspShadowRunSent(mspShadow_t *shadow, const mspShadowRun_t *run);
@@ -28,18 +28,29 @@
  * Note that bits can only be set to 0 when writing, not back to 1 from 0. You must erase sectors in order
  * to bring bits back to 1 again.
  *
- * In future, we can add support for multiple different flash chips by adding a flash device driver vtable
- * and make calls through that, at the moment flashfs just calls m25p16_* routines explicitly.
+ * On NAND devices the volume skips the blocks the driver reports as bad, so flashfs addresses are only equal to
+ * device addresses up to the first bad block. Erasing the volume runs in the background one block at a time, driven
+ * by flashfsEraseUpdate(), and writes may follow the eraser as soon as it has moved on. An erase that was cut short by
+ * a reboot is picked up again by flashfsInit().
  */
 
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
 
+#include "build/build_config.h"
+
+#include "common/maths.h"
+#include "common/time.h"
+#include "common/utils.h"
+
 #include "drivers/flash.h"
 
 #include "io/flashfs.h"
 
+// Enough for two W25N01G dies at their specified worst case, plus some that wear out
+#define FLASHFS_MAX_BAD_BLOCKS 64
+
 static uint8_t flashWriteBuffer[FLASHFS_WRITE_BUFFER_SIZE];
 
 /* The position of our head and tail in the circular flash write buffer.
@@ -54,6 +65,25 @@ static uint8_t bufferHead = 0, bufferTail = 0;
 // The position of the buffer's tail in the overall flash address space:
 static uint32_t tailAddress = 0;
 
+// The volume as flashfs uses it, the device less its bad blocks
+static flashGeometry_t volumeGeometry;
+
+// Device blocks that are skipped, ascending
+static uint16_t badBlocks[FLASHFS_MAX_BAD_BLOCKS];
+static uint8_t badBlockCount = 0;
+
+// Background erase, everything below eraseAddress is erased
+static bool eraseActive = false;
+static bool eraseInFlight = false;
+static uint32_t eraseAddress = 0;
+static uint16_t eraseBlock;
+
+enum {
+    /* We don't expect valid data to ever contain this many consecutive uint32_t's of all 1 bits: */
+    FREE_BLOCK_TEST_SIZE_INTS = 4, // i.e. 16 bytes
+    FREE_BLOCK_TEST_SIZE_BYTES = FREE_BLOCK_TEST_SIZE_INTS * sizeof(uint32_t)
+};
+
 static void flashfsClearBuffer(void) {
     bufferTail = bufferHead = 0;
 }
@@ -66,10 +96,89 @@ static void flashfsSetTailAddress(uint32_t address) {
     tailAddress = address;
 }
 
+static void flashfsAddBadBlock(uint16_t block) {
+    if (badBlockCount == FLASHFS_MAX_BAD_BLOCKS) {
+        // No room to skip it, so the volume ends there
+        volumeGeometry.sectors = MIN(volumeGeometry.sectors, block - badBlockCount);
+    } else {
+        int i = badBlockCount++;
+        for (; i > 0 && badBlocks[i - 1] > block; i--) {
+            badBlocks[i] = badBlocks[i - 1];
+        }
+        badBlocks[i] = block;
+        volumeGeometry.sectors--;
+    }
+    volumeGeometry.totalSize = volumeGeometry.sectors * volumeGeometry.sectorSize;
+}
+
+/**
+ * Translate a volume address to a device address. Volume block n is the n-th good block of the device.
+ */
+STATIC_UNIT_TESTED uint32_t flashfsDeviceAddress(uint32_t address) {
+    if (badBlockCount == 0) {
+        return address;
+    }
+    uint32_t block = address / volumeGeometry.sectorSize;
+    for (int i = 0; i < badBlockCount && badBlocks[i] <= block; i++) {
+        block++;
+    }
+    return block * volumeGeometry.sectorSize + address % volumeGeometry.sectorSize;
+}
+
+/**
+ * Keep the background erase going while the device is idle. A block that fails to erase is retired by the
+ * driver, the same volume block then maps to the next good one and is erased again.
+ *
+ * Returns true once there is nothing left to erase.
+ */
+static bool flashfsEraseAhead(void) {
+    if (!eraseActive) {
+        return true;
+    }
+    if (!flashIsReady()) {
+        return false;
+    }
+    if (eraseInFlight) {
+        eraseInFlight = false;
+        if (flashIsBadBlock(eraseBlock)) {
+            flashfsAddBadBlock(eraseBlock);
+        } else {
+            eraseAddress += volumeGeometry.sectorSize;
+        }
+    }
+    if (eraseAddress >= volumeGeometry.totalSize) {
+        eraseActive = false;
+        return true;
+    }
+    eraseBlock = flashfsDeviceAddress(eraseAddress) / volumeGeometry.sectorSize;
+    flashEraseSector(eraseBlock * volumeGeometry.sectorSize);
+    eraseInFlight = true;
+    return false;
+}
+
+/**
+ * Scheduler task, keeps the background erase going while nothing else uses the device.
+ */
+void flashfsEraseUpdate(timeUs_t currentTimeUs) {
+    UNUSED(currentTimeUs);
+    flashfsEraseAhead();
+}
+
+/**
+ * On NAND the erase only starts here and continues from flashfsEraseUpdate(), flashfsIsReady() and the flush calls,
+ * the volume can be written straight away behind it.
+ */
 void flashfsEraseCompletely(void) {
-    flashEraseCompletely();
     flashfsClearBuffer();
     flashfsSetTailAddress(0);
+    if (volumeGeometry.flashType == FLASH_TYPE_NAND) {
+        eraseAddress = 0;
+        eraseInFlight = false;
+        eraseActive = true;
+        flashfsEraseAhead();
+    } else {
+        flashEraseCompletely();
+    }
 }
 
 /**
@@ -77,7 +186,7 @@ void flashfsEraseCompletely(void) {
  * all the bytes in the range [start...end) are erased.
  */
 void flashfsEraseRange(uint32_t start, uint32_t end) {
-    const flashGeometry_t *geometry = flashGetGeometry();
+    const flashGeometry_t *geometry = flashfsGetGeometry();
     if (geometry->sectorSize <= 0)
         return;
     // Round the start down to a sector boundary
@@ -89,7 +198,7 @@ void flashfsEraseRange(uint32_t start, uint32_t end) {
         endSector++;
     }
     for (int i = startSector; i < endSector; i++) {
-        flashEraseSector(i * geometry->sectorSize);
+        flashEraseSector(flashfsDeviceAddress(i * geometry->sectorSize));
     }
 }
 
@@ -98,7 +207,7 @@ void flashfsEraseRange(uint32_t start, uint32_t end) {
  */
 bool flashfsIsReady(void) {
     // Check for flash chip existence first, then check if ready.
-    return (flashfsIsSupported() && flashIsReady());
+    return (flashfsIsSupported() && flashfsEraseAhead() && flashIsReady());
 }
 
 bool flashfsIsSupported(void) {
@@ -106,7 +215,7 @@ bool flashfsIsSupported(void) {
 }
 
 uint32_t flashfsGetSize(void) {
-    return flashGetGeometry()->totalSize;
+    return volumeGeometry.totalSize;
 }
 
 static uint32_t flashfsTransmitBufferUsed(void) {
@@ -130,7 +239,7 @@ uint32_t flashfsGetWriteBufferFreeSpace(void) {
 }
 
 const flashGeometry_t* flashfsGetGeometry(void) {
-    return flashGetGeometry();
+    return &volumeGeometry;
 }
 
 /**
@@ -175,13 +284,23 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
         } else {
             bytesTotalThisIteration = bytesTotalRemaining;
         }
+        // Keep a whole erased block between the log and the background erase, see flashfsResumeErase()
+        if (eraseActive && tailAddress + volumeGeometry.sectorSize >= eraseAddress) {
+            if (!sync) {
+                flashfsEraseAhead();
+                break;
+            }
+            do {
+                flashfsEraseAhead();
+            } while (eraseActive && tailAddress + volumeGeometry.sectorSize >= eraseAddress);
+        }
         // Are we at EOF already? Abort.
         if (flashfsIsEOF()) {
             // May as well throw away any buffered data
             flashfsClearBuffer();
             break;
         }
-        flashPageProgramBegin(tailAddress);
+        flashPageProgramBegin(flashfsDeviceAddress(tailAddress));
         bytesRemainThisIteration = bytesTotalThisIteration;
         for (i = 0; i < bufferCount; i++) {
             if (bufferSizes[i] > 0) {
@@ -266,6 +385,7 @@ static void flashfsAdvanceTailInBuffer(uint32_t delta) {
  */
 bool flashfsFlushAsync(void) {
     if (flashfsBufferIsEmpty()) {
+        flashfsEraseAhead();
         return true; // Nothing to flush
     }
     uint8_t const * buffers[2];
@@ -384,6 +504,29 @@ void flashfsWrite(const uint8_t *data, unsigned int len, bool sync) {
     }
 }
 
+static bool flashfsTestBufferIsErased(const uint32_t *ints) {
+    // Checking the buffer 4 bytes at a time like this is probably faster than byte-by-byte, but I didn't benchmark it :)
+    for (int i = 0; i < FREE_BLOCK_TEST_SIZE_INTS; i++) {
+        if (ints[i] != 0xFFFFFFFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void flashfsClosePage(void) {
+    switch(flashfsGetGeometry()->flashType) {
+    case FLASH_TYPE_NOR:
+        break;
+    case FLASH_TYPE_NAND:
+        flashFlush();
+        // Advance tailAddress to next page boundary.
+        uint32_t pageSize = flashfsGetGeometry()->pageSize;
+        flashfsSetTailAddress((tailAddress + pageSize - 1) & ~(pageSize - 1));
+        break;
+    }
+}
+
 /**
  * Read `len` bytes from the given address into the supplied buffer.
  *
@@ -398,12 +541,37 @@ int flashfsReadAbs(uint32_t address, uint8_t *buffer, unsigned int len) {
     }
     // Since the read could overlap data in our dirty buffers, force a sync to clear those first
     flashfsFlushSync();
-    bytesRead = flashReadBytes(address, buffer, len);
+    // A NAND page can only be programmed once, the driver completes the open one when it is read so move on from it
+    if (volumeGeometry.flashType == FLASH_TYPE_NAND && tailAddress % volumeGeometry.pageSize) {
+        const uint32_t openPage = tailAddress - tailAddress % volumeGeometry.pageSize;
+        if (address < openPage + volumeGeometry.pageSize && address + len > openPage) {
+            flashfsClosePage();
+        }
+    }
+    if (badBlockCount == 0) {
+        bytesRead = flashReadBytes(address, buffer, len);
+        return bytesRead;
+    }
+    // Blocks that follow each other in the volume need not be adjacent on the device
+    bytesRead = 0;
+    while (len > 0) {
+        const unsigned int chunk = MIN(len, volumeGeometry.sectorSize - address % volumeGeometry.sectorSize);
+        const int chunkRead = flashReadBytes(flashfsDeviceAddress(address), buffer, chunk);
+        bytesRead += chunkRead;
+        if (chunkRead < (int)chunk) {
+            break;
+        }
+        address += chunk;
+        buffer += chunk;
+        len -= chunk;
+    }
     return bytesRead;
 }
 
 /**
  * Find the offset of the start of the free space on the device (or the size of the device if it is full).
+ *
+ * While a background erase is running only the erased part of the volume is free.
  */
 int flashfsIdentifyStartOfFreeSpace(void) {
     /* Find the start of the free space on the device by examining the beginning of blocks with a binary search,
@@ -418,11 +586,8 @@ int flashfsIdentifyStartOfFreeSpace(void) {
         /* We can choose whatever power of 2 size we like, which determines how much wastage of free space we'll have
          * at the end of the last written data. But smaller blocksizes will require more searching.
          */
-        FREE_BLOCK_SIZE = 2048, // XXX This can't be smaller than page size for underlying flash device.
+        FREE_BLOCK_SIZE = 2048 // XXX This can't be smaller than page size for underlying flash device.
 
-        /* We don't expect valid data to ever contain this many consecutive uint32_t's of all 1 bits: */
-        FREE_BLOCK_TEST_SIZE_INTS = 4, // i.e. 16 bytes
-        FREE_BLOCK_TEST_SIZE_BYTES = FREE_BLOCK_TEST_SIZE_INTS * sizeof(uint32_t)
     };
     STATIC_ASSERT(FREE_BLOCK_SIZE >= FLASH_MAX_PAGE_SIZE, FREE_BLOCK_SIZE_too_small);
     union {
@@ -430,26 +595,16 @@ int flashfsIdentifyStartOfFreeSpace(void) {
         uint32_t ints[FREE_BLOCK_TEST_SIZE_INTS];
     } testBuffer;
     int left = 0; // Smallest block index in the search region
-    int right = flashfsGetSize() / FREE_BLOCK_SIZE; // One past the largest block index in the search region
+    int right = (eraseActive ? eraseAddress : flashfsGetSize()) / FREE_BLOCK_SIZE; // One past the largest block index in the search region
     int mid;
     int result = right;
-    int i;
-    bool blockErased;
     while (left < right) {
         mid = (left + right) / 2;
-        if (flashReadBytes(mid * FREE_BLOCK_SIZE, testBuffer.bytes, FREE_BLOCK_TEST_SIZE_BYTES) < FREE_BLOCK_TEST_SIZE_BYTES) {
+        if (flashReadBytes(flashfsDeviceAddress(mid * FREE_BLOCK_SIZE), testBuffer.bytes, FREE_BLOCK_TEST_SIZE_BYTES) < FREE_BLOCK_TEST_SIZE_BYTES) {
             // Unexpected timeout from flash, so bail early (reporting the device fuller than it really is)
             break;
         }
-        // Checking the buffer 4 bytes at a time like this is probably faster than byte-by-byte, but I didn't benchmark it :)
-        blockErased = true;
-        for (i = 0; i < FREE_BLOCK_TEST_SIZE_INTS; i++) {
-            if (testBuffer.ints[i] != 0xFFFFFFFF) {
-                blockErased = false;
-                break;
-            }
-        }
-        if (blockErased) {
+        if (flashfsTestBufferIsErased(testBuffer.ints)) {
             /* This erased block might be the leftmost erased block in the volume, but we'll need to continue the
              * search leftwards to find out:
              */
@@ -462,6 +617,33 @@ int flashfsIdentifyStartOfFreeSpace(void) {
     return result * FREE_BLOCK_SIZE;
 }
 
+/**
+ * A volume block that starts erased after one that does not is where the erase of an earlier flashfsEraseCompletely()
+ * got to before the power went, the erase carries on from there. Writes stay a block behind the erase, so there is
+ * always an erased block between the log and old data that is still to be erased. The block the eraser was working
+ * on may still look written, or look erased without being so, so the erase resumes one block early where that block
+ * holds no data.
+ */
+static void flashfsResumeErase(void) {
+    uint32_t testBuffer[FREE_BLOCK_TEST_SIZE_INTS];
+    bool sawErased = false;
+    bool previousErased = false;
+    for (uint32_t address = 0; address < flashfsGetSize(); address += volumeGeometry.sectorSize) {
+        if (flashReadBytes(flashfsDeviceAddress(address), (uint8_t *)testBuffer, FREE_BLOCK_TEST_SIZE_BYTES) < FREE_BLOCK_TEST_SIZE_BYTES) {
+            return;
+        }
+        const bool erased = flashfsTestBufferIsErased(testBuffer);
+        if (sawErased && !erased) {
+            eraseAddress = previousErased ? address - volumeGeometry.sectorSize : address;
+            eraseInFlight = false;
+            eraseActive = true;
+            return;
+        }
+        sawErased |= erased;
+        previousErased = erased;
+    }
+}
+
 /**
  * Returns true if the file pointer is at the end of the device.
  */
@@ -470,22 +652,25 @@ bool flashfsIsEOF(void) {
 }
 
 void flashfsClose(void) {
-    switch(flashfsGetGeometry()->flashType) {
-    case FLASH_TYPE_NOR:
-        break;
-    case FLASH_TYPE_NAND:
-        flashFlush();
-        // Advance tailAddress to next page boundary.
-        uint32_t pageSize = flashfsGetGeometry()->pageSize;
-        flashfsSetTailAddress((tailAddress + pageSize - 1) & ~(pageSize - 1));
-        break;
-    }
+    flashfsClosePage();
 }
 
 /**
  * Call after initializing the flash chip in order to set up the filesystem.
  */
 void flashfsInit(void) {
+    volumeGeometry = *flashGetGeometry();
+    badBlockCount = 0;
+    eraseActive = false;
+    if (volumeGeometry.flashType == FLASH_TYPE_NAND) {
+        const uint16_t deviceBlocks = volumeGeometry.sectors;
+        for (int block = 0; block < deviceBlocks; block++) {
+            if (flashIsBadBlock(block)) {
+                flashfsAddBadBlock(block);
+            }
+        }
+        flashfsResumeErase();
+    }
     // If we have a flash chip present at all
     if (flashfsGetSize() > 0) {
         // Start the file pointer off at the beginning of free space so caller can start writing immediately
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 #define FLASHFS_WRITE_BUFFER_SIZE 128
 #define FLASHFS_WRITE_BUFFER_USABLE (FLASHFS_WRITE_BUFFER_SIZE - 1)
 
@@ -28,6 +30,7 @@
 
 void flashfsEraseCompletely(void);
 void flashfsEraseRange(uint32_t start, uint32_t end);
+void flashfsEraseUpdate(timeUs_t currentTimeUs);
 
 uint32_t flashfsGetSize(void);
 uint32_t flashfsGetOffset(void);
@@ -90,6 +90,7 @@
 #include "pg/rx.h"
 
 #include "rx/rx.h"
+#include "rx/rx_frame_timing.h"
 
 #include "sensors/acceleration.h"
 #include "sensors/adcinternal.h"
@@ -189,6 +190,7 @@ static const uint8_t osdElementDisplayOrder[] = {
     OSD_CRSF_TX,
     OSD_CRSF_SNR,
     OSD_CRSF_RSSI,
+    OSD_RX_JITTER,
     OSD_CROSSHAIRS,
     OSD_HORIZON_SIDEBARS,
     OSD_ITEM_TIMER_1,
@@ -515,6 +517,12 @@ static bool osdDrawSingleElement(uint8_t item) {
         }
         break;
     }
+    case OSD_RX_JITTER: {
+        // mean deviation of the rx frame interval in us
+        const uint16_t jitterUs = rxFrameTimingJitterUs(rxGetFrameTiming());
+        tfp_sprintf(buff, "RXJ%4d", MIN(jitterUs, 9999));
+        break;
+    }
     case OSD_CRSF_SNR: { //crsf signal to noise ratio
         if(crsfRssi) {
             uint8_t osdSNR = CRSFgetSnR();
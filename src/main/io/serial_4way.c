@@ -38,6 +38,8 @@
 #include "drivers/pwm_output.h"
 #include "drivers/light_led.h"
 
+#include "common/maths.h"
+
 #include "flight/mixer.h"
 
 #include "io/beeper.h"
@@ -77,7 +79,7 @@
 // *** change to adapt Revision
 #define SERIAL_4WAY_VER_MAIN 20
 #define SERIAL_4WAY_VER_SUB_1 (uint8_t) 0
-#define SERIAL_4WAY_VER_SUB_2 (uint8_t) 04
+#define SERIAL_4WAY_VER_SUB_2 (uint8_t) 05
 
 #define SERIAL_4WAY_PROTOCOL_VER 108
 // *** end
@@ -257,6 +259,24 @@ void esc4wayRelease(void) {
 //PARAM: uint8_t ADRESS_Hi + ADRESS_Lo + BUffLen + Buffer[0..255]
 //RETURN: ACK
 
+// Batched image transfer, since 20.0.05
+// The host loads the image into the interface once, the interface then writes
+// and verifies it page by page on every selected ESC without a host round trip
+// per page. Images larger than the buffer are sent in buffer sized windows.
+
+// Write to the image buffer of the interface // Buffer Len is Max 256 Bytes
+// BuffLen = 0 means 256 Bytes
+#define cmd_ImageBufferWrite 0x41   // 'A' write image buffer
+// PARAM: uint8_t OFFSET_Hi + OFFSET_Lo + BUffLen + Buffer[0..255]
+// RETURN: ACK or ACK_I_INVALID_PARAM
+
+// Write and verify the image buffer on all ESCs of the mask
+// All ESCs must report the signature of the device connected by cmd_DeviceInitFlash
+// Pages starting inside the range are erased first (SiLabs and ARM bootloaders)
+#define cmd_ImageFlash 0x42         // 'B' flash image
+// PARAM: uint8_t ADRESS_Hi + ADRESS_Lo + 3 + EscMask + ImageLen_Hi + ImageLen_Lo
+// RETURN: uint8_t EscResult[EscCount] + ACK (first failing EscResult)
+
 
 // responses
 #define ACK_OK                  0x00
@@ -374,6 +394,107 @@ static uint8_t Connect(uint8_32_u *pDeviceInfo) {
 return 0;
 }
 
+#ifdef USE_SERIAL_4WAY_IMAGE_BUFFER
+#ifndef SERIAL_4WAY_IMAGE_BUFFER_SIZE
+#define SERIAL_4WAY_IMAGE_BUFFER_SIZE (16 * 1024) // BLHeli_S and BLHeli images fit in one window
+#endif
+
+static uint8_t imageBuffer[SERIAL_4WAY_IMAGE_BUFFER_SIZE];
+
+static uint16_t imagePageSize(uint8_t interfaceMode) {
+    switch (interfaceMode) {
+    case imSIL_BLB:
+        return 512;
+    case imARM_BLB:
+        return 1024;
+    default:
+        return 0; // the AVR bootloader erases as it writes
+    }
+}
+
+// writes the image buffer to the connected ESC, every chunk is verified before the next one goes out
+static uint8_t imageFlashConnected(uint16_t address, uint16_t length, uint8_t *verifyBuf) {
+    const uint16_t pageSize = imagePageSize(CurrentInterfaceMode);
+    // first page not erased yet, partial pages at either end of the image are erased too
+    uint32_t eraseAddress = pageSize ? address - (address % pageSize) : 0x10000;
+    ioMem_t ioMem;
+    for (uint32_t offset = 0; offset < length; offset += 256) {
+        const uint16_t chunk = MIN(length - offset, 256);
+        const uint16_t chunkAddress = address + offset;
+        while (eraseAddress < (uint32_t)chunkAddress + chunk) {
+            ioMem.D_FLASH_ADDR_H = eraseAddress >> 8;
+            ioMem.D_FLASH_ADDR_L = eraseAddress & 0xFF;
+            if (!BL_PageErase(&ioMem)) {
+                return ACK_D_GENERAL_ERROR;
+            }
+            eraseAddress += pageSize;
+        }
+        ioMem.D_FLASH_ADDR_H = chunkAddress >> 8;
+        ioMem.D_FLASH_ADDR_L = chunkAddress & 0xFF;
+        ioMem.D_NUM_BYTES = chunk & 0xFF; // 0 means 256
+        ioMem.D_PTR_I = &imageBuffer[offset];
+        if (!BL_WriteFlash(&ioMem)) {
+            return ACK_D_GENERAL_ERROR;
+        }
+        if (CurrentInterfaceMode == imARM_BLB) {
+            // verified by the bootloader, no need to read the chunk back
+            ioMem.D_PTR_I = &imageBuffer[offset];
+            switch (BL_VerifyFlash(&ioMem)) {
+            case brSUCCESS:
+                break;
+            case brERRORVERIFY:
+                return ACK_I_VERIFY_ERROR;
+            default:
+                return ACK_D_GENERAL_ERROR;
+            }
+        } else {
+            ioMem.D_PTR_I = verifyBuf;
+            if (!BL_ReadFlash(CurrentInterfaceMode, &ioMem)) {
+                return ACK_D_GENERAL_ERROR;
+            }
+            if (memcmp(verifyBuf, &imageBuffer[offset], chunk) != 0) {
+                return ACK_I_VERIFY_ERROR;
+            }
+        }
+    }
+    return ACK_OK;
+}
+
+// ESCs are written one after the other, they share the bit banged bootloader timing.
+// The host's selection is restored afterwards so the session carries on with the ESC it had connected.
+static uint8_t imageFlash(uint8_t escMask, uint16_t address, uint16_t length, uint8_t *result, uint8_t *verifyBuf) {
+    const uint8_t savedEsc = selected_esc;
+    const uint8_32_u savedDeviceInfo = DeviceInfo;
+    const uint8_t savedInterfaceMode = CurrentInterfaceMode;
+    const uint16_t signature = DeviceInfo.words[0];
+    uint8_t ack = ACK_OK;
+    for (uint8_t esc = 0; esc < escCount; esc++) {
+        result[esc] = ACK_OK;
+        if (!(escMask & (1 << esc))) {
+            continue;
+        }
+        SET_DISCONNECTED;
+        selected_esc = esc;
+        if (!Connect(&DeviceInfo)) {
+            SET_DISCONNECTED;
+            result[esc] = ACK_D_GENERAL_ERROR;
+        } else if (DeviceInfo.words[0] != signature || CurrentInterfaceMode == imSK) {
+            result[esc] = ACK_I_INVALID_CHANNEL;
+        } else {
+            DeviceInfo.bytes[INTF_MODE_IDX] = CurrentInterfaceMode;
+            result[esc] = imageFlashConnected(address, length, verifyBuf);
+        }
+        if (ack == ACK_OK) {
+            ack = result[esc];
+        }
+    }
+    selected_esc = savedEsc;
+    DeviceInfo = savedDeviceInfo;
+    CurrentInterfaceMode = savedInterfaceMode;
+    return ack;
+}
+#endif
+
 static serialPort_t *port;
 
 static uint8_t ReadByte(void) {
@@ -411,6 +532,9 @@ void esc4wayProcess(serialPort_t *mspPort) {
     uint8_t *O_PARAM;
     uint8_t *InBuff;
     ioMem_t ioMem;
+#ifdef USE_SERIAL_4WAY_IMAGE_BUFFER
+    uint8_t EscResult[MAX_SUPPORTED_MOTORS];
+#endif
     port = mspPort;
     // Start here  with UART Main loop
 #ifdef USE_BEEPER
@@ -777,6 +901,35 @@ void esc4wayProcess(serialPort_t *mspPort) {
                 }
                 break;
             }
+#endif
+#ifdef USE_SERIAL_4WAY_IMAGE_BUFFER
+            case cmd_ImageBufferWrite: {
+                const uint16_t offset = (ioMem.D_FLASH_ADDR_H << 8) | ioMem.D_FLASH_ADDR_L;
+                const uint16_t len = I_PARAM_LEN ? I_PARAM_LEN : 256;
+                if (offset + len <= SERIAL_4WAY_IMAGE_BUFFER_SIZE) {
+                    memcpy(&imageBuffer[offset], ParamBuf, len);
+                } else {
+                    ACK_OUT = ACK_I_INVALID_PARAM;
+                }
+                break;
+            }
+            case cmd_ImageFlash: {
+                const uint16_t address = (ioMem.D_FLASH_ADDR_H << 8) | ioMem.D_FLASH_ADDR_L;
+                const uint8_t escMask = ParamBuf[0];
+                const uint16_t len = (ParamBuf[1] << 8) | ParamBuf[2];
+                if (I_PARAM_LEN != 3 || len == 0 || len > SERIAL_4WAY_IMAGE_BUFFER_SIZE
+                    || (uint32_t)address + len > 0x10000) {
+                    ACK_OUT = ACK_I_INVALID_PARAM;
+                } else if (!isMcuConnected() || !(escMask & ((1 << escCount) - 1))) {
+                    ACK_OUT = ACK_I_INVALID_CHANNEL;
+                } else {
+                    // ParamBuf is free once the parameters are read, it holds the read back chunks
+                    ACK_OUT = imageFlash(escMask, address, len, EscResult, ParamBuf);
+                    O_PARAM_LEN = escCount;
+                    O_PARAM = EscResult;
+                }
+                break;
+            }
 #endif
             default: {
                 ACK_OUT = ACK_I_INVALID_CMD;
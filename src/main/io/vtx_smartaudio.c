@@ -46,6 +46,7 @@
 #include "io/vtx_control.h"
 #include "io/vtx_smartaudio.h"
 #include "io/vtx_string.h"
+#include "io/vtx_transport.h"
 
 #include "config/feature.h"
 
@@ -53,6 +54,7 @@
 // Timing parameters
 // Note that vtxSAProcess() is normally called at 200ms interval
 #define SMARTAUDIO_CMD_TIMEOUT       120    // Time until the command is considered lost
+#define SMARTAUDIO_CMD_RETRIES         3    // Resends before a command is given up
 #define SMARTAUDIO_POLLING_INTERVAL  150    // Minimum time between state polling
 #define SMARTAUDIO_POLLING_WINDOW   1000    // Time window after command polling for state change
 
@@ -248,21 +250,13 @@ static void saAutobaud(void) {
 // Transport level variables
 
 static timeUs_t sa_lastTransmissionMs = 0;
-static uint8_t sa_outstanding = SA_CMD_NONE; // Outstanding command
-static uint8_t sa_osbuf[32]; // Outstanding comamnd frame for retransmission
-static int sa_oslen;         // And associate length
+static vtxTransport_t saTransport;
 
 static void saProcessResponse(uint8_t *buf, int len) {
     uint8_t resp = buf[0];
-    if (resp == sa_outstanding) {
-        sa_outstanding = SA_CMD_NONE;
-    } else if ((resp == SA_CMD_GET_SETTINGS_V2 ||
-                resp == SA_CMD_GET_SETTINGS_V21) &&
-               (sa_outstanding == SA_CMD_GET_SETTINGS)) {
-        sa_outstanding = SA_CMD_NONE;
-    } else {
+    if (!vtxTransportReply(&saTransport, resp, millis())) {
         saStat.ooopresp++;
-        dprintf(("processResponse: outstanding %d got %d\r\n", sa_outstanding, resp));
+        dprintf(("processResponse: unexpected response %d\r\n", resp));
     }
     switch (resp) {
     case SA_CMD_GET_SETTINGS_V21: // Version 2.1 Get Settings
@@ -407,7 +401,7 @@ bool isLegacySmartAudioEnabled(void) {
     return feature(FEATURE_LEGACY_SA_SUPPORT);
 }
 
-static void saSendFrame(uint8_t *buf, int len) {
+static void saSendFrame(const uint8_t *buf, uint8_t len) {
     switch (smartAudioSerialPort->identifier) {
     case SERIAL_PORT_SOFTSERIAL1:
     case SERIAL_PORT_SOFTSERIAL2:
@@ -427,97 +421,63 @@ static void saSendFrame(uint8_t *buf, int len) {
 /*
  * Retransmission and command queuing
  *
- *   The transport level support includes retransmission on response timeout
- * and command queueing.
+ *   The transport level support, retransmission on response timeout and
+ * command queueing, is provided by the shared VTX transport.
  *
  * Resend buffer:
  *   The smartaudio returns response for valid command frames in no less
- * than 60msec, which we can't wait. So there's a need for a resend buffer.
+ * than 60msec, which we can't wait. The transport keeps a copy of the
+ * outstanding frame for resending.
  *
  * Command queueing:
  *   The driver autonomously sends GetSettings command for auto-bauding,
  * asynchronous to user initiated commands; commands issued while another
- * command is outstanding must be queued for later processing.
+ * command is outstanding must be queued for later processing. Settings that
+ * are changed again before they were sent replace the queued command.
  *   The queueing also handles the case in which multiple commands are
  * required to implement a user level command.
  */
 
-// Retransmission
-
-static void saResendCmd(void) {
-    saSendFrame(sa_osbuf, sa_oslen);
-}
-
-static void saSendCmd(uint8_t *buf, int len) {
-    for (int i = 0 ; i < len ; i++) {
-        sa_osbuf[i] = buf[i];
-    }
-    sa_oslen = len;
-    sa_outstanding = (buf[2] >> 1);
-    saSendFrame(sa_osbuf, sa_oslen);
-}
-
-// Command queue management
-
-typedef struct saCmdQueue_s {
-    uint8_t *buf;
-    int len;
-} saCmdQueue_t;
-
 #define SA_QSIZE 6     // 1 heartbeat (GetSettings) + 2 commands + 1 slack
 #define SA_AKK_MACH2_QSIZE 4
 
-static saCmdQueue_t sa_queue[SA_QSIZE];
-static saCmdQueue_t sa_akk_mach2_queue[SA_AKK_MACH2_QSIZE];
-static uint8_t sa_qhead = 0;
-static uint8_t sa_qtail = 0;
-
-static bool saQueueEmpty(void) {
-    return sa_qhead == sa_qtail;
-}
-
-static bool saQueueFull(void) {
-    return ((sa_qhead + 1) % (isLegacySmartAudioEnabled() ? SA_AKK_MACH2_QSIZE : SA_QSIZE)) == sa_qtail;
-}
-
-static void saQueueCmdInner(saCmdQueue_t *queue, uint8_t qSize, uint8_t *buf, int len) {
-    queue[sa_qhead].buf = buf;
-    queue[sa_qhead].len = len;
-    sa_qhead = (sa_qhead + 1) % qSize;
-}
-
-static void saQueueCmd(uint8_t *buf, int len) {
-    if (saQueueFull()) {
-        return;
-    }
-    if (isLegacySmartAudioEnabled()) {
-        saQueueCmdInner(sa_akk_mach2_queue, SA_AKK_MACH2_QSIZE, buf, len);
-    } else {
-        saQueueCmdInner(sa_queue, SA_QSIZE, buf, len);
+static bool saReplyMatches(uint8_t expected, uint8_t reply) {
+    if (expected == SA_CMD_GET_SETTINGS) {
+        return reply == SA_CMD_GET_SETTINGS || reply == SA_CMD_GET_SETTINGS_V2 || reply == SA_CMD_GET_SETTINGS_V21;
     }
+    return reply == expected;
 }
 
-static void saSendQueueInner(saCmdQueue_t *queue, uint8_t qSize) {
-    saSendCmd(queue[sa_qtail].buf, queue[sa_qtail].len);
-    sa_qtail = (sa_qtail + 1) % qSize;
-}
+static const vtxTransportPolicy_t saTransportPolicy = {
+    .send = saSendFrame,
+    .replyMatches = saReplyMatches,
+    .timeoutMs = SMARTAUDIO_CMD_TIMEOUT,
+    .guardMs = 0,
+    .maxRetries = SMARTAUDIO_CMD_RETRIES,
+    .queueDepth = SA_QSIZE,
+};
+
+static const vtxTransportPolicy_t saLegacyTransportPolicy = {
+    .send = saSendFrame,
+    .replyMatches = saReplyMatches,
+    .timeoutMs = SMARTAUDIO_CMD_TIMEOUT,
+    .guardMs = 0,
+    .maxRetries = SMARTAUDIO_CMD_RETRIES,
+    .queueDepth = SA_AKK_MACH2_QSIZE,
+};
 
-static void saSendQueue(void) {
-    if (saQueueEmpty()) {
+static void saQueueCmd(vtxCommandKind_e kind, const uint8_t *buf, uint8_t len) {
+    if (!smartAudioSerialPort) {
         return;
     }
-    if (isLegacySmartAudioEnabled()) {
-        saSendQueueInner(sa_akk_mach2_queue, SA_AKK_MACH2_QSIZE);
-    } else {
-        saSendQueueInner(sa_queue, SA_QSIZE);
-    }
+    vtxTransportQueue(&saTransport, kind, buf, len, buf[2] >> 1);
 }
 
 // Individual commands
 
 static void saGetSettings(void) {
     static uint8_t bufGetSettings[5] = {0xAA, 0x55, SACMD(SA_CMD_GET_SETTINGS), 0x00, 0x9F};
-    saQueueCmd(bufGetSettings, 5);
+    saQueueCmd(VTX_CMD_QUERY, bufGetSettings, 5);
 }
 
 static bool saValidateFreq(uint16_t freq) {
@@ -540,15 +500,19 @@ static void saDoDevSetFreq(uint16_t freq) {
     // Need to work around apparent SmartAudio bug when going from 'channel'
     // to 'user-freq' mode, where the set-freq command will fail if the freq
     // value is unchanged from the previous 'user-freq' mode
+    // Pit mode frequency commands and the workaround pair must not be coalesced
+    // with (or reordered by) a plain frequency change.
+    vtxCommandKind_e kind = (freq & (SA_FREQ_GETPIT | SA_FREQ_SETPIT)) ? VTX_CMD_OTHER : VTX_CMD_FREQUENCY;
     if ((saDevice.mode & SA_MODE_GET_FREQ_BY_FREQ) == 0 && freq == saDevice.freq) {
         memcpy(&switchBuf, &buf, sizeof(buf));
         const uint16_t switchFreq = freq + ((freq == VTX_SMARTAUDIO_MAX_FREQUENCY_MHZ) ? -1 : 1);
         switchBuf[4] = (switchFreq >> 8);
         switchBuf[5] = switchFreq & 0xff;
         switchBuf[6] = CRC8(switchBuf, 6);
-        saQueueCmd(switchBuf, 7);
+        saQueueCmd(VTX_CMD_OTHER, switchBuf, 7);
+        kind = VTX_CMD_OTHER;
     }
-    saQueueCmd(buf, 7);
+    saQueueCmd(kind, buf, 7);
 }
 
 void saSetFreq(uint16_t freq) {
@@ -574,7 +538,7 @@ static void saDevSetBandAndChannel(uint8_t band, uint8_t channel) {
     static uint8_t buf[6] = { 0xAA, 0x55, SACMD(SA_CMD_SET_CHAN), 1 };
     buf[4] = SA_BANDCHAN_TO_DEVICE_CHVAL(band, channel);
     buf[5] = CRC8(buf, 5);
-    saQueueCmd(buf, 6);
+    saQueueCmd(VTX_CMD_FREQUENCY, buf, 6);
 }
 
 void saSetBandAndChannel(uint8_t band, uint8_t channel) {
@@ -585,7 +549,7 @@ void saSetMode(int mode) {
     static uint8_t buf[6] = { 0xAA, 0x55, SACMD(SA_CMD_SET_MODE), 1 };
     buf[4] = (mode & 0x3f) | saLockMode;
     buf[5] = CRC8(buf, 5);
-    saQueueCmd(buf, 6);
+    saQueueCmd(VTX_CMD_MODE, buf, 6);
 }
 
 static void saDevSetPowerByIndex(uint8_t index) {
@@ -600,7 +564,7 @@ static void saDevSetPowerByIndex(uint8_t index) {
     }
     buf[4] = (saDevice.version == 1) ? saPowerTable[index].valueV1 : saPowerTable[index].valueV2;
     buf[5] = CRC8(buf, 5);
-    saQueueCmd(buf, 6);
+    saQueueCmd(VTX_CMD_POWER, buf, 6);
 }
 
 void saSetPowerByIndex(uint8_t index) {
@@ -629,6 +593,7 @@ bool vtxSmartAudioInit(void) {
     if (!smartAudioSerialPort) {
         return false;
     }
+    vtxTransportInit(&saTransport, isLegacySmartAudioEnabled() ? &saLegacyTransportPolicy : &saTransportPolicy);
     vtxCommonSetDevice(&vtxSmartAudio);
     return true;
 }
@@ -680,21 +645,15 @@ static void vtxSAProcess(vtxDevice_t *vtxDevice, timeUs_t currentTimeUs) {
     // Command queue control
     timeMs_t nowMs = millis();             // Don't substitute with "currentTimeUs / 1000"; sa_lastTransmissionMs is based on millis().
     static timeMs_t lastCommandSentMs = 0; // Last non-GET_SETTINGS sent
-    if ((sa_outstanding != SA_CMD_NONE) && (nowMs - sa_lastTransmissionMs > SMARTAUDIO_CMD_TIMEOUT)) {
-        // Last command timed out
-        // dprintf(("process: resending 0x%x\r\n", sa_outstanding));
-        // XXX Todo: Resend termination and possible offline transition
-        saResendCmd();
-        lastCommandSentMs = nowMs;
-    } else if (!saQueueEmpty()) {
-        // Command pending. Send it.
-        // dprintf(("process: sending queue\r\n"));
-        saSendQueue();
-        lastCommandSentMs = nowMs;
-    } else if ((nowMs - lastCommandSentMs < SMARTAUDIO_POLLING_WINDOW) && (nowMs - sa_lastTransmissionMs >= SMARTAUDIO_POLLING_INTERVAL)) {
+    const vtxCommandKind_e sentCmd = vtxTransportProcess(&saTransport, nowMs);
+    if (sentCmd != VTX_CMD_NONE) {
+        if (sentCmd != VTX_CMD_QUERY) {
+            lastCommandSentMs = nowMs;
+        }
+    } else if (vtxTransportIsIdle(&saTransport) && (nowMs - lastCommandSentMs < SMARTAUDIO_POLLING_WINDOW) && (nowMs - sa_lastTransmissionMs >= SMARTAUDIO_POLLING_INTERVAL)) {
         //dprintf(("process: sending status change polling\r\n"));
         saGetSettings();
-        saSendQueue();
+        vtxTransportProcess(&saTransport, nowMs);
     }
 }
 
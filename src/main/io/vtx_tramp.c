@@ -43,6 +43,7 @@
 #include "io/vtx_control.h"
 #include "io/vtx.h"
 #include "io/vtx_string.h"
+#include "io/vtx_transport.h"
 
 #if defined(USE_CMS) || defined(USE_VTX_COMMON)
 const uint16_t trampPowerTable[VTX_TRAMP_POWER_COUNT] = {
@@ -104,8 +105,53 @@ uint8_t  trampFreqRetries = 0;
 uint16_t trampConfPower = 0;
 uint8_t  trampPowerRetries = 0;
 
-static void trampWriteBuf(uint8_t *buf) {
-    serialWriteBuf(trampSerialPort, buf, 16);
+// Time until a query is considered lost, the vtx task runs every 200ms
+#define TRAMP_QUERY_TIMEOUT 150
+#define TRAMP_QUERY_RETRIES 1
+
+static vtxTransport_t trampTransport;
+
+static void trampResetReceiver(void);
+
+static bool trampIsValidResponseCode(uint8_t code) {
+    if (code == 'r' || code == 'v' || code == 's') {
+        return true;
+    } else {
+        return false;
+    }
+}
+
+static void trampWriteBuf(const uint8_t *buf, uint8_t len) {
+    if (trampIsValidResponseCode(buf[1])) {
+        // a query, drop whatever is left of the previous response
+        trampResetReceiver();
+    }
+    serialWriteBuf(trampSerialPort, buf, len);
+}
+
+static const vtxTransportPolicy_t trampTransportPolicy = {
+    .send = trampWriteBuf,
+    .replyMatches = NULL,
+    .timeoutMs = TRAMP_QUERY_TIMEOUT,
+    .guardMs = 0,
+    .maxRetries = TRAMP_QUERY_RETRIES,
+    .queueDepth = VTX_TRANSPORT_QUEUE_SIZE,
+};
+
+static vtxCommandKind_e trampCmdKind(uint8_t cmd) {
+    switch (cmd) {
+    case 'F':
+        return VTX_CMD_FREQUENCY;
+    case 'P':
+        return VTX_CMD_POWER;
+    case 'I':
+        return VTX_CMD_MODE;
+    case 'r':
+    case 'v':
+        return VTX_CMD_QUERY;
+    default:
+        return VTX_CMD_OTHER;
+    }
 }
 
 static uint8_t trampChecksum(uint8_t *trampBuf) {
@@ -126,7 +172,9 @@ void trampCmdU16(uint8_t cmd, uint16_t param) {
     trampReqBuffer[2] = param & 0xff;
     trampReqBuffer[3] = (param >> 8) & 0xff;
     trampReqBuffer[14] = trampChecksum(trampReqBuffer);
-    trampWriteBuf(trampReqBuffer);
+    // set commands are not answered, they are checked with a 'v' query
+    const uint8_t reply = trampIsValidResponseCode(cmd) ? cmd : VTX_TRANSPORT_REPLY_NONE;
+    vtxTransportQueue(&trampTransport, trampCmdKind(cmd), trampReqBuffer, ARRAYLEN(trampReqBuffer), reply);
 }
 
 static bool trampValidateFreq(uint16_t freq) {
@@ -256,14 +304,6 @@ static void trampResetReceiver(void) {
     trampReceivePos = 0;
 }
 
-static bool trampIsValidResponseCode(uint8_t code) {
-    if (code == 'r' || code == 'v' || code == 's') {
-        return true;
-    } else {
-        return false;
-    }
-}
-
 // returns completed response code or 0
 static char trampReceive(uint32_t currentTimeUs) {
     UNUSED(currentTimeUs);
@@ -306,7 +346,6 @@ static char trampReceive(uint32_t currentTimeUs) {
 }
 
 void trampQuery(uint8_t cmd) {
-    trampResetReceiver();
     trampCmdU16(cmd, 0);
 }
 
@@ -333,7 +372,11 @@ static void vtxTrampProcess(vtxDevice_t *vtxDevice, timeUs_t currentTimeUs) {
     if (trampStatus == TRAMP_STATUS_BAD_DEVICE) {
         return;
     }
+    const timeMs_t currentTimeMs = currentTimeUs / 1000;
     const char replyCode = trampReceive(currentTimeUs);
+    if (replyCode) {
+        vtxTransportReply(&trampTransport, replyCode, currentTimeMs);
+    }
 #ifdef TRAMP_DEBUG
     debug[0] = trampStatus;
 #endif
@@ -411,6 +454,7 @@ static void vtxTrampProcess(vtxDevice_t *vtxDevice, timeUs_t currentTimeUs) {
     default:
         break;
     }
+    vtxTransportProcess(&trampTransport, currentTimeMs);
 #ifdef TRAMP_DEBUG
     debug[1] = debugFreqReqCounter;
     debug[2] = debugPowReqCounter;
@@ -532,6 +576,7 @@ bool vtxTrampInit(void) {
     if (!trampSerialPort) {
         return false;
     }
+    vtxTransportInit(&trampTransport, &trampTransportPolicy);
 #if defined(USE_VTX_COMMON)
     vtxCommonSetDevice(&vtxTramp);
 #endif
@@ -0,0 +1,164 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Shared outbound command queue for the VTX control protocols.
+ *
+ *   The VTX links are slow half duplex serial lines where every command
+ * waits for its reply. Commands are queued and sent one at a time from the
+ * VTX task; a setting that is changed again before its command went out
+ * replaces the queued one instead of adding another round trip. Timeouts,
+ * retries and the gap between frames come from the protocol's policy.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "io/vtx_transport.h"
+
+static vtxTransportCmd_t *vtxTransportEntry(vtxTransport_t *transport, uint8_t index) {
+    return &transport->queue[(transport->head + index) % VTX_TRANSPORT_QUEUE_SIZE];
+}
+
+static void vtxTransportPop(vtxTransport_t *transport) {
+    transport->head = (transport->head + 1) % VTX_TRANSPORT_QUEUE_SIZE;
+    transport->count--;
+    transport->outstanding = false;
+    transport->superseded = false;
+    transport->retries = 0;
+}
+
+static void vtxTransportSend(vtxTransport_t *transport, timeMs_t currentTimeMs) {
+    const vtxTransportCmd_t *cmd = vtxTransportEntry(transport, 0);
+    transport->policy->send(cmd->frame, cmd->len);
+    transport->lastSentMs = currentTimeMs;
+    transport->stats.sent++;
+}
+
+void vtxTransportInit(vtxTransport_t *transport, const vtxTransportPolicy_t *policy) {
+    memset(transport, 0, sizeof(*transport));
+    transport->policy = policy;
+}
+
+// returns false if the queue is full
+bool vtxTransportQueue(vtxTransport_t *transport, vtxCommandKind_e kind, const uint8_t *frame, uint8_t len, uint8_t reply) {
+    if (len > VTX_TRANSPORT_FRAME_SIZE) {
+        return false;
+    }
+    vtxTransportCmd_t *cmd = NULL;
+    if (kind != VTX_CMD_OTHER) {
+        for (int i = 0; i < transport->count; i++) {
+            vtxTransportCmd_t *queued = vtxTransportEntry(transport, i);
+            if (queued->kind != kind) {
+                continue;
+            }
+            if (i == 0 && transport->outstanding) {
+                // no point in resending it once it times out
+                transport->superseded = true;
+            } else {
+                cmd = queued;
+                transport->stats.coalesced++;
+                break;
+            }
+        }
+    }
+    if (!cmd) {
+        const uint8_t depth = MIN(transport->policy->queueDepth, VTX_TRANSPORT_QUEUE_SIZE);
+        if (transport->count >= depth) {
+            return false;
+        }
+        cmd = vtxTransportEntry(transport, transport->count++);
+    }
+    memcpy(cmd->frame, frame, len);
+    cmd->len = len;
+    cmd->kind = kind;
+    cmd->reply = reply;
+    return true;
+}
+
+// returns the kind of the command put on the wire, VTX_CMD_NONE if nothing was sent
+vtxCommandKind_e vtxTransportProcess(vtxTransport_t *transport, timeMs_t currentTimeMs) {
+    const vtxTransportPolicy_t *policy = transport->policy;
+    if (transport->outstanding) {
+        if (cmp32(currentTimeMs, transport->lastSentMs) <= policy->timeoutMs) {
+            return VTX_CMD_NONE;
+        }
+        if (transport->retries < policy->maxRetries && !transport->superseded) {
+            const vtxCommandKind_e kind = vtxTransportEntry(transport, 0)->kind;
+            transport->retries++;
+            transport->stats.resent++;
+            DEBUG_SET(DEBUG_VTX_TRANSPORT, 2, transport->stats.resent);
+            vtxTransportSend(transport, currentTimeMs);
+            return kind;
+        }
+        if (transport->superseded) {
+            // replaced by the newer command behind it, not a failure
+            transport->stats.coalesced++;
+        } else {
+            transport->stats.dropped++;
+            DEBUG_SET(DEBUG_VTX_TRANSPORT, 3, transport->stats.dropped);
+        }
+        vtxTransportPop(transport);
+    }
+    if (transport->count == 0 || cmp32(currentTimeMs, transport->lastSentMs) < policy->guardMs) {
+        return VTX_CMD_NONE;
+    }
+    const vtxTransportCmd_t *cmd = vtxTransportEntry(transport, 0);
+    const vtxCommandKind_e kind = cmd->kind;
+    vtxTransportSend(transport, currentTimeMs);
+    if (cmd->reply == VTX_TRANSPORT_REPLY_NONE) {
+        vtxTransportPop(transport);
+    } else {
+        transport->outstanding = true;
+        transport->firstSentMs = currentTimeMs;
+    }
+    return kind;
+}
+
+// returns true if the reply completed the outstanding command
+bool vtxTransportReply(vtxTransport_t *transport, uint8_t reply, timeMs_t currentTimeMs) {
+    if (transport->outstanding) {
+        const vtxTransportCmd_t *cmd = vtxTransportEntry(transport, 0);
+        vtxTransportReplyMatchFn *replyMatches = transport->policy->replyMatches;
+        if (replyMatches ? replyMatches(cmd->reply, reply) : cmd->reply == reply) {
+            // round trip from the first transmission, so retries show up in the latency
+            const uint16_t latencyMs = MIN(cmp32(currentTimeMs, transport->firstSentMs), UINT16_MAX);
+            transport->stats.latencyMs[cmd->kind] = latencyMs;
+            transport->stats.maxLatencyMs = MAX(transport->stats.maxLatencyMs, latencyMs);
+            transport->stats.acked++;
+            DEBUG_SET(DEBUG_VTX_TRANSPORT, 0, latencyMs);
+            DEBUG_SET(DEBUG_VTX_TRANSPORT, 1, transport->stats.maxLatencyMs);
+            vtxTransportPop(transport);
+            return true;
+        }
+    }
+    transport->stats.unexpected++;
+    return false;
+}
+
+bool vtxTransportIsIdle(const vtxTransport_t *transport) {
+    return transport->count == 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define VTX_TRANSPORT_QUEUE_SIZE 6
+#define VTX_TRANSPORT_FRAME_SIZE 16
+#define VTX_TRANSPORT_REPLY_NONE 0 // frame is done once it is on the wire
+
+// Commands of the same kind supersede each other while they wait in the queue
+typedef enum {
+    VTX_CMD_NONE = 0,
+    VTX_CMD_OTHER,      // never coalesced
+    VTX_CMD_QUERY,      // status poll
+    VTX_CMD_FREQUENCY,  // band/channel or frequency
+    VTX_CMD_POWER,
+    VTX_CMD_MODE,       // pit mode and operation mode
+    VTX_CMD_COUNT
+} vtxCommandKind_e;
+
+typedef void vtxTransportSendFn(const uint8_t *frame, uint8_t len);
+typedef bool vtxTransportReplyMatchFn(uint8_t expected, uint8_t reply);
+
+typedef struct vtxTransportPolicy_s {
+    vtxTransportSendFn *send;
+    vtxTransportReplyMatchFn *replyMatches; // NULL if a reply must carry the expected code
+    uint16_t timeoutMs;                     // time to wait for a reply before resending
+    uint16_t guardMs;                       // minimum gap between frames on the half duplex link
+    uint8_t maxRetries;                     // resends before a command is given up
+    uint8_t queueDepth;                     // at most VTX_TRANSPORT_QUEUE_SIZE
+} vtxTransportPolicy_t;
+
+typedef struct vtxTransportCmd_s {
+    uint8_t frame[VTX_TRANSPORT_FRAME_SIZE];
+    uint8_t len;
+    uint8_t kind;
+    uint8_t reply;
+} vtxTransportCmd_t;
+
+typedef struct vtxTransportStats_s {
+    uint32_t sent;
+    uint32_t acked;
+    uint32_t resent;
+    uint32_t dropped;       // commands given up after maxRetries
+    uint32_t coalesced;     // commands replaced by a newer one of the same kind
+    uint32_t unexpected;    // replies that did not match the outstanding command
+    uint16_t latencyMs[VTX_CMD_COUNT]; // last round trip per command kind
+    uint16_t maxLatencyMs;
+} vtxTransportStats_t;
+
+typedef struct vtxTransport_s {
+    const vtxTransportPolicy_t *policy;
+    vtxTransportCmd_t queue[VTX_TRANSPORT_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    bool outstanding;       // queue[head] is on the wire and waits for its reply
+    bool superseded;        // a newer command of the same kind is queued behind it
+    uint8_t retries;
+    timeMs_t firstSentMs;
+    timeMs_t lastSentMs;
+    vtxTransportStats_t stats;
+} vtxTransport_t;
+
+void vtxTransportInit(vtxTransport_t *transport, const vtxTransportPolicy_t *policy);
+bool vtxTransportQueue(vtxTransport_t *transport, vtxCommandKind_e kind, const uint8_t *frame, uint8_t len, uint8_t reply);
+vtxCommandKind_e vtxTransportProcess(vtxTransport_t *transport, timeMs_t currentTimeMs);
+bool vtxTransportReply(vtxTransport_t *transport, uint8_t reply, timeMs_t currentTimeMs);
+bool vtxTransportIsIdle(const vtxTransport_t *transport);
@@ -27,6 +27,10 @@
 
 #include "scheduler/scheduler.h"
 
+#ifdef SIMULATOR_BUILD
+#include "drivers/serial_tcp.h"
+#endif
+
 void run(void);
 
 int main(void) {
@@ -40,6 +44,7 @@ void FAST_CODE FAST_CODE_NOINLINE run(void) {
         scheduler();
         processLoopback();
 #ifdef SIMULATOR_BUILD
+        tcpPortsUpdate();
         delayMicroseconds_real(50); // max rate 20kHz
 #endif
     }
@@ -19,6 +19,7 @@
  */
 
 #include <stdbool.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -32,7 +33,9 @@
 #include "pg/rx_spi.h"
 
 #include "drivers/rx/rx_cc2500.h"
+#include "drivers/exti.h"
 #include "drivers/io.h"
+#include "drivers/nvic.h"
 #include "drivers/time.h"
 
 #include "fc/config.h"
@@ -55,6 +58,51 @@ static IO_t antSelPin;
 #endif
 static int16_t rssiDbm;
 
+#define GDO_EDGE_MAX_AGE_US 9000 // an older edge belongs to an earlier packet
+
+static uint8_t packetMinLength;
+static uint8_t packetMaxLength;
+static volatile bool packetCaptureActive;
+
+#ifdef USE_EXTI
+static extiCallbackRec_t gdoExtiCallbackRec;
+static bool gdoExtiActive;
+static volatile timeUs_t gdoEdgeTimeUs;
+static volatile bool gdoEdgeSeen;
+static uint8_t capturedPacket[CC2500_PACKET_MAX_LENGTH];
+static volatile uint8_t capturedLength;
+static volatile timeUs_t capturedTimeUs;
+#endif
+
+// Empties the FIFO into packet, a packet shorter than the protocol's is
+// dropped and the receiver restarted.
+static uint8_t cc2500ReadFifoPacket(uint8_t *packet) {
+    uint8_t length = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
+    length = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F; // read 2 times to avoid reading errors
+    if (length == 0 || length < packetMinLength) {
+        cc2500Strobe(CC2500_SRX);
+        return 0;
+    }
+    length = MIN(length, packetMaxLength);
+    cc2500ReadFifo(packet, length);
+    return length;
+}
+
+#ifdef USE_EXTI
+// Shares the priority of the slot timer, so neither interrupts the other
+// halfway through an SPI transaction.
+static void cc2500GdoExtiHandler(extiCallbackRec_t *cb) {
+    UNUSED(cb);
+    const timeUs_t edgeTimeUs = micros();
+    gdoEdgeTimeUs = edgeTimeUs;
+    gdoEdgeSeen = true;
+    if (packetCaptureActive && capturedLength == 0) {
+        capturedLength = cc2500ReadFifoPacket(capturedPacket);
+        capturedTimeUs = edgeTimeUs;
+    }
+}
+#endif
+
 uint16_t cc2500getRssiDbm(void) {
     return rssiDbm;
 }
@@ -94,6 +142,86 @@ bool cc2500getGdo(void) {
     return IORead(gdoPin);
 }
 
+// Time GDO0 went up for the packet that is in the FIFO. The pin itself is
+// still polled, the edge interrupt only records when the packet arrived.
+// Falls back to the current time when no edge was captured.
+timeUs_t cc2500getGdoTimeUs(void) {
+    const timeUs_t currentTimeUs = micros();
+#ifdef USE_EXTI
+    if (gdoEdgeSeen) {
+        const timeUs_t edgeTimeUs = gdoEdgeTimeUs;
+        gdoEdgeSeen = false;
+        if (cmpTimeUs(currentTimeUs, edgeTimeUs) < GDO_EDGE_MAX_AGE_US) {
+            return edgeTimeUs;
+        }
+    }
+#endif
+    return currentTimeUs;
+}
+
+/*
+ * The protocols that hop once bound read their packets with
+ * cc2500ReadPacket(). With the GDO0 interrupt the FIFO is read when the
+ * packet arrives and the packet waits for the RX task, otherwise the RX
+ * task reads it when it polls. From then on the RX task talks to the radio
+ * only with the interrupts held off (CC2500_RADIO_BLOCK).
+ */
+void cc2500StartPacketCapture(uint8_t minLength, uint8_t maxLength) {
+    packetMinLength = minLength;
+    packetMaxLength = MIN(maxLength, CC2500_PACKET_MAX_LENGTH);
+    cc2500DropPacket();
+#ifdef USE_EXTI
+    packetCaptureActive = gdoExtiActive;
+#endif
+}
+
+void cc2500StopPacketCapture(void) {
+    packetCaptureActive = false;
+}
+
+bool cc2500PacketCaptureActive(void) {
+    return packetCaptureActive;
+}
+
+// forget a packet that arrived on the channel the receiver hops away from
+void cc2500DropPacket(void) {
+#ifdef USE_EXTI
+    capturedLength = 0;
+#endif
+}
+
+// a packet is waiting for the RX task
+bool cc2500PacketPending(void) {
+#ifdef USE_EXTI
+    if (capturedLength) {
+        return true;
+    }
+#endif
+    return cc2500getGdo();
+}
+
+// Returns the length of the packet copied to packet and when it arrived, or
+// 0 if there is none.
+uint8_t cc2500ReadPacket(uint8_t *packet, timeUs_t *packetTimeUs) {
+    uint8_t length = 0;
+    CC2500_RADIO_BLOCK {
+#ifdef USE_EXTI
+        length = capturedLength;
+        if (length) {
+            memcpy(packet, capturedPacket, length);
+            *packetTimeUs = capturedTimeUs;
+            capturedLength = 0;
+        } else
+#endif
+        if (cc2500getGdo()) {
+            // without the interrupt, or the edge came while the line was held off
+            *packetTimeUs = cc2500getGdoTimeUs();
+            length = cc2500ReadFifoPacket(packet);
+        }
+    }
+    return length;
+}
+
 #if defined(USE_RX_CC2500_SPI_PA_LNA) && defined(USE_RX_CC2500_SPI_DIVERSITY)
 void cc2500switchAntennae(void) {
     static bool alternativeAntennaSelected = true;
@@ -170,6 +298,19 @@ bool cc2500SpiInit(void) {
     gdoPin = IOGetByTag(IO_TAG(RX_CC2500_SPI_GDO_0_PIN));
     IOInit(gdoPin, OWNER_RX_SPI, 0);
     IOConfigGPIO(gdoPin, IOCFG_IN_FLOATING);
+#ifdef USE_EXTI
+    // leave the line alone if the gyro or another device already uses it
+    if (EXTIIsFree(gdoPin)) {
+        EXTIHandlerInit(&gdoExtiCallbackRec, cc2500GdoExtiHandler);
+#ifdef STM32F7
+        EXTIConfig(gdoPin, &gdoExtiCallbackRec, NVIC_PRIO_TIMER, IO_CONFIG(GPIO_MODE_INPUT, 0, GPIO_NOPULL));
+#else
+        EXTIConfig(gdoPin, &gdoExtiCallbackRec, NVIC_PRIO_TIMER, EXTI_Trigger_Rising);
+#endif
+        EXTIEnable(gdoPin, true);
+        gdoExtiActive = true;
+    }
+#endif
     cc2500LedPin = IOGetByTag(IO_TAG(RX_CC2500_SPI_LED_PIN));
     IOInit(cc2500LedPin, OWNER_LED, 0);
     IOConfigGPIO(cc2500LedPin, IOCFG_OUT_PP);
@@ -20,15 +20,31 @@
 
 #pragma once
 
+#include "build/atomic.h"
+
+#include "drivers/nvic.h"
+
 #include "pg/pg.h"
 
 #include "rx/rx_spi.h"
 
+#define CC2500_PACKET_MAX_LENGTH 32
+
+// radio access from the RX task while the packet capture or the slot timer may interrupt it
+#define CC2500_RADIO_BLOCK ATOMIC_BLOCK(NVIC_PRIO_TIMER)
+
 uint16_t cc2500getRssiDbm(void);
 void cc2500setRssiDbm(uint8_t value);
 void cc2500SpiBind(void);
 bool cc2500checkBindRequested(bool reset);
 bool cc2500getGdo(void);
+timeUs_t cc2500getGdoTimeUs(void);
+void cc2500StartPacketCapture(uint8_t minLength, uint8_t maxLength);
+void cc2500StopPacketCapture(void);
+bool cc2500PacketCaptureActive(void);
+void cc2500DropPacket(void);
+bool cc2500PacketPending(void);
+uint8_t cc2500ReadPacket(uint8_t *packet, timeUs_t *packetTimeUs);
 #if defined(USE_RX_CC2500_SPI_PA_LNA) && defined(USE_RX_CC2500_SPI_DIVERSITY)
 void cc2500switchAntennae(void);
 #endif
@@ -49,6 +49,7 @@
 #include "rx/cc2500_common.h"
 #include "rx/cc2500_frsky_common.h"
 #include "rx/cc2500_frsky_shared.h"
+#include "rx/rx_spi_timing.h"
 
 #include "sensors/battery.h"
 
@@ -56,6 +57,15 @@
 
 #include "cc2500_frsky_d.h"
 
+#define SLOT_GUARD_US 500 // how late a packet may be before it counts as missed
+#define TELEMETRY_OFFSET_US 1380
+
+static rxSpiSlotTimer_t slotTimer;
+#ifdef USE_RX_SPI_SLOT_TIMER
+static volatile bool telemetrySent;
+static volatile uint8_t hopSlots;
+#endif
+
 #if defined(USE_RX_FRSKY_SPI_TELEMETRY)
 static uint8_t frame[20];
 static uint8_t telemetryId;
@@ -158,9 +168,99 @@ void frSkyDSetRcData(uint16_t *rcData, const uint8_t *packet) {
     }
 }
 
+#if defined(USE_RX_FRSKY_SPI_TELEMETRY)
+static void frSkyDSendTelemetry(void) {
+    cc2500Strobe(CC2500_SIDLE);
+    cc2500SetPower(6);
+    cc2500Strobe(CC2500_SFRX);
+#if defined(USE_RX_CC2500_SPI_PA_LNA)
+    cc2500TxEnable();
+#endif
+    cc2500Strobe(CC2500_SIDLE);
+    cc2500WriteFifo(frame, frame[0] + 1);
+}
+#endif
+
+// hop on the schedule of the transmitter, over every slot that went by
+static uint8_t frSkyDHop(timeUs_t currentTimeUs) {
+    const uint8_t slots = rxSpiSlotTimerAdvance(&slotTimer, SYNC_DELAY_MAX, currentTimeUs);
+#if defined(USE_RX_CC2500_SPI_PA_LNA)
+    cc2500TxDisable();
+#endif
+#if defined(USE_RX_CC2500_SPI_PA_LNA) && defined(USE_RX_CC2500_SPI_DIVERSITY) // SE4311 chip
+    if (missingPackets >= 2) {
+        cc2500switchAntennae();
+    }
+#endif
+    nextChannel(slots % listLength);
+    cc2500DropPacket();
+    cc2500Strobe(CC2500_SRX);
+    return slots;
+}
+
+#ifdef USE_RX_SPI_SLOT_TIMER
+static void frSkyDHopFromTimer(timeUs_t currentTimeUs) {
+    if (cc2500PacketPending()) {
+        // it came in the guard time, the RX task schedules the next hop from it
+        return;
+    }
+    hopSlots += frSkyDHop(currentTimeUs);
+    rxSpiSlotTimerArm(&slotTimer, SYNC_DELAY_MAX + SLOT_GUARD_US, frSkyDHopFromTimer);
+}
+
+#if defined(USE_RX_FRSKY_SPI_TELEMETRY)
+static void frSkyDTelemetryFromTimer(timeUs_t currentTimeUs) {
+    UNUSED(currentTimeUs);
+    frSkyDSendTelemetry();
+    telemetrySent = true;
+    rxSpiSlotTimerArm(&slotTimer, SYNC_DELAY_MAX + SLOT_GUARD_US, frSkyDHopFromTimer);
+}
+#endif
+#endif
+
+#if defined(USE_RX_FRSKY_SPI_TELEMETRY)
+// true once the telemetry frame went out in its slot
+static bool frSkyDTelemetrySlot(void) {
+#ifdef USE_RX_SPI_SLOT_TIMER
+    if (rxSpiSlotTimerIsHardware()) {
+        if (!telemetrySent) {
+            return false;
+        }
+        telemetrySent = false;
+        return true;
+    }
+#endif
+    if (!rxSpiSlotTimerDue(&slotTimer, TELEMETRY_OFFSET_US, micros())) {
+        return false;
+    }
+    CC2500_RADIO_BLOCK {
+        frSkyDSendTelemetry();
+    }
+    return true;
+}
+#endif
+
+// the slots hopped over since the last call, 0 while the packet may still come
+static uint8_t frSkyDHopSlots(timeUs_t currentTimeUs) {
+    uint8_t slots = 0;
+#ifdef USE_RX_SPI_SLOT_TIMER
+    if (rxSpiSlotTimerIsHardware()) {
+        CC2500_RADIO_BLOCK {
+            slots = hopSlots;
+            hopSlots = 0;
+        }
+        return slots;
+    }
+#endif
+    if (rxSpiSlotTimerDue(&slotTimer, SYNC_DELAY_MAX + SLOT_GUARD_US, currentTimeUs)) {
+        CC2500_RADIO_BLOCK {
+            slots = frSkyDHop(currentTimeUs);
+        }
+    }
+    return slots;
+}
+
 rx_spi_received_e frSkyDHandlePacket(uint8_t * const packet, uint8_t * const protocolState) {
-    static timeUs_t lastPacketReceivedTime = 0;
-    static timeUs_t telemetryTimeUs;
     static bool ledIsOn;
     rx_spi_received_e ret = RX_SPI_RECEIVED_NONE;
     const timeUs_t currentPacketReceivedTime = micros();
@@ -168,103 +268,135 @@ rx_spi_received_e frSkyDHandlePacket(uint8_t * const packet, uint8_t * const pro
     case STATE_STARTING:
         listLength = 47;
         initialiseData(false);
+        rxSpiSlotTimerInit(&slotTimer, SYNC_DELAY_MAX);
+        rxSpiSlotTimerSync(&slotTimer, currentPacketReceivedTime);
         *protocolState = STATE_UPDATE;
         nextChannel(1);
         cc2500Strobe(CC2500_SRX);
+        cc2500StartPacketCapture(20, 20);
         break;
     case STATE_UPDATE:
-        lastPacketReceivedTime = currentPacketReceivedTime;
         *protocolState = STATE_DATA;
         if (cc2500checkBindRequested(false)) {
-            lastPacketReceivedTime = 0;
             timeoutUs = 50;
             missingPackets = 0;
+#ifdef USE_RX_SPI_SLOT_TIMER
+            if (rxSpiSlotTimerIsHardware()) {
+                rxSpiSlotTimerDisarm();
+            }
+#endif
+            cc2500StopPacketCapture();
             *protocolState = STATE_INIT;
             break;
         }
         FALLTHROUGH; //!!TODO -check this fall through is correct
     // here FS code could be
-    case STATE_DATA:
-        if (cc2500getGdo()) {
-            uint8_t ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
+    case STATE_DATA: {
+        timeUs_t gdoTimeUs;
+        uint8_t ccLen;
+        CC2500_RADIO_BLOCK {
+            ccLen = cc2500ReadPacket(packet, &gdoTimeUs);
+#ifdef USE_RX_SPI_SLOT_TIMER
+            if (ccLen && rxSpiSlotTimerIsHardware()) {
+                // the packet decides the next deadline
+                rxSpiSlotTimerDisarm();
+            }
+#endif
+        }
+        if (ccLen) {
             bool packetOk = false;
-            if (ccLen >= 20) {
-                cc2500ReadFifo(packet, 20);
-                if (packet[19] & 0x80) {
-                    packetOk = true;
-                    missingPackets = 0;
-                    timeoutUs = 1;
-                    if (packet[0] == 0x11) {
-                        if ((packet[1] == rxFrSkySpiConfig()->bindTxId[0]) &&
-                                (packet[2] == rxFrSkySpiConfig()->bindTxId[1])) {
-                            cc2500LedOn();
+            if (packet[19] & 0x80) {
+                packetOk = true;
+                missingPackets = 0;
+                timeoutUs = 1;
+#ifdef USE_RX_SPI_SLOT_TIMER
+                hopSlots = 0; // the timer is disarmed, the hops before the packet do not count
+#endif
+                if (packet[0] == 0x11) {
+                    if ((packet[1] == rxFrSkySpiConfig()->bindTxId[0]) &&
+                            (packet[2] == rxFrSkySpiConfig()->bindTxId[1])) {
+                        cc2500LedOn();
+                        CC2500_RADIO_BLOCK {
                             nextChannel(1);
-                            cc2500setRssiDbm(packet[18]);
+                        }
+                        cc2500setRssiDbm(packet[18]);
+                        packetTimeUs = gdoTimeUs;
+                        rxSpiSlotTimerSync(&slotTimer, gdoTimeUs);
 #if defined(USE_RX_FRSKY_SPI_TELEMETRY)
-                            if ((packet[3] % 4) == 2) {
-                                telemetryTimeUs = micros();
-                                buildTelemetryFrame(packet);
-                                *protocolState = STATE_TELEMETRY;
-                            } else
+                        if ((packet[3] % 4) == 2) {
+                            buildTelemetryFrame(packet);
+                            *protocolState = STATE_TELEMETRY;
+#ifdef USE_RX_SPI_SLOT_TIMER
+                            if (rxSpiSlotTimerIsHardware()) {
+                                rxSpiSlotTimerArm(&slotTimer, TELEMETRY_OFFSET_US, frSkyDTelemetryFromTimer);
+                            }
 #endif
-                            {
+                        } else
+#endif
+                        {
+                            CC2500_RADIO_BLOCK {
                                 cc2500Strobe(CC2500_SRX);
-                                *protocolState = STATE_UPDATE;
                             }
-                            ret = RX_SPI_RECEIVED_DATA;
-                            lastPacketReceivedTime = currentPacketReceivedTime;
+                            *protocolState = STATE_UPDATE;
                         }
+                        ret = RX_SPI_RECEIVED_DATA;
                     }
                 }
             }
             if (!packetOk) {
-                cc2500Strobe(CC2500_SRX);
-            }
-        }
-        if (cmpTimeUs(currentPacketReceivedTime, lastPacketReceivedTime) > (timeoutUs * SYNC_DELAY_MAX)) {
-#if defined(USE_RX_CC2500_SPI_PA_LNA)
-            cc2500TxDisable();
-#endif
-            if (timeoutUs == 1) {
-#if defined(USE_RX_CC2500_SPI_PA_LNA) && defined(USE_RX_CC2500_SPI_DIVERSITY) // SE4311 chip
-                if (missingPackets >= 2) {
-                    cc2500switchAntennae();
+                CC2500_RADIO_BLOCK {
+                    cc2500Strobe(CC2500_SRX);
                 }
+            }
+#ifdef USE_RX_SPI_SLOT_TIMER
+            if (rxSpiSlotTimerIsHardware() && timeoutUs == 1 && *protocolState != STATE_TELEMETRY) {
+                rxSpiSlotTimerArm(&slotTimer, SYNC_DELAY_MAX + SLOT_GUARD_US, frSkyDHopFromTimer);
+            }
 #endif
+        }
+        if (timeoutUs == 1) {
+            const uint8_t slots = frSkyDHopSlots(currentPacketReceivedTime);
+            if (slots) {
                 if (missingPackets > MAX_MISSING_PKT) {
                     timeoutUs = 50;
                     setRssiDirect(0, RSSI_SOURCE_RX_PROTOCOL);
+#ifdef USE_RX_SPI_SLOT_TIMER
+                    if (rxSpiSlotTimerIsHardware()) {
+                        // back to searching, which the RX task does
+                        rxSpiSlotTimerDisarm();
+                    }
+#endif
                 }
-                missingPackets++;
-                nextChannel(1);
+                missingPackets += slots;
+                DEBUG_SET(DEBUG_RX_FRSKY_SPI, DEBUG_DATA_MISSING_PACKETS, missingPackets);
+                *protocolState = STATE_UPDATE;
+            }
+        } else if (rxSpiSlotTimerDue(&slotTimer, timeoutUs * SYNC_DELAY_MAX, currentPacketReceivedTime)) {
+            if (ledIsOn) {
+                cc2500LedOff();
             } else {
-                if (ledIsOn) {
-                    cc2500LedOff();
-                } else {
-                    cc2500LedOn();
-                }
-                ledIsOn = !ledIsOn;
-                setRssi(0, RSSI_SOURCE_RX_PROTOCOL);
+                cc2500LedOn();
+            }
+            ledIsOn = !ledIsOn;
+            setRssi(0, RSSI_SOURCE_RX_PROTOCOL);
+            rxSpiSlotTimerSync(&slotTimer, currentPacketReceivedTime);
+            CC2500_RADIO_BLOCK {
+#if defined(USE_RX_CC2500_SPI_PA_LNA)
+                cc2500TxDisable();
+#endif
                 nextChannel(13);
+                cc2500DropPacket();
+                cc2500Strobe(CC2500_SRX);
             }
-            cc2500Strobe(CC2500_SRX);
             *protocolState = STATE_UPDATE;
         }
         break;
+    }
 #if defined(USE_RX_FRSKY_SPI_TELEMETRY)
     case STATE_TELEMETRY:
-        if (cmpTimeUs(micros(), telemetryTimeUs) >= 1380) {
-            cc2500Strobe(CC2500_SIDLE);
-            cc2500SetPower(6);
-            cc2500Strobe(CC2500_SFRX);
-#if defined(USE_RX_CC2500_SPI_PA_LNA)
-            cc2500TxEnable();
-#endif
-            cc2500Strobe(CC2500_SIDLE);
-            cc2500WriteFifo(frame, frame[0] + 1);
+        if (frSkyDTelemetrySlot()) {
             *protocolState = STATE_DATA;
             ret = RX_SPI_RECEIVED_DATA;
-            lastPacketReceivedTime = currentPacketReceivedTime;
         }
         break;
 #endif
@@ -54,6 +54,7 @@ static uint8_t protocolState;
 
 uint32_t missingPackets;
 timeDelta_t timeoutUs;
+timeUs_t packetTimeUs;
 
 static uint8_t calData[255][3];
 static timeMs_t timeTunedMs;
@@ -295,6 +296,7 @@ rx_spi_received_e frSkySpiDataReceived(uint8_t *packet) {
     rx_spi_received_e ret = RX_SPI_RECEIVED_NONE;
     static uint32_t ledBindBlinkTime = 0;
     static bool ledIsOn = 0;
+    static uint8_t bindCompleteBlinks;
     if (protocolState == STATE_INIT ||
             protocolState == STATE_BIND ||
             protocolState == STATE_BIND_TUNING ||
@@ -341,20 +343,29 @@ rx_spi_received_e frSkySpiDataReceived(uint8_t *packet) {
     case STATE_BIND_BINDING2:
         if (getBind2(packet)) {
             cc2500Strobe(CC2500_SIDLE);
+            cc2500LedOff();
+            ledIsOn = false;
+            ledBindBlinkTime = millis();
+            bindCompleteBlinks = 80;
             protocolState = STATE_BIND_COMPLETE;
         }
         break;
     case STATE_BIND_COMPLETE:
         if (!rxFrSkySpiConfig()->autoBind) {
             writeEEPROM();
-        } else {
-            uint8_t ctr = 40;
-            while (ctr--) {
-                cc2500LedOn();
-                delay(50);
-                cc2500LedOff();
-                delay(50);
+        } else if (bindCompleteBlinks) {
+            // flash the LED for a few seconds without holding up the other tasks
+            if (millis() - ledBindBlinkTime >= 50) {
+                ledBindBlinkTime = millis();
+                if (ledIsOn) {
+                    cc2500LedOff();
+                } else {
+                    cc2500LedOn();
+                }
+                ledIsOn = !ledIsOn;
+                bindCompleteBlinks--;
             }
+            break;
         }
         ret = RX_SPI_RECEIVED_BIND;
         protocolState = STATE_STARTING;
@@ -389,6 +400,10 @@ void nextChannel(uint8_t skip) {
     }
 }
 
+static timeUs_t frSkySpiFrameTimeUs(void) {
+    return packetTimeUs;
+}
+
 bool frSkySpiInit(const rxSpiConfig_t *rxSpiConfig, rxRuntimeConfig_t *rxRuntimeConfig) {
     cc2500SpiInit();
     spiProtocol = rxSpiConfig->rx_spi_protocol;
@@ -413,8 +428,10 @@ bool frSkySpiInit(const rxSpiConfig_t *rxSpiConfig, rxRuntimeConfig_t *rxRuntime
         rssiSource = RSSI_SOURCE_RX_PROTOCOL;
     }
 #endif
+    rxRuntimeConfig->rcFrameTimeUsFn = frSkySpiFrameTimeUs;
     missingPackets = 0;
     timeoutUs = 50;
+    packetTimeUs = 0;
     start_time = millis();
     protocolState = STATE_INIT;
     return true;
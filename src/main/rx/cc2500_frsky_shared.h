@@ -28,6 +28,7 @@
 #define DEBUG_DATA_ERROR_COUNT 0
 #define DEBUG_DATA_MISSING_PACKETS 1
 #define DEBUG_DATA_BAD_FRAME 2
+#define DEBUG_DATA_HOP_LATENESS 3
 
 
 #define SYNC_DELAY_MAX 9000
@@ -51,6 +52,7 @@ enum {
 extern uint8_t listLength;
 extern uint32_t missingPackets;
 extern timeDelta_t timeoutUs;
+extern timeUs_t packetTimeUs;   // arrival of the last good packet
 
 void initialiseData(bool inBindState);
 
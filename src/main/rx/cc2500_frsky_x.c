@@ -50,6 +50,7 @@
 #include "rx/cc2500_common.h"
 #include "rx/cc2500_frsky_common.h"
 #include "rx/cc2500_frsky_shared.h"
+#include "rx/rx_spi_timing.h"
 
 #include "sensors/battery.h"
 
@@ -279,6 +280,110 @@ void frSkyXSetRcData(uint16_t *rcData, const uint8_t *packet) {
     }
 }
 
+#define TELEMETRY_OFFSET_US 400  // after the packet, or where it was due
+#define HOP_OFFSET_US       3700
+
+static rxSpiSlotTimer_t slotTimer;
+static timeDelta_t receiveDelayUs;
+static uint8_t channelsToSkip = 1;
+#ifdef USE_RX_SPI_SLOT_TIMER
+static volatile bool telemetrySent;
+static volatile uint8_t hopSlots;
+#endif
+
+#if defined(USE_RX_FRSKY_SPI_TELEMETRY)
+static void frSkyXSendTelemetry(void) {
+    cc2500Strobe(CC2500_SIDLE);
+    cc2500SetPower(6);
+    cc2500Strobe(CC2500_SFRX);
+    delayMicroseconds(30);
+#if defined(USE_RX_CC2500_SPI_PA_LNA)
+    cc2500TxEnable();
+#endif
+    cc2500Strobe(CC2500_SIDLE);
+    cc2500WriteFifo(frame, frame[0] + 1);
+}
+#endif
+
+// The hop is scheduled from the last packet, a late one hops over the
+// slots it missed to stay on the channel of the transmitter. Returns the
+// number of slots.
+static uint8_t frSkyXHop(timeUs_t currentTimeUs) {
+    DEBUG_SET(DEBUG_RX_FRSKY_SPI, DEBUG_DATA_HOP_LATENESS, rxSpiSlotTimerLateness(&slotTimer, receiveDelayUs + HOP_OFFSET_US, currentTimeUs));
+    const uint8_t slots = rxSpiSlotTimerAdvance(&slotTimer, receiveDelayUs + HOP_OFFSET_US, currentTimeUs);
+    nextChannel((channelsToSkip * slots) % listLength);
+    cc2500DropPacket();
+    cc2500Strobe(CC2500_SRX);
+#ifdef USE_RX_CC2500_SPI_PA_LNA
+    cc2500TxDisable();
+#if defined(USE_RX_CC2500_SPI_DIVERSITY)
+    if (missingPackets >= 2) {
+        cc2500switchAntennae();
+    }
+#endif
+#endif // USE_RX_CC2500_SPI_PA_LNA
+    return slots;
+}
+
+#ifdef USE_RX_SPI_SLOT_TIMER
+static void frSkyXHopFromTimer(timeUs_t currentTimeUs) {
+    hopSlots = frSkyXHop(currentTimeUs);
+}
+
+#if defined(USE_RX_FRSKY_SPI_TELEMETRY)
+static void frSkyXTelemetryFromTimer(timeUs_t currentTimeUs) {
+    UNUSED(currentTimeUs);
+    frSkyXSendTelemetry();
+    telemetrySent = true;
+    rxSpiSlotTimerArm(&slotTimer, receiveDelayUs + HOP_OFFSET_US, frSkyXHopFromTimer);
+}
+#endif
+#endif
+
+#if defined(USE_RX_FRSKY_SPI_TELEMETRY)
+// true once the telemetry frame went out in its slot
+static bool frSkyXTelemetrySlot(void) {
+#ifdef USE_RX_SPI_SLOT_TIMER
+    if (rxSpiSlotTimerIsHardware()) {
+        if (!telemetrySent) {
+            return false;
+        }
+        telemetrySent = false;
+        return true;
+    }
+#endif
+    if (!rxSpiSlotTimerDue(&slotTimer, receiveDelayUs + TELEMETRY_OFFSET_US, micros())) {
+        return false;
+    }
+    CC2500_RADIO_BLOCK {
+        frSkyXSendTelemetry();
+    }
+    return true;
+}
+#endif
+
+// the slots the hop went over, 0 while it is still ahead
+static uint8_t frSkyXHopSlot(void) {
+    uint8_t slots = 0;
+#ifdef USE_RX_SPI_SLOT_TIMER
+    if (rxSpiSlotTimerIsHardware()) {
+        // only the hop writes it, and it is not armed again before this clears it
+        slots = hopSlots;
+        if (slots) {
+            hopSlots = 0;
+        }
+        return slots;
+    }
+#endif
+    const timeUs_t currentTimeUs = micros();
+    if (rxSpiSlotTimerDue(&slotTimer, receiveDelayUs + HOP_OFFSET_US, currentTimeUs)) {
+        CC2500_RADIO_BLOCK {
+            slots = frSkyXHop(currentTimeUs);
+        }
+    }
+    return slots;
+}
+
 rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const protocolState) {
     static unsigned receiveTelemetryRetryCount = 0;
     static timeMs_t pollingTimeMs = 0;
@@ -287,10 +392,7 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
     static uint8_t remoteProcessedId = 0;
     static uint8_t remoteAckId = 0;
     static uint8_t remoteToProcessIndex = 0;
-    static timeUs_t packetTimerUs;
     static bool frameReceived;
-    static timeDelta_t receiveDelayUs;
-    static uint8_t channelsToSkip = 1;
     static uint32_t packetErrors = 0;
     static telemetryBuffer_t telemetryRxBuffer[TELEMETRY_SEQUENCE_LENGTH];
 #if defined(USE_RX_FRSKY_SPI_TELEMETRY)
@@ -301,34 +403,32 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
     case STATE_STARTING:
         listLength = 47;
         initialiseData(false);
+        rxSpiSlotTimerInit(&slotTimer, SYNC_DELAY_MAX);
         *protocolState = STATE_UPDATE;
         nextChannel(1);
         cc2500Strobe(CC2500_SRX);
+        cc2500StartPacketCapture(1, CC2500_PACKET_MAX_LENGTH);
         break;
     case STATE_UPDATE:
-        packetTimerUs = micros();
+        rxSpiSlotTimerSync(&slotTimer, micros());
         *protocolState = STATE_DATA;
         frameReceived = false; // again set for receive
         receiveDelayUs = 5300;
         if (cc2500checkBindRequested(false)) {
-            packetTimerUs = 0;
             timeoutUs = 50;
             missingPackets = 0;
+            cc2500StopPacketCapture();
             *protocolState = STATE_INIT;
             break;
         }
         FALLTHROUGH;
     // here FS code could be
     case STATE_DATA:
-        if (cc2500getGdo() && (frameReceived == false)) {
-            bool packetOk = false;
-            uint8_t ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
-            ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F; // read 2 times to avoid reading errors
-            if (ccLen > 32) {
-                ccLen = 32;
-            }
+        if (frameReceived == false) {
+            timeUs_t gdoTimeUs;
+            const uint8_t ccLen = cc2500ReadPacket(packet, &gdoTimeUs);
             if (ccLen) {
-                cc2500ReadFifo(packet, ccLen);
+                bool packetOk = false;
                 uint16_t lcrc = calculateCrc(&packet[3], (ccLen - 7));
                 if((lcrc >> 8) == packet[ccLen - 4] && (lcrc & 0x00FF) == packet[ccLen - 3]) { // check calculateCrc
                     if (packet[0] == 0x1D) {
@@ -391,7 +491,8 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
                                 }
                                 receiveTelemetryRetryCount = 0;
                             }
-                            packetTimerUs = micros();
+                            packetTimeUs = gdoTimeUs;
+                            rxSpiSlotTimerSync(&slotTimer, gdoTimeUs);
                             frameReceived = true; // no need to process frame again.
                         }
                     }
@@ -400,18 +501,27 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
                     packetErrors++;
                     DEBUG_SET(DEBUG_RX_FRSKY_SPI, DEBUG_DATA_BAD_FRAME, packetErrors);
                 }
-            }
-            if (!packetOk) {
-                    cc2500Strobe(CC2500_SRX);
+                if (!packetOk) {
+                    CC2500_RADIO_BLOCK {
+                        cc2500Strobe(CC2500_SRX);
+                    }
+                }
             }
         }
         if (telemetryReceived) {
-            if(cmpTimeUs(micros(), packetTimerUs) > receiveDelayUs) { // if received or not received in this time sent telemetry data
+            if (rxSpiSlotTimerDue(&slotTimer, receiveDelayUs, micros())) { // if received or not received in this time sent telemetry data
                 *protocolState = STATE_TELEMETRY;
                 buildTelemetryFrame(packet);
+#ifdef USE_RX_SPI_SLOT_TIMER
+                if (rxSpiSlotTimerIsHardware()) {
+                    // the frame goes out and the hop follows from the timer interrupt
+                    rxSpiSlotTimerArm(&slotTimer, receiveDelayUs + TELEMETRY_OFFSET_US, frSkyXTelemetryFromTimer);
+                }
+#endif
+                break;
             }
         }
-        if (cmpTimeUs(micros(), packetTimerUs) > timeoutUs * SYNC_DELAY_MAX) {
+        if (rxSpiSlotTimerDue(&slotTimer, timeoutUs * SYNC_DELAY_MAX, micros())) {
             if (ledIsOn) {
                 cc2500LedOff();
             } else {
@@ -419,23 +529,17 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
             }
             ledIsOn = !ledIsOn;
             setRssiDirect(0, RSSI_SOURCE_RX_PROTOCOL);
-            nextChannel(1);
-            cc2500Strobe(CC2500_SRX);
+            CC2500_RADIO_BLOCK {
+                nextChannel(1);
+                cc2500DropPacket();
+                cc2500Strobe(CC2500_SRX);
+            }
             *protocolState = STATE_UPDATE;
         }
         break;
 #ifdef USE_RX_FRSKY_SPI_TELEMETRY
     case STATE_TELEMETRY:
-        if(cmpTimeUs(micros(), packetTimerUs) >= receiveDelayUs + 400) { // if received or not received in this time sent telemetry data
-            cc2500Strobe(CC2500_SIDLE);
-            cc2500SetPower(6);
-            cc2500Strobe(CC2500_SFRX);
-            delayMicroseconds(30);
-#if defined(USE_RX_CC2500_SPI_PA_LNA)
-            cc2500TxEnable();
-#endif
-            cc2500Strobe(CC2500_SIDLE);
-            cc2500WriteFifo(frame, frame[0] + 1);
+        if (frSkyXTelemetrySlot()) { // if received or not received in this time sent telemetry data
 #if defined(USE_TELEMETRY_SMARTPORT)
             if (telemetryEnabled) {
                 bool clearToSend = false;
@@ -469,21 +573,11 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
         }
         break;
 #endif // USE_RX_FRSKY_SPI_TELEMETRY
-    case STATE_RESUME:
-        if (cmpTimeUs(micros(), packetTimerUs) > receiveDelayUs + 3700) {
-            packetTimerUs = micros();
+    case STATE_RESUME: {
+        const uint8_t slots = frSkyXHopSlot();
+        if (slots) {
             receiveDelayUs = 5300;
             frameReceived = false; // again set for receive
-            nextChannel(channelsToSkip);
-            cc2500Strobe(CC2500_SRX);
-#ifdef USE_RX_CC2500_SPI_PA_LNA
-            cc2500TxDisable();
-#if defined(USE_RX_CC2500_SPI_DIVERSITY)
-            if (missingPackets >= 2) {
-                cc2500switchAntennae();
-            }
-#endif
-#endif // USE_RX_CC2500_SPI_PA_LNA
             if (missingPackets > MAX_MISSING_PKT) {
                 timeoutUs = 50;
                 skipChannels = true;
@@ -491,12 +585,13 @@ rx_spi_received_e frSkyXHandlePacket(uint8_t * const packet, uint8_t * const pro
                 *protocolState = STATE_UPDATE;
                 break;
             }
-            missingPackets++;
+            missingPackets += slots;
             DEBUG_SET(DEBUG_RX_FRSKY_SPI, DEBUG_DATA_MISSING_PACKETS, missingPackets);
             *protocolState = STATE_DATA;
         }
         break;
     }
+    }
     return ret;
 }
 
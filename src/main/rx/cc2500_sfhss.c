@@ -70,6 +70,8 @@
 #define NEXT_CH_TIME_SYNC1      3500        /* sync ch1-4 recv */
 #define NEXT_CH_TIME_SYNC2      500         /* sync ch5-8 recv */
 
+static timeUs_t lastPacketTimeUs;
+
 static int8_t sfhss_channel = 0;
 static int8_t sfhss_code = 0;
 
@@ -139,6 +141,7 @@ static bool sfhssRecv(uint8_t *packet) {
     if (!(cc2500getGdo())) {
         return false;
     }
+    lastPacketTimeUs = cc2500getGdoTimeUs();
     ccLen = cc2500ReadReg(CC2500_3B_RXBYTES | CC2500_READ_BURST) & 0x7F;
     if (ccLen < SFHSS_PACKET_LEN) {
         return false;
@@ -340,7 +343,7 @@ rx_spi_received_e sfhssSpiDataReceived(uint8_t *packet) {
                     cc2500LedOn();
                     frame_recvd = 0x3;
                     SET_STATE(STATE_SYNC);
-                    nextFrameReceiveStartTime = currentPacketReceivedTime + NEXT_CH_TIME_SYNC2;
+                    nextFrameReceiveStartTime = lastPacketTimeUs + NEXT_CH_TIME_SYNC2;
                     return RX_SPI_RECEIVED_NONE;
                 }
             }
@@ -362,10 +365,10 @@ rx_spi_received_e sfhssSpiDataReceived(uint8_t *packet) {
             if (sfhssPacketParse(packet, true)) {
                 missingPackets = 0;
                 if ( GET_COMMAND(packet) & 0x8 ) {
-                    nextFrameReceiveStartTime = currentPacketReceivedTime + NEXT_CH_TIME_SYNC2;
+                    nextFrameReceiveStartTime = lastPacketTimeUs + NEXT_CH_TIME_SYNC2;
                     frame_recvd |= 0x2;     /* ch5-8 */
                 } else {
-                    nextFrameReceiveStartTime = currentPacketReceivedTime + NEXT_CH_TIME_SYNC1;
+                    nextFrameReceiveStartTime = lastPacketTimeUs + NEXT_CH_TIME_SYNC1;
                     cc2500Strobe(CC2500_SRX);
                     frame_recvd |= 0x1;     /* ch1-4 */
                 }
@@ -405,10 +408,15 @@ rx_spi_received_e sfhssSpiDataReceived(uint8_t *packet) {
     return ret;
 }
 
+static timeUs_t sfhssFrameTimeUs(void) {
+    return lastPacketTimeUs;
+}
+
 bool sfhssSpiInit(const rxSpiConfig_t *rxSpiConfig, rxRuntimeConfig_t *rxRuntimeConfig) {
     UNUSED(rxSpiConfig);
     cc2500SpiInit();
     rxRuntimeConfig->channelCount = RC_CHANNEL_COUNT_SFHSS;
+    rxRuntimeConfig->rcFrameTimeUsFn = sfhssFrameTimeUs;
     start_time = millis();
     SET_STATE(STATE_INIT);
     return true;
@@ -109,6 +109,7 @@ static rx_spi_protocol_e protocol = RX_SPI_A7105_FLYSKY_2A;
 static const timings_t *timings = &flySky2ATimings;
 static uint32_t timeout = 0;
 static uint32_t timeLastPacket = 0;
+static timeUs_t lastRcFrameTimeUs = 0;
 static uint32_t timeLastBind = 0;
 static uint32_t timeTxRequest = 0;
 static uint32_t countTimeout = 0;
@@ -303,6 +304,10 @@ static rx_spi_received_e flySkyReadAndProcess (uint8_t *payload, const uint32_t
     return result;
 }
 
+static timeUs_t flySkyFrameTimeUs(void) {
+    return lastRcFrameTimeUs;
+}
+
 bool flySkyInit (const rxSpiConfig_t *rxSpiConfig, struct rxRuntimeConfig_s *rxRuntimeConfig) {
     protocol = rxSpiConfig->rx_spi_protocol;
     if (protocol != flySkyConfig()->protocol) {
@@ -332,6 +337,7 @@ bool flySkyInit (const rxSpiConfig_t *rxSpiConfig, struct rxRuntimeConfig_s *rxR
         A7105Init(0x5475c52A);
         A7105Config(flySkyRegs, sizeof(flySkyRegs));
     }
+    rxRuntimeConfig->rcFrameTimeUsFn = flySkyFrameTimeUs;
     if ( !IORead(bindPin) || flySkyConfig()->txId == 0) {
         bound = false;
     } else {
@@ -380,6 +386,9 @@ rx_spi_received_e flySkyDataReceived (uint8_t *payload) {
             } else {
                 result = flySkyReadAndProcess(payload, timeStamp);
             }
+            if (result == RX_SPI_RECEIVED_DATA) {
+                lastRcFrameTimeUs = timeStamp; // GIO1 EXTI edge, not the task poll
+            }
         } else {
             A7105Strobe(A7105_RX);
         }
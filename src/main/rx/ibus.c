@@ -70,6 +70,8 @@ static uint8_t rxBytesToIgnore;
 static uint16_t ibusChecksum;
 
 static bool ibusFrameDone = false;
+static timeUs_t ibusFrameDoneAtUs = 0;
+static timeUs_t lastRcFrameTimeUs = 0;
 static uint32_t ibusChannelData[IBUS_MAX_CHANNEL];
 
 static uint8_t ibus[IBUS_BUFFSIZE] = { 0, };
@@ -115,6 +117,7 @@ static void ibusDataReceive(uint16_t c, void *data) {
     ibus[ibusFramePosition] = (uint8_t)c;
     if (ibusFramePosition == ibusFrameSize - 1) {
         ibusFrameDone = true;
+        ibusFrameDoneAtUs = ibusTime;
     } else {
         ibusFramePosition++;
     }
@@ -161,6 +164,7 @@ static uint8_t ibusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig) {
     if (checksumIsOk()) {
         if (ibusModel == IBUS_MODEL_IA6 || ibusSyncByte == 0x20) {
             updateChannelData();
+            lastRcFrameTimeUs = ibusFrameDoneAtUs;
             frameStatus = RX_FRAME_COMPLETE;
         } else {
 #if defined(USE_TELEMETRY) && defined(USE_TELEMETRY_IBUS)
@@ -178,6 +182,11 @@ static uint16_t ibusReadRawRC(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t
 }
 
 
+static timeUs_t ibusFrameTimeUs(void) {
+    return lastRcFrameTimeUs;
+}
+
+
 bool ibusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig) {
     UNUSED(rxConfig);
     ibusSyncByte = 0;
@@ -185,6 +194,7 @@ bool ibusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig) {
     rxRuntimeConfig->rxRefreshRate = 20000; // TODO - Verify speed
     rxRuntimeConfig->rcReadRawFn = ibusReadRawRC;
     rxRuntimeConfig->rcFrameStatusFn = ibusFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = ibusFrameTimeUs;
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
         return false;
@@ -67,6 +67,7 @@
 #include "rx/crsf.h"
 #include "rx/ghst.h"
 #include "rx/rx_spi.h"
+#include "rx/rx_frame_timing.h"
 #include "rx/targetcustomserial.h"
 
 
@@ -101,6 +102,7 @@ static uint32_t needRxSignalBefore = 0;
 static uint32_t needRxSignalMaxDelayUs;
 static uint32_t suspendRxSignalUntil = 0;
 static uint8_t  skipRxSamples = 0;
+static rxFrameTiming_t rxFrameTiming;
 
 static int16_t rcRaw[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
 int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
@@ -243,6 +245,8 @@ void rxInit(void) {
     rxRuntimeConfig.rcReadRawFn = nullReadRawRC;
     rxRuntimeConfig.rcFrameStatusFn = nullFrameStatus;
     rxRuntimeConfig.rcProcessFrameFn = nullProcessFrame;
+    rxRuntimeConfig.rcFrameTimeUsFn = NULL;
+    rxFrameTimingInit(&rxFrameTiming);
     rcSampleIndex = 0;
     needRxSignalMaxDelayUs = DELAY_10_HZ;
     for (int i = 0; i < MAX_SUPPORTED_RC_CHANNEL_COUNT; i++) {
@@ -365,6 +369,9 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime) {
             signalReceived = !(rxIsInFailsafeMode || rxFrameDropped);
             if (signalReceived) {
                 needRxSignalBefore = currentTimeUs + needRxSignalMaxDelayUs;
+                // drivers without their own timestamp are timed by this check
+                const timeUs_t frameTimeUs = rxRuntimeConfig.rcFrameTimeUsFn ? rxRuntimeConfig.rcFrameTimeUsFn() : currentTimeUs;
+                rxFrameTimingUpdate(&rxFrameTiming, frameTimeUs);
             }
             if (frameStatus & (RX_FRAME_FAILSAFE | RX_FRAME_DROPPED)) {
                 // No (0%) signal
@@ -668,6 +675,19 @@ uint16_t rxGetRefreshRate(void) {
     return rxRuntimeConfig.rxRefreshRate;
 }
 
+// time between the last two received frames, 0 if not known
+timeDelta_t rxGetFrameDelta(void) {
+    return rxFrameTiming.frameDeltaUs;
+}
+
+const rxFrameTiming_t *rxGetFrameTiming(void) {
+    return &rxFrameTiming;
+}
+
+bool rxHasFrameTimestamps(void) {
+    return rxRuntimeConfig.rcFrameTimeUsFn != NULL;
+}
+
 bool isRssiConfigured(void) {
     return rssiSource != RSSI_SOURCE_NONE;
 }
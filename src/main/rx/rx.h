@@ -126,7 +126,7 @@ struct rxRuntimeConfig_s;
 typedef uint16_t (*rcReadRawDataFnPtr)(const struct rxRuntimeConfig_s *rxRuntimeConfig, uint8_t chan); // used by receiver driver to return channel data
 typedef uint8_t (*rcFrameStatusFnPtr)(struct rxRuntimeConfig_s *rxRuntimeConfig);
 typedef bool (*rcProcessFrameFnPtr)(const struct rxRuntimeConfig_s *rxRuntimeConfig);
-typedef timeUs_t rcGetFrameTimeUsFn(void);  // used to retrieve the timestamp in microseconds for the last channe     l data frame
+typedef timeUs_t rcGetFrameTimeUsFn(void);  // used to retrieve the timestamp in microseconds for the last channel data frame
 
 typedef struct rxRuntimeConfig_s {
     uint8_t             channelCount; // number of RC channels as reported by current input driver
@@ -190,3 +190,8 @@ uint8_t CRSFgetSnR(void);
 uint16_t CRSFgetTXPower(void);
 
 uint16_t rxGetRefreshRate(void);
+
+struct rxFrameTiming_s;
+timeDelta_t rxGetFrameDelta(void);
+const struct rxFrameTiming_s *rxGetFrameTiming(void);
+bool rxHasFrameTimestamps(void);
@@ -0,0 +1,80 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * RX frame interval statistics.
+ *
+ *   The receiver drivers timestamp each frame when its last byte arrives,
+ * so the intervals seen here do not include the scheduling latency of the
+ * RX task. The average and the mean deviation from it (the jitter) are
+ * first order low pass filters over the intervals.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/maths.h"
+
+#include "rx/rx_frame_timing.h"
+
+#define RX_FRAME_TIMING_SCALE       16
+#define RX_FRAME_TIMING_FILTER_GAIN 8   // filter time constant in frames
+
+void rxFrameTimingInit(rxFrameTiming_t *timing) {
+    memset(timing, 0, sizeof(*timing));
+}
+
+// returns true if the frame produced a new interval
+bool rxFrameTimingUpdate(rxFrameTiming_t *timing, timeUs_t frameTimeUs) {
+    const timeDelta_t deltaUs = cmpTimeUs(frameTimeUs, timing->lastFrameTimeUs);
+    if (timing->frameCount && deltaUs == 0) {
+        // same frame reported again
+        return false;
+    }
+    const bool restart = timing->frameCount == 0 || deltaUs < 0 || deltaUs > RX_FRAME_TIMING_MAX_GAP_US;
+    timing->lastFrameTimeUs = frameTimeUs;
+    if (restart) {
+        rxFrameTimingInit(timing);
+        timing->lastFrameTimeUs = frameTimeUs;
+        timing->frameCount = 1;
+        return false;
+    }
+    timing->frameCount++;
+    timing->frameDeltaUs = deltaUs;
+    const int32_t delta = deltaUs * RX_FRAME_TIMING_SCALE;
+    if (timing->frameCount == 2) {
+        timing->averageDelta = delta;
+        return true;
+    }
+    const int32_t deviation = ABS(delta - timing->averageDelta);
+    timing->averageDelta += (delta - timing->averageDelta) / RX_FRAME_TIMING_FILTER_GAIN;
+    timing->averageDeviation += (deviation - timing->averageDeviation) / RX_FRAME_TIMING_FILTER_GAIN;
+    timing->maxJitterUs = MAX(timing->maxJitterUs, MIN(deviation / RX_FRAME_TIMING_SCALE, UINT16_MAX));
+    return true;
+}
+
+uint16_t rxFrameTimingAverageUs(const rxFrameTiming_t *timing) {
+    return MIN(timing->averageDelta / RX_FRAME_TIMING_SCALE, UINT16_MAX);
+}
+
+uint16_t rxFrameTimingJitterUs(const rxFrameTiming_t *timing) {
+    return MIN(timing->averageDeviation / RX_FRAME_TIMING_SCALE, UINT16_MAX);
+}
@@ -0,0 +1,44 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define RX_FRAME_TIMING_MAX_GAP_US  100000  // a longer gap restarts the statistics
+
+// Inter-frame times measured from the frame timestamps of the receiver driver.
+// Averages are kept in 1/16us.
+typedef struct rxFrameTiming_s {
+    timeUs_t lastFrameTimeUs;
+    timeDelta_t frameDeltaUs;   // last inter-frame time, 0 until two frames are seen
+    int32_t averageDelta;
+    int32_t averageDeviation;
+    uint16_t maxJitterUs;       // largest deviation from the average since the restart
+    uint32_t frameCount;
+} rxFrameTiming_t;
+
+void rxFrameTimingInit(rxFrameTiming_t *timing);
+bool rxFrameTimingUpdate(rxFrameTiming_t *timing, timeUs_t frameTimeUs);
+uint16_t rxFrameTimingAverageUs(const rxFrameTiming_t *timing);
+uint16_t rxFrameTimingJitterUs(const rxFrameTiming_t *timing);
@@ -48,6 +48,7 @@
 #include "rx/nrf24_kn.h"
 #include "rx/flysky.h"
 #include "rx/cc2500_sfhss.h"
+#include "rx/rx_spi_timing.h"
 
 
 uint16_t rxSpiRcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
@@ -175,6 +176,9 @@ bool rxSpiInit(const rxSpiConfig_t *rxSpiConfig, rxRuntimeConfig_t *rxRuntimeCon
     if (!rxSpiDeviceInit(rxSpiConfig)) {
         return false;
     }
+#ifdef USE_RX_SPI_SLOT_TIMER
+    rxSpiSlotTimerHardwareInit();
+#endif
     if (rxSpiSetProtocol(rxSpiConfig->rx_spi_protocol)) {
         ret = protocolInit(rxSpiConfig, rxRuntimeConfig);
     }
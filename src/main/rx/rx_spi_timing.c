@@ -0,0 +1,150 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Slot timing for the frequency hopping SPI receivers.
+ *
+ *   The transmitter hops on a fixed period, so the hop and telemetry
+ * deadlines of the receiver are offsets from the arrival of the last
+ * packet. When a packet is missed the anchor moves on by exactly the
+ * deadline that passed, so the time the RX task is polled late does not
+ * add up over a run of missed packets. A poll that is later than a whole
+ * period reports the slots that went by, so the caller can hop over them
+ * and stay on the channel the transmitter is on.
+ *
+ *   Targets that set aside a timer channel (RX_SPI_SLOT_TIMER_PIN) run the
+ * deadlines from its compare interrupt instead, so the hop and the
+ * telemetry slot do not wait for the scheduler to poll the RX task. Only
+ * the compare interrupt of the channel is used, its pin is left alone.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#ifdef USE_RX_SPI_SLOT_TIMER
+#include "build/atomic.h"
+
+#include "drivers/io.h"
+#include "drivers/nvic.h"
+#include "drivers/time.h"
+#include "drivers/timer.h"
+#endif
+
+#include "rx/rx_spi_timing.h"
+
+#define SLOT_TIMER_PERIOD       0x10000 // free running, 1us per tick
+#define SLOT_TIMER_MIN_DELAY_US 5       // a compare this close may already have gone by
+#define SLOT_TIMER_MAX_DELAY_US (SLOT_TIMER_PERIOD - 1000)
+
+void rxSpiSlotTimerInit(rxSpiSlotTimer_t *timer, timeDelta_t periodUs) {
+    timer->anchorUs = 0;
+    timer->periodUs = periodUs;
+}
+
+// anchor the slot to the arrival of a packet, also used to restart the search
+void rxSpiSlotTimerSync(rxSpiSlotTimer_t *timer, timeUs_t packetTimeUs) {
+    timer->anchorUs = packetTimeUs;
+}
+
+bool rxSpiSlotTimerDue(const rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, timeUs_t currentTimeUs) {
+    return rxSpiSlotTimerLateness(timer, offsetUs, currentTimeUs) >= 0;
+}
+
+// Moves the anchor to the deadline at offsetUs, and on by the periods that
+// elapsed after it. Returns the number of slots that went by, at least one.
+uint8_t rxSpiSlotTimerAdvance(rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, timeUs_t currentTimeUs) {
+    timer->anchorUs += offsetUs;
+    const timeDelta_t lateUs = cmpTimeUs(currentTimeUs, timer->anchorUs);
+    uint32_t slots = 1;
+    if (lateUs >= timer->periodUs && timer->periodUs > 0) {
+        const uint32_t skipped = MIN(lateUs / timer->periodUs, UINT8_MAX - 1);
+        timer->anchorUs += skipped * timer->periodUs;
+        slots += skipped;
+    }
+    return slots;
+}
+
+// time since the deadline at offsetUs, negative while it is still ahead
+timeDelta_t rxSpiSlotTimerLateness(const rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, timeUs_t currentTimeUs) {
+    return cmpTimeUs(currentTimeUs, timer->anchorUs + offsetUs);
+}
+
+// time from now to the deadline at offsetUs, as far as a 16 bit compare reaches
+timeDelta_t rxSpiSlotTimerDelay(const rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, timeUs_t currentTimeUs) {
+    return constrain(-rxSpiSlotTimerLateness(timer, offsetUs, currentTimeUs), SLOT_TIMER_MIN_DELAY_US, SLOT_TIMER_MAX_DELAY_US);
+}
+
+#ifdef USE_RX_SPI_SLOT_TIMER
+static const timerHardware_t *slotTimerHardware;
+static timerCCHandlerRec_t slotTimerCompareCb;
+static rxSpiSlotCallbackFn * volatile slotCallback;
+
+static void rxSpiSlotTimerCompare(timerCCHandlerRec_t *cbRec, captureCompare_t capture) {
+    UNUSED(cbRec);
+    UNUSED(capture);
+    timerChITConfig(slotTimerHardware, DISABLE);
+    rxSpiSlotCallbackFn *callback = slotCallback;
+    slotCallback = NULL;
+    if (callback) {
+        callback(micros());
+    }
+}
+
+bool rxSpiSlotTimerHardwareInit(void) {
+    const timerHardware_t *timerHardware = timerGetByTag(IO_TAG(RX_SPI_SLOT_TIMER_PIN));
+    if (!timerHardware) {
+        return false;
+    }
+    timerConfigure(timerHardware, (uint16_t)SLOT_TIMER_PERIOD, MHZ_TO_HZ(1));
+    timerChCCHandlerInit(&slotTimerCompareCb, rxSpiSlotTimerCompare);
+    timerChConfigCallbacks(timerHardware, &slotTimerCompareCb, NULL);
+    timerChITConfig(timerHardware, DISABLE);
+    slotTimerHardware = timerHardware;
+    return true;
+}
+
+bool rxSpiSlotTimerIsHardware(void) {
+    return slotTimerHardware != NULL;
+}
+
+// Calls back from the compare interrupt at the deadline at offsetUs. There
+// is one deadline at a time, arming again replaces the pending one.
+void rxSpiSlotTimerArm(const rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, rxSpiSlotCallbackFn *callback) {
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        const timeDelta_t delayUs = rxSpiSlotTimerDelay(timer, offsetUs, micros());
+        slotCallback = callback;
+        *timerChCCR(slotTimerHardware) = (uint16_t)(slotTimerHardware->tim->CNT + delayUs);
+        timerChClearCCFlag(slotTimerHardware);
+        timerChITConfig(slotTimerHardware, ENABLE);
+    }
+}
+
+void rxSpiSlotTimerDisarm(void) {
+    ATOMIC_BLOCK(NVIC_PRIO_TIMER) {
+        timerChITConfig(slotTimerHardware, DISABLE);
+        slotCallback = NULL;
+    }
+}
+#endif
@@ -0,0 +1,53 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+// Hop slots of a frequency hopping SPI receiver. The anchor is the arrival
+// time of the last packet, or the scheduled start of the slot when a packet
+// was missed, never the time the RX task got around to polling the radio.
+typedef struct rxSpiSlotTimer_s {
+    timeUs_t anchorUs;
+    timeDelta_t periodUs;       // time between two packets of the transmitter
+} rxSpiSlotTimer_t;
+
+void rxSpiSlotTimerInit(rxSpiSlotTimer_t *timer, timeDelta_t periodUs);
+void rxSpiSlotTimerSync(rxSpiSlotTimer_t *timer, timeUs_t packetTimeUs);
+bool rxSpiSlotTimerDue(const rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, timeUs_t currentTimeUs);
+uint8_t rxSpiSlotTimerAdvance(rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, timeUs_t currentTimeUs);
+timeDelta_t rxSpiSlotTimerLateness(const rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, timeUs_t currentTimeUs);
+timeDelta_t rxSpiSlotTimerDelay(const rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, timeUs_t currentTimeUs);
+
+// Runs from the slot timer interrupt at a deadline
+typedef void rxSpiSlotCallbackFn(timeUs_t currentTimeUs);
+
+#ifdef USE_RX_SPI_SLOT_TIMER
+bool rxSpiSlotTimerHardwareInit(void);
+bool rxSpiSlotTimerIsHardware(void);
+void rxSpiSlotTimerArm(const rxSpiSlotTimer_t *timer, timeDelta_t offsetUs, rxSpiSlotCallbackFn *callback);
+void rxSpiSlotTimerDisarm(void);
+#else
+#define rxSpiSlotTimerIsHardware() (false)
+#endif
@@ -109,12 +109,15 @@ typedef union sbusFrame_u {
 typedef struct sbusFrameData_s {
     sbusFrame_t frame;
     uint32_t startAtUs;
+    timeUs_t doneAtUs;
     uint16_t stateFlags;
     uint8_t position;
     bool done;
 } sbusFrameData_t;
 
 
+static timeUs_t lastRcFrameTimeUs = 0;
+
 // Receive ISR callback
 static void sbusDataReceive(uint16_t c, void *data) {
     sbusFrameData_t *sbusFrameData = data;
@@ -135,6 +138,7 @@ static void sbusDataReceive(uint16_t c, void *data) {
             sbusFrameData->done = false;
         } else {
             sbusFrameData->done = true;
+            sbusFrameData->doneAtUs = nowUs;
             DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_TIME, sbusFrameTime);
         }
     }
@@ -146,6 +150,7 @@ static uint8_t sbusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig) {
         return RX_FRAME_PENDING;
     }
     sbusFrameData->done = false;
+    lastRcFrameTimeUs = sbusFrameData->doneAtUs;
     DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_FLAGS, sbusFrameData->frame.frame.channels.flags);
     if (sbusFrameData->frame.frame.channels.flags & SBUS_FLAG_SIGNAL_LOSS) {
         sbusFrameData->stateFlags |= SBUS_STATE_SIGNALLOSS;
@@ -159,6 +164,10 @@ static uint8_t sbusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig) {
     return sbusChannelsDecode(rxRuntimeConfig, &sbusFrameData->frame.frame.channels);
 }
 
+static timeUs_t sbusFrameTimeUs(void) {
+    return lastRcFrameTimeUs;
+}
+
 bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig) {
     static uint16_t sbusChannelData[SBUS_MAX_CHANNEL];
     static sbusFrameData_t sbusFrameData;
@@ -178,6 +187,7 @@ bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig) {
     }
 
     rxRuntimeConfig->rcFrameStatusFn = sbusFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = sbusFrameTimeUs;
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
         return false;
@@ -140,6 +140,14 @@ typedef enum {
     TASK_BEESIGN,
 #endif
 
+#ifdef USE_GYRO_SPECTRUM
+    TASK_GYRO_SPECTRUM,
+#endif
+
+#if defined(USE_FLASHFS) && defined(USE_FLASH_W25N01G)
+    TASK_FLASHFS,
+#endif
+
     /* Count of real tasks */
     TASK_COUNT,
 
@@ -98,12 +98,37 @@ extern bool AccInflightCalibrationSavetoEEProm;
 extern bool AccInflightCalibrationActive;
 
 static flightDynamicsTrims_t *accelerationTrims;
+static sensorTransform_t accTransform;
 
 static uint16_t accLpfCutHz = 0;
 static pt1Filter_t accFilterPt1[XYZ_AXIS_COUNT];
 
 PG_REGISTER_WITH_RESET_FN(accelerometerConfig_t, accelerometerConfig, PG_ACCELEROMETER_CONFIG, 0);
 
+// must be called whenever accAlign or the acceleration trims change
+static void accUpdateSensorTransform(void) {
+#ifdef USE_ACC_IMUF9001
+    // alignment is done by the IMU-F, only the trims are applied here
+    memset(&accTransform, 0, sizeof(accTransform));
+    accTransform.matrix[X][X] = 1.0f;
+    accTransform.matrix[Y][Y] = 1.0f;
+    accTransform.matrix[Z][Z] = 1.0f;
+    accTransform.scale = 1.0f;
+    accTransform.integerRotation = true;
+    accTransform.source[Y] = Y;
+    accTransform.source[Z] = Z;
+    accTransform.sign[X] = 1;
+    accTransform.sign[Y] = 1;
+    accTransform.sign[Z] = 1;
+#else
+    buildSensorTransform(&accTransform, acc.dev.accAlign, 1.0f);
+#endif
+    if (accelerationTrims) {
+        const float trims[XYZ_AXIS_COUNT] = { accelerationTrims->raw[X], accelerationTrims->raw[Y], accelerationTrims->raw[Z] };
+        sensorTransformSetAlignedBias(&accTransform, trims);
+    }
+}
+
 void resetRollAndPitchTrims(rollAndPitchTrims_t *rollAndPitchTrims) {
     RESET_CONFIG_2(rollAndPitchTrims_t, rollAndPitchTrims,
                    .values.roll = 0,
@@ -357,6 +382,7 @@ bool accInit(void) {
         acc.dev.accAlign = accelerometerConfig()->acc_align;
     }
 #endif //USE_ACC_IMUF9001
+    accUpdateSensorTransform();
     return true;
 }
 
@@ -383,8 +409,8 @@ static void performAccelerationCalibration(rollAndPitchTrims_t *rollAndPitchTrim
         if (isOnFirstAccelerationCalibrationCycle()) {
             a[axis] = 0;
         }
-        // Sum up CALIBRATING_ACC_CYCLES readings
-        a[axis] += acc.accADC[axis];
+        // Sum up CALIBRATING_ACC_CYCLES readings, adding back the trims the transform still applies
+        a[axis] += acc.accADC[axis] + accTransform.offset[axis];
         // Reset global variables to prevent other code from using un-calibrated data
         acc.accADC[axis] = 0;
         accelerationTrims->raw[axis] = 0;
@@ -394,6 +420,7 @@ static void performAccelerationCalibration(rollAndPitchTrims_t *rollAndPitchTrim
         accelerationTrims->raw[X] = a[X] / CALIBRATING_ACC_CYCLES;
         accelerationTrims->raw[Y] = a[Y] / CALIBRATING_ACC_CYCLES;
         accelerationTrims->raw[Z] = a[Z] / CALIBRATING_ACC_CYCLES - acc.dev.acc_1G;
+        accUpdateSensorTransform();
         resetRollAndPitchTrims(rollAndPitchTrims);
         saveConfigAndNotify();
     }
@@ -417,8 +444,8 @@ static void performInflightAccelerationCalibration(rollAndPitchTrims_t *rollAndP
             // Reset a[axis] at start of calibration
             if (InflightcalibratingA == 50)
                 b[axis] = 0;
-            // Sum up 50 readings
-            b[axis] += acc.accADC[axis];
+            // Sum up 50 readings, adding back the trims the transform still applies
+            b[axis] += acc.accADC[axis] + accTransform.offset[axis];
             // Clear global variables for next reading
             acc.accADC[axis] = 0;
             accelerationTrims->raw[axis] = 0;
@@ -443,6 +470,7 @@ static void performInflightAccelerationCalibration(rollAndPitchTrims_t *rollAndP
         accelerationTrims->raw[X] = b[X] / 50;
         accelerationTrims->raw[Y] = b[Y] / 50;
         accelerationTrims->raw[Z] = b[Z] / 50 - acc.dev.acc_1G;    // for nunchuck 200=1G
+        accUpdateSensorTransform();
         resetRollAndPitchTrims(rollAndPitchTrims);
         saveConfigAndNotify();
     }
@@ -455,11 +483,9 @@ void accUpdate(timeUs_t currentTimeUs, rollAndPitchTrims_t *rollAndPitchTrims) {
     }
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         DEBUG_SET(DEBUG_ACCELEROMETER, axis, acc.dev.ADCRaw[axis]);
-        acc.accADC[axis] = acc.dev.ADCRaw[axis];
     }
-#ifndef USE_ACC_IMUF9001
-    alignSensors(acc.accADC, acc.dev.accAlign);
-#endif
+    // rotation, board alignment and trims in a single pass
+    applySensorTransform(&accTransform, acc.dev.ADCRaw[X], acc.dev.ADCRaw[Y], acc.dev.ADCRaw[Z], acc.accADC);
     if (accLpfCutHz) {
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             acc.accADC[axis] = pt1FilterApply(&accFilterPt1[axis], (float)acc.accADC[axis]);
@@ -470,9 +496,6 @@ void accUpdate(timeUs_t currentTimeUs, rollAndPitchTrims_t *rollAndPitchTrims) {
     } else if (feature(FEATURE_INFLIGHT_ACC_CAL)) {
         performInflightAccelerationCalibration(rollAndPitchTrims);
     }
-    acc.accADC[X] -= accelerationTrims->raw[X];
-    acc.accADC[Y] -= accelerationTrims->raw[Y];
-    acc.accADC[Z] -= accelerationTrims->raw[Z];
     ++accumulatedMeasurementCount;
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         accumulatedMeasurements[axis] += acc.accADC[axis];
@@ -499,6 +522,7 @@ bool accGetAverage(quaternion *vAverage) {
 
 void setAccelerationTrims(flightDynamicsTrims_t *accelerationTrimsToUse) {
     accelerationTrims = accelerationTrimsToUse;
+    accUpdateSensorTransform();
 }
 
 void accInitFilters(void) {
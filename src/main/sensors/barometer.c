@@ -284,34 +284,78 @@ static uint32_t recalculateBarometerTotal(uint8_t baroSampleCount, uint32_t pres
 
 typedef enum {
     BAROMETER_NEEDS_SAMPLES = 0,
-    BAROMETER_NEEDS_CALCULATION
+    BAROMETER_NEEDS_CALCULATION,
+    BAROMETER_READING_SAMPLES,      // temperature read queued on the bus
+    BAROMETER_READING_CALCULATION   // pressure read queued on the bus
 } barometerState_e;
 
+#define BARO_JOB_POLL_US 500        // a few bytes at 400kHz, the read is normally done by then
+
 
 bool isBaroReady(void) {
     return baroReady;
 }
 
+static void baroCalculate(void) {
+    baro.dev.calculate(&baroPressure, &baroTemperature);
+    baro.baroPressure = baroPressure;
+    baro.baroTemperature = baroTemperature;
+    baroPressureSum = recalculateBarometerTotal(barometerConfig()->baro_sample_count, baroPressureSum, baroPressure);
+}
+
+// drivers with read_ut/read_up have their reads started in one invocation and picked up in the next
 uint32_t baroUpdate(void) {
     static barometerState_e state = BAROMETER_NEEDS_SAMPLES;
+    if (busJobBusy(&baro.dev.busdev, &baro.dev.job)) {
+        return BARO_JOB_POLL_US;
+    }
     switch (state) {
     default:
     case BAROMETER_NEEDS_SAMPLES:
+        if (baro.dev.read_ut) {
+            baro.dev.read_ut(&baro.dev);
+            state = BAROMETER_READING_SAMPLES;
+            return BARO_JOB_POLL_US;
+        }
         baro.dev.get_ut(&baro.dev);
         baro.dev.start_up(&baro.dev);
         state = BAROMETER_NEEDS_CALCULATION;
         return baro.dev.up_delay;
         break;
+    case BAROMETER_READING_SAMPLES:
+        // a failed read keeps the previous temperature
+        if (baro.dev.job.status == I2C_JOB_DONE) {
+            baro.dev.get_ut(&baro.dev);
+        }
+        baro.dev.start_up(&baro.dev);
+        state = BAROMETER_NEEDS_CALCULATION;
+        return baro.dev.up_delay;
+        break;
     case BAROMETER_NEEDS_CALCULATION:
+        if (baro.dev.read_up) {
+            baro.dev.read_up(&baro.dev);
+            state = BAROMETER_READING_CALCULATION;
+            return BARO_JOB_POLL_US;
+        }
         baro.dev.get_up(&baro.dev);
         baro.dev.start_ut(&baro.dev);
-        baro.dev.calculate(&baroPressure, &baroTemperature);
-        baro.baroPressure = baroPressure;
-        baro.baroTemperature = baroTemperature;
-        baroPressureSum = recalculateBarometerTotal(barometerConfig()->baro_sample_count, baroPressureSum, baroPressure);
+        baroCalculate();
         state = BAROMETER_NEEDS_SAMPLES;
         return baro.dev.ut_delay;
         break;
+    case BAROMETER_READING_CALCULATION: {
+        const bool readOk = baro.dev.job.status == I2C_JOB_DONE;
+        if (readOk) {
+            baro.dev.get_up(&baro.dev);
+        }
+        baro.dev.start_ut(&baro.dev);
+        if (readOk) {
+            baroCalculate();
+        }
+        state = BAROMETER_NEEDS_SAMPLES;
+        return baro.dev.ut_delay;
+        break;
+    }
     }
 }
 
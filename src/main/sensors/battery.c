@@ -487,3 +487,7 @@ int32_t getAmperageLatest(void) {
 int32_t getMAhDrawn(void) {
     return currentMeter.mAhDrawn;
 }
+
+int32_t getMWhDrawn(void) {
+    return currentMeter.mWhDrawn;
+}
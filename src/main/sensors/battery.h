@@ -109,6 +109,7 @@ bool isAmperageConfigured(void);
 int32_t getAmperage(void);
 int32_t getAmperageLatest(void);
 int32_t getMAhDrawn(void);
+int32_t getMWhDrawn(void);
 
 void batteryUpdateCurrentMeter(timeUs_t currentTimeUs);
 
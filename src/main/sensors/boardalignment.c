@@ -116,3 +116,68 @@ FAST_CODE void alignSensors(float *dest, uint8_t rotation) {
     if (!standardBoardAlignment)
         alignBoard(dest);
 }
+
+// Builds the combined rotation/scale matrix by pushing each unit vector through
+// alignSensors(), so the result always matches the per-sample path exactly.
+// When the result is a pure axis swap (standard board alignment or multiples of
+// 90 degrees) the swap and sign are also stored so samples can be rotated as
+// integers and only scaled in float.
+void buildSensorTransform(sensorTransform_t *transform, uint8_t rotation, float scale) {
+    transform->integerRotation = true;
+    transform->scale = scale;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float unit[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+        unit[axis] = 1.0f;
+        alignSensors(unit, rotation);
+        transform->matrix[X][axis] = unit[X] * scale;
+        transform->matrix[Y][axis] = unit[Y] * scale;
+        transform->matrix[Z][axis] = unit[Z] * scale;
+        transform->offset[axis] = 0.0f;
+        int nonZero = 0;
+        for (int dest = 0; dest < XYZ_AXIS_COUNT; dest++) {
+            if (unit[dest] == 1.0f || unit[dest] == -1.0f) {
+                transform->source[dest] = axis;
+                transform->sign[dest] = unit[dest] > 0 ? 1 : -1;
+                nonZero++;
+            } else if (unit[dest] != 0.0f) {
+                nonZero += XYZ_AXIS_COUNT;
+            }
+        }
+        if (nonZero != 1) {
+            transform->integerRotation = false;
+        }
+    }
+}
+
+// bias is given in raw sensor counts, before rotation (e.g. gyroZero)
+void sensorTransformSetSensorBias(sensorTransform_t *transform, const float *bias) {
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        transform->offset[axis] = transform->matrix[axis][X] * bias[X]
+                                  + transform->matrix[axis][Y] * bias[Y]
+                                  + transform->matrix[axis][Z] * bias[Z];
+    }
+}
+
+// bias is given in the aircraft frame, after rotation and scaling (e.g. accZero)
+void sensorTransformSetAlignedBias(sensorTransform_t *transform, const float *bias) {
+    transform->offset[X] = bias[X];
+    transform->offset[Y] = bias[Y];
+    transform->offset[Z] = bias[Z];
+}
+
+FAST_CODE void applySensorTransform(const sensorTransform_t *transform, int32_t x, int32_t y, int32_t z, float *dest) {
+    if (transform->integerRotation) {
+        // axis swap and sign in the integer domain, one multiply per axis
+        const int32_t raw[XYZ_AXIS_COUNT] = { x, y, z };
+        dest[X] = (float)(transform->sign[X] * raw[transform->source[X]]) * transform->scale - transform->offset[X];
+        dest[Y] = (float)(transform->sign[Y] * raw[transform->source[Y]]) * transform->scale - transform->offset[Y];
+        dest[Z] = (float)(transform->sign[Z] * raw[transform->source[Z]]) * transform->scale - transform->offset[Z];
+        return;
+    }
+    const float fx = x;
+    const float fy = y;
+    const float fz = z;
+    dest[X] = transform->matrix[X][X] * fx + transform->matrix[X][Y] * fy + transform->matrix[X][Z] * fz - transform->offset[X];
+    dest[Y] = transform->matrix[Y][X] * fx + transform->matrix[Y][Y] * fy + transform->matrix[Y][Z] * fz - transform->offset[Y];
+    dest[Z] = transform->matrix[Z][X] * fx + transform->matrix[Z][Y] * fy + transform->matrix[Z][Z] * fz - transform->offset[Z];
+}
@@ -30,6 +30,25 @@ typedef struct boardAlignment_s {
 
 PG_DECLARE(boardAlignment_t, boardAlignment);
 
+// Affine transform from raw sensor counts to the aircraft frame:
+// dest = matrix * raw - offset, where matrix combines the chip rotation,
+// the board alignment and the sensor scale, and offset holds the bias
+// already taken through the same matrix. For axis swaps the rotation is also
+// kept as source axis and sign so it can be done on the integer samples.
+typedef struct sensorTransform_s {
+    float matrix[3][3];
+    float offset[3];
+    float scale;
+    bool integerRotation;
+    uint8_t source[3];
+    int8_t sign[3];
+} sensorTransform_t;
+
 void alignSensors(float *dest, uint8_t rotation);
 void initBoardAlignment(const boardAlignment_t *boardAlignment);
 bool isBoardAlignmentStandard(const boardAlignment_t *boardAlignment);
+
+void buildSensorTransform(sensorTransform_t *transform, uint8_t rotation, float scale);
+void sensorTransformSetSensorBias(sensorTransform_t *transform, const float *bias);
+void sensorTransformSetAlignedBias(sensorTransform_t *transform, const float *bias);
+void applySensorTransform(const sensorTransform_t *transform, int32_t x, int32_t y, int32_t z, float *dest);
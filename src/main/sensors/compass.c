@@ -48,6 +48,7 @@
 
 #include "sensors/boardalignment.h"
 #include "sensors/compass.h"
+#include "sensors/compass_calibration.h"
 #include "sensors/gyro.h"
 #include "sensors/sensors.h"
 
@@ -64,7 +65,7 @@ mag_t mag;                   // mag access functions
 #define COMPASS_INTERRUPT_TAG   IO_TAG_NONE
 #endif
 
-PG_REGISTER_WITH_RESET_FN(compassConfig_t, compassConfig, PG_COMPASS_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(compassConfig_t, compassConfig, PG_COMPASS_CONFIG, 2);
 
 void pgResetFn_compassConfig(compassConfig_t *compassConfig) {
     compassConfig->mag_align = ALIGN_DEFAULT;
@@ -107,12 +108,22 @@ void pgResetFn_compassConfig(compassConfig_t *compassConfig) {
     compassConfig->mag_spi_csn = IO_TAG_NONE;
 #endif
     compassConfig->interruptTag = COMPASS_INTERRUPT_TAG;
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        compassConfig->magSoftIron[i * XYZ_AXIS_COUNT + i] = MAG_SOFT_IRON_SCALE;
+    }
 }
 
 #if defined(USE_MAG)
 
+#define MAG_CALIBRATION_TIME_US             30000000    // 30s: you have 30s to turn the multi in all directions
+#define MAG_CALIBRATION_MIN_COVERAGE        18          // of MAG_CALIBRATION_COVERAGE_BINS
+#define MAG_CALIBRATION_MAX_FIT_ERROR       0.05f
+#define MAG_CALIBRATION_MAX_RADIUS_RATIO    2.0f
+
 static int16_t magADCRaw[XYZ_AXIS_COUNT];
-static uint8_t magInit = 0;
+static sensorTransform_t magAlignment;  // chip rotation and board alignment only, used while calibrating
+static sensorTransform_t magTransform;  // alignment, soft iron and hard iron correction in one
+static magCalibration_t magCalibration;
 
 #if !defined(SIMULATOR_BUILD)
 bool compassDetect(magDev_t *dev) {
@@ -234,6 +245,49 @@ bool compassDetect(magDev_t *dev) {
 }
 #endif // !SIMULATOR_BUILD
 
+static void compassBuildTransform(void) {
+    const compassConfig_t *config = compassConfig();
+    buildSensorTransform(&magAlignment, magDev.magAlign, 1.0f);
+    // the calibration is taken in the aligned frame, so the correction goes after the alignment
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        float offset = 0;
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            float sum = 0;
+            for (int k = 0; k < XYZ_AXIS_COUNT; k++) {
+                sum += config->magSoftIron[i * XYZ_AXIS_COUNT + k] * magAlignment.matrix[k][j];
+            }
+            magTransform.matrix[i][j] = sum / MAG_SOFT_IRON_SCALE;
+            offset += config->magSoftIron[i * XYZ_AXIS_COUNT + j] * config->magZero.raw[j];
+        }
+        magTransform.offset[i] = offset / MAG_SOFT_IRON_SCALE;
+    }
+}
+
+static void compassFinishCalibration(void) {
+    compassConfig_t *config = compassConfigMutable();
+    magCalibrationResult_t result;
+    const bool fitted = magCalibrationCoverage(&magCalibration) >= MAG_CALIBRATION_MIN_COVERAGE
+        && magCalibrationSolve(&magCalibration, &result)
+        && result.fitError < MAG_CALIBRATION_MAX_FIT_ERROR
+        && result.radiusRatio < MAG_CALIBRATION_MAX_RADIUS_RATIO;
+    if (!fitted) {
+        // not enough directions for the ellipsoid, use the centre of the readings without soft iron correction
+        magCalibrationGetMinMaxBias(&magCalibration, result.bias);
+        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+            for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+                result.correction[i][j] = (i == j) ? 1.0f : 0.0f;
+            }
+        }
+    }
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        config->magZero.raw[i] = lrintf(result.bias[i]);
+        for (int j = 0; j < XYZ_AXIS_COUNT; j++) {
+            config->magSoftIron[i * XYZ_AXIS_COUNT + j] = constrain(lrintf(result.correction[i][j] * MAG_SOFT_IRON_SCALE), INT16_MIN, INT16_MAX);
+        }
+    }
+    compassBuildTransform();
+}
+
 bool compassInit(void) {
     // initialize and calibration. turn on led during mag calibration (calibration routine blinks it)
     // calculate magnetic declination
@@ -247,10 +301,10 @@ bool compassInit(void) {
     LED1_ON;
     magDev.init(&magDev);
     LED1_OFF;
-    magInit = 1;
     if (compassConfig()->mag_align != ALIGN_DEFAULT) {
         magDev.magAlign = compassConfig()->mag_align;
     }
+    compassBuildTransform();
     return true;
 }
 
@@ -262,44 +316,25 @@ bool compassIsHealthy(quaternion *q) {
 
 void compassUpdate(timeUs_t currentTimeUs) {
     static timeUs_t tCal = 0;
-    static flightDynamicsTrims_t magZeroTempMin;
-    static flightDynamicsTrims_t magZeroTempMax;
     magDev.read(&magDev, magADCRaw);
-    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        mag.magADC[axis] = magADCRaw[axis];
-    }
-    alignSensors(mag.magADC, magDev.magAlign);
-    flightDynamicsTrims_t *magZero = &compassConfigMutable()->magZero;
     if (STATE(CALIBRATE_MAG)) {
         tCal = currentTimeUs;
-        for (int axis = 0; axis < 3; axis++) {
-            magZero->raw[axis] = 0;
-            magZeroTempMin.raw[axis] = mag.magADC[axis];
-            magZeroTempMax.raw[axis] = mag.magADC[axis];
-        }
+        magCalibrationStart(&magCalibration);
         DISABLE_STATE(CALIBRATE_MAG);
     }
-    if (magInit) {              // we apply offset only once mag calibration is done
-        mag.magADC[X] -= magZero->raw[X];
-        mag.magADC[Y] -= magZero->raw[Y];
-        mag.magADC[Z] -= magZero->raw[Z];
+    if (tCal == 0) {
+        applySensorTransform(&magTransform, magADCRaw[X], magADCRaw[Y], magADCRaw[Z], mag.magADC);
+        return;
     }
-    if (tCal != 0) {
-        if ((currentTimeUs - tCal) < 30000000) {    // 30s: you have 30s to turn the multi in all directions
-            LED0_TOGGLE;
-            for (int axis = 0; axis < 3; axis++) {
-                if (mag.magADC[axis] < magZeroTempMin.raw[axis])
-                    magZeroTempMin.raw[axis] = mag.magADC[axis];
-                if (mag.magADC[axis] > magZeroTempMax.raw[axis])
-                    magZeroTempMax.raw[axis] = mag.magADC[axis];
-            }
-        } else {
-            tCal = 0;
-            for (int axis = 0; axis < 3; axis++) {
-                magZero->raw[axis] = (magZeroTempMin.raw[axis] + magZeroTempMax.raw[axis]) / 2; // Calculate offsets
-            }
-            saveConfigAndNotify();
-        }
+    // calibrate on the aligned readings, the previous correction no longer applies
+    applySensorTransform(&magAlignment, magADCRaw[X], magADCRaw[Y], magADCRaw[Z], mag.magADC);
+    if ((currentTimeUs - tCal) < MAG_CALIBRATION_TIME_US) {
+        LED0_TOGGLE;
+        magCalibrationAddSample(&magCalibration, mag.magADC);
+    } else {
+        tCal = 0;
+        compassFinishCalibration();
+        saveConfigAndNotify();
     }
 }
 
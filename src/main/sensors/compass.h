@@ -38,6 +38,8 @@ typedef enum {
     MAG_QMC5883 = 5
 } magSensor_e;
 
+#define MAG_SOFT_IRON_SCALE 4096
+
 typedef struct mag_s {
     float magADC[XYZ_AXIS_COUNT];
     float magneticDeclination;
@@ -57,6 +59,7 @@ typedef struct compassConfig_s {
     ioTag_t mag_spi_csn;
     ioTag_t interruptTag;
     flightDynamicsTrims_t magZero;
+    int16_t magSoftIron[XYZ_AXIS_COUNT * XYZ_AXIS_COUNT]; // row major, MAG_SOFT_IRON_SCALE is 1.0
 } compassConfig_t;
 
 PG_DECLARE(compassConfig_t, compassConfig);
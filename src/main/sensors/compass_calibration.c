@@ -0,0 +1,289 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Hard and soft iron magnetometer calibration.
+ *
+ *   Every sample adds one row to the least squares problem
+ *
+ *     a x^2 + b y^2 + c z^2 + 2d xy + 2e xz + 2f yz + 2g x + 2h y + 2i z = 1
+ *
+ * which is folded into the 9x9 normal equations straight away. Solving
+ * them gives the quadric, its centre is the hard iron bias and the
+ * symmetric square root of its shape matrix maps the ellipsoid back onto
+ * a sphere without rotating it.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "common/maths.h"
+
+#include "sensors/compass_calibration.h"
+
+#define JACOBI_MAX_SWEEPS 10
+
+void magCalibrationStart(magCalibration_t *cal) {
+    memset(cal, 0, sizeof(*cal));
+}
+
+static uint8_t coverageBin(const float *v) {
+    const float ax = fabsf(v[0]);
+    const float ay = fabsf(v[1]);
+    const float az = fabsf(v[2]);
+    // dominant axis picks the face, the signs of the other two its quadrant
+    if (ax >= ay && ax >= az) {
+        return (v[0] < 0 ? 4 : 0) + (v[1] < 0 ? 2 : 0) + (v[2] < 0 ? 1 : 0);
+    } else if (ay >= az) {
+        return 8 + (v[1] < 0 ? 4 : 0) + (v[0] < 0 ? 2 : 0) + (v[2] < 0 ? 1 : 0);
+    }
+    return 16 + (v[2] < 0 ? 4 : 0) + (v[0] < 0 ? 2 : 0) + (v[1] < 0 ? 1 : 0);
+}
+
+void magCalibrationAddSample(magCalibration_t *cal, const float *sample) {
+    if (cal->sampleCount == 0) {
+        const float length = sqrtf(sq(sample[0]) + sq(sample[1]) + sq(sample[2]));
+        cal->scale = length > 1.0f ? length : 1.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            cal->min[axis] = sample[axis];
+            cal->max[axis] = sample[axis];
+        }
+    }
+    float centred[3];
+    for (int axis = 0; axis < 3; axis++) {
+        cal->min[axis] = MIN(cal->min[axis], sample[axis]);
+        cal->max[axis] = MAX(cal->max[axis], sample[axis]);
+        centred[axis] = sample[axis] - (cal->min[axis] + cal->max[axis]) / 2;
+    }
+    cal->coverage |= 1U << coverageBin(centred);
+
+    const float x = sample[0] / cal->scale;
+    const float y = sample[1] / cal->scale;
+    const float z = sample[2] / cal->scale;
+    const float row[MAG_CALIBRATION_FIT_PARAMS] = {
+        x * x, y * y, z * z, 2 * x * y, 2 * x * z, 2 * y * z, 2 * x, 2 * y, 2 * z
+    };
+    for (int i = 0; i < MAG_CALIBRATION_FIT_PARAMS; i++) {
+        for (int j = i; j < MAG_CALIBRATION_FIT_PARAMS; j++) {
+            cal->normal[i][j] += row[i] * row[j];
+        }
+        cal->rhs[i] += row[i];
+    }
+    cal->sampleCount++;
+}
+
+uint8_t magCalibrationCoverage(const magCalibration_t *cal) {
+    return __builtin_popcount(cal->coverage);
+}
+
+// the classic calibration, the centre of the box around all samples
+void magCalibrationGetMinMaxBias(const magCalibration_t *cal, float *bias) {
+    for (int axis = 0; axis < 3; axis++) {
+        bias[axis] = (cal->min[axis] + cal->max[axis]) / 2;
+    }
+}
+
+// Gaussian elimination with partial pivoting, a is destroyed
+static bool solveLinear(float a[MAG_CALIBRATION_FIT_PARAMS][MAG_CALIBRATION_FIT_PARAMS + 1], float *x) {
+    const int n = MAG_CALIBRATION_FIT_PARAMS;
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < n; row++) {
+            if (fabsf(a[row][col]) > fabsf(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (fabsf(a[pivot][col]) < 1e-12f) {
+            return false;
+        }
+        if (pivot != col) {
+            for (int k = col; k <= n; k++) {
+                const float tmp = a[col][k];
+                a[col][k] = a[pivot][k];
+                a[pivot][k] = tmp;
+            }
+        }
+        for (int row = col + 1; row < n; row++) {
+            const float factor = a[row][col] / a[col][col];
+            for (int k = col; k <= n; k++) {
+                a[row][k] -= factor * a[col][k];
+            }
+        }
+    }
+    for (int row = n - 1; row >= 0; row--) {
+        float sum = a[row][n];
+        for (int k = row + 1; k < n; k++) {
+            sum -= a[row][k] * x[k];
+        }
+        x[row] = sum / a[row][row];
+    }
+    return true;
+}
+
+static bool invert3x3(float m[3][3], float inv[3][3]) {
+    const float det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                    - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                    + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    if (fabsf(det) < 1e-12f) {
+        return false;
+    }
+    inv[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) / det;
+    inv[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) / det;
+    inv[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) / det;
+    inv[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) / det;
+    inv[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) / det;
+    inv[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) / det;
+    inv[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) / det;
+    inv[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) / det;
+    inv[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / det;
+    return true;
+}
+
+// eigenvalues of the symmetric m end up on its diagonal, the eigenvectors in the columns of v
+static void jacobiEigen(float m[3][3], float v[3][3]) {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            v[i][j] = i == j ? 1.0f : 0.0f;
+        }
+    }
+    for (int sweep = 0; sweep < JACOBI_MAX_SWEEPS; sweep++) {
+        const float offDiagonal = fabsf(m[0][1]) + fabsf(m[0][2]) + fabsf(m[1][2]);
+        if (offDiagonal < 1e-9f * (fabsf(m[0][0]) + fabsf(m[1][1]) + fabsf(m[2][2]))) {
+            return;
+        }
+        for (int p = 0; p < 2; p++) {
+            for (int q = p + 1; q < 3; q++) {
+                if (m[p][q] == 0.0f) {
+                    continue;
+                }
+                const float theta = (m[q][q] - m[p][p]) / (2 * m[p][q]);
+                const float t = (theta >= 0 ? 1.0f : -1.0f) / (fabsf(theta) + sqrtf(theta * theta + 1));
+                const float c = 1 / sqrtf(t * t + 1);
+                const float s = t * c;
+                for (int k = 0; k < 3; k++) {
+                    const float mkp = m[k][p];
+                    const float mkq = m[k][q];
+                    m[k][p] = c * mkp - s * mkq;
+                    m[k][q] = s * mkp + c * mkq;
+                }
+                for (int k = 0; k < 3; k++) {
+                    const float mpk = m[p][k];
+                    const float mqk = m[q][k];
+                    m[p][k] = c * mpk - s * mqk;
+                    m[q][k] = s * mpk + c * mqk;
+                }
+                for (int k = 0; k < 3; k++) {
+                    const float vkp = v[k][p];
+                    const float vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+bool magCalibrationSolve(const magCalibration_t *cal, magCalibrationResult_t *result) {
+    const int n = MAG_CALIBRATION_FIT_PARAMS;
+    if (cal->sampleCount < MAG_CALIBRATION_MIN_SAMPLES) {
+        return false;
+    }
+    float a[MAG_CALIBRATION_FIT_PARAMS][MAG_CALIBRATION_FIT_PARAMS + 1];
+    for (int i = 0; i < n; i++) {
+        for (int j = i; j < n; j++) {
+            a[i][j] = cal->normal[i][j];
+            a[j][i] = cal->normal[i][j];
+        }
+        a[i][n] = cal->rhs[i];
+    }
+    float p[MAG_CALIBRATION_FIT_PARAMS];
+    if (!solveLinear(a, p)) {
+        return false;
+    }
+
+    // sum of squared residuals straight from the normal equations
+    float residual = cal->sampleCount;
+    for (int i = 0; i < n; i++) {
+        float np = 0;
+        for (int j = 0; j < n; j++) {
+            np += (i <= j ? cal->normal[i][j] : cal->normal[j][i]) * p[j];
+        }
+        residual += p[i] * np - 2 * p[i] * cal->rhs[i];
+    }
+
+    float shape[3][3] = {
+        { p[0], p[3], p[4] },
+        { p[3], p[1], p[5] },
+        { p[4], p[5], p[2] },
+    };
+    float inverse[3][3];
+    if (!invert3x3(shape, inverse)) {
+        return false;
+    }
+    float centre[3];
+    for (int i = 0; i < 3; i++) {
+        centre[i] = -(inverse[i][0] * p[6] + inverse[i][1] * p[7] + inverse[i][2] * p[8]);
+    }
+    // (x - centre)' shape (x - centre) = k
+    float k = 1;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            k += centre[i] * shape[i][j] * centre[j];
+        }
+    }
+    // k is negative when the origin lies outside the ellipsoid, shape / k is positive definite either way
+    if (fabsf(k) < 1e-6f) {
+        return false;
+    }
+    float eigen[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            eigen[i][j] = shape[i][j] / k;
+        }
+    }
+    float v[3][3];
+    jacobiEigen(eigen, v);
+    float root[3];
+    for (int i = 0; i < 3; i++) {
+        if (eigen[i][i] <= 0) {
+            // not an ellipsoid, the samples do not cover enough directions
+            return false;
+        }
+        root[i] = sqrtf(eigen[i][i]);
+    }
+    // keep the field strength, scaled to the geometric mean of the radii
+    const float radius = 1 / cbrtf(root[0] * root[1] * root[2]);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            float sum = 0;
+            for (int e = 0; e < 3; e++) {
+                sum += v[i][e] * root[e] * v[j][e];
+            }
+            result->correction[i][j] = sum * radius;
+        }
+        result->bias[i] = centre[i] * cal->scale;
+    }
+    result->radiusRatio = MAX(MAX(root[0], root[1]), root[2]) / MIN(MIN(root[0], root[1]), root[2]);
+    // the algebraic residual is about twice the relative radial error times k
+    result->fitError = sqrtf(MAX(residual, 0.0f) / cal->sampleCount) / (2 * fabsf(k));
+    return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MAG_CALIBRATION_FIT_PARAMS      9   // general ellipsoid through the origin of the quadric
+#define MAG_CALIBRATION_COVERAGE_BINS   24  // cube faces split into quadrants
+#define MAG_CALIBRATION_MIN_SAMPLES     50
+
+// Streaming least squares ellipsoid fit. Only the sums of the normal
+// equations are kept, so memory and the cost per sample are fixed however
+// long the calibration runs.
+typedef struct magCalibration_s {
+    float scale;            // samples are divided by it to keep the sums well conditioned
+    float normal[MAG_CALIBRATION_FIT_PARAMS][MAG_CALIBRATION_FIT_PARAMS]; // upper triangle only
+    float rhs[MAG_CALIBRATION_FIT_PARAMS];
+    uint32_t sampleCount;
+    float min[3];
+    float max[3];
+    uint32_t coverage;      // bit per direction bin seen from the min/max centre
+} magCalibration_t;
+
+typedef struct magCalibrationResult_s {
+    float bias[3];          // hard iron offset
+    float correction[3][3]; // soft iron correction, applied after removing the bias
+    float fitError;         // rms deviation from the fitted ellipsoid, relative to the field strength
+    float radiusRatio;      // longest over shortest ellipsoid axis
+} magCalibrationResult_t;
+
+void magCalibrationStart(magCalibration_t *cal);
+void magCalibrationAddSample(magCalibration_t *cal, const float *sample);
+uint8_t magCalibrationCoverage(const magCalibration_t *cal);
+void magCalibrationGetMinMaxBias(const magCalibration_t *cal, float *bias);
+bool magCalibrationSolve(const magCalibration_t *cal, magCalibrationResult_t *result);
@@ -18,6 +18,7 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "math.h"
 #include "stdbool.h"
 #include "stdint.h"
 #include "string.h"
@@ -32,6 +33,7 @@
 #include "common/filter.h"
 
 #include "drivers/adc.h"
+#include "drivers/adc_oversample.h"
 
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
@@ -39,6 +41,7 @@
 #include "sensors/adcinternal.h"
 #include "sensors/battery.h"
 #include "sensors/esc_sensor.h"
+#include "sensors/voltage.h"
 
 #include "current.h"
 
@@ -81,6 +84,7 @@ void currentMeterReset(currentMeter_t *meter) {
     meter->amperage = 0;
     meter->amperageLatest = 0;
     meter->mAhDrawn = 0;
+    meter->mWhDrawn = 0;
 }
 
 //
@@ -131,13 +135,48 @@ static void updateCurrentmAhDrawnState(currentMeterMAhDrawnState_t *state, int32
 
 currentMeterADCState_t currentMeterADCState;
 
+#if defined(USE_ADC) && defined(USE_ADC_OVERSAMPLE)
+static adcOversampleTotals_t adciBatTotals;
+static int32_t adciBatPendingUs;
+
+// battery power in W from the mean of battery * current and the mean battery counts.
+// Both sensors are linear, so E[V * I] = kv * (ki * E[v * i] + bi * E[v]).
+static float currentMeterADCPower(const adcOversampleTotals_t *totals) {
+    const currentSensorADCConfig_t *config = currentSensorADCConfig();
+    const float ampsPerCount = getVrefMv() * 10.0f / (4096.0f * config->scale);
+    const float ampsOffset = config->offset / 1000.0f;
+    const float voltsPerCount = voltageMeterADCVoltsPerCount(VOLTAGE_SENSOR_ADC_VBAT);
+    return voltsPerCount * (ampsPerCount * adcOversamplePowerMean(totals, &adciBatTotals) + ampsOffset * adcOversampleMean(totals, &adciBatTotals, ADC_BATTERY));
+}
+#endif
+
 void currentMeterADCInit(void) {
     memset(&currentMeterADCState, 0, sizeof(currentMeterADCState_t));
     biquadFilterInitLPF(&adciBatFilter, GET_BATTERY_LPF_FREQUENCY(batteryConfig()->ibatLpfPeriod), HZ_TO_INTERVAL_US(50));
+#if defined(USE_ADC) && defined(USE_ADC_OVERSAMPLE)
+    adcGetOversampleTotals(&adciBatTotals);
+#endif
 }
 
 void currentMeterADCRefresh(int32_t lastUpdateAt) {
-#ifdef USE_ADC
+#if defined(USE_ADC) && defined(USE_ADC_OVERSAMPLE)
+    adcOversampleTotals_t totals;
+    adcGetOversampleTotals(&totals);
+    adciBatPendingUs += lastUpdateAt;
+    if (totals.frames == adciBatTotals.frames) {
+        // no DMA block completed since the last refresh, integrate the time with the next one
+        return;
+    }
+    // every conversion since the last refresh, the PWM ripple averages out instead of aliasing
+    const float iBatMean = adcOversampleMean(&totals, &adciBatTotals, ADC_CURRENT);
+    currentMeterADCState.amperageLatest = currentMeterADCToCentiamps(lrintf(iBatMean));
+    currentMeterADCState.amperage = currentMeterADCToCentiamps(lrintf(biquadFilterApply(&adciBatFilter, iBatMean)));
+    updateCurrentmAhDrawnState(&currentMeterADCState.mahDrawnState, currentMeterADCState.amperageLatest, adciBatPendingUs);
+    currentMeterADCState.mWhDrawnF += currentMeterADCPower(&totals) * adciBatPendingUs / (1000.0f * 3600);
+    currentMeterADCState.mWhDrawn = currentMeterADCState.mWhDrawnF;
+    adciBatTotals = totals;
+    adciBatPendingUs = 0;
+#elif defined(USE_ADC)
     const uint16_t iBatSample = adcGetChannel(ADC_CURRENT);
     currentMeterADCState.amperageLatest = currentMeterADCToCentiamps(iBatSample);
     currentMeterADCState.amperage = currentMeterADCToCentiamps(biquadFilterApply(&adciBatFilter, iBatSample));
@@ -154,6 +193,7 @@ void currentMeterADCRead(currentMeter_t *meter) {
     meter->amperageLatest = currentMeterADCState.amperageLatest;
     meter->amperage = currentMeterADCState.amperage;
     meter->mAhDrawn = currentMeterADCState.mahDrawnState.mAhDrawn;
+    meter->mWhDrawn = currentMeterADCState.mWhDrawn;
     DEBUG_SET(DEBUG_CURRENT, 2, meter->amperageLatest);
     DEBUG_SET(DEBUG_CURRENT, 3, meter->mAhDrawn);
 }
@@ -38,6 +38,7 @@ typedef struct currentMeter_s {
     int32_t amperage;           // current read by current sensor in centiampere (1/100th A)
     int32_t amperageLatest;     // current read by current sensor in centiampere (1/100th A) (unfiltered)
     int32_t mAhDrawn;           // milliampere hours drawn from the battery since start
+    int32_t mWhDrawn;           // milliwatt hours drawn from the battery since start, 0 if the meter cannot measure power
 } currentMeter_t;
 
 // WARNING - do not mix usage of CURRENT_SENSOR_* and CURRENT_METER_*, they are separate concerns.
@@ -67,6 +68,8 @@ typedef struct currentMeterADCState_s {
     currentMeterMAhDrawnState_t mahDrawnState;
     int32_t amperage;           // current read by current sensor in centiampere (1/100th A)
     int32_t amperageLatest;     // current read by current sensor in centiampere (1/100th A) (unfiltered)
+    int32_t mWhDrawn;           // milliwatt hours drawn from the battery since start
+    float mWhDrawnF;
 } currentMeterADCState_t;
 
 typedef struct currentSensorADCConfig_s {
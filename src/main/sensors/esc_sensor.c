@@ -96,12 +96,14 @@ typedef enum {
 typedef enum {
     ESC_SENSOR_TRIGGER_STARTUP = 0,
     ESC_SENSOR_TRIGGER_READY = 1,
-    ESC_SENSOR_TRIGGER_PENDING = 2
+    ESC_SENSOR_TRIGGER_PENDING = 2,
+    ESC_SENSOR_TRIGGER_INFO = 3
 } escSensorTriggerState_t;
 
 #define ESC_SENSOR_BAUDRATE 115200
 #define ESC_BOOTTIME 5000               // 5 seconds
 #define ESC_REQUEST_TIMEOUT 100         // 100 ms (data transfer takes only 900us)
+#define ESC_INFO_TIMEOUT 12             // after the info command went out
 
 #define TELEMETRY_FRAME_SIZE 10
 static uint8_t telemetryBuffer[TELEMETRY_FRAME_SIZE] = { 0, };
@@ -124,6 +126,12 @@ static bool combinedDataNeedsUpdate = true;
 static uint16_t totalTimeoutCount = 0;
 static uint16_t totalCrcErrorCount = 0;
 
+// ESC info request, the reply lands in the caller's buffer instead of the telemetry frame
+static uint8_t *escInfoFrame;
+static uint8_t escInfoFrameLength;
+static uint8_t escInfoMotor;
+static bool escInfoPending = false;
+
 void startEscDataRead(uint8_t *frameBuffer, uint8_t frameLength) {
     buffer = frameBuffer;
     bufferPosition = 0;
@@ -270,6 +278,16 @@ void escSensorProcess(timeUs_t currentTimeUs) {
         break;
     case ESC_SENSOR_TRIGGER_READY:
         escTriggerTimestamp = currentTimeMs;
+        if (escInfoPending) {
+            // no telemetry request is in flight, the line is free for the info reply
+            startEscDataRead(escInfoFrame, escInfoFrameLength);
+            if (dshotCommandWrite(escInfoMotor, getMotorCount(), DSHOT_CMD_ESC_INFO)) {
+                escSensorTriggerState = ESC_SENSOR_TRIGGER_INFO;
+            } else {
+                escInfoPending = false;
+            }
+            break;
+        }
         startEscDataRead(telemetryBuffer, TELEMETRY_FRAME_SIZE);
         motorDmaOutput_t * const motor = getMotorDmaOutput(escSensorMotor);
         motor->requestTelemetry = true;
@@ -301,9 +319,34 @@ void escSensorProcess(timeUs_t currentTimeUs) {
             DEBUG_SET(DEBUG_ESC_SENSOR, DEBUG_ESC_NUM_TIMEOUTS, ++totalTimeoutCount);
         }
         break;
+    case ESC_SENSOR_TRIGGER_INFO:
+        // the command waits its turn in the dshot command queue, the reply timeout starts once it went out
+        if (dshotCommandIsQueuedFor(escInfoMotor)) {
+            escTriggerTimestamp = currentTimeMs;
+        } else if (isFrameComplete() || currentTimeMs >= escTriggerTimestamp + ESC_INFO_TIMEOUT) {
+            escInfoPending = false;
+            escSensorTriggerState = ESC_SENSOR_TRIGGER_READY;
+        }
+        break;
     }
 }
 
+// queues an ESC info request for one motor, the frame is complete once escSensorInfoIsPending() turns false
+bool escSensorRequestInfo(uint8_t motorIndex, uint8_t *frameBuffer, uint8_t frameLength) {
+    if (!escSensorPort || escInfoPending || motorIndex >= getMotorCount()) {
+        return false;
+    }
+    escInfoFrame = frameBuffer;
+    escInfoFrameLength = frameLength;
+    escInfoMotor = motorIndex;
+    escInfoPending = true;
+    return true;
+}
+
+bool escSensorInfoIsPending(void) {
+    return escInfoPending;
+}
+
 int calcEscRpm(int erpm) {
     return (erpm * 100) / (motorConfig()->motorPoleCount / 2);
 }
@@ -52,6 +52,8 @@ escSensorData_t *getEscSensorData(uint8_t motorNumber);
 
 void startEscDataRead(uint8_t *frameBuffer, uint8_t frameLength);
 uint8_t getNumberEscBytesRead(void);
+bool escSensorRequestInfo(uint8_t motorIndex, uint8_t *frameBuffer, uint8_t frameLength);
+bool escSensorInfoIsPending(void);
 
 uint8_t calculateCrc8(const uint8_t *Buf, const uint8_t BufLen);
 
@@ -88,6 +88,7 @@
 #ifdef USE_GYRO_DATA_ANALYSE
 #include "sensors/gyroanalyse.h"
 #endif
+#include "sensors/gyro_spectrum.h"
 #include "sensors/sensors.h"
 #ifdef USE_GYRO_IMUF9001
 
@@ -120,7 +121,7 @@ static FAST_RAM_ZERO_INIT uint8_t overflowAxisMask;
 static FAST_RAM_ZERO_INIT bool yawSpinDetected;
 #endif
 
-static FAST_RAM_ZERO_INIT float accumulatedMeasurements[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT deltaRotation_t accumulatedRotation;
 static FAST_RAM_ZERO_INIT float gyroPrevious[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT int accumulatedMeasurementCount;
 
@@ -148,6 +149,7 @@ typedef union gyroLowpassFilter_u {
 typedef struct gyroSensor_s {
     gyroDev_t gyroDev;
     gyroCalibration_t calibration;
+    sensorTransform_t transform;
 
     // lowpass gyro soft filter
     filterApplyFnPtr lowpassFilterApplyFn;
@@ -200,6 +202,7 @@ STATIC_UNIT_TESTED gyroDev_t * const gyroDevPtr = &gyroSensor1.gyroDev;
 #endif
 
 static void gyroInitSensorFilters(gyroSensor_t *gyroSensor);
+static void gyroUpdateSensorTransform(gyroSensor_t *gyroSensor);
 static void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type);
 
 #define DEBUG_GYRO_CALIBRATION 3
@@ -216,7 +219,7 @@ static void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int typ
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 6);
+PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 7);
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
@@ -251,6 +254,9 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
                   .dyn_notch_q_factor = 400,
                   .dyn_notch_min_hz = 150,
                   .dyn_notch_max_hz = 600,
+                  .spectrum_max_hz = 0,
+                  .spectrum_bins = 32,
+                  .spectrum_throttle_bins = 10,
                   .imuf_mode = GTBCM_GYRO_ACC_FILTER_F,
                   .imuf_rate = IMUF_RATE_16K,
                   .imuf_roll_q = IMUF_DEFAULT_ROLL_Q,
@@ -305,6 +311,9 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
                   .dyn_notch_q_factor = 350,
                   .dyn_notch_min_hz = 150,
                   .dyn_notch_max_hz = 600,
+                  .spectrum_max_hz = 0,
+                  .spectrum_bins = 32,
+                  .spectrum_throttle_bins = 10,
                   .gyro_ABG_alpha = 0,
                   .gyro_ABG_boost = 275,
                   .gyro_ABG_half_life = 50,
@@ -569,6 +578,7 @@ static bool gyroInitSensor(gyroSensor_t *gyroSensor) {
         gyroSensor->gyroDev.gyroAlign = gyroConfig()->gyro_align;
     }
 #endif //!USE_GYRO_IMUF9001
+    gyroUpdateSensorTransform(gyroSensor);
     // As new gyros are supported, be sure to add them below based on whether they are subject to the overflow/inversion bug
     // Any gyro not explicitly defined will default to not having built-in overflow protection as a safe alternative.
     switch (gyroHardware) {
@@ -908,6 +918,12 @@ static bool isOnFirstGyroCalibrationCycle(const gyroCalibration_t *gyroCalibrati
     return gyroCalibration->cyclesRemaining == gyroCalculateCalibratingCycles();
 }
 
+// must be called whenever gyroAlign, scale or gyroZero change
+static void gyroUpdateSensorTransform(gyroSensor_t *gyroSensor) {
+    buildSensorTransform(&gyroSensor->transform, gyroSensor->gyroDev.gyroAlign, gyroSensor->gyroDev.scale);
+    sensorTransformSetSensorBias(&gyroSensor->transform, gyroSensor->gyroDev.gyroZero);
+}
+
 static void gyroSetCalibrationCycles(gyroSensor_t *gyroSensor) {
 #ifdef USE_GYRO_IMUF9001
     imufStartCalibration();
@@ -963,6 +979,7 @@ STATIC_UNIT_TESTED void performGyroCalibration(gyroSensor_t *gyroSensor, uint8_t
         }
     }
     if (isOnFinalGyroCalibrationCycle(&gyroSensor->calibration)) {
+        gyroUpdateSensorTransform(gyroSensor);
         schedulerResetTaskStatistics(TASK_SELF); // so calibration cycles do not pollute tasks statistics
         if (!firstArmingCalibrationWasStarted || (getArmingDisableFlags() & ~ARMING_DISABLED_CALIBRATING) == 0) {
             // calculate gyro noise standard deviation modulus
@@ -1136,11 +1153,6 @@ static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         // NOTE: this branch optimized for when there is no gyro debugging, ensure it is kept in step with non-optimized branch
         DEBUG_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyroSensor->gyroDev.gyroADCf[axis]));
-        if (!gyroSensor->overflowDetected) {
-            // integrate using trapezium rule to avoid bias
-            accumulatedMeasurements[axis] += 0.5f * (gyroPrevious[axis] + gyro.gyroADCf[axis]) * gyro.targetLooptime;
-            gyroPrevious[axis] = gyroSensor->gyroDev.gyroADCf[axis];
-        }
     }
     if (!isGyroSensorCalibrationComplete(gyroSensor)) {
         performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
@@ -1152,17 +1164,16 @@ static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs
     }
 #else
     if (isGyroSensorCalibrationComplete(gyroSensor)) {
-        // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
+        // bias removal, chip rotation, board alignment and scaling to deg/s in a single pass
 #if defined(USE_GYRO_SLEW_LIMITER)
-        gyroSensor->gyroDev.gyroADC[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
+        applySensorTransform(&gyroSensor->transform,
+                             gyroSlewLimiter(gyroSensor, X), gyroSlewLimiter(gyroSensor, Y), gyroSlewLimiter(gyroSensor, Z),
+                             gyroSensor->gyroDev.gyroADC);
 #else
-        gyroSensor->gyroDev.gyroADC[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
+        applySensorTransform(&gyroSensor->transform,
+                             gyroSensor->gyroDev.gyroADCRaw[X], gyroSensor->gyroDev.gyroADCRaw[Y], gyroSensor->gyroDev.gyroADCRaw[Z],
+                             gyroSensor->gyroDev.gyroADC);
 #endif
-        alignSensors(gyroSensor->gyroDev.gyroADC, gyroSensor->gyroDev.gyroAlign);
     } else {
         performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
         // still calibrating, so no need to further process gyro data
@@ -1292,28 +1303,39 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs) {
 #endif
 #endif
     if (!overflowDetected) {
+        // pre-integrate the body rotation at full loop rate so the attitude task keeps the rotation ordering
+        const float deltaAngleScale = DEGREES_TO_RADIANS(0.5f * gyro.targetLooptime * 1e-6f);
+        float deltaAngle[XYZ_AXIS_COUNT];
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             // integrate using trapezium rule to avoid bias
-            accumulatedMeasurements[axis] += 0.5f * (gyroPrevious[axis] + gyro.gyroADCf[axis]) * gyro.targetLooptime;
+            deltaAngle[axis] = (gyroPrevious[axis] + gyro.gyroADCf[axis]) * deltaAngleScale;
             gyroPrevious[axis] = gyro.gyroADCf[axis];
         }
+        deltaRotationAccumulate(&accumulatedRotation, deltaAngle);
         accumulatedMeasurementCount++;
     }
+#ifdef USE_GYRO_SPECTRUM
+    if (gyroSpectrumIsEnabled()) {
+        const float gyroUnfiltered[XYZ_AXIS_COUNT] = { gyroUnfilteredRate(X), gyroUnfilteredRate(Y), gyroUnfilteredRate(Z) };
+        gyroSpectrumPush(gyroUnfiltered, gyro.gyroADCf);
+    }
+#endif
 }
 
-bool gyroGetAverage(quaternion *vAverage) {
+// vRotation is the rotation vector in radians since the last call, vAverage the mean rate in rad/s
+bool gyroGetDeltaRotation(quaternion *vRotation, quaternion *vAverage) {
     if (accumulatedMeasurementCount) {
-        const timeUs_t accumulatedMeasurementTimeUs = accumulatedMeasurementCount * gyro.targetLooptime;
+        const float accumulatedMeasurementTime = accumulatedMeasurementCount * gyro.targetLooptime * 1e-6f;
+        deltaRotationGetVector(&accumulatedRotation, vRotation);
         vAverage->w = 0;
-        vAverage->x = DEGREES_TO_RADIANS(accumulatedMeasurements[X] / accumulatedMeasurementTimeUs);
-        vAverage->y = DEGREES_TO_RADIANS(accumulatedMeasurements[Y] / accumulatedMeasurementTimeUs);
-        vAverage->z = DEGREES_TO_RADIANS(accumulatedMeasurements[Z] / accumulatedMeasurementTimeUs);
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            accumulatedMeasurements[axis] = 0.0f;
-        }
+        vAverage->x = vRotation->x / accumulatedMeasurementTime;
+        vAverage->y = vRotation->y / accumulatedMeasurementTime;
+        vAverage->z = vRotation->z / accumulatedMeasurementTime;
+        deltaRotationReset(&accumulatedRotation);
         accumulatedMeasurementCount = 0;
         return true;
     } else {
+        quaternionInitVector(vRotation);
         quaternionInitVector(vAverage);
         return false;
     }
@@ -1360,6 +1382,16 @@ int16_t gyroRateDps(int axis) {
 #endif
 }
 
+// calibrated and aligned rate of the active sensor ahead of the filters
+float gyroUnfilteredRate(int axis) {
+#ifdef USE_DUAL_GYRO
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2) {
+        return gyroSensor2.gyroDev.gyroADC[axis];
+    }
+#endif
+    return gyroSensor1.gyroDev.gyroADC[axis];
+}
+
 bool gyroOverflowDetected(void) {
 #ifdef USE_GYRO_OVERFLOW_CHECK
     return overflowDetected;
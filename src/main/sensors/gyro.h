@@ -135,6 +135,9 @@ typedef struct gyroConfig_s {
     uint16_t dyn_notch_q_factor;
     uint16_t dyn_notch_min_hz;
     uint16_t dyn_notch_max_hz;
+    uint16_t spectrum_max_hz;          // upper end of the noise spectrum map, 0 = off
+    uint8_t  spectrum_bins;            // frequency bins of the noise spectrum map
+    uint8_t  spectrum_throttle_bins;   // throttle bands of the noise spectrum map
 #if defined(USE_GYRO_IMUF9001)
     uint16_t imuf_mode;
     uint16_t imuf_rate;
@@ -165,7 +168,7 @@ void gyroDmaSpiFinishRead(void);
 void gyroDmaSpiStartRead(void);
 #endif
 void gyroUpdate(timeUs_t currentTimeUs);
-bool gyroGetAverage(quaternion *vAverage);
+bool gyroGetDeltaRotation(quaternion *vRotation, quaternion *vAverage);
 const busDevice_t *gyroSensorBus(void);
 struct mpuConfiguration_s;
 const struct mpuConfiguration_s *gyroMpuConfiguration(void);
@@ -177,8 +180,11 @@ bool isGyroCalibrationComplete(void);
 void gyroReadTemperature(void);
 int16_t gyroGetTemperature(void);
 int16_t gyroRateDps(int axis);
+float gyroUnfilteredRate(int axis);
 bool gyroOverflowDetected(void);
 bool gyroYawSpinDetected(void);
 uint16_t gyroAbsRateDps(int axis);
 uint8_t gyroReadRegister(uint8_t whichSensor, uint8_t reg);
+#ifdef USE_SMITH_PREDICTOR
 float applySmithPredictor(smithPredictor_t *smithPredictor, float gyroFiltered);
+#endif // USE_SMITH_PREDICTOR
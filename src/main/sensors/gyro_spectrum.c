@@ -0,0 +1,218 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Throttle binned gyro noise spectrum, before and after the gyro filters.
+ *
+ *   The dynamic notch analysis only looks at 16 bins and forgets them once
+ * the peak is picked. Here the gyro is decimated to twice the configured
+ * maximum frequency and collected into 128 sample windows. A full window is
+ * transformed in the idle task, one axis of one source per run, and its
+ * power is averaged into the row of the throttle it was recorded at. The
+ * map is kept until reboot and read over MSP one throttle row at a time, so
+ * filters can be tuned from a hover and a few punches without a log.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#include "common/axis.h"
+#include "common/maths.h"
+#include "common/utils.h"
+
+#ifdef USE_GYRO_SPECTRUM
+#include "arm_math.h"
+
+#include "fc/fc_core.h"
+#include "fc/runtime_config.h"
+
+#include "sensors/gyro.h"
+#endif
+
+#include "sensors/gyro_spectrum.h"
+
+void gyroSpectrumMapInit(gyroSpectrumMap_t *map, uint8_t freqBins, uint8_t throttleBins) {
+    memset(map, 0, sizeof(*map));
+    // bins are merged in powers of two
+    map->freqBins = GYRO_SPECTRUM_MAX_FREQ_BINS;
+    while (map->freqBins > MAX(freqBins, GYRO_SPECTRUM_MIN_FREQ_BINS)) {
+        map->freqBins /= 2;
+    }
+    map->throttleBins = constrain(throttleBins, 1, GYRO_SPECTRUM_MAX_THROTTLE_BINS);
+}
+
+static uint8_t gyroSpectrumMapRow(const gyroSpectrumMap_t *map, uint8_t throttlePercent) {
+    return MIN(throttlePercent * map->throttleBins / 100, map->throttleBins - 1);
+}
+
+// fftPower holds GYRO_SPECTRUM_MAX_FREQ_BINS bins of one window, call gyroSpectrumMapCommit() once all sources are in
+void gyroSpectrumMapAccumulate(gyroSpectrumMap_t *map, uint8_t throttlePercent, gyroSpectrumSource_e source, const float *fftPower) {
+    const uint8_t row = gyroSpectrumMapRow(map, throttlePercent);
+    const int mergedBins = GYRO_SPECTRUM_MAX_FREQ_BINS / map->freqBins;
+    const float weight = 1.0f / MIN(map->windows[row] + 1, GYRO_SPECTRUM_AVERAGE_WINDOWS);
+    float *power = map->power[row][source];
+    for (int bin = 0; bin < map->freqBins; bin++) {
+        float binPower = 0.0f;
+        for (int i = 0; i < mergedBins; i++) {
+            binPower += fftPower[bin * mergedBins + i];
+        }
+        power[bin] += (binPower - power[bin]) * weight;
+    }
+}
+
+void gyroSpectrumMapCommit(gyroSpectrumMap_t *map, uint8_t throttlePercent) {
+    const uint8_t row = gyroSpectrumMapRow(map, throttlePercent);
+    if (map->windows[row] < UINT16_MAX) {
+        map->windows[row]++;
+    }
+}
+
+// Noise level in 0.5dB steps, 0 is 0.01deg/s rms or less
+uint8_t gyroSpectrumMapLevel(const gyroSpectrumMap_t *map, uint8_t throttleBin, gyroSpectrumSource_e source, uint8_t freqBin) {
+    const float power = map->power[throttleBin][source][freqBin];
+    if (power <= 1e-4f) {
+        return 0;
+    }
+    return constrain(lrintf(20.0f * log10f(power) + 80.0f), 0, UINT8_MAX);
+}
+
+#ifdef USE_GYRO_SPECTRUM
+#define GYRO_SPECTRUM_CHANNELS (GYRO_SPECTRUM_SOURCE_COUNT * XYZ_AXIS_COUNT)
+
+typedef struct gyroSpectrumState_s {
+    // decimation
+    uint8_t sampleCount;
+    uint8_t maxSampleCount;
+    float maxSampleCountRcp;
+    float accumulator[GYRO_SPECTRUM_SOURCE_COUNT][XYZ_AXIS_COUNT];
+
+    // a full window is held until every channel is transformed
+    uint8_t windowIdx;
+    bool windowFull;
+    uint8_t throttlePercent;
+    uint8_t channel;
+    float window[GYRO_SPECTRUM_SOURCE_COUNT][XYZ_AXIS_COUNT][GYRO_SPECTRUM_FFT_SIZE];
+
+    arm_rfft_fast_instance_f32 fftInstance;
+    float fftData[GYRO_SPECTRUM_FFT_SIZE];
+    float rfftData[GYRO_SPECTRUM_FFT_SIZE];
+    float power[GYRO_SPECTRUM_SOURCE_COUNT][GYRO_SPECTRUM_MAX_FREQ_BINS];
+} gyroSpectrumState_t;
+
+static bool spectrumEnabled;
+static uint16_t spectrumSampleRateHz;
+static gyroSpectrumState_t spectrumState;
+static gyroSpectrumMap_t spectrumMap;
+static float spectrumHanningWindow[GYRO_SPECTRUM_FFT_SIZE];
+
+void gyroSpectrumInit(uint32_t targetLooptimeUs) {
+    const uint16_t maxHz = gyroConfig()->spectrum_max_hz;
+    spectrumEnabled = maxHz > 0 && targetLooptimeUs > 0;
+    if (!spectrumEnabled) {
+        return;
+    }
+    memset(&spectrumState, 0, sizeof(spectrumState));
+    const int gyroLoopRateHz = lrintf((1.0f / targetLooptimeUs) * 1e6f);
+    spectrumState.maxSampleCount = constrain(gyroLoopRateHz / (2 * maxHz), 1, UINT8_MAX);
+    spectrumState.maxSampleCountRcp = 1.0f / spectrumState.maxSampleCount;
+    spectrumSampleRateHz = gyroLoopRateHz / spectrumState.maxSampleCount;
+    arm_rfft_fast_init_f32(&spectrumState.fftInstance, GYRO_SPECTRUM_FFT_SIZE);
+    for (int i = 0; i < GYRO_SPECTRUM_FFT_SIZE; i++) {
+        spectrumHanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (GYRO_SPECTRUM_FFT_SIZE - 1)));
+    }
+    gyroSpectrumMapInit(&spectrumMap, gyroConfig()->spectrum_bins, gyroConfig()->spectrum_throttle_bins);
+}
+
+// Called every gyro loop
+FAST_CODE void gyroSpectrumPush(const float *unfiltered, const float *filtered) {
+    if (!spectrumEnabled || spectrumState.windowFull) {
+        return;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        spectrumState.accumulator[GYRO_SPECTRUM_PRE_FILTER][axis] += unfiltered[axis];
+        spectrumState.accumulator[GYRO_SPECTRUM_POST_FILTER][axis] += filtered[axis];
+    }
+    if (++spectrumState.sampleCount < spectrumState.maxSampleCount) {
+        return;
+    }
+    spectrumState.sampleCount = 0;
+    for (int source = 0; source < GYRO_SPECTRUM_SOURCE_COUNT; source++) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            spectrumState.window[source][axis][spectrumState.windowIdx] = spectrumState.accumulator[source][axis] * spectrumState.maxSampleCountRcp;
+            spectrumState.accumulator[source][axis] = 0;
+        }
+    }
+    if (++spectrumState.windowIdx == GYRO_SPECTRUM_FFT_SIZE) {
+        spectrumState.windowFull = true;
+        spectrumState.throttlePercent = calculateThrottlePercentAbs();
+        spectrumState.channel = 0;
+    }
+}
+
+// Idle task, transforms one channel of a full window per run
+void gyroSpectrumUpdate(timeUs_t currentTimeUs) {
+    UNUSED(currentTimeUs);
+    if (!spectrumState.windowFull) {
+        return;
+    }
+    const int source = spectrumState.channel / XYZ_AXIS_COUNT;
+    const int axis = spectrumState.channel % XYZ_AXIS_COUNT;
+    arm_mult_f32(spectrumState.window[source][axis], spectrumHanningWindow, spectrumState.fftData, GYRO_SPECTRUM_FFT_SIZE);
+    arm_rfft_fast_f32(&spectrumState.fftInstance, spectrumState.fftData, spectrumState.rfftData, 0);
+    // first complex pair packs the DC and Nyquist terms, neither is of use here
+    spectrumState.rfftData[0] = 0.0f;
+    spectrumState.rfftData[1] = 0.0f;
+    arm_cmplx_mag_f32(spectrumState.rfftData, spectrumState.fftData, GYRO_SPECTRUM_MAX_FREQ_BINS);
+    // single sided amplitude in deg/s, corrected for the coherent gain of the Hanning window
+    const float amplitudeScale = 4.0f / GYRO_SPECTRUM_FFT_SIZE;
+    for (int i = 0; i < GYRO_SPECTRUM_MAX_FREQ_BINS; i++) {
+        spectrumState.power[source][i] += sq(spectrumState.fftData[i] * amplitudeScale);
+    }
+    if (++spectrumState.channel < GYRO_SPECTRUM_CHANNELS) {
+        return;
+    }
+    // noise on the ground is of no interest for tuning
+    if (ARMING_FLAG(ARMED)) {
+        for (int i = 0; i < GYRO_SPECTRUM_SOURCE_COUNT; i++) {
+            gyroSpectrumMapAccumulate(&spectrumMap, spectrumState.throttlePercent, i, spectrumState.power[i]);
+        }
+        gyroSpectrumMapCommit(&spectrumMap, spectrumState.throttlePercent);
+    }
+    memset(spectrumState.power, 0, sizeof(spectrumState.power));
+    spectrumState.windowIdx = 0;
+    spectrumState.windowFull = false;
+}
+
+bool gyroSpectrumIsEnabled(void) {
+    return spectrumEnabled;
+}
+
+uint16_t gyroSpectrumSampleRateHz(void) {
+    return spectrumSampleRateHz;
+}
+
+const gyroSpectrumMap_t *gyroSpectrumGetMap(void) {
+    return &spectrumMap;
+}
+#endif // USE_GYRO_SPECTRUM
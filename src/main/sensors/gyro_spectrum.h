@@ -0,0 +1,58 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define GYRO_SPECTRUM_FFT_SIZE          128
+#define GYRO_SPECTRUM_MAX_FREQ_BINS     (GYRO_SPECTRUM_FFT_SIZE / 2)
+#define GYRO_SPECTRUM_MIN_FREQ_BINS     8
+#define GYRO_SPECTRUM_MAX_THROTTLE_BINS 10
+#define GYRO_SPECTRUM_AVERAGE_WINDOWS   256 // running mean turns into a moving average after this many windows
+
+typedef enum {
+    GYRO_SPECTRUM_PRE_FILTER = 0,
+    GYRO_SPECTRUM_POST_FILTER,
+    GYRO_SPECTRUM_SOURCE_COUNT
+} gyroSpectrumSource_e;
+
+// Mean noise power per throttle band and frequency bin, all axes summed
+typedef struct gyroSpectrumMap_s {
+    uint8_t freqBins;
+    uint8_t throttleBins;
+    uint16_t windows[GYRO_SPECTRUM_MAX_THROTTLE_BINS];
+    float power[GYRO_SPECTRUM_MAX_THROTTLE_BINS][GYRO_SPECTRUM_SOURCE_COUNT][GYRO_SPECTRUM_MAX_FREQ_BINS];
+} gyroSpectrumMap_t;
+
+void gyroSpectrumMapInit(gyroSpectrumMap_t *map, uint8_t freqBins, uint8_t throttleBins);
+void gyroSpectrumMapAccumulate(gyroSpectrumMap_t *map, uint8_t throttlePercent, gyroSpectrumSource_e source, const float *fftPower);
+void gyroSpectrumMapCommit(gyroSpectrumMap_t *map, uint8_t throttlePercent);
+uint8_t gyroSpectrumMapLevel(const gyroSpectrumMap_t *map, uint8_t throttleBin, gyroSpectrumSource_e source, uint8_t freqBin);
+
+void gyroSpectrumInit(uint32_t targetLooptimeUs);
+void gyroSpectrumPush(const float *unfiltered, const float *filtered);
+void gyroSpectrumUpdate(timeUs_t currentTimeUs);
+bool gyroSpectrumIsEnabled(void);
+uint16_t gyroSpectrumSampleRateHz(void);
+const gyroSpectrumMap_t *gyroSpectrumGetMap(void);
@@ -148,6 +148,12 @@ STATIC_UNIT_TESTED uint16_t voltageAdcToVoltage(const uint16_t src, const voltag
     return ((((uint32_t)src * config->vbatscale * getVrefMv() / 100 + (0xFFF * 5)) / (0xFFF * config->vbatresdivval)) / config->vbatresdivmultiplier);
 }
 
+// volts per ADC count, the same divider as voltageAdcToVoltage() without the rounding to 0.1V
+float voltageMeterADCVoltsPerCount(voltageSensorADC_e adcChannel) {
+    const voltageSensorADCConfig_t *config = voltageSensorADCConfig(adcChannel);
+    return (float)config->vbatscale * getVrefMv() / (100.0f * 10 * 0xFFF * config->vbatresdivval * config->vbatresdivmultiplier);
+}
+
 void voltageMeterADCRefresh(void) {
     for (uint8_t i = 0; i < MAX_VOLTAGE_SENSOR_ADC; i++) {
         voltageMeterADCState_t *state = &voltageMeterADCStates[i];
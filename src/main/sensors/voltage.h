@@ -97,6 +97,7 @@ void voltageMeterReset(voltageMeter_t *voltageMeter);
 void voltageMeterADCInit(void);
 void voltageMeterADCRefresh(void);
 void voltageMeterADCRead(voltageSensorADC_e adcChannel, voltageMeter_t *voltageMeter);
+float voltageMeterADCVoltsPerCount(voltageSensorADC_e adcChannel);
 
 void voltageMeterESCInit(void);
 void voltageMeterESCRefresh(void);
@@ -40,4 +40,6 @@ const timerHardware_t timerHardware[USABLE_TIMER_CHANNEL_COUNT] = {
     DEF_TIM(TIM9, CH1, PA2,  TIM_USE_PWM,   0, 0 ), // TX2
     DEF_TIM(TIM1, CH2, PA9,  TIM_USE_PWM,   0, 0 ), // TX1
     DEF_TIM(TIM1, CH3, PA10, TIM_USE_PWM,   0, 0 ), // RX1
+
+    DEF_TIM(TIM3, CH3, PB0,  TIM_USE_NONE,  0, 0 ), // RX SPI slot timer, compare interrupt only, PB0 stays with the ADC
 };
@@ -129,6 +129,7 @@
 #define DEFAULT_RX_FEATURE      FEATURE_RX_SPI
 #define RX_SPI_DEFAULT_PROTOCOL RX_SPI_FRSKY_X
 #define USE_RX_FRSKY_SPI_TELEMETRY
+#define RX_SPI_SLOT_TIMER_PIN   PB0
 #else
 #define USE_RX_SPI
 #define RX_SPI_INSTANCE         SPI3
@@ -149,6 +150,7 @@
 #define DEFAULT_RX_FEATURE      FEATURE_RX_SPI
 #define RX_SPI_DEFAULT_PROTOCOL RX_SPI_FRSKY_X
 #define USE_RX_FRSKY_SPI_TELEMETRY
+#define RX_SPI_SLOT_TIMER_PIN   PB0
 #endif
 // *************** UART *****************************
 #define USE_VCP
@@ -185,5 +187,5 @@
 
 //#define  USE_DSHOT_DMA
 
-#define USABLE_TIMER_CHANNEL_COUNT 9
-#define USED_TIMERS             ( TIM_N(1)|TIM_N(2)|TIM_N(4)|TIM_N(5)|TIM_N(9))
+#define USABLE_TIMER_CHANNEL_COUNT 10
+#define USED_TIMERS             ( TIM_N(1)|TIM_N(2)|TIM_N(3)|TIM_N(4)|TIM_N(5)|TIM_N(9))
@@ -129,6 +129,10 @@
 #undef USE_VTX_SMARTAUDIO
 #endif
 
+#if defined(USE_RX_SPI) && defined(RX_SPI_SLOT_TIMER_PIN)
+#define USE_RX_SPI_SLOT_TIMER
+#endif
+
 #if defined(USE_RX_FRSKY_SPI_D) || defined(USE_RX_FRSKY_SPI_X)
 #define USE_RX_CC2500
 #define USE_RX_CC2500_BIND
@@ -172,7 +176,17 @@
 #define USE_FLASH_M25P16
 #endif
 
-#if defined(USE_FLASH_M25P16)
+#if defined(USE_FLASH_W25M02G)
+#define USE_FLASH_W25M
+#define USE_FLASH_W25N01G
+#endif
+
+// Boards with SPI NOR flash may come with a pin compatible SPI NAND part instead
+#if defined(USE_FLASH_M25P16) && (FLASH_SIZE > 256) && !defined(USE_FLASH_W25N01G)
+#define USE_FLASH_W25N01G
+#endif
+
+#if defined(USE_FLASH_M25P16) || defined(USE_FLASH_W25N01G)
 #define USE_FLASH
 #endif
 
@@ -51,6 +51,7 @@
 #define USE_SRAM2
 #if defined(STM32F40_41xxx)
 #define USE_FAST_RAM
+#define TARGET_LARGE_RAM
 #endif
 #define USE_DSHOT
 #define I2C3_OVERCLOCK true
@@ -59,6 +60,9 @@
 #define USE_ADC_INTERNAL
 #define USE_USB_CDC_HID
 #define USE_USB_MSC
+#define USE_ADC_OVERSAMPLE
+#define USE_DSHOT_TELEMETRY
+#define USE_DSHOT_BITBANG
 
 #if defined(STM32F40_41xxx) || defined(STM32F411xE)
 #define USE_OVERCLOCK
@@ -78,6 +82,15 @@
 #define USE_ADC_INTERNAL
 #define USE_USB_CDC_HID
 #define USE_USB_MSC
+#define TARGET_LARGE_RAM
+#define USE_ADC_OVERSAMPLE
+#endif
+
+// large static buffers only on MCUs with RAM to spare, F411 and F446 have 128KB
+#ifdef TARGET_LARGE_RAM
+#define USE_SERIAL_4WAY_IMAGE_BUFFER
+#define USE_BLACKBOX_BURST
+#define USE_GYRO_SPECTRUM
 #endif
 
 #if defined(STM32F4) || defined(STM32F7)
@@ -267,9 +267,9 @@ uint32_t CDC_Send_DATA(const uint8_t *ptrBuffer, uint32_t sendLength) {
     if (packetSent) {
         return 0;
     }
-    // We can only put 64 bytes in the buffer
-    if (sendLength > 64 / 2) {
-        sendLength = 64 / 2;
+    // Keep every packet short so it ends its transfer without a zero length packet
+    if (sendLength > VIRTUAL_COM_PORT_DATA_SIZE - 1) {
+        sendLength = VIRTUAL_COM_PORT_DATA_SIZE - 1;
     }
     // Try to load some bytes if we can
     if (sendLength) {
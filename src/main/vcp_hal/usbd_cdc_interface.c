@@ -46,6 +46,8 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
 #include "drivers/serial_usb_vcp.h"
 #include "drivers/time.h"
 
@@ -224,6 +226,7 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
     }
     uint32_t buffsize;
     static uint32_t lastBuffsize = 0;
+    static bool zlpPending = false;
     USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)USBD_Device.pCDC_ClassData;
     if (hcdc->TxState == 0) {
         // endpoint has finished transmitting previous block
@@ -233,6 +236,8 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
             if (UserTxBufPtrOut == APP_TX_DATA_SIZE) {
                 UserTxBufPtrOut = 0;
             }
+            // a block ending on a full packet leaves the host waiting for the end of the transfer
+            zlpPending = (lastBuffsize % CDC_DATA_FS_MAX_PACKET_SIZE) == 0;
             lastBuffsize = 0;
         }
         if (UserTxBufPtrOut != UserTxBufPtrIn) {
@@ -247,6 +252,13 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
             USBD_CDC_SetTxBuffer(&USBD_Device, (uint8_t*)&UserTxBuffer[UserTxBufPtrOut], buffsize);
             if (USBD_CDC_TransmitPacket(&USBD_Device) == USBD_OK) {
                 lastBuffsize = buffsize;
+                zlpPending = false;
+            }
+        } else if (zlpPending) {
+            // nothing follows, end the transfer with a zero length packet
+            USBD_CDC_SetTxBuffer(&USBD_Device, (uint8_t*)&UserTxBuffer[UserTxBufPtrOut], 0);
+            if (USBD_CDC_TransmitPacket(&USBD_Device) == USBD_OK) {
+                zlpPending = false;
             }
         }
     }
@@ -349,15 +361,21 @@ uint32_t CDC_Send_FreeBytes(void) {
  * @retval Bytes sent
  */
 uint32_t CDC_Send_DATA(const uint8_t *ptrBuffer, uint32_t sendLength) {
-    for (uint32_t i = 0; i < sendLength; i++) {
-        while (CDC_Send_FreeBytes() == 0) {
+    uint32_t sent = 0;
+    while (sent < sendLength) {
+        uint32_t freeBytes;
+        while ((freeBytes = CDC_Send_FreeBytes()) == 0) {
             // block until there is free space in the ring buffer
             delay(1);
         }
-        ATOMIC_BLOCK(NVIC_BUILD_PRIORITY(6, 0)) { // Paranoia
-            UserTxBuffer[UserTxBufPtrIn] = ptrBuffer[i];
-            UserTxBufPtrIn = (UserTxBufPtrIn + 1) % APP_TX_DATA_SIZE;
+        // copy in runs up to the end of the ring, only this side moves the head
+        const uint32_t ptrIn = UserTxBufPtrIn;
+        const uint32_t len = MIN(MIN(sendLength - sent, freeBytes), APP_TX_DATA_SIZE - ptrIn);
+        memcpy((uint8_t *)&UserTxBuffer[ptrIn], &ptrBuffer[sent], len);
+        ATOMIC_BLOCK(NVIC_BUILD_PRIORITY(6, 0)) {
+            UserTxBufPtrIn = (ptrIn + len) % APP_TX_DATA_SIZE;
         }
+        sent += len;
     }
     return sendLength;
 }
@@ -24,11 +24,15 @@
 #endif /* USB_OTG_HS_INTERNAL_DMA_ENABLED */
 
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
 #include "usbd_cdc_vcp.h"
 #include "stm32f4xx_conf.h"
 #include "stdbool.h"
 #include "drivers/time.h"
 
+#include "common/maths.h"
+
 LINE_CODING g_lc;
 
 extern __IO uint8_t USB_Tx_State;
@@ -188,12 +192,18 @@ static uint16_t VCP_DataTx(const uint8_t* Buf, uint32_t Len) {
         and wait for any existing transmission to complete.
     */
     while (USB_Tx_State != 0);
-    for (uint32_t i = 0; i < Len; i++) {
-        APP_Rx_Buffer[APP_Rx_ptr_in] = Buf[i];
-        APP_Rx_ptr_in = (APP_Rx_ptr_in + 1) % APP_RX_DATA_SIZE;
-        while (CDC_Send_FreeBytes() == 0) {
+    while (Len > 0) {
+        uint32_t freeBytes;
+        while ((freeBytes = CDC_Send_FreeBytes()) == 0) {
             delay(1);
         }
+        // copy in runs up to the end of the ring
+        const uint32_t ptrIn = APP_Rx_ptr_in;
+        const uint32_t len = MIN(MIN(Len, freeBytes), APP_RX_DATA_SIZE - ptrIn);
+        memcpy(&APP_Rx_Buffer[ptrIn], Buf, len);
+        APP_Rx_ptr_in = (ptrIn + len) % APP_RX_DATA_SIZE;
+        Buf += len;
+        Len -= len;
     }
     return USBD_OK;
 }
@@ -0,0 +1,157 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "drivers/adc_oversample.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// battery and current converted, external and RSSI not
+static const uint8_t dmaIndex[ADC_CHANNEL_COUNT] = { 0, 1, ADC_OVERSAMPLE_UNUSED, ADC_OVERSAMPLE_UNUSED };
+
+#define FRAME_RATE_HZ   10417.0     // two channels at 480 cycles each with the F4 prescaler
+#define PWM_HZ          24000.0     // a multiple of the 50Hz current meter task, so single samples alias to DC
+#define PWM_DUTY        0.3
+#define CURRENT_LOW     400
+#define CURRENT_HIGH    1600
+#define TASK_HZ         50
+
+static adcOversample_t oversample;
+static uint16_t buffer[ADC_OVERSAMPLE_FRAMES * 2];
+static uint32_t frameNumber;
+
+// current chopped by the ESC PWM
+static uint16_t currentAt(double timeS)
+{
+    return fmod(timeS * PWM_HZ, 1.0) < PWM_DUTY ? CURRENT_HIGH : CURRENT_LOW;
+}
+
+// battery voltage sagging with the current
+static void fillBlock(void)
+{
+    for (int frame = 0; frame < ADC_OVERSAMPLE_FRAMES; frame++, frameNumber++) {
+        const uint16_t current = currentAt(frameNumber / FRAME_RATE_HZ);
+        buffer[frame * 2 + 0] = 3000 - current / 2;
+        buffer[frame * 2 + 1] = current;
+    }
+}
+
+static void feedUntil(double timeS)
+{
+    while ((frameNumber + ADC_OVERSAMPLE_FRAMES) / FRAME_RATE_HZ <= timeS) {
+        fillBlock();
+        adcOversampleBlock(&oversample, buffer, ADC_OVERSAMPLE_FRAMES);
+    }
+}
+
+TEST(AdcOversampleTest, BlockMeanAndTotals)
+{
+    adcOversampleInit(&oversample, dmaIndex, 2);
+    for (int frame = 0; frame < ADC_OVERSAMPLE_FRAMES; frame++) {
+        buffer[frame * 2 + 0] = 2000;
+        buffer[frame * 2 + 1] = frame & 1 ? 101 : 100;
+    }
+    adcOversampleBlock(&oversample, buffer, ADC_OVERSAMPLE_FRAMES);
+    EXPECT_EQ(2000, oversample.blockMean[ADC_BATTERY]);
+    EXPECT_EQ(101, oversample.blockMean[ADC_CURRENT]); // 100.5 rounds up
+    EXPECT_EQ(0, oversample.blockMean[ADC_RSSI]);
+    EXPECT_EQ((uint32_t)ADC_OVERSAMPLE_FRAMES, oversample.totals.frames);
+    EXPECT_EQ(2000u * ADC_OVERSAMPLE_FRAMES, oversample.totals.sum[ADC_BATTERY]);
+    EXPECT_EQ(0u, oversample.totals.sum[ADC_EXTERNAL1]);
+    EXPECT_EQ(2000ull * (100 + 101) * ADC_OVERSAMPLE_FRAMES / 2, oversample.totals.powerSum);
+}
+
+TEST(AdcOversampleTest, NoPowerWithoutBothChannels)
+{
+    const uint8_t currentOnly[ADC_CHANNEL_COUNT] = { ADC_OVERSAMPLE_UNUSED, 0, ADC_OVERSAMPLE_UNUSED, ADC_OVERSAMPLE_UNUSED };
+    adcOversampleInit(&oversample, currentOnly, 1);
+    for (int frame = 0; frame < ADC_OVERSAMPLE_FRAMES; frame++) {
+        buffer[frame] = 500;
+    }
+    adcOversampleBlock(&oversample, buffer, ADC_OVERSAMPLE_FRAMES);
+    EXPECT_EQ(500, oversample.blockMean[ADC_CURRENT]);
+    EXPECT_EQ(0u, oversample.totals.sum[ADC_BATTERY]);
+    EXPECT_EQ(0ull, oversample.totals.powerSum);
+}
+
+TEST(AdcOversampleTest, MeanAcrossWrap)
+{
+    adcOversampleInit(&oversample, dmaIndex, 2);
+    oversample.totals.frames = UINT32_MAX - 10;
+    oversample.totals.sum[ADC_CURRENT] = UINT32_MAX - 1000;
+    const adcOversampleTotals_t before = oversample.totals;
+    for (int frame = 0; frame < ADC_OVERSAMPLE_FRAMES; frame++) {
+        buffer[frame * 2 + 0] = 0;
+        buffer[frame * 2 + 1] = 4000;
+    }
+    adcOversampleBlock(&oversample, buffer, ADC_OVERSAMPLE_FRAMES);
+    EXPECT_FLOAT_EQ(4000.0f, adcOversampleMean(&oversample.totals, &before, ADC_CURRENT));
+    EXPECT_FLOAT_EQ(0.0f, adcOversampleMean(&before, &before, ADC_CURRENT));
+}
+
+TEST(AdcOversampleTest, PwmRippleChargeIntegral)
+{
+    adcOversampleInit(&oversample, dmaIndex, 2);
+    frameNumber = 0;
+    const double expectedMean = CURRENT_LOW + (CURRENT_HIGH - CURRENT_LOW) * PWM_DUTY;
+
+    adcOversampleTotals_t before = oversample.totals;
+    double oversampledCharge = 0;
+    double singleSampleCharge = 0;
+    double worstTickError = 0;
+    const int ticks = 2 * TASK_HZ;
+    for (int tick = 1; tick <= ticks; tick++) {
+        feedUntil((double)tick / TASK_HZ);
+        const adcOversampleTotals_t now = oversample.totals;
+        const float mean = adcOversampleMean(&now, &before, ADC_CURRENT);
+        worstTickError = fmax(worstTickError, fabs(mean - expectedMean) / expectedMean);
+        oversampledCharge += mean / TASK_HZ;
+        // what a single conversion per task gives
+        singleSampleCharge += currentAt((double)tick / TASK_HZ) / (double)TASK_HZ;
+        before = now;
+    }
+    const double expectedCharge = expectedMean * ticks / TASK_HZ;
+
+    // every conversion counts, so the ripple averages out in each task interval
+    EXPECT_LT(worstTickError, 0.02);
+    EXPECT_NEAR(expectedCharge, oversampledCharge, expectedCharge * 0.005);
+    // the PWM is locked to the task rate, one sample per task keeps hitting the same phase
+    EXPECT_GT(fabs(singleSampleCharge - expectedCharge), expectedCharge * 0.2);
+}
+
+TEST(AdcOversampleTest, PwmRipplePowerIntegral)
+{
+    adcOversampleInit(&oversample, dmaIndex, 2);
+    frameNumber = 0;
+    const adcOversampleTotals_t before = oversample.totals;
+    feedUntil(1.0);
+
+    // the battery sags while the current is high, so E[v * i] is below E[v] * E[i]
+    const double expected = (1 - PWM_DUTY) * (3000 - CURRENT_LOW / 2) * CURRENT_LOW
+                          + PWM_DUTY * (3000 - CURRENT_HIGH / 2) * CURRENT_HIGH;
+    const double uncorrelated = adcOversampleMean(&oversample.totals, &before, ADC_BATTERY)
+                              * adcOversampleMean(&oversample.totals, &before, ADC_CURRENT);
+    const float power = adcOversamplePowerMean(&oversample.totals, &before);
+    EXPECT_NEAR(expected, power, expected * 0.01);
+    EXPECT_GT(uncorrelated - power, expected * 0.05);
+}
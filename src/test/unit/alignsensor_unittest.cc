@@ -265,3 +265,73 @@ TEST(AlignSensorTest, ClockwiseTwoSeventyDegreesFlip)
 {
     testCWFlip(CW270_DEG_FLIP, 270);
 }
+
+/*
+ * The fused sensor transform must give the same result as subtracting the
+ * bias, calling alignSensors() and scaling, for every rotation.
+ */
+static void testTransform(sensor_align_e rotation)
+{
+    const float scale = 0.061035f; // 2000dps gyro
+    const float bias[XYZ_AXIS_COUNT] = { 12.5f, -7.0f, 3.25f };
+    const int32_t raw[XYZ_AXIS_COUNT] = { 1234, -2345, 345 };
+
+    sensorTransform_t transform;
+    buildSensorTransform(&transform, rotation, scale);
+    sensorTransformSetSensorBias(&transform, bias);
+
+    float expected[XYZ_AXIS_COUNT];
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        expected[axis] = raw[axis] - bias[axis];
+    }
+    alignSensors(expected, rotation);
+
+    float result[XYZ_AXIS_COUNT];
+    applySensorTransform(&transform, raw[X], raw[Y], raw[Z], result);
+    // the integer and matrix paths must agree
+    sensorTransform_t matrixOnly = transform;
+    matrixOnly.integerRotation = false;
+    float matrixResult[XYZ_AXIS_COUNT];
+    applySensorTransform(&matrixOnly, raw[X], raw[Y], raw[Z], matrixResult);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_NEAR(matrixResult[axis], result[axis], 1e-3f) << "rotation " << rotation << " axis " << axis;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_NEAR(expected[axis] * scale, result[axis], 1e-3f) << "rotation " << rotation << " axis " << axis;
+    }
+}
+
+TEST(AlignSensorTest, TransformMatchesAlignSensors)
+{
+    for (int rotation = CW0_DEG; rotation <= CW270_DEG_FLIP; rotation++) {
+        testTransform((sensor_align_e)rotation);
+    }
+}
+
+TEST(AlignSensorTest, TransformAlignedBias)
+{
+    const float bias[XYZ_AXIS_COUNT] = { 10.0f, 20.0f, -30.0f };
+    sensorTransform_t transform;
+    buildSensorTransform(&transform, CW90_DEG, 1.0f);
+    sensorTransformSetAlignedBias(&transform, bias);
+
+    float result[XYZ_AXIS_COUNT];
+    EXPECT_TRUE(transform.integerRotation);
+    applySensorTransform(&transform, 100, 200, 300, result);
+    // CW90: x' = y, y' = -x, then the trims are removed in the aligned frame
+    EXPECT_FLOAT_EQ(200 - 10.0f, result[X]);
+    EXPECT_FLOAT_EQ(-100 - 20.0f, result[Y]);
+    EXPECT_FLOAT_EQ(300 + 30.0f, result[Z]);
+}
+
+// must be the last test, board alignment cannot be reset once set
+TEST(AlignSensorTest, TransformWithBoardAlignment)
+{
+    const boardAlignment_t alignment = { 0, 0, 30 };
+    initBoardAlignment(&alignment);
+    sensorTransform_t transform;
+    buildSensorTransform(&transform, CW0_DEG, 1.0f);
+    EXPECT_FALSE(transform.integerRotation);
+    testTransform(CW0_DEG);
+    testTransform(CW270_DEG_FLIP);
+}
@@ -146,6 +146,8 @@ extern "C" {
 void delay(uint32_t) {}
 bool busReadRegisterBuffer(const busDevice_t*, uint8_t, uint8_t*, uint8_t) {return true;}
 bool busWriteRegister(const busDevice_t*, uint8_t, uint8_t) {return true;}
+bool busReadRegisterBufferStart(const busDevice_t*, i2cJob_t*, uint8_t, uint8_t*, uint8_t) {return true;}
+bool busWriteRegisterStart(const busDevice_t*, i2cJob_t*, uint8_t, uint8_t) {return true;}
 
 void spiSetDivisor() {
 }
@@ -0,0 +1,125 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "blackbox/blackbox_burst.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static blackboxBurst_t burst;
+
+// sample values carry the iteration they were recorded at
+static void recordIterations(uint32_t first, int count)
+{
+    blackboxBurstSample_t sample;
+    memset(&sample, 0, sizeof(sample));
+    for (int i = 0; i < count; i++) {
+        sample.gyroUnfilt[0] = (int16_t)(first + i);
+        sample.axisD[2] = -(int16_t)(first + i);
+        blackboxBurstRecord(&burst, first + i, &sample);
+    }
+}
+
+TEST(BlackboxBurstTest, NothingToWriteWithoutTrigger)
+{
+    uint32_t iteration;
+    blackboxBurstInit(&burst);
+    recordIterations(0, 3 * BLACKBOX_BURST_SAMPLES);
+    EXPECT_EQ(BLACKBOX_BURST_RECORDING, burst.state);
+    EXPECT_EQ(BLACKBOX_BURST_SAMPLES, burst.count);
+    EXPECT_EQ(NULL, blackboxBurstNextSample(&burst, &iteration));
+}
+
+TEST(BlackboxBurstTest, FreezesAroundTrigger)
+{
+    uint32_t iteration;
+    blackboxBurstInit(&burst);
+    recordIterations(0, 1000);
+    EXPECT_TRUE(blackboxBurstTrigger(&burst, BLACKBOX_BURST_TRIGGER_SWITCH));
+    EXPECT_EQ(BLACKBOX_BURST_TRIGGERED, burst.state);
+
+    recordIterations(1000, BLACKBOX_BURST_POST_TRIGGER_SAMPLES - 1);
+    EXPECT_EQ(NULL, blackboxBurstNextSample(&burst, &iteration));
+    recordIterations(1000 + BLACKBOX_BURST_POST_TRIGGER_SAMPLES - 1, 1);
+    EXPECT_EQ(BLACKBOX_BURST_FROZEN, burst.state);
+
+    // recording is held while the ring is written out
+    recordIterations(5000, 10);
+
+    // trigger sits in the middle of the ring, samples come out oldest first and contiguous
+    const uint32_t last = 1000 + BLACKBOX_BURST_POST_TRIGGER_SAMPLES - 1;
+    const uint32_t first = last - BLACKBOX_BURST_SAMPLES + 1;
+    for (uint32_t expected = first; expected <= last; expected++) {
+        const blackboxBurstSample_t *sample = blackboxBurstNextSample(&burst, &iteration);
+        ASSERT_TRUE(sample != NULL);
+        EXPECT_EQ(expected, iteration);
+        EXPECT_EQ((int16_t)expected, sample->gyroUnfilt[0]);
+        EXPECT_EQ(-(int16_t)expected, sample->axisD[2]);
+    }
+    EXPECT_EQ(NULL, blackboxBurstNextSample(&burst, &iteration));
+    EXPECT_EQ(BLACKBOX_BURST_RECORDING, burst.state);
+    EXPECT_EQ(1, burst.bursts);
+}
+
+TEST(BlackboxBurstTest, ShortRingAfterEarlyTrigger)
+{
+    uint32_t iteration;
+    blackboxBurstInit(&burst);
+    recordIterations(0, 10);
+    blackboxBurstTrigger(&burst, BLACKBOX_BURST_TRIGGER_GYRO_OVERFLOW);
+    recordIterations(10, BLACKBOX_BURST_POST_TRIGGER_SAMPLES);
+    EXPECT_EQ(BLACKBOX_BURST_FROZEN, burst.state);
+
+    int written = 0;
+    const blackboxBurstSample_t *sample;
+    while ((sample = blackboxBurstNextSample(&burst, &iteration))) {
+        EXPECT_EQ((uint32_t)written, iteration);
+        written++;
+    }
+    EXPECT_EQ(10 + BLACKBOX_BURST_POST_TRIGGER_SAMPLES, written);
+}
+
+TEST(BlackboxBurstTest, TriggersCombineUntilFrozen)
+{
+    uint32_t iteration;
+    blackboxBurstInit(&burst);
+    recordIterations(0, BLACKBOX_BURST_SAMPLES);
+    EXPECT_FALSE(blackboxBurstTrigger(&burst, 0));
+    EXPECT_TRUE(blackboxBurstTrigger(&burst, BLACKBOX_BURST_TRIGGER_NOISE));
+    recordIterations(BLACKBOX_BURST_SAMPLES, 5);
+    EXPECT_FALSE(blackboxBurstTrigger(&burst, BLACKBOX_BURST_TRIGGER_CRASH_RECOVERY));
+    EXPECT_EQ(BLACKBOX_BURST_TRIGGER_NOISE | BLACKBOX_BURST_TRIGGER_CRASH_RECOVERY, burst.triggers);
+    recordIterations(BLACKBOX_BURST_SAMPLES + 5, BLACKBOX_BURST_POST_TRIGGER_SAMPLES);
+
+    // a trigger while the ring is written out is dropped
+    EXPECT_FALSE(blackboxBurstTrigger(&burst, BLACKBOX_BURST_TRIGGER_SWITCH));
+    EXPECT_EQ(BLACKBOX_BURST_TRIGGER_NOISE | BLACKBOX_BURST_TRIGGER_CRASH_RECOVERY, burst.triggers);
+
+    while (blackboxBurstNextSample(&burst, &iteration)) {
+    }
+    EXPECT_EQ(0, burst.triggers);
+    EXPECT_EQ(0, burst.count);
+
+    // recording starts over and a new burst can be taken
+    recordIterations(10000, 20);
+    EXPECT_TRUE(blackboxBurstTrigger(&burst, BLACKBOX_BURST_TRIGGER_SWITCH));
+}
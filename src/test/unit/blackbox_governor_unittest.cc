@@ -0,0 +1,115 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "blackbox/blackbox_governor.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BUFFER_SIZE 256
+#define IDLE_LOAD 50
+
+static blackboxGovernor_t governor;
+
+// one I-frame interval with every frame sampled at the given buffer fill
+static uint16_t runWindow(int fillPercent, uint8_t load)
+{
+    for (int frame = 0; frame < 4; frame++) {
+        blackboxGovernorSampleFrame(&governor, BUFFER_SIZE - BUFFER_SIZE * fillPercent / 100);
+    }
+    return blackboxGovernorUpdate(&governor, load);
+}
+
+static void initGovernor(void)
+{
+    blackboxGovernorInit(&governor, 1, 32);
+    blackboxGovernorSampleFrame(&governor, BUFFER_SIZE); // empty buffer seen once
+}
+
+TEST(BlackboxGovernorTest, KeepsConfiguredRateWhenCalm)
+{
+    initGovernor();
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(1, runWindow(10, IDLE_LOAD));
+    }
+    EXPECT_EQ(0, governor.overruns);
+}
+
+TEST(BlackboxGovernorTest, BacksOffOnOverrun)
+{
+    initGovernor();
+    EXPECT_EQ(2, runWindow(95, IDLE_LOAD));
+    EXPECT_EQ(4, runWindow(95, IDLE_LOAD));
+    EXPECT_EQ(8u, governor.overruns);
+    // busy but not overrunning holds the rate
+    EXPECT_EQ(4, runWindow(70, IDLE_LOAD));
+}
+
+TEST(BlackboxGovernorTest, BacksOffOnPidLoad)
+{
+    initGovernor();
+    EXPECT_EQ(2, runWindow(10, BLACKBOX_GOVERNOR_HIGH_LOAD_PERCENT));
+    EXPECT_EQ(0, governor.overruns);
+}
+
+TEST(BlackboxGovernorTest, NeverSlowerThanIFramesOnly)
+{
+    initGovernor();
+    for (int i = 0; i < 20; i++) {
+        runWindow(100, 100);
+    }
+    EXPECT_EQ(32, governor.pInterval);
+}
+
+TEST(BlackboxGovernorTest, RecoversAfterCalmWindows)
+{
+    initGovernor();
+    runWindow(95, IDLE_LOAD);
+    runWindow(95, IDLE_LOAD);
+    EXPECT_EQ(4, governor.pInterval);
+    for (int i = 0; i < BLACKBOX_GOVERNOR_CALM_WINDOWS - 1; i++) {
+        EXPECT_EQ(4, runWindow(10, IDLE_LOAD));
+    }
+    EXPECT_EQ(2, runWindow(10, IDLE_LOAD));
+    // a busy window restarts the count
+    for (int i = 0; i < BLACKBOX_GOVERNOR_CALM_WINDOWS - 1; i++) {
+        runWindow(10, IDLE_LOAD);
+    }
+    EXPECT_EQ(2, runWindow(70, IDLE_LOAD));
+    EXPECT_EQ(2, runWindow(10, IDLE_LOAD));
+    for (int i = 0; i < BLACKBOX_GOVERNOR_CALM_WINDOWS; i++) {
+        runWindow(10, IDLE_LOAD);
+    }
+    EXPECT_EQ(1, governor.pInterval);
+}
+
+TEST(BlackboxGovernorTest, BufferSizeLearntFromFreeSpace)
+{
+    blackboxGovernorInit(&governor, 2, 64);
+    // a buffer never seen empty is not taken as full
+    blackboxGovernorSampleFrame(&governor, 100);
+    EXPECT_EQ(0, governor.overruns);
+    blackboxGovernorSampleFrame(&governor, 400);
+    blackboxGovernorSampleFrame(&governor, 20);
+    EXPECT_EQ(1u, governor.overruns);
+    EXPECT_EQ(4, blackboxGovernorUpdate(&governor, IDLE_LOAD));
+}
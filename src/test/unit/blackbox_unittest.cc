@@ -43,6 +43,8 @@ extern "C" {
 
     #include "rx/rx.h"
 
+    #include "scheduler/scheduler.h"
+
     #include "sensors/battery.h"
     #include "sensors/gyro.h"
 
@@ -405,5 +407,6 @@ failsafePhase_e failsafePhase(void) {return FAILSAFE_IDLE;}
 bool rxAreFlightChannelsValid(void) {return false;}
 bool rxIsReceivingSignal(void) {return false;}
 bool isRssiConfigured(void) {return false;}
+void getTaskInfo(cfTaskId_e, cfTaskInfo_t *taskInfo) {memset(taskInfo, 0, sizeof(*taskInfo));}
 
 }
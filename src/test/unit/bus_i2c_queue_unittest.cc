@@ -0,0 +1,156 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "drivers/bus_i2c_queue.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static i2cQueue_t queue;
+static i2cJob_t jobs[I2C_QUEUE_SIZE + 1];
+static uint8_t buffer[6];
+static int callbacks;
+static i2cJob_t *lastCompleted;
+
+static void jobCallback(i2cJob_t *job)
+{
+    callbacks++;
+    lastCompleted = job;
+}
+
+static void resetJobs(void)
+{
+    i2cQueueInit(&queue);
+    memset(jobs, 0, sizeof(jobs));
+    callbacks = 0;
+    lastCompleted = NULL;
+}
+
+TEST(I2cQueueUnittest, JobsCompleteInOrder)
+{
+    resetJobs();
+    i2cJobSetRead(&jobs[0], 0x77, 0x00, buffer, 3);
+    i2cJobSetWriteByte(&jobs[1], 0x1e, 0x02, 0x00);
+    EXPECT_TRUE(i2cQueuePush(&queue, &jobs[0]));
+    EXPECT_TRUE(i2cQueuePush(&queue, &jobs[1]));
+    EXPECT_EQ(I2C_JOB_QUEUED, jobs[0].status);
+    EXPECT_TRUE(i2cJobIsBusy(&jobs[1]));
+
+    EXPECT_EQ(&jobs[0], i2cQueueStart(&queue, 100));
+    EXPECT_EQ(I2C_JOB_ACTIVE, jobs[0].status);
+    EXPECT_EQ(100u, jobs[0].startedAtUs);
+    EXPECT_EQ(I2C_JOB_QUEUED, jobs[1].status);
+
+    EXPECT_EQ(&jobs[1], i2cQueueComplete(&queue, I2C_JOB_DONE));
+    EXPECT_EQ(I2C_JOB_DONE, jobs[0].status);
+    EXPECT_FALSE(i2cJobIsBusy(&jobs[0]));
+    i2cQueueStart(&queue, 200);
+    EXPECT_EQ(NULL, i2cQueueComplete(&queue, I2C_JOB_DONE));
+    EXPECT_EQ(NULL, i2cQueueHead(&queue));
+    EXPECT_EQ(2u, queue.stats.jobs);
+    EXPECT_EQ(2, queue.stats.maxDepth);
+    EXPECT_EQ(0, queue.stats.depth);
+}
+
+TEST(I2cQueueUnittest, SegmentsDescribeTheTransfer)
+{
+    resetJobs();
+    i2cJobSetRead(&jobs[0], 0x77, I2C_REG_NONE, buffer, 6);
+    EXPECT_EQ(0x77, jobs[0].addr);
+    EXPECT_EQ(I2C_REG_NONE, jobs[0].reg);
+    EXPECT_EQ(buffer, jobs[0].data.buffer);
+    EXPECT_EQ(6, jobs[0].data.len);
+    EXPECT_TRUE(jobs[0].data.read);
+
+    // the single byte payload lives in the job, so the caller needs no buffer
+    i2cJobSetWriteByte(&jobs[1], 0x76, 0xf4, 0x57);
+    EXPECT_EQ(&jobs[1].scratch, jobs[1].data.buffer);
+    EXPECT_EQ(0x57, jobs[1].data.buffer[0]);
+    EXPECT_EQ(1, jobs[1].data.len);
+    EXPECT_FALSE(jobs[1].data.read);
+}
+
+TEST(I2cQueueUnittest, FullQueueAndBusyJobsAreRejected)
+{
+    resetJobs();
+    for (int i = 0; i < I2C_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(i2cQueuePush(&queue, &jobs[i]));
+    }
+    EXPECT_FALSE(i2cQueuePush(&queue, &jobs[I2C_QUEUE_SIZE]));
+    EXPECT_EQ(I2C_JOB_IDLE, jobs[I2C_QUEUE_SIZE].status);
+
+    i2cQueueStart(&queue, 0);
+    i2cQueueComplete(&queue, I2C_JOB_DONE);
+    // still queued, submitting it twice would corrupt the ring
+    EXPECT_FALSE(i2cQueuePush(&queue, &jobs[1]));
+    EXPECT_TRUE(i2cQueuePush(&queue, &jobs[0]));
+    EXPECT_EQ(2u, queue.stats.rejected);
+    EXPECT_EQ(I2C_QUEUE_SIZE, queue.stats.maxDepth);
+
+    // the ring wraps
+    for (int i = 1; i < I2C_QUEUE_SIZE; i++) {
+        i2cQueueStart(&queue, 0);
+        EXPECT_EQ(&jobs[i], i2cQueueHead(&queue));
+        i2cQueueComplete(&queue, I2C_JOB_DONE);
+    }
+    EXPECT_EQ(&jobs[0], i2cQueueHead(&queue));
+}
+
+TEST(I2cQueueUnittest, FailuresAreCountedAndReported)
+{
+    resetJobs();
+    for (int i = 0; i < 4; i++) {
+        jobs[i].callback = jobCallback;
+        i2cQueuePush(&queue, &jobs[i]);
+    }
+    const i2cJobStatus_e results[4] = { I2C_JOB_NAK, I2C_JOB_ERROR, I2C_JOB_TIMEOUT, I2C_JOB_DONE };
+    for (int i = 0; i < 4; i++) {
+        i2cQueueStart(&queue, 0);
+        i2cQueueComplete(&queue, results[i]);
+        EXPECT_EQ(&jobs[i], lastCompleted);
+        EXPECT_EQ(results[i], jobs[i].status);
+    }
+    EXPECT_EQ(4, callbacks);
+    EXPECT_EQ(4u, queue.stats.jobs);
+    EXPECT_EQ(1u, queue.stats.naks);
+    EXPECT_EQ(1u, queue.stats.errors);
+    EXPECT_EQ(1u, queue.stats.timeouts);
+}
+
+TEST(I2cQueueUnittest, StuckJobTimesOut)
+{
+    resetJobs();
+    EXPECT_FALSE(i2cQueueTimedOut(&queue, 0));
+    i2cQueuePush(&queue, &jobs[0]);
+    // not on the bus yet
+    EXPECT_FALSE(i2cQueueTimedOut(&queue, 1000000));
+
+    i2cQueueStart(&queue, 0xfffffc00);
+    EXPECT_FALSE(i2cQueueTimedOut(&queue, 0xfffffc00 + I2C_JOB_TIMEOUT_US));
+    // across the timer wrap
+    EXPECT_TRUE(i2cQueueTimedOut(&queue, 0xfffffc00 + I2C_JOB_TIMEOUT_US + 1));
+
+    i2cQueueComplete(&queue, I2C_JOB_TIMEOUT);
+    EXPECT_FALSE(i2cQueueTimedOut(&queue, 0xfffffc00 + I2C_JOB_TIMEOUT_US + 1));
+    EXPECT_FALSE(i2cJobIsBusy(&jobs[0]));
+}
@@ -18,11 +18,15 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdarg.h>
 
 #include <limits.h>
 
 #include <math.h>
 
+#include <sstream>
+#include <string>
+
 extern "C" {
     #include "platform.h"
     #include "target.h"
@@ -32,6 +36,7 @@ extern "C" {
     #include "pg/pg_ids.h"
     #include "pg/rx.h"
     #include "drivers/buf_writer.h"
+    #include "drivers/serial_usb_vcp.h"
     #include "drivers/vtx_common.h"
     #include "fc/config.h"
     #include "fc/rc_adjustments.h"
@@ -58,9 +63,34 @@ extern "C" {
     void cliSet(char *cmdline);
     void cliGet(char *cmdline);
     void cliVtx(char *cmdline);
+    void dumpAllValues(uint16_t valueSection, uint8_t dumpMask);
+    bool valuePtrEqualsDefault(const clivalue_t *var, const void *ptr, const void *ptrDefault);
+
+    typedef struct diffTestConfig_s {
+        uint8_t u8;
+        int8_t i8;
+        uint16_t u16;
+        int16_t i16;
+        uint32_t u32;
+        uint8_t flags;
+        uint32_t flags32;
+        int16_t array[3];
+    } diffTestConfig_t;
 
     const clivalue_t valueTable[] = {
-        { "array_unit_test",             VAR_INT8  | MODE_ARRAY | MASTER_VALUE, .config.array.length = 3, PG_RESERVED_FOR_TESTING_1, 0 }
+        { "array_unit_test",             VAR_INT8  | MODE_ARRAY | MASTER_VALUE, { .array = { .length = 3 } }, PG_RESERVED_FOR_TESTING_1, 0 },
+        { "diff_u8",                     VAR_UINT8  | MASTER_VALUE, { .minmax = { 0, 255 } }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, u8) },
+        { "diff_i8",                     VAR_INT8   | MASTER_VALUE, { .minmax = { -100, 100 } }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, i8) },
+        { "diff_u16",                    VAR_UINT16 | MASTER_VALUE, { .minmax = { 0, 30000 } }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, u16) },
+        { "diff_i16",                    VAR_INT16  | MASTER_VALUE, { .minmax = { -30000, 30000 } }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, i16) },
+        { "diff_u32",                    VAR_UINT32 | MASTER_VALUE, { .minmax = { 0, 30000 } }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, u32) },
+        { "diff_flag0",                  VAR_UINT8  | MASTER_VALUE | MODE_BITSET, { .bitpos = 0 }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, flags) },
+        { "diff_flag1",                  VAR_UINT8  | MASTER_VALUE | MODE_BITSET, { .bitpos = 1 }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, flags) },
+        { "diff_flag32_0",               VAR_UINT32 | MASTER_VALUE | MODE_BITSET, { .bitpos = 0 }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, flags32) },
+        { "diff_flag32_1",               VAR_UINT32 | MASTER_VALUE | MODE_BITSET, { .bitpos = 1 }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, flags32) },
+        { "diff_array",                  VAR_INT16  | MASTER_VALUE | MODE_ARRAY, { .array = { .length = 3 } }, PG_RESERVED_FOR_TESTING_2, offsetof(diffTestConfig_t, array) },
+        { "diff_other_group",            VAR_UINT8  | MASTER_VALUE, { .minmax = { 0, 255 } }, PG_RESERVED_FOR_TESTING_3, 0 },
+        { "diff_profile",                VAR_UINT8  | PROFILE_VALUE, { .minmax = { 0, 255 } }, PG_RESERVED_FOR_TESTING_3, 0 },
     };
     const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
     const lookupTableEntry_t lookupTables[] = {};
@@ -89,6 +119,26 @@ extern "C" {
                      );
 
     PG_REGISTER_WITH_RESET_FN(int8_t, unitTestData, PG_RESERVED_FOR_TESTING_1, 0);
+    PG_REGISTER(diffTestConfig_t, diffTestConfig, PG_RESERVED_FOR_TESTING_2, 0);
+    PG_REGISTER(uint8_t, diffTestOther, PG_RESERVED_FOR_TESTING_3, 0);
+}
+
+#define DO_DIFF (1 << 4) // dumpFlags_e in cli.c
+
+static std::string cliOutput;
+
+// the lines of the captured output that belong to the diff test values
+static std::string diffLines(void)
+{
+    std::istringstream lines(cliOutput);
+    std::string line;
+    std::string result;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 9, "set diff_") == 0) {
+            result += line + "\n";
+        }
+    }
+    return result;
 }
 
 #include "unittest_macros.h"
@@ -203,6 +253,131 @@ TEST(CLIUnittest, TestCliVtxInvalidArgumentCount)
     EXPECT_EQ(900, MODE_STEP_TO_CHANNEL_VALUE(cac1->range.startStep));
     EXPECT_EQ(900, MODE_STEP_TO_CHANNEL_VALUE(cac1->range.endStep));
 }
+
+TEST(CLIUnittest, TestDiffOnlyChangedValues)
+{
+    // the copy holds the configuration being dumped, the registry address the defaults
+    const pgRegistry_t *reg = pgFind(PG_RESERVED_FOR_TESTING_2);
+    diffTestConfig_t *defaults = (diffTestConfig_t *)reg->address;
+    diffTestConfig_t *current = (diffTestConfig_t *)reg->copy;
+    memset(defaults, 0, sizeof(*defaults));
+    memset(current, 0, sizeof(*current));
+    *pgFind(PG_RESERVED_FOR_TESTING_3)->address = 7;
+    *pgFind(PG_RESERVED_FOR_TESTING_3)->copy = 7;
+
+    current->i8 = -5;
+    current->u32 = 100000;
+    // a narrow bitset differs whenever any bit of its field does
+    current->flags = 0x02;
+    // a 32 bit bitset only compares its own bit
+    current->flags32 = 0x02;
+    current->array[2] = -1;
+
+    cliOutput.clear();
+    dumpAllValues(MASTER_VALUE, DO_DIFF);
+    EXPECT_EQ(
+        "set diff_i8 = -5\r\n"
+        "set diff_u32 = 100000\r\n"
+        "set diff_flag0 = OFF\r\n"
+        "set diff_flag1 = ON\r\n"
+        "set diff_flag32_1 = ON\r\n"
+        "set diff_array = 0,0,-1\r\n", diffLines());
+
+    // a full dump lists every value of the section in table order
+    cliOutput.clear();
+    dumpAllValues(MASTER_VALUE, 0);
+    EXPECT_EQ(
+        "set diff_u8 = 0\r\n"
+        "set diff_i8 = -5\r\n"
+        "set diff_u16 = 0\r\n"
+        "set diff_i16 = 0\r\n"
+        "set diff_u32 = 100000\r\n"
+        "set diff_flag0 = OFF\r\n"
+        "set diff_flag1 = ON\r\n"
+        "set diff_flag32_0 = OFF\r\n"
+        "set diff_flag32_1 = ON\r\n"
+        "set diff_array = 0,0,-1\r\n"
+        "set diff_other_group = 7\r\n", diffLines());
+}
+
+static clivalue_t comparedValue(uint8_t type, uint8_t mode, uint8_t param)
+{
+    type |= mode | MASTER_VALUE;
+    switch (mode) {
+    case MODE_ARRAY: {
+        const clivalue_t value = { "compared", type, { .array = { param } }, PG_RESERVED_FOR_TESTING_2, 0 };
+        return value;
+    }
+    case MODE_BITSET: {
+        const clivalue_t value = { "compared", type, { .bitpos = param }, PG_RESERVED_FOR_TESTING_2, 0 };
+        return value;
+    }
+    case MODE_LOOKUP: {
+        const clivalue_t value = { "compared", type, { .lookup = { (lookupTableIndex_e)0 } }, PG_RESERVED_FOR_TESTING_2, 0 };
+        return value;
+    }
+    default: {
+        const clivalue_t value = { "compared", type, { .minmax = { 0, 100 } }, PG_RESERVED_FOR_TESTING_2, 0 };
+        return value;
+    }
+    }
+}
+
+TEST(CLIUnittest, TestValueComparison)
+{
+    // the current value is the default with one byte changed by flip
+    const struct {
+        uint8_t type;
+        uint8_t mode;
+        uint8_t param;      // array length or bit position
+        uint8_t byte;
+        uint8_t flip;
+        bool equal;
+    } cases[] = {
+        { VAR_UINT8, MODE_DIRECT, 0, 0, 0x00, true },
+        { VAR_UINT8, MODE_DIRECT, 0, 0, 0x80, false },
+        { VAR_INT8, MODE_DIRECT, 0, 0, 0x80, false },
+        { VAR_UINT16, MODE_DIRECT, 0, 0, 0x01, false },
+        { VAR_UINT16, MODE_DIRECT, 0, 1, 0x80, false },
+        { VAR_INT16, MODE_DIRECT, 0, 1, 0x80, false },
+        { VAR_UINT32, MODE_DIRECT, 0, 0, 0x00, true },
+        { VAR_UINT32, MODE_DIRECT, 0, 3, 0x80, false },
+        { VAR_UINT8, MODE_LOOKUP, 0, 0, 0x01, false },
+        // bytes past the value do not count
+        { VAR_UINT8, MODE_DIRECT, 0, 1, 0xff, true },
+        { VAR_UINT16, MODE_DIRECT, 0, 2, 0xff, true },
+        { VAR_UINT32, MODE_DIRECT, 0, 4, 0xff, true },
+        // every element of an array counts, up to its length
+        { VAR_UINT8, MODE_ARRAY, 1, 0, 0x01, false },
+        { VAR_UINT8, MODE_ARRAY, 3, 2, 0x01, false },
+        { VAR_UINT8, MODE_ARRAY, 3, 3, 0x01, true },
+        { VAR_INT16, MODE_ARRAY, 2, 3, 0x80, false },
+        { VAR_INT16, MODE_ARRAY, 2, 4, 0x80, true },
+        { VAR_UINT32, MODE_ARRAY, 2, 7, 0x01, false },
+        { VAR_UINT32, MODE_ARRAY, 1, 4, 0x01, true },
+        // a 32 bit bitset only compares its own bit
+        { VAR_UINT32, MODE_BITSET, 5, 0, 0x20, false },
+        { VAR_UINT32, MODE_BITSET, 5, 0, 0xdf, true },
+        { VAR_UINT32, MODE_BITSET, 0, 3, 0xff, true },
+        { VAR_UINT32, MODE_BITSET, 30, 3, 0x40, false },
+        { VAR_UINT32, MODE_BITSET, 30, 3, 0xbf, true },
+        // narrower bitsets compare the whole field
+        { VAR_UINT8, MODE_BITSET, 0, 0, 0x01, false },
+        { VAR_UINT8, MODE_BITSET, 0, 0, 0x80, false },
+        { VAR_UINT8, MODE_BITSET, 7, 1, 0xff, true },
+        { VAR_UINT16, MODE_BITSET, 3, 1, 0x01, false },
+        { VAR_UINT16, MODE_BITSET, 15, 2, 0xff, true },
+    };
+    const uint8_t defaults[8] = { 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0 };
+    for (unsigned i = 0; i < ARRAYLEN(cases); i++) {
+        const clivalue_t value = comparedValue(cases[i].type, cases[i].mode, cases[i].param);
+        uint8_t current[8];
+        memcpy(current, defaults, sizeof(current));
+        current[cases[i].byte] ^= cases[i].flip;
+        EXPECT_EQ(cases[i].equal, valuePtrEqualsDefault(&value, current, defaults)) << "case " << i;
+    }
+}
+
 // STUBS
 extern "C" {
 
@@ -246,8 +421,11 @@ void tfp_printf(const char * expectedFormat, ...) {
 }
 
 
-void tfp_format(void *, void (*) (void *, char), const char * expectedFormat, va_list va) {
-    vprintf(expectedFormat, va);
+int tfp_format_write(void *putp, void (*putw) (void *, const char *, int), const char * expectedFormat, va_list va) {
+    char buffer[256];
+    const int written = vsnprintf(buffer, sizeof(buffer), expectedFormat, va);
+    putw(putp, buffer, strlen(buffer));
+    return written;
 }
 
 static const box_t boxes[] = { { 0, "DUMMYBOX", 0 } };
@@ -338,7 +516,8 @@ const char * const shortGitRevision = "MASTER";
 uint32_t serialRxBytesWaiting(const serialPort_t *) {return 0;}
 uint8_t serialRead(serialPort_t *){return 0;}
 
-void bufWriterAppend(bufWriter_t *, uint8_t ch){ printf("%c", ch); }
+void bufWriterAppend(bufWriter_t *, uint8_t ch){ cliOutput += ch; printf("%c", ch); }
+void bufWriterAppendData(bufWriter_t *, const void *data, int count){ cliOutput.append((const char *)data, count); printf("%.*s", count, (const char *)data); }
 void serialWriteBufShim(void *, const uint8_t *, int) {}
 bufWriter_t *bufWriterInit(uint8_t *, int, bufWrite_t, void *) {return NULL;}
 void schedulerSetCalulateTaskStatistics(bool) {}
@@ -351,6 +530,7 @@ void resetConfigs(void) {}
 void systemReset(void) {}
 
 void changePidProfile(uint8_t) {}
+void pidMarkProfileDirty(uint8_t) {}
 bool serialIsPortAvailable(serialPortIdentifier_e) { return false; }
 void generateLedConfig(ledConfig_t *, char *, size_t) {}
 bool isSerialTransmitBufferEmpty(const serialPort_t *) {return true; }
@@ -369,4 +549,8 @@ bool boardInformationIsSet(void) { return true; };
 bool setBoardName(char *newBoardName) { UNUSED(newBoardName); return true; };
 bool setManufacturerId(char *newManufacturerId) { UNUSED(newManufacturerId); return true; };
 bool persistBoardInformation(void) { return true; };
+
+void rcControlsInit(void) {}
+void analyzeAdjustmentRanges(void) {}
+const vcpTxStats_t *usbVcpGetTxStats(void) { return NULL; }
 }
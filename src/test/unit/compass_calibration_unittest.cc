@@ -0,0 +1,192 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+extern "C" {
+    #include "sensors/compass_calibration.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FIELD_STRENGTH 450.0f
+
+static magCalibration_t cal;
+static magCalibrationResult_t result;
+
+static float randomUnit(void)
+{
+    return (float)rand() / RAND_MAX * 2 - 1;
+}
+
+// random direction, uniform over the sphere
+static void randomDirection(float *v)
+{
+    float length;
+    do {
+        v[0] = randomUnit();
+        v[1] = randomUnit();
+        v[2] = randomUnit();
+        length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    } while (length > 1 || length < 0.1f);
+    for (int i = 0; i < 3; i++) {
+        v[i] /= length;
+    }
+}
+
+static void distort(const float softIron[3][3], const float *bias, const float *field, float noise, float *measured)
+{
+    for (int i = 0; i < 3; i++) {
+        measured[i] = softIron[i][0] * field[0] + softIron[i][1] * field[1] + softIron[i][2] * field[2] + bias[i] + noise * randomUnit();
+    }
+}
+
+static void correct(const float *measured, float *corrected)
+{
+    float d[3];
+    for (int i = 0; i < 3; i++) {
+        d[i] = measured[i] - result.bias[i];
+    }
+    for (int i = 0; i < 3; i++) {
+        corrected[i] = result.correction[i][0] * d[0] + result.correction[i][1] * d[1] + result.correction[i][2] * d[2];
+    }
+}
+
+static void calibrate(const float softIron[3][3], const float *bias, float noise, int samples)
+{
+    magCalibrationStart(&cal);
+    for (int s = 0; s < samples; s++) {
+        float field[3], measured[3];
+        randomDirection(field);
+        for (int i = 0; i < 3; i++) {
+            field[i] *= FIELD_STRENGTH;
+        }
+        distort(softIron, bias, field, noise, measured);
+        magCalibrationAddSample(&cal, measured);
+    }
+}
+
+// worst angle between the true field and the corrected one, in degrees
+static float worstAngleError(const float softIron[3][3], const float *bias)
+{
+    float worst = 0;
+    for (int s = 0; s < 500; s++) {
+        float field[3], measured[3], corrected[3];
+        randomDirection(field);
+        for (int i = 0; i < 3; i++) {
+            field[i] *= FIELD_STRENGTH;
+        }
+        distort(softIron, bias, field, 0, measured);
+        correct(measured, corrected);
+        const float dot = field[0] * corrected[0] + field[1] * corrected[1] + field[2] * corrected[2];
+        const float length = sqrtf(corrected[0] * corrected[0] + corrected[1] * corrected[1] + corrected[2] * corrected[2]);
+        const float angle = acosf(fminf(1.0f, dot / (length * FIELD_STRENGTH))) * 180.0f / M_PI;
+        worst = fmaxf(worst, angle);
+    }
+    return worst;
+}
+
+TEST(CompassCalibrationUnittest, TestHardIronOnly)
+{
+    srand(1);
+    const float identity[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    const float bias[3] = { 120, -340, 75 };
+    calibrate(identity, bias, 0, 300);
+
+    ASSERT_TRUE(magCalibrationSolve(&cal, &result));
+    EXPECT_NEAR(bias[0], result.bias[0], 1.0f);
+    EXPECT_NEAR(bias[1], result.bias[1], 1.0f);
+    EXPECT_NEAR(bias[2], result.bias[2], 1.0f);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(identity[i][j], result.correction[i][j], 0.01f);
+        }
+    }
+    EXPECT_LT(result.fitError, 0.001f);
+    EXPECT_NEAR(1.0f, result.radiusRatio, 0.01f);
+    EXPECT_EQ(MAG_CALIBRATION_COVERAGE_BINS, magCalibrationCoverage(&cal));
+}
+
+TEST(CompassCalibrationUnittest, TestSoftIron)
+{
+    srand(2);
+    // symmetric distortion, stretching and shearing the sphere
+    const float softIron[3][3] = {
+        { 1.20f, 0.10f, -0.05f },
+        { 0.10f, 0.85f, 0.08f },
+        { -0.05f, 0.08f, 1.05f },
+    };
+    const float bias[3] = { -250, 180, 400 };
+    calibrate(softIron, bias, 2.0f, 300);
+
+    ASSERT_TRUE(magCalibrationSolve(&cal, &result));
+    EXPECT_NEAR(bias[0], result.bias[0], 5.0f);
+    EXPECT_NEAR(bias[1], result.bias[1], 5.0f);
+    EXPECT_NEAR(bias[2], result.bias[2], 5.0f);
+    EXPECT_LT(worstAngleError(softIron, bias), 1.0f);
+    EXPECT_LT(result.fitError, 0.01f);
+    EXPECT_GT(result.radiusRatio, 1.3f);
+
+    // the min/max centre alone leaves a much larger error
+    magCalibrationGetMinMaxBias(&cal, result.bias);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            result.correction[i][j] = i == j ? 1 : 0;
+        }
+    }
+    EXPECT_GT(worstAngleError(softIron, bias), 5.0f);
+}
+
+TEST(CompassCalibrationUnittest, TestNoisyFitReportsError)
+{
+    srand(3);
+    const float identity[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    const float bias[3] = { 0, 0, 0 };
+    calibrate(identity, bias, 60.0f, 300);
+
+    ASSERT_TRUE(magCalibrationSolve(&cal, &result));
+    EXPECT_GT(result.fitError, 0.03f);
+}
+
+TEST(CompassCalibrationUnittest, TestPoorCoverage)
+{
+    srand(4);
+    const float bias[3] = { 50, 50, 50 };
+    magCalibrationStart(&cal);
+    // only yawing flat, the vertical axis is never explored
+    for (int s = 0; s < 300; s++) {
+        const float yaw = s * 0.05f;
+        const float sample[3] = { FIELD_STRENGTH * cosf(yaw) + bias[0], FIELD_STRENGTH * sinf(yaw) + bias[1], 200 + bias[2] };
+        magCalibrationAddSample(&cal, sample);
+    }
+    EXPECT_LT(magCalibrationCoverage(&cal), MAG_CALIBRATION_COVERAGE_BINS / 2);
+    EXPECT_FALSE(magCalibrationSolve(&cal, &result));
+}
+
+TEST(CompassCalibrationUnittest, TestTooFewSamples)
+{
+    magCalibrationStart(&cal);
+    const float sample[3] = { 100, 200, 300 };
+    for (int s = 0; s < MAG_CALIBRATION_MIN_SAMPLES - 1; s++) {
+        magCalibrationAddSample(&cal, sample);
+    }
+    EXPECT_FALSE(magCalibrationSolve(&cal, &result));
+}
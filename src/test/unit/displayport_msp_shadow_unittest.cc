@@ -0,0 +1,235 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "io/displayport_msp_shadow.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define ROWS 13
+#define COLS 30
+#define MAX_RUNS 40
+
+static mspShadow_t shadow;
+static mspShadowRun_t runs[MAX_RUNS];
+// what a display receiving the runs shows
+static uint8_t display[ROWS][COLS];
+
+static mspShadowLimits_t limits(uint16_t budget, uint8_t overhead)
+{
+    mspShadowLimits_t l;
+    l.budget = budget;
+    l.runOverhead = overhead;
+    l.maxRunLen = 30;
+    l.maxRuns = MAX_RUNS;
+    return l;
+}
+
+static void initDisplay(void)
+{
+    mspShadowInit(&shadow, ROWS, COLS);
+    memset(display, ' ', sizeof(display));
+}
+
+// returns the bytes the runs cost on the wire
+static int sendFrame(const mspShadowLimits_t *l)
+{
+    const uint8_t count = mspShadowCollect(&shadow, l, runs);
+    int bytes = 0;
+    for (int i = 0; i < count; i++) {
+        memcpy(&display[runs[i].row][runs[i].col], runs[i].chars, runs[i].len);
+        mspShadowRunSent(&shadow, &runs[i]);
+        bytes += l->runOverhead + runs[i].len;
+    }
+    return bytes;
+}
+
+static bool displayMatchesCanvas(void)
+{
+    for (int row = 0; row < ROWS; row++) {
+        if (memcmp(display[row], shadow.canvas[row], COLS)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(DisplayPortMspShadowUnittest, OnlyChangesAreSent)
+{
+    initDisplay();
+    const mspShadowLimits_t l = limits(1000, 10);
+    mspShadowWrite(&shadow, 2, 1, "12.6V");
+    mspShadowWrite(&shadow, 20, 11, "00:42");
+    EXPECT_EQ(2 * (10 + 5), sendFrame(&l));
+    EXPECT_TRUE(displayMatchesCanvas());
+
+    // the OSD clears and redraws the same screen with one digit changed
+    mspShadowClear(&shadow);
+    mspShadowWrite(&shadow, 2, 1, "12.5V");
+    mspShadowWrite(&shadow, 20, 11, "00:42");
+    EXPECT_EQ(1u, mspShadowCollect(&shadow, &l, runs));
+    EXPECT_EQ(1, runs[0].row);
+    EXPECT_EQ(5, runs[0].col);
+    EXPECT_EQ(1, runs[0].len);
+    EXPECT_EQ('5', runs[0].chars[0]);
+}
+
+TEST(DisplayPortMspShadowUnittest, DroppedRunsAreCollectedAgain)
+{
+    initDisplay();
+    const mspShadowLimits_t l = limits(1000, 10);
+    mspShadowWrite(&shadow, 2, 1, "12.6V");
+    mspShadowWrite(&shadow, 20, 11, "00:42");
+    // the serial buffer was full, only the first run went out
+    EXPECT_EQ(2u, mspShadowCollect(&shadow, &l, runs));
+    mspShadowRunSent(&shadow, &runs[0]);
+    EXPECT_EQ(1u, mspShadowCollect(&shadow, &l, runs));
+    EXPECT_EQ(11, runs[0].row);
+    EXPECT_EQ(20, runs[0].col);
+    EXPECT_EQ(5, runs[0].len);
+    // nothing was taken, the same run is offered again
+    EXPECT_EQ(1u, mspShadowCollect(&shadow, &l, runs));
+    EXPECT_EQ(11, runs[0].row);
+}
+
+TEST(DisplayPortMspShadowUnittest, ErasedTextIsBlanked)
+{
+    initDisplay();
+    const mspShadowLimits_t l = limits(1000, 10);
+    mspShadowWrite(&shadow, 0, 5, "WARNING");
+    sendFrame(&l);
+    mspShadowClear(&shadow);
+    sendFrame(&l);
+    EXPECT_TRUE(displayMatchesCanvas());
+    EXPECT_EQ(0, memcmp(display[5], "       ", 7));
+}
+
+TEST(DisplayPortMspShadowUnittest, CloseChangesShareARun)
+{
+    initDisplay();
+    mspShadowWrite(&shadow, 0, 0, "A B");
+    mspShadowWrite(&shadow, 20, 0, "C");
+    // the single blank between A and B is cheaper to resend than another run header, the gap to C is not
+    mspShadowLimits_t l = limits(1000, 4);
+    EXPECT_EQ(2u, mspShadowCollect(&shadow, &l, runs));
+    EXPECT_EQ(0, runs[0].col);
+    EXPECT_EQ(3, runs[0].len);
+    EXPECT_EQ(20, runs[1].col);
+    EXPECT_EQ(1, runs[1].len);
+
+    // with a large overhead everything in reach is merged
+    initDisplay();
+    mspShadowWrite(&shadow, 0, 0, "A B");
+    mspShadowWrite(&shadow, 20, 0, "C");
+    l = limits(1000, 30);
+    EXPECT_EQ(1u, mspShadowCollect(&shadow, &l, runs));
+    EXPECT_EQ(21, runs[0].len);
+}
+
+TEST(DisplayPortMspShadowUnittest, BudgetIsHonouredAndNoRowStarves)
+{
+    initDisplay();
+    for (int row = 0; row < ROWS; row++) {
+        mspShadowWrite(&shadow, 0, row, "0123456789");
+    }
+    const mspShadowLimits_t l = limits(50, 10);
+    int frames = 0;
+    while (!displayMatchesCanvas() && frames < 20) {
+        EXPECT_LE(sendFrame(&l), 50);
+        frames++;
+    }
+    // two rows of 20 bytes per frame
+    EXPECT_EQ(7, frames);
+
+    // the top rows change on every frame, the rest still gets through
+    initDisplay();
+    for (int row = 0; row < ROWS; row++) {
+        mspShadowWrite(&shadow, 0, row, "0123456789");
+    }
+    for (frames = 0; frames < 20; frames++) {
+        mspShadowWrite(&shadow, 0, 0, frames & 1 ? "AAAAAAAAAA" : "BBBBBBBBBB");
+        sendFrame(&l);
+    }
+    for (int row = 1; row < ROWS; row++) {
+        EXPECT_EQ(0, memcmp(display[row], "0123456789", 10));
+    }
+}
+
+TEST(DisplayPortMspShadowUnittest, IdleFramesRefreshOneRow)
+{
+    initDisplay();
+    const mspShadowLimits_t l = limits(100, 10);
+    mspShadowWrite(&shadow, 0, 3, "HELLO");
+    sendFrame(&l);
+    // the display lost the text, the unchanged canvas still brings it back
+    memset(display, ' ', sizeof(display));
+    for (int i = 0; i < ROWS; i++) {
+        EXPECT_EQ(10 + COLS, sendFrame(&l));
+    }
+    EXPECT_TRUE(displayMatchesCanvas());
+
+    // no refresh if the row does not fit
+    const mspShadowLimits_t small = limits(30, 10);
+    EXPECT_EQ(0, sendFrame(&small));
+}
+
+TEST(DisplayPortMspShadowUnittest, WritesAreClipped)
+{
+    mspShadowInit(&shadow, ROWS, COLS);
+    mspShadowWrite(&shadow, COLS - 2, 0, "ABCD");
+    mspShadowWrite(&shadow, 0, ROWS, "X");
+    mspShadowWriteChar(&shadow, COLS, 1, 'Y');
+    EXPECT_EQ('A', shadow.canvas[0][COLS - 2]);
+    EXPECT_EQ('B', shadow.canvas[0][COLS - 1]);
+    EXPECT_EQ(' ', shadow.canvas[1][0]);
+    const mspShadowLimits_t l = limits(1000, 10);
+    EXPECT_EQ(1u, mspShadowCollect(&shadow, &l, runs));
+    EXPECT_EQ(2, runs[0].len);
+}
+
+TEST(DisplayPortMspShadowUnittest, LongestWaitingRowGoesFirst)
+{
+    initDisplay();
+    // room for one row of ten characters per frame
+    const mspShadowLimits_t l = limits(20, 10);
+    mspShadowWrite(&shadow, 0, 3, "0123456789");
+    mspShadowWrite(&shadow, 0, 5, "0123456789");
+    mspShadowWrite(&shadow, 0, 8, "0123456789");
+    // equal waits go top first
+    EXPECT_EQ(20, sendFrame(&l));
+    EXPECT_EQ(3, runs[0].row);
+
+    mspShadowWrite(&shadow, 0, 3, "ABCDEFGHIJ");
+    EXPECT_EQ(20, sendFrame(&l));
+    EXPECT_EQ(5, runs[0].row);
+
+    // row 8 has waited three frames, the fresh changes on rows 3 and 9 queue behind it
+    mspShadowWrite(&shadow, 0, 9, "0123456789");
+    EXPECT_EQ(20, sendFrame(&l));
+    EXPECT_EQ(8, runs[0].row);
+    // row 3 changed before row 9 did
+    EXPECT_EQ(20, sendFrame(&l));
+    EXPECT_EQ(3, runs[0].row);
+    EXPECT_EQ(20, sendFrame(&l));
+    EXPECT_EQ(9, runs[0].row);
+}
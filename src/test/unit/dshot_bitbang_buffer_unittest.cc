@@ -0,0 +1,171 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "drivers/dshot_bitbang_buffer.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static dshotBitbangBuffer_t buffer;
+
+// output data register after every slot, as the DMA stream writes the words to BSRR
+static void runBuffer(uint16_t odr, uint16_t *levels)
+{
+    for (int i = 0; i < DSHOT_BITBANG_BUFFER_LEN; i++) {
+        const uint32_t word = buffer.words[i];
+        // set wins over reset when both halves carry a pin
+        odr = (odr & ~(word >> 16)) | (word & 0xffff);
+        levels[i] = odr;
+    }
+}
+
+// number of high slots per bit gives 0 (one slot) or 1 (two slots), -1 on a malformed bit
+static int32_t decodePin(const uint16_t *levels, uint16_t pin, bool inverted)
+{
+    uint16_t packet = 0;
+    for (int bit = 0; bit < DSHOT_BITBANG_BITS; bit++) {
+        int high = 0;
+        for (int slot = 0; slot < DSHOT_BITBANG_PHASES; slot++) {
+            const bool level = (levels[bit * DSHOT_BITBANG_PHASES + slot] & pin) != 0;
+            high += level != inverted;
+        }
+        if (high != 1 && high != 2) {
+            return -1;
+        }
+        packet = (packet << 1) | (high == 2);
+    }
+    return packet;
+}
+
+TEST(DshotBitbangBufferUnittest, ClearedBufferSendsZeroBits)
+{
+    dshotBitbangBufferInit(&buffer, false);
+    dshotBitbangBufferAddPin(&buffer, 1 << 3);
+    dshotBitbangBufferClear(&buffer);
+
+    uint16_t levels[DSHOT_BITBANG_BUFFER_LEN];
+    runBuffer(0, levels);
+    EXPECT_EQ(0, decodePin(levels, 1 << 3, false));
+    // line idles low after the frame
+    EXPECT_EQ(0, levels[DSHOT_BITBANG_BUFFER_LEN - 1]);
+}
+
+TEST(DshotBitbangBufferUnittest, PinsOfAPortCarryTheirOwnPackets)
+{
+    const uint16_t pins[4] = { 1 << 0, 1 << 1, 1 << 8, 1 << 15 };
+    const uint16_t packets[4] = { 0x0000, 0xffff, 0xa5c3, 0x1234 };
+    dshotBitbangBufferInit(&buffer, false);
+    for (int i = 0; i < 4; i++) {
+        dshotBitbangBufferAddPin(&buffer, pins[i]);
+    }
+    dshotBitbangBufferClear(&buffer);
+    for (int i = 0; i < 4; i++) {
+        dshotBitbangBufferSetPacket(&buffer, pins[i], packets[i]);
+    }
+
+    uint16_t levels[DSHOT_BITBANG_BUFFER_LEN];
+    runBuffer(0, levels);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(packets[i], decodePin(levels, pins[i], false));
+    }
+    EXPECT_EQ(0, levels[DSHOT_BITBANG_BUFFER_LEN - 1]);
+}
+
+TEST(DshotBitbangBufferUnittest, NewPacketReplacesThePreviousOne)
+{
+    dshotBitbangBufferInit(&buffer, false);
+    dshotBitbangBufferAddPin(&buffer, 1 << 4);
+    dshotBitbangBufferAddPin(&buffer, 1 << 5);
+    dshotBitbangBufferClear(&buffer);
+    dshotBitbangBufferSetPacket(&buffer, 1 << 4, 0xffff);
+    dshotBitbangBufferSetPacket(&buffer, 1 << 5, 0x8001);
+    dshotBitbangBufferSetPacket(&buffer, 1 << 4, 0x0f0f);
+
+    uint16_t levels[DSHOT_BITBANG_BUFFER_LEN];
+    runBuffer(0, levels);
+    EXPECT_EQ(0x0f0f, decodePin(levels, 1 << 4, false));
+    EXPECT_EQ(0x8001, decodePin(levels, 1 << 5, false));
+}
+
+TEST(DshotBitbangBufferUnittest, PinsOutsideTheMaskAreNotTouched)
+{
+    dshotBitbangBufferInit(&buffer, false);
+    dshotBitbangBufferAddPin(&buffer, 1 << 2);
+    dshotBitbangBufferClear(&buffer);
+    dshotBitbangBufferSetPacket(&buffer, 1 << 2, 0x5555);
+
+    for (int i = 0; i < DSHOT_BITBANG_BUFFER_LEN; i++) {
+        EXPECT_EQ(0u, buffer.words[i] & ~((1u << 2) | (1u << 18)));
+    }
+    // other outputs of the port keep their state through the frame
+    uint16_t levels[DSHOT_BITBANG_BUFFER_LEN];
+    runBuffer(0x8001, levels);
+    for (int i = 0; i < DSHOT_BITBANG_BUFFER_LEN; i++) {
+        EXPECT_EQ(0x8001, levels[i] & 0x8001);
+    }
+    EXPECT_EQ(0x5555, decodePin(levels, 1 << 2, false));
+}
+
+TEST(DshotBitbangBufferUnittest, InvertedPulsesGoLow)
+{
+    dshotBitbangBufferInit(&buffer, true);
+    dshotBitbangBufferAddPin(&buffer, 1 << 6);
+    dshotBitbangBufferAddPin(&buffer, 1 << 7);
+    dshotBitbangBufferClear(&buffer);
+    dshotBitbangBufferSetPacket(&buffer, 1 << 6, 0xbeef);
+    dshotBitbangBufferSetPacket(&buffer, 1 << 7, 0x0001);
+
+    uint16_t levels[DSHOT_BITBANG_BUFFER_LEN];
+    runBuffer(0xffff, levels);
+    EXPECT_EQ(0xbeef, decodePin(levels, 1 << 6, true));
+    EXPECT_EQ(0x0001, decodePin(levels, 1 << 7, true));
+    // idles high
+    EXPECT_EQ(0xffff, levels[DSHOT_BITBANG_BUFFER_LEN - 1]);
+}
+
+TEST(DshotBitbangBufferUnittest, SkippedPinStaysIdle)
+{
+    const bool inverted[2] = { false, true };
+    for (int i = 0; i < 2; i++) {
+        const uint16_t idle = inverted[i] ? 0xffff : 0;
+        dshotBitbangBufferInit(&buffer, inverted[i]);
+        dshotBitbangBufferAddPin(&buffer, 1 << 0);
+        dshotBitbangBufferAddPin(&buffer, 1 << 1);
+        dshotBitbangBufferClear(&buffer);
+        dshotBitbangBufferSetPacket(&buffer, 1 << 0, 0xf00f);
+        dshotBitbangBufferSetPacket(&buffer, 1 << 1, 0x1234);
+        // the next update skips pin 0, its last packet must not go out again
+        dshotBitbangBufferSetIdle(&buffer, 1 << 0);
+
+        uint16_t levels[DSHOT_BITBANG_BUFFER_LEN];
+        runBuffer(idle, levels);
+        for (int slot = 0; slot < DSHOT_BITBANG_BUFFER_LEN; slot++) {
+            EXPECT_EQ(idle & (1 << 0), levels[slot] & (1 << 0));
+        }
+        EXPECT_EQ(0x1234, decodePin(levels, 1 << 1, inverted[i]));
+
+        // a packet after the skip starts its pulses again
+        dshotBitbangBufferSetPacket(&buffer, 1 << 0, 0x0ff0);
+        runBuffer(idle, levels);
+        EXPECT_EQ(0x0ff0, decodePin(levels, 1 << 0, inverted[i]));
+    }
+}
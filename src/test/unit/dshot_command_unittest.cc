@@ -0,0 +1,234 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "drivers/dshot_command.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define MOTOR_COUNT 4
+#define LOOP_US 125
+
+static timeUs_t nowUs;
+static int output[MOTOR_COUNT];
+
+// one motor update: the mixer asks for value on every motor
+static void runUpdate(uint16_t value)
+{
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        output[i] = dshotCommandApply(i, value);
+    }
+    dshotCommandUpdate(nowUs);
+    nowUs += LOOP_US;
+}
+
+// runs updates for durationUs, counting the command frames each motor got
+static void runFor(timeUs_t durationUs, uint16_t value, int commandFrames[MOTOR_COUNT], uint8_t command)
+{
+    const timeUs_t endUs = nowUs + durationUs;
+    while (cmpTimeUs(endUs, nowUs) > 0) {
+        runUpdate(value);
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            if (output[i] == command) {
+                commandFrames[i]++;
+            }
+        }
+    }
+}
+
+static void resetEngine(void)
+{
+    dshotCommandInit();
+    nowUs = 1000;
+    // motors have been at stop
+    runUpdate(DSHOT_CMD_MOTOR_STOP);
+}
+
+TEST(DshotCommandUnittest, TestPassThroughWhenEmpty)
+{
+    resetEngine();
+    EXPECT_FALSE(dshotCommandIsQueued());
+    runUpdate(1000);
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        EXPECT_EQ(1000, output[i]);
+    }
+}
+
+TEST(DshotCommandUnittest, TestRejectsInvalid)
+{
+    resetEngine();
+    EXPECT_FALSE(dshotCommandWrite(0, MOTOR_COUNT, DSHOT_MAX_COMMAND + 1));
+    EXPECT_FALSE(dshotCommandWrite(MOTOR_COUNT, MOTOR_COUNT, DSHOT_CMD_BEACON1));
+    EXPECT_FALSE(dshotCommandIsQueued());
+}
+
+TEST(DshotCommandUnittest, TestSpinDirectionRepeats)
+{
+    resetEngine();
+    EXPECT_TRUE(dshotCommandWrite(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_REVERSED));
+    EXPECT_TRUE(dshotCommandIsQueued());
+
+    int frames[MOTOR_COUNT] = { 0 };
+    runFor(50000, DSHOT_CMD_MOTOR_STOP, frames, DSHOT_CMD_SPIN_DIRECTION_REVERSED);
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        EXPECT_EQ(10, frames[i]);
+    }
+    EXPECT_FALSE(dshotCommandIsQueued());
+}
+
+TEST(DshotCommandUnittest, TestNoFramesBetweenRepeats)
+{
+    resetEngine();
+    dshotCommandWrite(0, MOTOR_COUNT, DSHOT_CMD_SAVE_SETTINGS);
+
+    int frames[MOTOR_COUNT] = { 0 };
+    // wait for the first command frame
+    while (output[0] != DSHOT_CMD_SAVE_SETTINGS) {
+        runUpdate(DSHOT_CMD_MOTOR_STOP);
+    }
+    bool sawStop = false;
+    bool sawSkip = false;
+    while (dshotCommandIsQueuedFor(0) && frames[0] < 9) {
+        runUpdate(DSHOT_CMD_MOTOR_STOP);
+        if (output[0] == DSHOT_CMD_SAVE_SETTINGS) {
+            frames[0]++;
+        } else if (output[0] == DSHOT_COMMAND_SKIP_FRAME) {
+            sawSkip = true;
+        } else {
+            sawStop = true;
+        }
+    }
+    EXPECT_EQ(9, frames[0]);
+    EXPECT_TRUE(sawSkip);
+    EXPECT_FALSE(sawStop);
+}
+
+TEST(DshotCommandUnittest, TestPerMotorSequences)
+{
+    resetEngine();
+    // spin direction on motor 1 while motor 3 beeps
+    EXPECT_TRUE(dshotCommandWrite(1, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_REVERSED));
+    EXPECT_TRUE(dshotCommandWrite(3, MOTOR_COUNT, DSHOT_CMD_BEACON2));
+    EXPECT_FALSE(dshotCommandIsQueuedFor(0));
+    EXPECT_TRUE(dshotCommandIsQueuedFor(1));
+    EXPECT_TRUE(dshotCommandIsQueuedFor(3));
+
+    int spinFrames[MOTOR_COUNT] = { 0 };
+    int beaconFrames[MOTOR_COUNT] = { 0 };
+    const timeUs_t endUs = nowUs + 200000;
+    while (cmpTimeUs(endUs, nowUs) > 0) {
+        runUpdate(DSHOT_CMD_MOTOR_STOP);
+        for (int i = 0; i < MOTOR_COUNT; i++) {
+            spinFrames[i] += output[i] == DSHOT_CMD_SPIN_DIRECTION_REVERSED;
+            beaconFrames[i] += output[i] == DSHOT_CMD_BEACON2;
+        }
+    }
+    EXPECT_EQ(0, spinFrames[0]);
+    EXPECT_EQ(10, spinFrames[1]);
+    EXPECT_EQ(0, spinFrames[3]);
+    EXPECT_EQ(1, beaconFrames[3]);
+    EXPECT_EQ(0, beaconFrames[1]);
+    EXPECT_FALSE(dshotCommandIsQueued());
+}
+
+TEST(DshotCommandUnittest, TestOtherMotorsKeepMixerOutput)
+{
+    resetEngine();
+    dshotCommandWrite(2, MOTOR_COUNT, DSHOT_CMD_BEACON1);
+    // the queued motor was idle, so it is held at stop while the others follow the mixer
+    runUpdate(DSHOT_CMD_MOTOR_STOP);
+    runUpdate(500);
+    EXPECT_EQ(500, output[0]);
+    EXPECT_EQ(500, output[1]);
+    EXPECT_EQ(DSHOT_CMD_MOTOR_STOP, output[2]);
+    EXPECT_EQ(500, output[3]);
+}
+
+TEST(DshotCommandUnittest, TestSequenceOnOneMotor)
+{
+    resetEngine();
+    EXPECT_TRUE(dshotCommandWrite(0, MOTOR_COUNT, DSHOT_CMD_LED0_ON));
+    EXPECT_TRUE(dshotCommandWrite(0, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_1));
+    EXPECT_TRUE(dshotCommandWrite(0, MOTOR_COUNT, DSHOT_CMD_SAVE_SETTINGS));
+
+    uint8_t order[3];
+    int seen = 0;
+    int last = -2;
+    const timeUs_t endUs = nowUs + 100000;
+    while (cmpTimeUs(endUs, nowUs) > 0) {
+        runUpdate(DSHOT_CMD_MOTOR_STOP);
+        if (output[0] > 0 && output[0] != last && seen < 3) {
+            order[seen++] = output[0];
+        }
+        if (output[0] > 0) {
+            last = output[0];
+        }
+    }
+    ASSERT_EQ(3, seen);
+    EXPECT_EQ(DSHOT_CMD_LED0_ON, order[0]);
+    EXPECT_EQ(DSHOT_CMD_SPIN_DIRECTION_1, order[1]);
+    EXPECT_EQ(DSHOT_CMD_SAVE_SETTINGS, order[2]);
+    EXPECT_FALSE(dshotCommandIsQueued());
+}
+
+TEST(DshotCommandUnittest, TestQueueFullAndCoalesce)
+{
+    resetEngine();
+    for (int i = 0; i < DSHOT_COMMAND_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(dshotCommandWrite(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_LED0_ON + (i % 2)));
+    }
+    // a different command does not fit any more
+    EXPECT_FALSE(dshotCommandWrite(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_BEACON1));
+    // the command already waiting at the tail is accepted without taking room
+    EXPECT_TRUE(dshotCommandWrite(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_LED0_ON + ((DSHOT_COMMAND_QUEUE_SIZE - 1) % 2)));
+}
+
+TEST(DshotCommandUnittest, TestWaitsForIdle)
+{
+    resetEngine();
+    // motors spinning when the command is queued
+    runUpdate(1200);
+    dshotCommandWrite(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_BEACON3);
+
+    int frames[MOTOR_COUNT] = { 0 };
+    runFor(50000, 1200, frames, DSHOT_CMD_BEACON3);
+    EXPECT_EQ(0, frames[0]);
+    EXPECT_EQ(1200, output[0]);
+
+    runFor(50000, DSHOT_CMD_MOTOR_STOP, frames, DSHOT_CMD_BEACON3);
+    EXPECT_EQ(1, frames[0]);
+}
+
+TEST(DshotCommandUnittest, TestArmedRightAfterQueueing)
+{
+    resetEngine();
+    // queued while idle, then armed before the next update
+    dshotCommandWrite(ALL_MOTORS, MOTOR_COUNT, DSHOT_CMD_SPIN_DIRECTION_NORMAL);
+
+    int frames[MOTOR_COUNT] = { 0 };
+    runFor(50000, 100, frames, DSHOT_CMD_SPIN_DIRECTION_NORMAL);
+    EXPECT_EQ(10, frames[0]);
+    EXPECT_FALSE(dshotCommandIsQueued());
+    runUpdate(100);
+    EXPECT_EQ(100, output[0]);
+}
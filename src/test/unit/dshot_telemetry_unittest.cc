@@ -0,0 +1,160 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "drivers/dshot_telemetry.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const uint8_t gcrEncode[16] = {
+    0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17,
+    0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f
+};
+
+static uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+
+static uint16_t replyPacket(uint8_t exponent, uint16_t mantissa)
+{
+    const uint16_t value = (exponent << 9) | mantissa;
+    const uint16_t csum = ~(value ^ (value >> 4) ^ (value >> 8)) & 0xf;
+    return (value << 4) | csum;
+}
+
+// capture buffer as the timer sees a reply: an edge at the start of every 1 bit of start bit + GCR code.
+// The line going back to idle after the reply adds an edge at idleBit, none if idleBit is 0
+static uint8_t captureReply(uint16_t packet, uint16_t startTicks, const int8_t *jitter, uint8_t idleBit = 0)
+{
+    uint32_t gcr = 1;
+    for (int nibble = 3; nibble >= 0; nibble--) {
+        gcr = (gcr << 5) | gcrEncode[(packet >> (nibble * 4)) & 0xf];
+    }
+    uint8_t count = 0;
+    for (int bit = 0; bit < 21; bit++) {
+        if (gcr & (1 << (20 - bit))) {
+            const int offset = jitter ? jitter[count % 4] : 0;
+            edges[count++] = (uint16_t)(startTicks + bit * DSHOT_TELEMETRY_BIT_TICKS + offset);
+        }
+    }
+    if (idleBit) {
+        edges[count++] = (uint16_t)(startTicks + idleBit * DSHOT_TELEMETRY_BIT_TICKS);
+    }
+    return count;
+}
+
+static uint16_t expectedErpm(uint8_t exponent, uint16_t mantissa)
+{
+    const uint32_t periodUs = mantissa << exponent;
+    return (600000 + periodUs / 2) / periodUs;
+}
+
+TEST(DshotTelemetryTest, DecodesPeriods)
+{
+    const struct { uint8_t exponent; uint16_t mantissa; } periods[] = {
+        { 0, 1 }, { 0, 37 }, { 1, 250 }, { 2, 511 }, { 4, 300 }, { 6, 100 }, { 7, 3 },
+    };
+    for (unsigned i = 0; i < sizeof(periods) / sizeof(periods[0]); i++) {
+        const uint8_t count = captureReply(replyPacket(periods[i].exponent, periods[i].mantissa), 100, NULL);
+        EXPECT_EQ(expectedErpm(periods[i].exponent, periods[i].mantissa), dshotTelemetryDecode(edges, count, DSHOT_TELEMETRY_BIT_TICKS));
+    }
+}
+
+TEST(DshotTelemetryTest, TrailingIdleEdge)
+{
+    const struct { uint8_t exponent; uint16_t mantissa; } periods[] = {
+        { 0, 1 }, { 0, 37 }, { 1, 250 }, { 2, 511 }, { 4, 300 }, { 6, 100 }, { 7, 3 },
+    };
+    for (unsigned i = 0; i < sizeof(periods) / sizeof(periods[0]); i++) {
+        const uint16_t packet = replyPacket(periods[i].exponent, periods[i].mantissa);
+        // the line returns to idle at the end of the frame or some bits later
+        for (uint8_t idleBit = 21; idleBit <= 26; idleBit++) {
+            const uint8_t count = captureReply(packet, 100, NULL, idleBit);
+            EXPECT_EQ(expectedErpm(periods[i].exponent, periods[i].mantissa), dshotTelemetryDecode(edges, count, DSHOT_TELEMETRY_BIT_TICKS));
+        }
+    }
+}
+
+TEST(DshotTelemetryTest, StoppedMotor)
+{
+    const uint8_t count = captureReply(replyPacket(7, 0x1ff), 100, NULL);
+    EXPECT_EQ(0, dshotTelemetryDecode(edges, count, DSHOT_TELEMETRY_BIT_TICKS));
+}
+
+TEST(DshotTelemetryTest, JitterAndCounterWrap)
+{
+    const int8_t jitter[4] = { 3, -4, 0, 5 };
+    // the capture timer wraps at 16 bits in the middle of the reply
+    const uint8_t count = captureReply(replyPacket(3, 417), 0xffff - 5 * DSHOT_TELEMETRY_BIT_TICKS, jitter);
+    EXPECT_EQ(expectedErpm(3, 417), dshotTelemetryDecode(edges, count, DSHOT_TELEMETRY_BIT_TICKS));
+}
+
+TEST(DshotTelemetryTest, RejectsBadReplies)
+{
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotTelemetryDecode(edges, 0, DSHOT_TELEMETRY_BIT_TICKS));
+
+    // a command frame checksum is not inverted
+    uint16_t packet = replyPacket(2, 200) ^ 0xf;
+    uint8_t count = captureReply(packet, 100, NULL);
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotTelemetryDecode(edges, count, DSHOT_TELEMETRY_BIT_TICKS));
+
+    // a missed edge shifts the rest of the frame
+    packet = replyPacket(2, 200);
+    count = captureReply(packet, 100, NULL);
+    memmove(&edges[4], &edges[5], (count - 5) * sizeof(edges[0]));
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotTelemetryDecode(edges, count - 1, DSHOT_TELEMETRY_BIT_TICKS));
+
+    // a glitch adds an edge
+    count = captureReply(packet, 100, NULL);
+    memmove(&edges[3], &edges[2], (count - 2) * sizeof(edges[0]));
+    edges[3] = edges[2] + 3;
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotTelemetryDecode(edges, count + 1, DSHOT_TELEMETRY_BIT_TICKS));
+
+    // edges too far apart for a 21 bit frame
+    count = captureReply(packet, 100, NULL);
+    edges[count - 1] += 8 * DSHOT_TELEMETRY_BIT_TICKS;
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotTelemetryDecode(edges, count, DSHOT_TELEMETRY_BIT_TICKS));
+}
+
+TEST(DshotTelemetryTest, ErrorRateAndStaleness)
+{
+    dshotTelemetryMotorState_t state;
+    dshotTelemetryReset(&state);
+    EXPECT_FALSE(state.valid);
+
+    for (int i = 0; i < DSHOT_TELEMETRY_ERROR_WINDOW; i++) {
+        dshotTelemetryUpdate(&state, i % 20 == 0 ? DSHOT_TELEMETRY_INVALID : 250);
+    }
+    EXPECT_TRUE(state.valid);
+    EXPECT_EQ(250, state.erpm);
+    EXPECT_EQ((uint32_t)DSHOT_TELEMETRY_ERROR_WINDOW, state.replies);
+    EXPECT_EQ(50u, state.errors);
+    EXPECT_EQ(50, state.errorPermille);
+
+    for (int i = 0; i < DSHOT_TELEMETRY_STALE_REPLIES - 1; i++) {
+        dshotTelemetryUpdate(&state, DSHOT_TELEMETRY_INVALID);
+    }
+    EXPECT_TRUE(state.valid);
+    dshotTelemetryUpdate(&state, DSHOT_TELEMETRY_INVALID);
+    EXPECT_FALSE(state.valid);
+    dshotTelemetryUpdate(&state, 300);
+    EXPECT_TRUE(state.valid);
+    EXPECT_EQ(300, state.erpm);
+}
@@ -0,0 +1,517 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/flash.h"
+
+    #include "io/flashfs.h"
+
+    uint32_t flashfsDeviceAddress(uint32_t address);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Simulated SPI NAND, a small W25N01G: 2KB pages, 4 pages per block, 16 blocks
+#define PAGE_SIZE       2048
+#define PAGES_PER_BLOCK 4
+#define BLOCK_SIZE      (PAGE_SIZE * PAGES_PER_BLOCK)
+#define BLOCK_COUNT     16
+#define DEVICE_SIZE     (BLOCK_SIZE * BLOCK_COUNT)
+#define ERASE_POLLS     3   // flashIsReady() calls an erase stays busy for
+
+static uint8_t nand[DEVICE_SIZE];
+static bool factoryBad[BLOCK_COUNT];
+static bool eraseFails[BLOCK_COUNT];
+static bool retired[BLOCK_COUNT];
+static int busyPolls;
+static int erasingBlock;        // erase in flight, the block only reads back erased once it is done
+static int badProgramCount;     // bytes programmed over data, into a bad block or out of page order
+static int badEraseCount;       // erases of bad or unaligned blocks
+static int eraseCompletelyCount;
+static uint32_t programAddress;
+static uint32_t lastProgrammedPage[BLOCK_COUNT];
+static bool pageFlushed[DEVICE_SIZE / PAGE_SIZE];   // programmed by a flush, no more data may go in
+
+static const flashGeometry_t nandGeometry = {
+    .sectors = BLOCK_COUNT,
+    .pageSize = PAGE_SIZE,
+    .sectorSize = BLOCK_SIZE,
+    .totalSize = DEVICE_SIZE,
+    .pagesPerSector = PAGES_PER_BLOCK,
+    .flashType = FLASH_TYPE_NAND,
+};
+
+static bool blockIsBad(int block)
+{
+    return factoryBad[block] || retired[block];
+}
+
+static void resetNand(void)
+{
+    // old log data everywhere, bad blocks carry their zeroed marker
+    for (int i = 0; i < DEVICE_SIZE; i++) {
+        nand[i] = i * 7;
+    }
+    memset(factoryBad, 0, sizeof(factoryBad));
+    memset(eraseFails, 0, sizeof(eraseFails));
+    memset(retired, 0, sizeof(retired));
+    for (int i = 0; i < BLOCK_COUNT; i++) {
+        lastProgrammedPage[i] = UINT32_MAX;
+    }
+    memset(pageFlushed, 0, sizeof(pageFlushed));
+    busyPolls = 0;
+    erasingBlock = -1;
+    programAddress = 0;
+    badProgramCount = 0;
+    badEraseCount = 0;
+    eraseCompletelyCount = 0;
+}
+
+static void finishErase(void)
+{
+    if (erasingBlock >= 0) {
+        memset(nand + erasingBlock * BLOCK_SIZE, 0xFF, BLOCK_SIZE);
+        memset(pageFlushed + erasingBlock * PAGES_PER_BLOCK, 0, PAGES_PER_BLOCK);
+        lastProgrammedPage[erasingBlock] = UINT32_MAX;
+        erasingBlock = -1;
+    }
+}
+
+// the erase in flight never completes
+static void powerCut(void)
+{
+    erasingBlock = -1;
+    busyPolls = 0;
+}
+
+static void injectBadBlock(int block)
+{
+    factoryBad[block] = true;
+    memset(nand + block * BLOCK_SIZE, 0, BLOCK_SIZE);
+}
+
+static uint8_t pattern(uint32_t offset)
+{
+    return (offset * 31 + (offset >> 8)) & 0xFF;
+}
+
+static void expectVolumeContains(uint32_t length)
+{
+    static uint8_t readBack[DEVICE_SIZE];
+    ASSERT_EQ((int)length, flashfsReadAbs(0, readBack, length));
+    for (uint32_t i = 0; i < length; i++) {
+        ASSERT_EQ(pattern(i), readBack[i]) << "offset " << i;
+    }
+}
+
+static void writePattern(uint32_t start, uint32_t length, bool sync)
+{
+    uint8_t chunk[100];
+    for (uint32_t offset = start; offset < start + length; ) {
+        const uint32_t chunkLength = start + length - offset < sizeof(chunk) ? start + length - offset : sizeof(chunk);
+        for (uint32_t i = 0; i < chunkLength; i++) {
+            chunk[i] = pattern(offset + i);
+        }
+        if (sync) {
+            flashfsWrite(chunk, chunkLength, true);
+            offset += chunkLength;
+        } else if (flashfsGetWriteBufferFreeSpace() >= chunkLength) {
+            // the way blackbox writes, only what fits in the buffer
+            flashfsWrite(chunk, chunkLength, false);
+            offset += chunkLength;
+        } else {
+            flashfsFlushAsync();
+        }
+    }
+}
+
+static void eraseVolume(void)
+{
+    flashfsEraseCompletely();
+    while (!flashfsIsReady());
+}
+
+TEST(FlashfsUnittest, TestVolumeSkipsBadBlocks)
+{
+    resetNand();
+    injectBadBlock(0);
+    injectBadBlock(5);
+    injectBadBlock(6);
+    flashfsInit();
+
+    EXPECT_EQ(BLOCK_COUNT - 3, flashfsGetGeometry()->sectors);
+    EXPECT_EQ((uint32_t)(BLOCK_COUNT - 3) * BLOCK_SIZE, flashfsGetSize());
+
+    EXPECT_EQ((uint32_t)1 * BLOCK_SIZE, flashfsDeviceAddress(0));
+    EXPECT_EQ((uint32_t)4 * BLOCK_SIZE + 10, flashfsDeviceAddress(3 * BLOCK_SIZE + 10));
+    EXPECT_EQ((uint32_t)7 * BLOCK_SIZE, flashfsDeviceAddress(4 * BLOCK_SIZE));
+    EXPECT_EQ((uint32_t)15 * BLOCK_SIZE + BLOCK_SIZE - 1, flashfsDeviceAddress(12 * BLOCK_SIZE + BLOCK_SIZE - 1));
+}
+
+TEST(FlashfsUnittest, TestWriteAndReadBackAroundBadBlocks)
+{
+    resetNand();
+    injectBadBlock(2);
+    injectBadBlock(3);
+    injectBadBlock(BLOCK_COUNT - 1);
+    flashfsInit();
+    eraseVolume();
+
+    EXPECT_EQ(0, eraseCompletelyCount);
+    EXPECT_EQ(0, badEraseCount);
+    EXPECT_EQ(0u, flashfsGetOffset());
+
+    const uint32_t size = flashfsGetSize();
+    writePattern(0, size, false);
+    flashfsFlushSync();
+    flashfsClose();
+
+    EXPECT_TRUE(flashfsIsEOF());
+    EXPECT_EQ(0, badProgramCount);
+    expectVolumeContains(size);
+    // the bad blocks were left alone
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        ASSERT_EQ(0, nand[2 * BLOCK_SIZE + i]);
+        ASSERT_EQ(0, nand[3 * BLOCK_SIZE + i]);
+        ASSERT_EQ(0, nand[(BLOCK_COUNT - 1) * BLOCK_SIZE + i]);
+    }
+}
+
+TEST(FlashfsUnittest, TestWritesFollowBackgroundErase)
+{
+    resetNand();
+    injectBadBlock(1);
+    flashfsInit();
+    flashfsEraseCompletely();
+
+    // logging starts while most of the volume still holds old data
+    EXPECT_FALSE(flashfsIsReady());
+    const uint32_t length = 3 * BLOCK_SIZE + 1234;
+    writePattern(0, length, false);
+    flashfsFlushSync();
+    flashfsClose();
+
+    EXPECT_EQ(0, badProgramCount);
+    expectVolumeContains(length);
+
+    // the erase finishes in the background
+    while (!flashfsIsReady());
+    EXPECT_EQ(0, badEraseCount);
+    for (int i = 8 * BLOCK_SIZE; i < DEVICE_SIZE; i++) {
+        ASSERT_EQ(0xFF, nand[i]);
+    }
+}
+
+TEST(FlashfsUnittest, TestFailedEraseRetiresBlock)
+{
+    resetNand();
+    injectBadBlock(4);
+    eraseFails[2] = true;
+    eraseFails[9] = true;
+    flashfsInit();
+    eraseVolume();
+
+    EXPECT_TRUE(retired[2]);
+    EXPECT_TRUE(retired[9]);
+    EXPECT_EQ((uint32_t)(BLOCK_COUNT - 3) * BLOCK_SIZE, flashfsGetSize());
+    EXPECT_EQ(BLOCK_COUNT - 3, flashfsGetGeometry()->sectors);
+
+    const uint32_t size = flashfsGetSize();
+    writePattern(0, size, true);
+    flashfsClose();
+
+    EXPECT_EQ(0, badProgramCount);
+    expectVolumeContains(size);
+
+    // the retired blocks stay out of the volume after a reboot
+    flashfsInit();
+    EXPECT_EQ(size, flashfsGetSize());
+    expectVolumeContains(size);
+}
+
+TEST(FlashfsUnittest, TestFreeSpaceFoundAfterReboot)
+{
+    resetNand();
+    injectBadBlock(0);
+    injectBadBlock(3);
+    flashfsInit();
+    eraseVolume();
+
+    const uint32_t length = 5 * BLOCK_SIZE + 3000;
+    writePattern(0, length, false);
+    flashfsFlushSync();
+    flashfsClose();
+
+    flashfsInit();
+    // the log ends in the page that was padded out on close
+    EXPECT_EQ((uint32_t)(length + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE, flashfsGetOffset());
+    expectVolumeContains(length);
+
+    // a second log goes behind it
+    writePattern(flashfsGetOffset(), 1000, true);
+    flashfsClose();
+    EXPECT_EQ(0, badProgramCount);
+}
+
+TEST(FlashfsUnittest, TestEraseTaskFinishesErase)
+{
+    resetNand();
+    injectBadBlock(7);
+    flashfsInit();
+    flashfsEraseCompletely();
+
+    // nobody polls flashfsIsReady(), only the scheduler runs the erase
+    for (int i = 0; i < (BLOCK_COUNT + 1) * (ERASE_POLLS + 1); i++) {
+        flashfsEraseUpdate(0);
+    }
+    EXPECT_TRUE(flashfsIsReady());
+    EXPECT_EQ(0, badEraseCount);
+    for (int block = 0; block < BLOCK_COUNT; block++) {
+        if (block != 7) {
+            ASSERT_EQ(0xFF, nand[block * BLOCK_SIZE + BLOCK_SIZE - 1]) << "block " << block;
+        }
+    }
+}
+
+TEST(FlashfsUnittest, TestInterruptedEraseResumesAfterReboot)
+{
+    resetNand();
+    injectBadBlock(2);
+    flashfsInit();
+    flashfsEraseCompletely();
+
+    const uint32_t length = BLOCK_SIZE + 1000;
+    writePattern(0, length, false);
+    flashfsFlushSync();
+    flashfsClose();
+    // the power goes with a few blocks erased ahead of the log
+    while (nand[6 * BLOCK_SIZE] != 0xFF) {
+        flashfsEraseUpdate(0);
+    }
+
+    flashfsInit();
+    EXPECT_FALSE(flashfsIsReady());
+    // the new log goes behind the old one, not into the old data past the erased blocks
+    EXPECT_EQ((uint32_t)(length + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE, flashfsGetOffset());
+    expectVolumeContains(length);
+
+    while (!flashfsIsReady()) {
+        flashfsEraseUpdate(0);
+    }
+    EXPECT_EQ(0, badEraseCount);
+    for (int i = 7 * BLOCK_SIZE; i < DEVICE_SIZE; i++) {
+        ASSERT_EQ(0xFF, nand[i]);
+    }
+    expectVolumeContains(length);
+
+    flashfsInit();
+    EXPECT_TRUE(flashfsIsReady());
+}
+
+TEST(FlashfsUnittest, TestReadDoesNotReprogramOpenPage)
+{
+    resetNand();
+    flashfsInit();
+    eraseVolume();
+
+    writePattern(0, 1000, true);
+    expectVolumeContains(1000);
+
+    // reading completed the open page, writing carries on in the next one
+    EXPECT_EQ((uint32_t)PAGE_SIZE, flashfsGetOffset());
+    uint8_t data[500];
+    for (int i = 0; i < 500; i++) {
+        data[i] = pattern(i);
+    }
+    flashfsWrite(data, sizeof(data), true);
+    flashfsClose();
+
+    EXPECT_EQ(0, badProgramCount);
+    uint8_t readBack[sizeof(data)];
+    ASSERT_EQ((int)sizeof(readBack), flashfsReadAbs(PAGE_SIZE, readBack, sizeof(readBack)));
+    EXPECT_EQ(0, memcmp(data, readBack, sizeof(data)));
+}
+
+TEST(FlashfsUnittest, TestReadBehindOpenPageKeepsItOpen)
+{
+    resetNand();
+    flashfsInit();
+    eraseVolume();
+
+    const uint32_t length = PAGE_SIZE + 1000;
+    writePattern(0, length, true);
+    // like the MSC or a CLI dump while logging, nothing of the page being written is read
+    uint8_t readBack[500];
+    ASSERT_EQ((int)sizeof(readBack), flashfsReadAbs(0, readBack, sizeof(readBack)));
+    EXPECT_EQ(length, flashfsGetOffset());
+
+    writePattern(length, 1000, true);
+    flashfsClose();
+    EXPECT_EQ(0, badProgramCount);
+    expectVolumeContains(length + 1000);
+}
+
+TEST(FlashfsUnittest, TestEraseResumesWhenLogCaughtUp)
+{
+    resetNand();
+    flashfsInit();
+    flashfsEraseCompletely();
+
+    // the log keeps up with the erase, whenever the power goes the old data must be told apart from it
+    const uint32_t length = 3 * BLOCK_SIZE + 1000;
+    for (uint32_t offset = 0; offset < length; offset += 100) {
+        writePattern(offset, 100, true);
+        const int nextBlock = programAddress / BLOCK_SIZE + 1;
+        if (programAddress > 0 && nextBlock < BLOCK_COUNT) {
+            ASSERT_NE(nextBlock, erasingBlock) << "offset " << offset;
+            for (int i = nextBlock * BLOCK_SIZE; i < (nextBlock + 1) * BLOCK_SIZE; i++) {
+                ASSERT_EQ(0xFF, nand[i]) << "offset " << offset;
+            }
+        }
+    }
+    flashfsFlushSync();
+    flashfsClose();
+    powerCut();
+
+    flashfsInit();
+    EXPECT_FALSE(flashfsIsReady());
+    EXPECT_EQ((uint32_t)(length + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE, flashfsGetOffset());
+    while (!flashfsIsReady()) {
+        flashfsEraseUpdate(0);
+    }
+    EXPECT_EQ(0, badEraseCount);
+    for (int i = 4 * BLOCK_SIZE; i < DEVICE_SIZE; i++) {
+        ASSERT_EQ(0xFF, nand[i]) << "offset " << i;
+    }
+    expectVolumeContains(length);
+}
+
+// STUBS
+
+extern "C" {
+
+bool flashIsReady(void)
+{
+    if (busyPolls > 0) {
+        busyPolls--;
+        return false;
+    }
+    finishErase();
+    return true;
+}
+
+bool flashWaitForReady(uint32_t timeoutMillis)
+{
+    UNUSED(timeoutMillis);
+    busyPolls = 0;
+    finishErase();
+    return true;
+}
+
+void flashEraseSector(uint32_t address)
+{
+    const int block = address / BLOCK_SIZE;
+    if (address % BLOCK_SIZE || blockIsBad(block) || busyPolls) {
+        badEraseCount++;
+        return;
+    }
+    busyPolls = ERASE_POLLS;
+    if (eraseFails[block]) {
+        // the driver retires the block and zeroes its marker
+        retired[block] = true;
+        return;
+    }
+    erasingBlock = block;
+}
+
+void flashEraseCompletely(void)
+{
+    eraseCompletelyCount++;
+}
+
+void flashPageProgramBegin(uint32_t address)
+{
+    programAddress = address;
+}
+
+void flashPageProgramContinue(const uint8_t *data, int length)
+{
+    const int block = programAddress / BLOCK_SIZE;
+    const uint32_t page = programAddress / PAGE_SIZE;
+    if (blockIsBad(block) || busyPolls || pageFlushed[page] || (lastProgrammedPage[block] != UINT32_MAX && page < lastProgrammedPage[block])) {
+        badProgramCount++;
+    }
+    lastProgrammedPage[block] = page;
+    for (int i = 0; i < length; i++) {
+        if (nand[programAddress + i] != 0xFF) {
+            badProgramCount++;
+        }
+        nand[programAddress + i] = data[i];
+    }
+    programAddress += length;
+}
+
+void flashPageProgramFinish(void)
+{
+}
+
+void flashPageProgram(uint32_t address, const uint8_t *data, int length)
+{
+    flashPageProgramBegin(address);
+    flashPageProgramContinue(data, length);
+    flashPageProgramFinish();
+}
+
+void flashFlush(void)
+{
+    if (programAddress % PAGE_SIZE) {
+        pageFlushed[programAddress / PAGE_SIZE] = true;
+    }
+}
+
+int flashReadBytes(uint32_t address, uint8_t *buffer, int length)
+{
+    if (address + length > DEVICE_SIZE) {
+        return 0;
+    }
+    // like the driver, reading the page being written programs it
+    if (address / PAGE_SIZE <= programAddress / PAGE_SIZE && programAddress / PAGE_SIZE <= (address + length - 1) / PAGE_SIZE) {
+        flashFlush();
+    }
+    memcpy(buffer, nand + address, length);
+    return length;
+}
+
+const flashGeometry_t *flashGetGeometry(void)
+{
+    return &nandGeometry;
+}
+
+bool flashIsBadBlock(uint16_t block)
+{
+    return blockIsBad(block);
+}
+
+}
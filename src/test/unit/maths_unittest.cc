@@ -19,6 +19,7 @@
 #include <stdbool.h>
 
 #include <limits.h>
+#include <string.h>
 
 #include <math.h>
 
@@ -273,3 +274,97 @@ TEST(MathsUnittest, TestFastTrigonometryACos)
     EXPECT_LE(error, 1e-4);
 }
 #endif
+
+// reference attitude for a classic coning motion: q(t) = Rz(wt) * Rx(angle) * Rz(-wt)
+static void coningAttitude(double t, double coningRate, double coningAngle, double *q)
+{
+    const double cz = cos(0.5 * coningRate * t), sz = sin(0.5 * coningRate * t);
+    const double cx = cos(0.5 * coningAngle), sx = sin(0.5 * coningAngle);
+    // Rz(wt) * Rx(angle)
+    const double a[4] = { cz * cx, cz * sx, sz * sx, sz * cx };
+    // * Rz(-wt)
+    q[0] = a[0] * cz + a[3] * sz;
+    q[1] = a[1] * cz - a[2] * sz;
+    q[2] = a[2] * cz + a[1] * sz;
+    q[3] = a[3] * cz - a[0] * sz;
+}
+
+// body rate from the reference attitude, w = 2 * vec(conj(q) * dq/dt)
+static void coningBodyRate(double t, double coningRate, double coningAngle, float *rate)
+{
+    const double h = 1e-6;
+    double q[4], q1[4], q0[4];
+    coningAttitude(t, coningRate, coningAngle, q);
+    coningAttitude(t + h, coningRate, coningAngle, q1);
+    coningAttitude(t - h, coningRate, coningAngle, q0);
+    double dq[4];
+    for (int i = 0; i < 4; i++) {
+        dq[i] = (q1[i] - q0[i]) / (2 * h);
+    }
+    rate[0] = 2 * (q[0] * dq[1] - q[1] * dq[0] - q[2] * dq[3] + q[3] * dq[2]);
+    rate[1] = 2 * (q[0] * dq[2] + q[1] * dq[3] - q[2] * dq[0] - q[3] * dq[1]);
+    rate[2] = 2 * (q[0] * dq[3] - q[1] * dq[2] + q[2] * dq[1] - q[3] * dq[0]);
+}
+
+// angle of conj(reference) * q
+static double quaternionErrorAngle(quaternion *q, const double *reference)
+{
+    const double x = reference[0] * q->x - reference[1] * q->w - reference[2] * q->z + reference[3] * q->y;
+    const double y = reference[0] * q->y + reference[1] * q->z - reference[2] * q->w - reference[3] * q->x;
+    const double z = reference[0] * q->z - reference[1] * q->y + reference[2] * q->x - reference[3] * q->w;
+    return 2 * asin(MIN(sqrt(x * x + y * y + z * z), 1.0));
+}
+
+TEST(MathsUnittest, TestDeltaRotationConing)
+{
+    const double coningRate = 2 * M_PI * 20;      // 20Hz coning
+    const double coningAngle = 10 * M_PI / 180;
+    const double gyroDt = 1.0 / 8000;             // 8kHz gyro
+    const int samplesPerUpdate = 8;               // 1kHz attitude
+    const int updates = 2000;                     // 2 seconds
+
+    double reference[4];
+    coningAttitude(0, coningRate, coningAngle, reference);
+    quaternion qConing = { (float)reference[0], (float)reference[1], (float)reference[2], (float)reference[3] };
+    quaternion qAverage = qConing;
+
+    deltaRotation_t rotation;
+    memset(&rotation, 0, sizeof(rotation));
+    float previousRate[3];
+    coningBodyRate(0, coningRate, coningAngle, previousRate);
+
+    int sample = 0;
+    for (int update = 0; update < updates; update++) {
+        deltaRotationReset(&rotation);
+        for (int i = 0; i < samplesPerUpdate; i++) {
+            sample++;
+            float rate[3];
+            coningBodyRate(sample * gyroDt, coningRate, coningAngle, rate);
+            float deltaAngle[3];
+            for (int axis = 0; axis < 3; axis++) {
+                deltaAngle[axis] = 0.5f * (previousRate[axis] + rate[axis]) * gyroDt;
+                previousRate[axis] = rate[axis];
+            }
+            deltaRotationAccumulate(&rotation, deltaAngle);
+        }
+        quaternion v, qDiff;
+        // coning corrected rotation vector
+        deltaRotationGetVector(&rotation, &v);
+        quaternionFromRotationVector(&v, &qDiff);
+        quaternionMultiply(&qConing, &qDiff, &qConing);
+        quaternionNormalize(&qConing);
+        // plain average of the rates, as used previously
+        v.x = rotation.alpha[0];
+        v.y = rotation.alpha[1];
+        v.z = rotation.alpha[2];
+        quaternionFromRotationVector(&v, &qDiff);
+        quaternionMultiply(&qAverage, &qDiff, &qAverage);
+        quaternionNormalize(&qAverage);
+    }
+
+    coningAttitude(sample * gyroDt, coningRate, coningAngle, reference);
+    const double coningError = quaternionErrorAngle(&qConing, reference) * 180 / M_PI;
+    const double averageError = quaternionErrorAngle(&qAverage, reference) * 180 / M_PI;
+    EXPECT_LT(coningError, 0.05);
+    EXPECT_LT(coningError * 10, averageError);
+}
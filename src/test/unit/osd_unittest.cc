@@ -55,6 +55,7 @@ extern "C" {
     #include "sensors/battery.h"
 
     #include "rx/rx.h"
+    #include "rx/rx_frame_timing.h"
 
     void osdRefresh(timeUs_t currentTimeUs);
     void osdFormatTime(char * buff, osd_timer_precision_e precision, timeUs_t time);
@@ -1129,6 +1130,9 @@ extern "C" {
 
     uint8_t getRssiPercent(void) { return scaleRange(rssi, 0, RSSI_MAX_VALUE, 0, 100); }
 
+    static rxFrameTiming_t rxFrameTiming;
+    const rxFrameTiming_t *rxGetFrameTiming(void) { return &rxFrameTiming; }
+
     uint16_t getCoreTemperatureCelsius(void) { return simulationCoreTemperature; }
 
     bool isFlipOverAfterCrashMode(void) {
@@ -19,6 +19,7 @@
 #include <stdbool.h>
 #include <limits.h>
 #include <cmath>
+#include <chrono>
 
 #include "unittest_macros.h"
 #include "gtest/gtest.h"
@@ -46,6 +47,7 @@ extern "C" {
     #include "drivers/sound_beeper.h"
     #include "drivers/time.h"
 
+    #include "fc/config.h"
     #include "fc/fc_core.h"
     #include "fc/fc_rc.h"
 
@@ -73,6 +75,13 @@ extern "C" {
     bool gyroOverflowDetected(void) { return false; }
     float getRcDeflection(int axis) { return simulatedRcDeflection[axis]; }
     void beeperConfirmationBeeps(uint8_t) { }
+    void mixerInitProfile(void) { }
+    float howUpsideDown(void) { return 1.0f; }
+    float getAngleModeAngles(int axis) { return attitude.raw[axis]; }
+    bool linearThrustEnabled = false;
+    float getThrottlePAttenuation(void) { return 1.0f; }
+    float getThrottleIAttenuation(void) { return 1.0f; }
+    float getThrottleDAttenuation(void) { return 1.0f; }
 }
 
 pidProfile_t *pidProfile;
@@ -470,3 +479,104 @@ TEST(pidControllerTest, testDtermFiltering) {
 TEST(pidControllerTest, testItermRotationHandling) {
 // TODO
 }
+
+// Drives a roll ramp through profile 1 and returns the pidData after one more loop,
+// either on the same profile, after a profile switch, or after a full pidInit()
+static pidAxisData_t runProfileSwitchStep(int mode) {
+    resetTest();
+    pidProfile->dFilter[FD_ROLL].Wc = 0;
+    pidProfile->dFilter[FD_ROLL].dLpf = 40;
+    *pidProfilesMutable(0) = *pidProfile;
+    pidProfilesMutable(0)->pid[PID_ROLL].P = pidProfile->pid[PID_ROLL].P * 2;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    // ramp the gyro so the dterm filter settles on a constant non zero derivative
+    for (int loop = 0; loop < 20; loop++) {
+        gyro.gyroADCf[FD_ROLL] = 10 * loop;
+        pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    }
+    gyro.gyroADCf[FD_ROLL] = 200;
+    const pidProfile_t *activeProfile = pidProfile;
+    if (mode == 1) {
+        pidSwitchProfile(0);
+        activeProfile = pidProfiles(0);
+    } else if (mode == 2) {
+        pidInit(pidProfiles(0));
+        activeProfile = pidProfiles(0);
+    }
+    pidController(activeProfile, &rollAndPitchTrims, currentTestTime());
+    return pidData[FD_ROLL];
+}
+
+TEST(pidControllerTest, testProfileSwitchKeepsFilterState) {
+    const pidAxisData_t unswitched = runProfileSwitchStep(0);
+    const pidAxisData_t switched = runProfileSwitchStep(1);
+    const pidAxisData_t reinitialised = runProfileSwitchStep(2);
+
+    // new gains apply on the very first loop after the switch
+    EXPECT_NEAR(2 * unswitched.P, switched.P, calculateTolerance(2 * unswitched.P));
+    EXPECT_FLOAT_EQ(reinitialised.P, switched.P);
+
+    // the dterm filter carries its state over, a full init restarts it
+    EXPECT_NE(0, unswitched.D);
+    EXPECT_FLOAT_EQ(unswitched.D, switched.D);
+    EXPECT_GT(fabsf(unswitched.D - reinitialised.D), calculateTolerance(unswitched.D));
+}
+
+TEST(pidControllerTest, testProfileSwitchCostsLessThanOneLoop) {
+    resetTest();
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+    gyro.gyroADCf[FD_ROLL] = 100;
+
+    const int iterations = 10000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    }
+    const auto loopTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        pidSwitchProfile(i & 1);
+    }
+    const auto switchTime = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(switchTime.count(), loopTime.count());
+}
+
+TEST(pidControllerTest, testProfileSwitchPicksUpEdits) {
+    resetTest();
+    *pidProfilesMutable(0) = *pidProfile;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    gyro.gyroADCf[FD_ROLL] = 100;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    const float initialP = pidData[FD_ROLL].P;
+
+    // edit the inactive profile directly and mark it, as CLI set does, then switch to it
+    pidProfilesMutable(0)->pid[PID_ROLL].P = pidProfile->pid[PID_ROLL].P * 2;
+    pidMarkProfileDirty(0);
+    pidSwitchProfile(0);
+    pidController(pidProfiles(0), &rollAndPitchTrims, currentTestTime());
+    EXPECT_FLOAT_EQ(2 * initialP, pidData[FD_ROLL].P);
+
+    // the same after editing it while active and switching away and back
+    pidProfilesMutable(0)->pid[PID_ROLL].P = pidProfile->pid[PID_ROLL].P * 3;
+    pidMarkProfileDirty(0);
+    pidSwitchProfile(1);
+    pidSwitchProfile(0);
+    pidController(pidProfiles(0), &rollAndPitchTrims, currentTestTime());
+    EXPECT_FLOAT_EQ(3 * initialP, pidData[FD_ROLL].P);
+
+    // a PG reset marks the profile too
+    resetPidProfile(pidProfilesMutable(0));
+    pidSwitchProfile(1);
+    pidSwitchProfile(0);
+    pidController(pidProfiles(0), &rollAndPitchTrims, currentTestTime());
+    EXPECT_FLOAT_EQ(initialP * pidProfiles(0)->pid[PID_ROLL].P / pidProfile->pid[PID_ROLL].P, pidData[FD_ROLL].P);
+}
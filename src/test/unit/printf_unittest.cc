@@ -0,0 +1,250 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/printf.h"
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define EXPECT_FORMAT(expected, ...) do { \
+    char actual[128]; \
+    const int actualLength = tfp_sprintf(actual, __VA_ARGS__); \
+    EXPECT_STREQ(expected, actual); \
+    EXPECT_EQ((int)strlen(expected), actualLength); \
+} while (0)
+
+TEST(PrintfUnittest, TestIntegers)
+{
+    const struct {
+        const char *format;
+        int value;
+        const char *expected;
+    } cases[] = {
+        { "%d", 0, "0" },
+        { "%d", -1, "-1" },
+        { "%d", INT_MAX, "2147483647" },
+        { "%d", INT_MIN, "-2147483648" },
+        { "%u", -1, "4294967295" },
+        { "%u", 100000, "100000" },
+        { "%x", 255, "ff" },
+        { "%X", 0xbeef, "BEEF" },
+        // width is a minimum, padding goes before the sign
+        { "%1d", 12345, "12345" },
+        { "%5d", 42, "   42" },
+        { "%5d", -42, "  -42" },
+        { "%05d", 42, "00042" },
+        { "%05d", -42, "00-42" },
+        { "%0d", 7, "7" },
+        { "%00d", 7, "7" },
+        { "%02d", 5, "05" },
+        { "%02d", 100, "100" },
+        { "%11d", INT_MIN, "-2147483648" },
+        { "%12d", INT_MIN, " -2147483648" },
+        { "%04x", 0xab, "00ab" },
+        { "%08X", 0xbeef, "0000BEEF" },
+        { "%02X", 0xfff, "FFF" },
+        { "%10u", -1, "4294967295" },
+        { "V%d!", 9, "V9!" },
+        { "%d%%", 50, "50%" },
+    };
+    for (unsigned i = 0; i < ARRAYLEN(cases); i++) {
+        SCOPED_TRACE(cases[i].format);
+        EXPECT_FORMAT(cases[i].expected, cases[i].format, cases[i].value);
+    }
+}
+
+TEST(PrintfUnittest, TestLongIntegers)
+{
+    // a long is 32 bits on the flight controller
+    EXPECT_FORMAT("-100000", "%ld", -100000L);
+    EXPECT_FORMAT("4000000000", "%lu", 4000000000UL);
+    EXPECT_FORMAT("deadbeef", "%lx", 0xdeadbeefUL);
+    EXPECT_FORMAT("0-1234", "%06ld", -1234L);
+}
+
+TEST(PrintfUnittest, TestFixedPoint)
+{
+    // fixed point values are printed as an integer and a fraction part
+    EXPECT_FORMAT("-1.2", "%d.%1d", -1, 2);
+    EXPECT_FORMAT(" 12.05A", "%3d.%02d%c", 12, 5, 'A');
+    EXPECT_FORMAT("01:02.03", "%02d:%02d.%02d", 1, 2, 3);
+    EXPECT_FORMAT("0.0001234", "%d.%07d", 0, 1234);
+}
+
+TEST(PrintfUnittest, TestStrings)
+{
+    const struct {
+        const char *format;
+        const char *value;
+        const char *expected;
+    } cases[] = {
+        { "%s", "", "" },
+        { "%s", "OSD", "OSD" },
+        { "%1s", "12345678", "12345678" },
+        { "%8s", "12345678", "12345678" },
+        { "%5s", "OSD", "  OSD" },
+        { "%5s", "", "     " },
+        { "%20s", "pid_process_denom", "   pid_process_denom" },
+        // strings are always padded with spaces
+        { "%05s", "ab", "   ab" },
+        { "[%s]", "a", "[a]" },
+    };
+    for (unsigned i = 0; i < ARRAYLEN(cases); i++) {
+        SCOPED_TRACE(cases[i].format);
+        EXPECT_FORMAT(cases[i].expected, cases[i].format, cases[i].value);
+    }
+}
+
+TEST(PrintfUnittest, TestCharacters)
+{
+    EXPECT_FORMAT("x", "%c", 'x');
+    // no width for characters
+    EXPECT_FORMAT("x|", "%5c|", 'x');
+    EXPECT_FORMAT("a\x7fz", "%c%c%c", 'a', 0x7f, 'z');
+    EXPECT_FORMAT("H Field I name:", "H Field %c %s:", 'I', "name");
+}
+
+TEST(PrintfUnittest, TestMalformedFormats)
+{
+    EXPECT_FORMAT("", "");
+    EXPECT_FORMAT("no conversions", "no conversions");
+    // an unfinished conversion ends the output
+    EXPECT_FORMAT("trailing ", "trailing %");
+    EXPECT_FORMAT("trailing ", "trailing %0");
+    EXPECT_FORMAT("trailing ", "trailing %12");
+    EXPECT_FORMAT("trailing ", "trailing %l");
+    EXPECT_FORMAT("Firmware Version: 4.02", "Firmware Version: %d.%02d%", 4, 2);
+    // unknown conversions are dropped, precision and left alignment are not supported
+    EXPECT_FORMAT(" unknown", "%q%z unknown");
+    EXPECT_FORMAT("2d", "%.2d", 5);
+    EXPECT_FORMAT("4d|", "%-4d|", 5);
+    EXPECT_FORMAT("5s", "%-5s", "a");
+    EXPECT_FORMAT("%50%", "%%%d%%", 50);
+}
+
+TEST(PrintfUnittest, TestSignBeforeZeroPadding)
+{
+    char buf[16];
+    EXPECT_EQ(4, tfp_sprintf(buf, "%04d", -5));
+    EXPECT_STREQ("00-5", buf);
+}
+
+TEST(PrintfUnittest, TestWrittenCount)
+{
+    char buf[32];
+    int atN = -1;
+    EXPECT_EQ(8, tfp_sprintf(buf, "ab%3d%ncd%c", 7, &atN, 'e'));
+    EXPECT_STREQ("ab  7cde", buf);
+    EXPECT_EQ(5, atN);
+}
+
+static int writeCalls;
+static std::string writeOutput;
+
+static void countingWrite(void *, const char *data, int len)
+{
+    writeCalls++;
+    writeOutput.append(data, len);
+}
+
+static int formatWrite(const char *fmt, ...)
+{
+    va_list va;
+    va_start(va, fmt);
+    const int written = tfp_format_write(NULL, countingWrite, fmt, va);
+    va_end(va);
+    return written;
+}
+
+TEST(PrintfUnittest, TestOutputInRuns)
+{
+    writeCalls = 0;
+    writeOutput.clear();
+    EXPECT_EQ(20, formatWrite("set roll_p = %5d\r\n", 45));
+    EXPECT_EQ("set roll_p =    45\r\n", writeOutput);
+    // literal text, padding, digits, literal text
+    EXPECT_EQ(4, writeCalls);
+
+    writeCalls = 0;
+    writeOutput.clear();
+    formatWrite("%20s", "x");
+    EXPECT_EQ(std::string(19, ' ') + "x", writeOutput);
+    EXPECT_EQ(4, writeCalls);
+}
+
+static std::string putcOutput;
+
+static void putcCollect(void *, char c)
+{
+    putcOutput += c;
+}
+
+static int formatPutc(const char *fmt, ...)
+{
+    va_list va;
+    va_start(va, fmt);
+    const int written = tfp_format(NULL, putcCollect, fmt, va);
+    va_end(va);
+    return written;
+}
+
+TEST(PrintfUnittest, TestCharacterSink)
+{
+    putcOutput.clear();
+    EXPECT_EQ(7, formatPutc("%s:%04X", "id", 0xbeef));
+    EXPECT_EQ("id:BEEF", putcOutput);
+}
+
+TEST(PrintfUnittest, TestStreamBufferSink)
+{
+    uint8_t data[8];
+    memset(data, '#', sizeof(data));
+    sbuf_t sbuf;
+    sbuf.ptr = data;
+    sbuf.end = data + 6;
+
+    EXPECT_EQ(3, tfp_sbufprintf(&sbuf, "%d", 123));
+    EXPECT_EQ(data + 3, sbuf.ptr);
+    EXPECT_EQ(0, memcmp(data, "123###", 6));
+
+    // the output that does not fit is dropped, the length is still reported
+    EXPECT_EQ(5, tfp_sbufprintf(&sbuf, "%5s", "ab"));
+    EXPECT_EQ(data + 6, sbuf.ptr);
+    EXPECT_EQ(0, memcmp(data, "123   ##", 8));
+
+    EXPECT_EQ(2, tfp_sbufprintf(&sbuf, "xy"));
+    EXPECT_EQ(data + 6, sbuf.ptr);
+}
+
+// STUBS
+extern "C" {
+    struct serialPort_s;
+    bool isSerialTransmitBufferEmpty(const struct serialPort_s *) { return true; }
+    void serialWrite(struct serialPort_s *, uint8_t) {}
+}
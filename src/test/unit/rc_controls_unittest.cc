@@ -26,6 +26,7 @@ extern "C" {
     #include "common/maths.h"
     #include "common/axis.h"
     #include "common/bitarray.h"
+    #include "common/utils.h"
 
     #include "pg/pg.h"
     #include "pg/pg_ids.h"
@@ -145,6 +146,9 @@ TEST_F(RcControlsModesTest, updateActivatedModesUsingValidAuxConfigurationAndRXV
     EXPECT_EQ(1, modeActivationConditions(6)->range.startStep);
     EXPECT_EQ(2, modeActivationConditions(6)->range.endStep);
 
+    // the conditions are compiled into range tables, rebuild them as the CLI and MSP setters do
+    analyzeModeActivationConditions();
+
     // and
     boxBitmask_t mask;
     memset(&mask, 0, sizeof(mask));
@@ -189,6 +193,159 @@ TEST_F(RcControlsModesTest, updateActivatedModesUsingValidAuxConfigurationAndRXV
     }
 }
 
+static void setModeCondition(int index, boxId_e modeId, uint8_t auxChannelIndex, uint8_t startStep, uint8_t endStep, modeLogic_e modeLogic)
+{
+    modeActivationCondition_t *mac = modeActivationConditionsMutable(index);
+    memset(mac, 0, sizeof(*mac));
+    mac->modeId = modeId;
+    mac->auxChannelIndex = auxChannelIndex;
+    mac->range.startStep = startStep;
+    mac->range.endStep = endStep;
+    mac->modeLogic = modeLogic;
+}
+
+static void clearModeConditions(void)
+{
+    memset(modeActivationConditionsMutable(0), 0, sizeof(modeActivationCondition_t) * MAX_MODE_ACTIVATION_CONDITION_COUNT);
+    analyzeModeActivationConditions();
+}
+
+TEST_F(RcControlsModesTest, compiledRangeBoundaries)
+{
+    memset(&rxRuntimeConfig, 0, sizeof(rxRuntimeConfig_t));
+    rxRuntimeConfig.channelCount = MAX_SUPPORTED_RC_CHANNEL_COUNT - NON_AUX_CHANNEL_COUNT;
+    clearModeConditions();
+    const struct {
+        uint8_t startStep;
+        uint8_t endStep;
+        int16_t channelValue;
+        bool active;
+    } cases[] = {
+        // the start of a range is inside, the end is not
+        { 20, 28, 1399, false },
+        { 20, 28, 1400, true },
+        { 20, 28, 1599, true },
+        { 20, 28, 1600, false },
+        // full range, values outside the channel range are clamped into it
+        { 0, MAX_MODE_RANGE_STEP, 850, true },
+        { 0, MAX_MODE_RANGE_STEP, 1500, true },
+        { 0, MAX_MODE_RANGE_STEP, 2150, true },
+        // first and last step
+        { 0, 1, 899, true },
+        { 0, 1, 924, true },
+        { 0, 1, 925, false },
+        { MAX_MODE_RANGE_STEP - 1, MAX_MODE_RANGE_STEP, 2074, false },
+        { MAX_MODE_RANGE_STEP - 1, MAX_MODE_RANGE_STEP, 2075, true },
+        { MAX_MODE_RANGE_STEP - 1, MAX_MODE_RANGE_STEP, 2101, true },
+        // empty and inverted ranges are never active
+        { 20, 20, 1400, false },
+        { 28, 20, 1500, false },
+        { 0, 0, 850, false },
+    };
+    for (unsigned i = 0; i < ARRAYLEN(cases); i++) {
+        setModeCondition(0, (boxId_e)1, 0, cases[i].startStep, cases[i].endStep, MODELOGIC_OR);
+        analyzeModeActivationConditions();
+        rcData[AUX1] = cases[i].channelValue;
+        updateActivatedModes();
+        EXPECT_EQ(cases[i].active, IS_RC_MODE_ACTIVE((boxId_e)1)) << "case " << i;
+    }
+    clearModeConditions();
+}
+
+TEST_F(RcControlsModesTest, compiledRangesFollowTheChannel)
+{
+    memset(&rxRuntimeConfig, 0, sizeof(rxRuntimeConfig_t));
+    rxRuntimeConfig.channelCount = MAX_SUPPORTED_RC_CHANNEL_COUNT - NON_AUX_CHANNEL_COUNT;
+    clearModeConditions();
+    // overlapping ranges on one channel, mode 2 also has a range on AUX2
+    setModeCondition(0, (boxId_e)1, 0, CHANNEL_VALUE_TO_STEP(1300), CHANNEL_VALUE_TO_STEP(1700), MODELOGIC_OR);
+    setModeCondition(1, (boxId_e)2, 0, CHANNEL_VALUE_TO_STEP(1500), CHANNEL_VALUE_TO_STEP(2100), MODELOGIC_OR);
+    setModeCondition(2, (boxId_e)2, 1, CHANNEL_VALUE_TO_STEP(900), CHANNEL_VALUE_TO_STEP(1000), MODELOGIC_OR);
+    analyzeModeActivationConditions();
+    rcData[AUX2] = 1500;
+    // steps across each boundary in both directions, and jumps over several segments
+    const struct {
+        int16_t channelValue;
+        bool mode1;
+        bool mode2;
+    } frames[] = {
+        { 1000, false, false },
+        { 1299, false, false },
+        { 1300, true, false },
+        { 1499, true, false },
+        { 1500, true, true },
+        { 1699, true, true },
+        { 1700, false, true },
+        { 1699, true, true },
+        { 1499, true, false },
+        { 2100, false, true },
+        { 900, false, false },
+        { 1650, true, true },
+        { 1650, true, true },
+    };
+    for (unsigned i = 0; i < ARRAYLEN(frames); i++) {
+        rcData[AUX1] = frames[i].channelValue;
+        updateActivatedModes();
+        EXPECT_EQ(frames[i].mode1, IS_RC_MODE_ACTIVE((boxId_e)1)) << "frame " << i;
+        EXPECT_EQ(frames[i].mode2, IS_RC_MODE_ACTIVE((boxId_e)2)) << "frame " << i;
+    }
+    // the second channel keeps mode 2 on wherever the first one is
+    rcData[AUX2] = 950;
+    for (unsigned i = 0; i < ARRAYLEN(frames); i++) {
+        rcData[AUX1] = frames[i].channelValue;
+        updateActivatedModes();
+        EXPECT_EQ(frames[i].mode1, IS_RC_MODE_ACTIVE((boxId_e)1)) << "frame " << i;
+        EXPECT_TRUE(IS_RC_MODE_ACTIVE((boxId_e)2)) << "frame " << i;
+    }
+    clearModeConditions();
+}
+
+TEST_F(RcControlsModesTest, compiledModeLogicAndLinks)
+{
+    memset(&rxRuntimeConfig, 0, sizeof(rxRuntimeConfig_t));
+    rxRuntimeConfig.channelCount = MAX_SUPPORTED_RC_CHANNEL_COUNT - NON_AUX_CHANNEL_COUNT;
+    clearModeConditions();
+    // AUX1 and AUX2 high activate the first and second condition of each case
+    const struct {
+        modeLogic_e first;
+        modeLogic_e second;
+        bool firstActive;
+        bool secondActive;
+        bool active;
+    } cases[] = {
+        { MODELOGIC_OR, MODELOGIC_OR, false, false, false },
+        { MODELOGIC_OR, MODELOGIC_OR, true, false, true },
+        { MODELOGIC_OR, MODELOGIC_OR, false, true, true },
+        { MODELOGIC_OR, MODELOGIC_OR, true, true, true },
+        { MODELOGIC_AND, MODELOGIC_AND, false, false, false },
+        { MODELOGIC_AND, MODELOGIC_AND, true, false, false },
+        { MODELOGIC_AND, MODELOGIC_AND, false, true, false },
+        { MODELOGIC_AND, MODELOGIC_AND, true, true, true },
+        // an AND condition turns every condition after it into AND
+        { MODELOGIC_AND, MODELOGIC_OR, true, false, false },
+        { MODELOGIC_AND, MODELOGIC_OR, true, true, true },
+        // OR conditions before the first AND must all be inactive
+        { MODELOGIC_OR, MODELOGIC_AND, false, false, false },
+        { MODELOGIC_OR, MODELOGIC_AND, false, true, true },
+        { MODELOGIC_OR, MODELOGIC_AND, true, true, false },
+        { MODELOGIC_OR, MODELOGIC_AND, true, false, false },
+    };
+    for (unsigned i = 0; i < ARRAYLEN(cases); i++) {
+        setModeCondition(0, (boxId_e)1, 0, CHANNEL_VALUE_TO_STEP(1700), CHANNEL_VALUE_TO_STEP(2100), cases[i].first);
+        setModeCondition(1, (boxId_e)1, 1, CHANNEL_VALUE_TO_STEP(1700), CHANNEL_VALUE_TO_STEP(2100), cases[i].second);
+        // mode 3 follows mode 1
+        setModeCondition(2, (boxId_e)3, 0, 0, 0, MODELOGIC_OR);
+        modeActivationConditionsMutable(2)->linkedTo = (boxId_e)1;
+        analyzeModeActivationConditions();
+        rcData[AUX1] = cases[i].firstActive ? 2000 : 1000;
+        rcData[AUX2] = cases[i].secondActive ? 2000 : 1000;
+        updateActivatedModes();
+        EXPECT_EQ(cases[i].active, IS_RC_MODE_ACTIVE((boxId_e)1)) << "case " << i;
+        EXPECT_EQ(cases[i].active, IS_RC_MODE_ACTIVE((boxId_e)3)) << "case " << i;
+    }
+    clearModeConditions();
+}
+
 enum {
     COUNTER_QUEUE_CONFIRMATION_BEEP,
     COUNTER_CHANGE_CONTROL_RATE_PROFILE
@@ -250,20 +407,19 @@ extern "C" {
         .data = { 1 }
     };
 }
+// C++ has no array designators, everything not set here is zero
+static controlRateConfig_t testControlRateConfig(void)
+{
+    controlRateConfig_t config;
+    memset(&config, 0, sizeof(config));
+    config.rcRates[FD_ROLL] = 90;
+    config.rcRates[FD_PITCH] = 90;
+    return config;
+}
+
 class RcControlsAdjustmentsTest : public ::testing::Test {
 protected:
-    controlRateConfig_t controlRateConfig = {
-            .rcRates[FD_ROLL] = 90,
-            .rcRates[FD_PITCH] = 90,
-            .rcExpo[FD_ROLL] = 0,
-            .rcExpo[FD_PITCH] = 0,
-            .thrMid8 = 0,
-            .thrExpo8 = 0,
-            .rates = {0, 0, 0},
-            .dynThrP = 0,
-            .rcExpo[FD_YAW] = 0,
-            .tpa_breakpoint = 0
-    };
+    controlRateConfig_t controlRateConfig = testControlRateConfig();
 
     virtual void SetUp() {
         adjustmentStateMask = 0;
@@ -319,18 +475,7 @@ TEST_F(RcControlsAdjustmentsTest, processRcAdjustmentsSticksInMiddle)
 TEST_F(RcControlsAdjustmentsTest, processRcAdjustmentsWithRcRateFunctionSwitchUp)
 {
     // given
-    controlRateConfig_t controlRateConfig = {
-            .rcRates[FD_ROLL] = 90,
-            .rcRates[FD_PITCH] = 90,
-            .rcExpo[FD_ROLL] = 0,
-            .rcExpo[FD_PITCH] = 0,
-            .thrMid8 = 0,
-            .thrExpo8 = 0,
-            .rates = {0,0,0},
-            .dynThrPID = 0,
-            .rcExpo[FD_YAW] = 0,
-            .tpa_breakpoint = 0
-    };
+    controlRateConfig_t controlRateConfig = testControlRateConfig();
 
     // and
     PG_RESET(rxConfig);
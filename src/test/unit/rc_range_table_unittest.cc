@@ -0,0 +1,190 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "fc/rc_range_table.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static rcRangeTable_t table;
+static int16_t aux[MAX_AUX_CHANNEL_COUNT];
+
+static channelRange_t makeRange(uint8_t startStep, uint8_t endStep)
+{
+    channelRange_t range;
+    range.startStep = startStep;
+    range.endStep = endStep;
+    return range;
+}
+
+static void setAllChannels(int16_t value)
+{
+    for (int i = 0; i < MAX_AUX_CHANNEL_COUNT; i++) {
+        aux[i] = value;
+    }
+}
+
+// same test as isRangeActive()
+static bool referenceActive(int16_t value, const channelRange_t *range)
+{
+    if (!IS_RANGE_USABLE(range)) {
+        return false;
+    }
+    const int16_t channelValue = constrain(value, CHANNEL_RANGE_MIN, CHANNEL_RANGE_MAX - 1);
+    return channelValue >= 900 + range->startStep * 25 && channelValue < 900 + range->endStep * 25;
+}
+
+TEST(RcRangeTableUnittest, TestFirstUpdateReportsChange)
+{
+    rcRangeTableReset(&table);
+    rcRangeTableBuild(&table);
+    setAllChannels(1500);
+
+    // an empty table still has to be evaluated once after building
+    EXPECT_TRUE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(0, table.active);
+    EXPECT_FALSE(rcRangeTableUpdate(&table, aux));
+}
+
+TEST(RcRangeTableUnittest, TestSingleRange)
+{
+    rcRangeTableReset(&table);
+    const channelRange_t range = makeRange(CHANNEL_VALUE_TO_STEP(1300), CHANNEL_VALUE_TO_STEP(1700));
+    EXPECT_TRUE(rcRangeTableAdd(&table, 3, 1, &range));
+    rcRangeTableBuild(&table);
+
+    setAllChannels(1000);
+    EXPECT_TRUE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(0, table.active);
+
+    aux[1] = 1500;
+    EXPECT_TRUE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(1U << 3, table.active);
+
+    // moving inside the range does not change anything
+    aux[1] = 1550;
+    EXPECT_FALSE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(1U << 3, table.active);
+
+    // channels without ranges are ignored
+    aux[0] = 2000;
+    EXPECT_FALSE(rcRangeTableUpdate(&table, aux));
+
+    // end of the range is exclusive
+    aux[1] = 1700;
+    EXPECT_TRUE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(0, table.active);
+
+    aux[1] = 1699;
+    EXPECT_TRUE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(1U << 3, table.active);
+}
+
+TEST(RcRangeTableUnittest, TestUnusableRangesAreSkipped)
+{
+    rcRangeTableReset(&table);
+    const channelRange_t empty = makeRange(10, 10);
+    const channelRange_t reversed = makeRange(20, 10);
+    const channelRange_t valid = makeRange(0, MAX_MODE_RANGE_STEP);
+
+    EXPECT_FALSE(rcRangeTableAdd(&table, 0, 0, &empty));
+    EXPECT_FALSE(rcRangeTableAdd(&table, 1, 0, &reversed));
+    EXPECT_FALSE(rcRangeTableAdd(&table, 2, MAX_AUX_CHANNEL_COUNT, &valid));
+    EXPECT_FALSE(rcRangeTableAdd(&table, RC_RANGE_TABLE_MAX_RANGES, 0, &valid));
+    EXPECT_TRUE(rcRangeTableAdd(&table, 4, 0, &valid));
+    EXPECT_EQ(1, table.rangeCount);
+    rcRangeTableBuild(&table);
+
+    setAllChannels(875);
+    EXPECT_TRUE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(1U << 4, table.active);
+    setAllChannels(2200);
+    EXPECT_FALSE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(1U << 4, table.active);
+}
+
+TEST(RcRangeTableUnittest, TestRebuildForcesEvaluation)
+{
+    rcRangeTableReset(&table);
+    const channelRange_t range = makeRange(0, 20);
+    rcRangeTableAdd(&table, 0, 2, &range);
+    rcRangeTableBuild(&table);
+
+    setAllChannels(1000);
+    EXPECT_TRUE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(1U, table.active);
+
+    rcRangeTableReset(&table);
+    const channelRange_t other = makeRange(0, 20);
+    rcRangeTableAdd(&table, 5, 2, &other);
+    rcRangeTableBuild(&table);
+
+    EXPECT_TRUE(rcRangeTableUpdate(&table, aux));
+    EXPECT_EQ(1U << 5, table.active);
+}
+
+TEST(RcRangeTableUnittest, TestMatchesReference)
+{
+    srand(42);
+    for (int config = 0; config < 200; config++) {
+        const int rangeCount = rand() % (RC_RANGE_TABLE_MAX_RANGES + 1);
+        uint8_t channels[RC_RANGE_TABLE_MAX_RANGES];
+        channelRange_t ranges[RC_RANGE_TABLE_MAX_RANGES];
+
+        rcRangeTableReset(&table);
+        for (int i = 0; i < rangeCount; i++) {
+            channels[i] = rand() % 4;
+            ranges[i] = makeRange(rand() % (MAX_MODE_RANGE_STEP + 1), rand() % (MAX_MODE_RANGE_STEP + 1));
+            rcRangeTableAdd(&table, i, channels[i], &ranges[i]);
+        }
+        rcRangeTableBuild(&table);
+        EXPECT_LE(table.segmentCount, RC_RANGE_TABLE_SEGMENT_COUNT);
+
+        uint32_t lastActive = 0;
+        for (int frame = 0; frame < 100; frame++) {
+            for (int ch = 0; ch < 4; ch++) {
+                if (frame == 0 || rand() % 3 == 0) {
+                    aux[ch] = 850 + rand() % 1300;
+                }
+            }
+            const bool changed = rcRangeTableUpdate(&table, aux);
+
+            uint32_t expected = 0;
+            for (int i = 0; i < rangeCount; i++) {
+                if (referenceActive(aux[channels[i]], &ranges[i])) {
+                    expected |= 1U << i;
+                }
+            }
+            ASSERT_EQ(expected, table.active);
+            if (frame > 0 && !changed) {
+                ASSERT_EQ(lastActive, expected);
+            }
+            lastActive = expected;
+        }
+    }
+}
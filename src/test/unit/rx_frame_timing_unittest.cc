@@ -0,0 +1,114 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/time.h"
+
+    #include "rx/rx_frame_timing.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define CRSF_500HZ_US 2000
+
+static rxFrameTiming_t timing;
+
+TEST(RxFrameTimingUnittest, TestFirstIntervalNeedsTwoFrames)
+{
+    rxFrameTimingInit(&timing);
+
+    EXPECT_FALSE(rxFrameTimingUpdate(&timing, 1000));
+    EXPECT_EQ(0, timing.frameDeltaUs);
+
+    EXPECT_TRUE(rxFrameTimingUpdate(&timing, 1000 + CRSF_500HZ_US));
+    EXPECT_EQ(CRSF_500HZ_US, timing.frameDeltaUs);
+    EXPECT_EQ(CRSF_500HZ_US, rxFrameTimingAverageUs(&timing));
+    EXPECT_EQ(0, rxFrameTimingJitterUs(&timing));
+    EXPECT_EQ(2, timing.frameCount);
+}
+
+TEST(RxFrameTimingUnittest, TestSteadyFramesHaveNoJitter)
+{
+    rxFrameTimingInit(&timing);
+
+    for (int i = 0; i < 100; i++) {
+        rxFrameTimingUpdate(&timing, 5000 + i * CRSF_500HZ_US);
+    }
+    EXPECT_EQ(CRSF_500HZ_US, timing.frameDeltaUs);
+    EXPECT_EQ(CRSF_500HZ_US, rxFrameTimingAverageUs(&timing));
+    EXPECT_EQ(0, rxFrameTimingJitterUs(&timing));
+    EXPECT_EQ(0, timing.maxJitterUs);
+}
+
+TEST(RxFrameTimingUnittest, TestJitteredFramesReportMeanDeviation)
+{
+    rxFrameTimingInit(&timing);
+
+    // every other frame arrives 100us late, so the intervals alternate 2100/1900us
+    for (int i = 0; i < 200; i++) {
+        rxFrameTimingUpdate(&timing, 5000 + i * CRSF_500HZ_US + (i & 1) * 100);
+    }
+    EXPECT_NEAR(CRSF_500HZ_US, rxFrameTimingAverageUs(&timing), 10);
+    EXPECT_NEAR(100, rxFrameTimingJitterUs(&timing), 10);
+    EXPECT_NEAR(200, timing.maxJitterUs, 10);
+}
+
+TEST(RxFrameTimingUnittest, TestRepeatedFrameIsIgnored)
+{
+    rxFrameTimingInit(&timing);
+
+    rxFrameTimingUpdate(&timing, 1000);
+    rxFrameTimingUpdate(&timing, 1000 + CRSF_500HZ_US);
+    // the same frame reported again must not count as a zero interval
+    EXPECT_FALSE(rxFrameTimingUpdate(&timing, 1000 + CRSF_500HZ_US));
+    EXPECT_EQ(CRSF_500HZ_US, timing.frameDeltaUs);
+    EXPECT_EQ(2, timing.frameCount);
+}
+
+TEST(RxFrameTimingUnittest, TestSignalGapRestarts)
+{
+    rxFrameTimingInit(&timing);
+
+    for (int i = 0; i < 10; i++) {
+        rxFrameTimingUpdate(&timing, i * CRSF_500HZ_US);
+    }
+    const timeUs_t lastFrameUs = 9 * CRSF_500HZ_US;
+    EXPECT_FALSE(rxFrameTimingUpdate(&timing, lastFrameUs + RX_FRAME_TIMING_MAX_GAP_US + 1));
+    EXPECT_EQ(0, timing.frameDeltaUs);
+    EXPECT_EQ(1, timing.frameCount);
+    EXPECT_EQ(0, timing.maxJitterUs);
+
+    EXPECT_TRUE(rxFrameTimingUpdate(&timing, lastFrameUs + RX_FRAME_TIMING_MAX_GAP_US + 1 + 4000));
+    EXPECT_EQ(4000, rxFrameTimingAverageUs(&timing));
+}
+
+TEST(RxFrameTimingUnittest, TestTimerWrapAround)
+{
+    rxFrameTimingInit(&timing);
+
+    const timeUs_t start = UINT32_MAX - CRSF_500HZ_US / 2;
+    rxFrameTimingUpdate(&timing, start);
+    EXPECT_TRUE(rxFrameTimingUpdate(&timing, start + CRSF_500HZ_US));
+    EXPECT_EQ(CRSF_500HZ_US, timing.frameDeltaUs);
+}
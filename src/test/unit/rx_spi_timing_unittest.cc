@@ -0,0 +1,127 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/time.h"
+
+    #include "rx/rx_spi_timing.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// FrSky X: 9ms frames, hop 3.7ms after a packet, 5.3ms from a hop to the next packet
+#define FRAME_US        9000
+#define HOP_OFFSET_US   3700
+#define RECEIVE_DELAY_US 5300
+
+static rxSpiSlotTimer_t timer;
+
+TEST(RxSpiTimingUnittest, TestDeadlineFromPacketArrival)
+{
+    rxSpiSlotTimerInit(&timer, FRAME_US);
+    rxSpiSlotTimerSync(&timer, 10000);
+
+    EXPECT_FALSE(rxSpiSlotTimerDue(&timer, HOP_OFFSET_US, 13699));
+    EXPECT_EQ(-1, rxSpiSlotTimerLateness(&timer, HOP_OFFSET_US, 13699));
+    EXPECT_TRUE(rxSpiSlotTimerDue(&timer, HOP_OFFSET_US, 13700));
+    EXPECT_EQ(250, rxSpiSlotTimerLateness(&timer, HOP_OFFSET_US, 13950));
+}
+
+TEST(RxSpiTimingUnittest, TestLatePollsDoNotDrift)
+{
+    rxSpiSlotTimerInit(&timer, FRAME_US);
+    rxSpiSlotTimerSync(&timer, 10000);
+
+    // hop polled 2ms late
+    EXPECT_EQ(1, rxSpiSlotTimerAdvance(&timer, HOP_OFFSET_US, 15700));
+    EXPECT_EQ(13700, timer.anchorUs);
+
+    // the packet is missed, every following hop is polled late as well
+    for (int i = 1; i <= 20; i++) {
+        EXPECT_EQ(1, rxSpiSlotTimerAdvance(&timer, RECEIVE_DELAY_US + HOP_OFFSET_US, timer.anchorUs + FRAME_US + 1500));
+        EXPECT_EQ((timeUs_t)(13700 + i * FRAME_US), timer.anchorUs);
+    }
+}
+
+TEST(RxSpiTimingUnittest, TestPacketResynchronises)
+{
+    rxSpiSlotTimerInit(&timer, FRAME_US);
+    rxSpiSlotTimerSync(&timer, 10000);
+    rxSpiSlotTimerAdvance(&timer, HOP_OFFSET_US, 14000);
+
+    // the transmitter clock runs slightly slow, the packet anchors the next slot
+    rxSpiSlotTimerSync(&timer, 19040);
+    EXPECT_FALSE(rxSpiSlotTimerDue(&timer, HOP_OFFSET_US, 22700));
+    EXPECT_TRUE(rxSpiSlotTimerDue(&timer, HOP_OFFSET_US, 22740));
+}
+
+TEST(RxSpiTimingUnittest, TestStalledPollSkipsSlots)
+{
+    rxSpiSlotTimerInit(&timer, FRAME_US);
+    rxSpiSlotTimerSync(&timer, 10000);
+
+    // hop deadline at 13700, polled 20ms later: two more hops went by
+    EXPECT_EQ(3, rxSpiSlotTimerAdvance(&timer, HOP_OFFSET_US, 33700));
+    EXPECT_EQ(13700u + 2 * FRAME_US, timer.anchorUs);
+
+    // next deadline is back on the schedule of the transmitter
+    EXPECT_FALSE(rxSpiSlotTimerDue(&timer, FRAME_US, 40699));
+    EXPECT_TRUE(rxSpiSlotTimerDue(&timer, FRAME_US, 40700));
+}
+
+TEST(RxSpiTimingUnittest, TestLongStallIsClamped)
+{
+    rxSpiSlotTimerInit(&timer, FRAME_US);
+    rxSpiSlotTimerSync(&timer, 0);
+
+    EXPECT_EQ(UINT8_MAX, rxSpiSlotTimerAdvance(&timer, 0, 10 * 1000 * 1000));
+}
+
+TEST(RxSpiTimingUnittest, TestTimerWraps)
+{
+    rxSpiSlotTimerInit(&timer, FRAME_US);
+    rxSpiSlotTimerSync(&timer, UINT32_MAX - 1000);
+
+    EXPECT_FALSE(rxSpiSlotTimerDue(&timer, HOP_OFFSET_US, UINT32_MAX));
+    EXPECT_TRUE(rxSpiSlotTimerDue(&timer, HOP_OFFSET_US, 2699));
+    EXPECT_EQ(1, rxSpiSlotTimerAdvance(&timer, HOP_OFFSET_US, 3000));
+    EXPECT_EQ(2699u, timer.anchorUs);
+}
+
+TEST(RxSpiTimingUnittest, TestCompareDelay)
+{
+    rxSpiSlotTimerInit(&timer, FRAME_US);
+    rxSpiSlotTimerSync(&timer, 10000);
+
+    // the hop compare is set from the packet, wherever the caller is
+    EXPECT_EQ(HOP_OFFSET_US, rxSpiSlotTimerDelay(&timer, HOP_OFFSET_US, 10000));
+    EXPECT_EQ(HOP_OFFSET_US - 1200, rxSpiSlotTimerDelay(&timer, HOP_OFFSET_US, 11200));
+
+    // a deadline that went by fires straight away
+    EXPECT_EQ(5, rxSpiSlotTimerDelay(&timer, HOP_OFFSET_US, 13699));
+    EXPECT_EQ(5, rxSpiSlotTimerDelay(&timer, HOP_OFFSET_US, 20000));
+
+    // and one past the reach of the 16 bit compare is cut short
+    EXPECT_EQ(0x10000 - 1000, rxSpiSlotTimerDelay(&timer, 100000, 10000));
+}
@@ -0,0 +1,108 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "sensors/gyro_spectrum.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static gyroSpectrumMap_t map;
+static float fftPower[GYRO_SPECTRUM_MAX_FREQ_BINS];
+
+static void addWindow(uint8_t throttlePercent, float preFilter, float postFilter)
+{
+    for (int i = 0; i < GYRO_SPECTRUM_MAX_FREQ_BINS; i++) {
+        fftPower[i] = preFilter;
+    }
+    gyroSpectrumMapAccumulate(&map, throttlePercent, GYRO_SPECTRUM_PRE_FILTER, fftPower);
+    for (int i = 0; i < GYRO_SPECTRUM_MAX_FREQ_BINS; i++) {
+        fftPower[i] = postFilter;
+    }
+    gyroSpectrumMapAccumulate(&map, throttlePercent, GYRO_SPECTRUM_POST_FILTER, fftPower);
+    gyroSpectrumMapCommit(&map, throttlePercent);
+}
+
+TEST(GyroSpectrumTest, BinsRoundedToPowerOfTwo)
+{
+    gyroSpectrumMapInit(&map, 48, 10);
+    EXPECT_EQ(32, map.freqBins);
+    gyroSpectrumMapInit(&map, 200, 0);
+    EXPECT_EQ(GYRO_SPECTRUM_MAX_FREQ_BINS, map.freqBins);
+    EXPECT_EQ(1, map.throttleBins);
+    gyroSpectrumMapInit(&map, 1, 50);
+    EXPECT_EQ(GYRO_SPECTRUM_MIN_FREQ_BINS, map.freqBins);
+    EXPECT_EQ(GYRO_SPECTRUM_MAX_THROTTLE_BINS, map.throttleBins);
+}
+
+TEST(GyroSpectrumTest, WindowsLandInThrottleRows)
+{
+    gyroSpectrumMapInit(&map, 64, 4);
+    addWindow(0, 1.0f, 1.0f);
+    addWindow(24, 1.0f, 1.0f);
+    addWindow(25, 1.0f, 1.0f);
+    addWindow(100, 1.0f, 1.0f);
+    EXPECT_EQ(2, map.windows[0]);
+    EXPECT_EQ(1, map.windows[1]);
+    EXPECT_EQ(0, map.windows[2]);
+    EXPECT_EQ(1, map.windows[3]);
+}
+
+TEST(GyroSpectrumTest, MergedBinsSumPower)
+{
+    gyroSpectrumMapInit(&map, 16, 1);
+    for (int i = 0; i < GYRO_SPECTRUM_MAX_FREQ_BINS; i++) {
+        fftPower[i] = i < 4 ? 0.25f : 0.0f;
+    }
+    fftPower[GYRO_SPECTRUM_MAX_FREQ_BINS - 1] = 2.0f;
+    gyroSpectrumMapAccumulate(&map, 50, GYRO_SPECTRUM_PRE_FILTER, fftPower);
+    gyroSpectrumMapCommit(&map, 50);
+    EXPECT_FLOAT_EQ(1.0f, map.power[0][GYRO_SPECTRUM_PRE_FILTER][0]);
+    EXPECT_FLOAT_EQ(0.0f, map.power[0][GYRO_SPECTRUM_PRE_FILTER][1]);
+    EXPECT_FLOAT_EQ(2.0f, map.power[0][GYRO_SPECTRUM_PRE_FILTER][15]);
+}
+
+TEST(GyroSpectrumTest, AveragesWindows)
+{
+    gyroSpectrumMapInit(&map, 64, 1);
+    addWindow(50, 1.0f, 0.1f);
+    addWindow(50, 3.0f, 0.3f);
+    EXPECT_FLOAT_EQ(2.0f, map.power[0][GYRO_SPECTRUM_PRE_FILTER][10]);
+    EXPECT_FLOAT_EQ(0.2f, map.power[0][GYRO_SPECTRUM_POST_FILTER][10]);
+
+    // turns into a moving average, so later flights still show up
+    for (int i = 0; i < 4 * GYRO_SPECTRUM_AVERAGE_WINDOWS; i++) {
+        addWindow(50, 100.0f, 1.0f);
+    }
+    EXPECT_NEAR(100.0f, map.power[0][GYRO_SPECTRUM_PRE_FILTER][10], 2.0f);
+}
+
+TEST(GyroSpectrumTest, LevelInHalfDecibels)
+{
+    gyroSpectrumMapInit(&map, 64, 1);
+    addWindow(0, 1.0f, 1e-6f);
+    EXPECT_EQ(80, gyroSpectrumMapLevel(&map, 0, GYRO_SPECTRUM_PRE_FILTER, 0));
+    EXPECT_EQ(0, gyroSpectrumMapLevel(&map, 0, GYRO_SPECTRUM_POST_FILTER, 0));
+    gyroSpectrumMapInit(&map, 64, 1);
+    addWindow(0, 100.0f, 1e9f);
+    EXPECT_EQ(120, gyroSpectrumMapLevel(&map, 0, GYRO_SPECTRUM_PRE_FILTER, 0));
+    EXPECT_EQ(255, gyroSpectrumMapLevel(&map, 0, GYRO_SPECTRUM_POST_FILTER, 0));
+}
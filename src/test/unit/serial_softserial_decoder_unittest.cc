@@ -0,0 +1,163 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "drivers/serial_softserial_decoder.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BIT_TICKS 729 // 84MHz timer at 115200 baud
+
+static softSerialDecoder_t decoder;
+static uint8_t received[64];
+static int receivedCount;
+
+static void rxByte(uint8_t byte, void *data)
+{
+    UNUSED(data);
+    received[receivedCount++] = byte;
+}
+
+// records the edges of one byte sent from start, bitTicks may differ from the decoder to simulate clock error
+static uint32_t sendByte(uint32_t start, uint8_t byte, uint32_t bitTicks)
+{
+    const uint16_t frame = (1 << 9) | (byte << 1);
+    uint8_t level = 1;
+    for (int bit = 0; bit < SOFTSERIAL_FRAME_BITS; bit++) {
+        const uint8_t bitLevel = (frame >> bit) & 1;
+        if (bitLevel != level) {
+            softSerialDecoderPushEdge(&decoder, start + bit * bitTicks, bitLevel);
+            level = bitLevel;
+        }
+    }
+    return start + SOFTSERIAL_FRAME_BITS * bitTicks;
+}
+
+static void resetDecoder(void)
+{
+    softSerialDecoderInit(&decoder, BIT_TICKS);
+    receivedCount = 0;
+}
+
+TEST(SoftSerialDecoderUnittest, TestSingleByte)
+{
+    resetDecoder();
+    const uint32_t end = sendByte(1000, 0x55, BIT_TICKS);
+
+    // the stop bit has not been sampled yet
+    EXPECT_EQ(0, softSerialDecoderProcess(&decoder, end - BIT_TICKS, rxByte, NULL));
+    EXPECT_EQ(1, softSerialDecoderProcess(&decoder, end, rxByte, NULL));
+    EXPECT_EQ(1, receivedCount);
+    EXPECT_EQ(0x55, received[0]);
+    EXPECT_EQ(0, decoder.framingErrors);
+}
+
+TEST(SoftSerialDecoderUnittest, TestByteEndingWithHighBits)
+{
+    resetDecoder();
+    // 0xF0 has no edge after its fifth data bit
+    const uint32_t end = sendByte(0, 0xF0, BIT_TICKS);
+    EXPECT_EQ(1, softSerialDecoderProcess(&decoder, end + 5 * BIT_TICKS, rxByte, NULL));
+    EXPECT_EQ(0xF0, received[0]);
+}
+
+TEST(SoftSerialDecoderUnittest, TestAllByteValuesBackToBack)
+{
+    resetDecoder();
+    uint32_t time = 12345;
+    for (int i = 0; i < 256; i++) {
+        time = sendByte(time, i, BIT_TICKS);
+        if (i % 8 == 7) {
+            // decode in batches like the task does
+            softSerialDecoderProcess(&decoder, time, rxByte, NULL);
+            for (int j = 0; j < receivedCount; j++) {
+                EXPECT_EQ(i - 7 + j, received[j]);
+            }
+            EXPECT_EQ(8, receivedCount);
+            receivedCount = 0;
+        }
+    }
+    EXPECT_EQ(0, decoder.framingErrors);
+    EXPECT_EQ(0, decoder.edgeOverruns);
+}
+
+TEST(SoftSerialDecoderUnittest, TestClockError)
+{
+    // a transmitter 3% off either way still lands every sample in its bit
+    const uint32_t bitTicks[] = { BIT_TICKS * 97 / 100, BIT_TICKS * 103 / 100 };
+    for (unsigned t = 0; t < sizeof(bitTicks) / sizeof(bitTicks[0]); t++) {
+        resetDecoder();
+        uint32_t time = 0;
+        const uint8_t bytes[] = { 0x00, 0xFF, 0xA5, 0x3C, 0x81 };
+        for (unsigned i = 0; i < sizeof(bytes); i++) {
+            time = sendByte(time, bytes[i], bitTicks[t]);
+        }
+        softSerialDecoderProcess(&decoder, time + SOFTSERIAL_FRAME_BITS * BIT_TICKS, rxByte, NULL);
+        ASSERT_EQ((int)sizeof(bytes), receivedCount);
+        EXPECT_EQ(0, memcmp(bytes, received, sizeof(bytes)));
+    }
+}
+
+TEST(SoftSerialDecoderUnittest, TestTimeWrap)
+{
+    resetDecoder();
+    const uint32_t end = sendByte(UINT32_MAX - 4 * BIT_TICKS, 0x3A, BIT_TICKS);
+    EXPECT_EQ(1, softSerialDecoderProcess(&decoder, end, rxByte, NULL));
+    EXPECT_EQ(0x3A, received[0]);
+}
+
+TEST(SoftSerialDecoderUnittest, TestGlitchIsNotAStartBit)
+{
+    resetDecoder();
+    softSerialDecoderPushEdge(&decoder, 1000, 0);
+    softSerialDecoderPushEdge(&decoder, 1000 + BIT_TICKS / 4, 1);
+    const uint32_t end = sendByte(1000 + 2 * BIT_TICKS, 0x42, BIT_TICKS);
+    EXPECT_EQ(1, softSerialDecoderProcess(&decoder, end, rxByte, NULL));
+    EXPECT_EQ(0x42, received[0]);
+    EXPECT_EQ(1, decoder.framingErrors);
+}
+
+TEST(SoftSerialDecoderUnittest, TestMissingStopBit)
+{
+    resetDecoder();
+    // break condition: the line stays low past the stop bit
+    softSerialDecoderPushEdge(&decoder, 0, 0);
+    softSerialDecoderPushEdge(&decoder, 15 * BIT_TICKS, 1);
+    EXPECT_EQ(0, softSerialDecoderProcess(&decoder, 20 * BIT_TICKS, rxByte, NULL));
+    EXPECT_EQ(1, decoder.framingErrors);
+
+    const uint32_t end = sendByte(20 * BIT_TICKS, 0x7E, BIT_TICKS);
+    EXPECT_EQ(1, softSerialDecoderProcess(&decoder, end, rxByte, NULL));
+    EXPECT_EQ(0x7E, received[0]);
+}
+
+TEST(SoftSerialDecoderUnittest, TestEdgeOverrun)
+{
+    resetDecoder();
+    for (int i = 0; i < SOFTSERIAL_EDGE_BUFFER_SIZE; i++) {
+        softSerialDecoderPushEdge(&decoder, i * BIT_TICKS, i & 1);
+    }
+    // one slot is kept free to tell a full ring from an empty one
+    EXPECT_EQ(1, decoder.edgeOverruns);
+}
@@ -0,0 +1,207 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "flight/servos.h"
+    #include "flight/servos_table.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FORWARDING_DISABLED 0xFF
+
+static servoTable_t table;
+static servoMixer_t rules[MAX_SERVO_RULES];
+static servoParam_t params[MAX_SUPPORTED_SERVOS];
+static int16_t rcData[18];
+
+// the servo mixer as it was evaluated before the rules were compiled
+static int16_t referenceCurrentOutput[MAX_SERVO_RULES];
+
+static void referenceMixer(const servoMixer_t *mixerRules, int ruleCount, const int16_t *input, uint8_t activeBoxes, uint8_t channelCount, int16_t *servo)
+{
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        servo[i] = 0;
+    }
+    for (int i = 0; i < ruleCount; i++) {
+        if (mixerRules[i].box == 0 || (activeBoxes & (1 << (mixerRules[i].box - 1)))) {
+            uint8_t target = mixerRules[i].targetChannel;
+            uint8_t from = mixerRules[i].inputSource;
+            uint16_t servo_width = params[target].max - params[target].min;
+            int16_t min = mixerRules[i].min * servo_width / 100 - servo_width / 2;
+            int16_t max = mixerRules[i].max * servo_width / 100 - servo_width / 2;
+            if (mixerRules[i].speed == 0)
+                referenceCurrentOutput[i] = input[from];
+            else {
+                if (referenceCurrentOutput[i] < input[from])
+                    referenceCurrentOutput[i] = constrain(referenceCurrentOutput[i] + mixerRules[i].speed, referenceCurrentOutput[i], input[from]);
+                else if (referenceCurrentOutput[i] > input[from])
+                    referenceCurrentOutput[i] = constrain(referenceCurrentOutput[i] - mixerRules[i].speed, input[from], referenceCurrentOutput[i]);
+            }
+            const int direction = (params[target].reversedSources & (1 << from)) ? -1 : 1;
+            servo[target] += direction * constrain(((int32_t)referenceCurrentOutput[i] * mixerRules[i].rate) / 100, min, max);
+        } else {
+            referenceCurrentOutput[i] = 0;
+        }
+    }
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        servo[i] = ((int32_t)params[i].rate * servo[i]) / 100L;
+        const uint8_t channelToForwardFrom = params[i].forwardFromChannel;
+        if (channelToForwardFrom != FORWARDING_DISABLED && channelToForwardFrom < channelCount) {
+            servo[i] += rcData[channelToForwardFrom];
+        } else {
+            servo[i] += params[i].middle;
+        }
+    }
+}
+
+static int randomRange(int low, int high)
+{
+    return low + rand() % (high - low + 1);
+}
+
+static void randomParams(void)
+{
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        params[i].min = randomRange(750, 1500);
+        params[i].max = randomRange(1500, 2250);
+        params[i].middle = randomRange(params[i].min, params[i].max);
+        params[i].rate = randomRange(-125, 125);
+        params[i].forwardFromChannel = rand() % 4 ? FORWARDING_DISABLED : randomRange(0, 20);
+        params[i].reversedSources = rand() & ((1 << INPUT_SOURCE_COUNT) - 1);
+    }
+}
+
+static void randomRules(int ruleCount)
+{
+    for (int i = 0; i < ruleCount; i++) {
+        rules[i].targetChannel = randomRange(0, MAX_SUPPORTED_SERVOS - 1);
+        rules[i].inputSource = randomRange(0, INPUT_SOURCE_COUNT - 1);
+        rules[i].rate = randomRange(-125, 125);
+        rules[i].speed = rand() % 2 ? 0 : randomRange(1, MAX_SERVO_SPEED);
+        rules[i].min = randomRange(0, 100);
+        rules[i].max = randomRange(0, 100);
+        rules[i].box = randomRange(0, MAX_SERVO_BOXES);
+    }
+}
+
+static void expectSameOutput(int ruleCount, int steps)
+{
+    int16_t input[INPUT_SOURCE_COUNT];
+    int16_t expected[MAX_SUPPORTED_SERVOS];
+    int16_t actual[MAX_SUPPORTED_SERVOS];
+    for (int step = 0; step < steps; step++) {
+        for (int i = 0; i < INPUT_SOURCE_COUNT; i++) {
+            input[i] = randomRange(-600, 600);
+        }
+        for (unsigned i = 0; i < ARRAYLEN(rcData); i++) {
+            rcData[i] = randomRange(900, 2100);
+        }
+        const uint8_t activeBoxes = rand() & ((1 << MAX_SERVO_BOXES) - 1);
+        const uint8_t channelCount = randomRange(4, 18);
+        referenceMixer(rules, ruleCount, input, activeBoxes, channelCount, expected);
+        servoTableApply(&table, input, activeBoxes, rcData, channelCount, actual);
+        for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+            ASSERT_EQ(expected[i], actual[i]) << "servo " << i << " step " << step;
+        }
+    }
+}
+
+TEST(ServosTableUnittest, TestMatchesReferenceMixer)
+{
+    srand(1);
+    for (int run = 0; run < 200; run++) {
+        const int ruleCount = randomRange(0, MAX_SERVO_RULES);
+        memset(&table, 0, sizeof(table));
+        memset(referenceCurrentOutput, 0, sizeof(referenceCurrentOutput));
+        randomParams();
+        randomRules(ruleCount);
+        servoTableCompile(&table, rules, ruleCount, params);
+        expectSameOutput(ruleCount, 50);
+    }
+}
+
+TEST(ServosTableUnittest, TestSpeedStateSurvivesRecompile)
+{
+    srand(2);
+    memset(&table, 0, sizeof(table));
+    memset(referenceCurrentOutput, 0, sizeof(referenceCurrentOutput));
+    randomParams();
+    randomRules(MAX_SERVO_RULES);
+    for (int i = 0; i < MAX_SERVO_RULES; i++) {
+        rules[i].speed = 5;
+    }
+    servoTableCompile(&table, rules, MAX_SERVO_RULES, params);
+    expectSameOutput(MAX_SERVO_RULES, 20);
+
+    // servo parameters changed from the CLI while the rules are slewing
+    randomParams();
+    servoTableCompile(&table, rules, MAX_SERVO_RULES, params);
+    expectSameOutput(MAX_SERVO_RULES, 20);
+}
+
+TEST(ServosTableUnittest, TestPrecomputedRule)
+{
+    memset(params, 0, sizeof(params));
+    params[SERVO_RUDDER].min = 1000;
+    params[SERVO_RUDDER].max = 2000;
+    params[SERVO_RUDDER].reversedSources = 1 << INPUT_STABILIZED_YAW;
+    rules[0] = { SERVO_RUDDER, INPUT_STABILIZED_YAW, 100, 0, 0, 100, 2 };
+    servoTableCompile(&table, rules, 1, params);
+
+    EXPECT_EQ(1, table.ruleCount);
+    EXPECT_EQ(1 << INPUT_STABILIZED_YAW, table.usedInputs);
+    EXPECT_EQ(-500, table.rules[0].min);
+    EXPECT_EQ(500, table.rules[0].max);
+    EXPECT_EQ(-1, table.rules[0].sign);
+    EXPECT_EQ(1 << 1, table.rules[0].boxMask);
+}
+
+TEST(ServosTableUnittest, TestInvalidRulesStayInactive)
+{
+    memset(&table, 0, sizeof(table));
+    memset(params, 0, sizeof(params));
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        params[i].rate = 100;
+        params[i].forwardFromChannel = FORWARDING_DISABLED;
+    }
+    rules[0] = { MAX_SUPPORTED_SERVOS, INPUT_RC_ROLL, 100, 0, 0, 100, 0 };
+    rules[1] = { 0, INPUT_SOURCE_COUNT, 100, 0, 0, 100, 0 };
+    rules[2] = { 0, INPUT_RC_ROLL, 100, 0, 0, 100, MAX_SERVO_BOXES + 1 };
+    servoTableCompile(&table, rules, 3, params);
+    EXPECT_EQ(0, table.usedInputs);
+
+    int16_t input[INPUT_SOURCE_COUNT];
+    for (int i = 0; i < INPUT_SOURCE_COUNT; i++) {
+        input[i] = 400;
+    }
+    int16_t actual[MAX_SUPPORTED_SERVOS];
+    servoTableApply(&table, input, 0xFF, rcData, 18, actual);
+    for (int i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        EXPECT_EQ(0, actual[i]);
+    }
+}
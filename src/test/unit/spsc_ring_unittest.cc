@@ -0,0 +1,145 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "common/spsc_ring.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define RING_SIZE 16
+
+static spscRing_t ring;
+static uint8_t storage[RING_SIZE];
+
+TEST(SpscRingUnittest, TestEmpty)
+{
+    spscRingInit(&ring, storage, RING_SIZE);
+    EXPECT_EQ(0, spscRingUsed(&ring));
+    EXPECT_EQ(RING_SIZE, spscRingFree(&ring));
+
+    uint8_t ch;
+    EXPECT_FALSE(spscRingGet(&ring, &ch));
+
+    const uint8_t *segment[2];
+    uint32_t segmentLen[2];
+    EXPECT_EQ(0, spscRingPeek(&ring, segment, segmentLen));
+}
+
+TEST(SpscRingUnittest, TestPutGet)
+{
+    spscRingInit(&ring, storage, RING_SIZE);
+    for (int i = 0; i < RING_SIZE; i++) {
+        EXPECT_TRUE(spscRingPut(&ring, i));
+    }
+    // full ring refuses more
+    EXPECT_FALSE(spscRingPut(&ring, 0xAA));
+    EXPECT_EQ(0, spscRingFree(&ring));
+
+    uint8_t ch;
+    for (int i = 0; i < RING_SIZE; i++) {
+        EXPECT_TRUE(spscRingGet(&ring, &ch));
+        EXPECT_EQ(i, ch);
+    }
+    EXPECT_FALSE(spscRingGet(&ring, &ch));
+}
+
+TEST(SpscRingUnittest, TestWriteTruncates)
+{
+    uint8_t data[RING_SIZE + 4];
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+    spscRingInit(&ring, storage, RING_SIZE);
+    EXPECT_EQ(10, spscRingWrite(&ring, data, 10));
+    EXPECT_EQ(RING_SIZE - 10, spscRingWrite(&ring, data + 10, 10));
+    EXPECT_EQ(RING_SIZE, spscRingUsed(&ring));
+
+    uint8_t out[RING_SIZE + 4];
+    EXPECT_EQ(RING_SIZE, spscRingRead(&ring, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(data, out, RING_SIZE));
+}
+
+TEST(SpscRingUnittest, TestWrapAround)
+{
+    uint8_t data[12];
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = 0x40 + i;
+    }
+    spscRingInit(&ring, storage, RING_SIZE);
+    uint8_t out[12];
+    // move the indexes close to the end of the storage
+    spscRingWrite(&ring, data, 10);
+    spscRingRead(&ring, out, 10);
+
+    EXPECT_EQ(12, spscRingWrite(&ring, data, 12));
+
+    const uint8_t *segment[2];
+    uint32_t segmentLen[2];
+    ASSERT_EQ(2, spscRingPeek(&ring, segment, segmentLen));
+    EXPECT_EQ(&storage[10], segment[0]);
+    EXPECT_EQ(6, segmentLen[0]);
+    EXPECT_EQ(storage, segment[1]);
+    EXPECT_EQ(6, segmentLen[1]);
+    EXPECT_EQ(0, memcmp(data, segment[0], 6));
+    EXPECT_EQ(0, memcmp(data + 6, segment[1], 6));
+
+    EXPECT_EQ(12, spscRingRead(&ring, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(data, out, sizeof(data)));
+}
+
+TEST(SpscRingUnittest, TestPartialConsume)
+{
+    uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    spscRingInit(&ring, storage, RING_SIZE);
+    spscRingWrite(&ring, data, sizeof(data));
+
+    // a short writev only releases what went out
+    spscRingConsume(&ring, 3);
+    EXPECT_EQ(5, spscRingUsed(&ring));
+
+    const uint8_t *segment[2];
+    uint32_t segmentLen[2];
+    ASSERT_EQ(1, spscRingPeek(&ring, segment, segmentLen));
+    EXPECT_EQ(4, segment[0][0]);
+    EXPECT_EQ(5, segmentLen[0]);
+
+    spscRingDiscard(&ring);
+    EXPECT_EQ(0, spscRingUsed(&ring));
+    EXPECT_EQ(RING_SIZE, spscRingFree(&ring));
+}
+
+TEST(SpscRingUnittest, TestIndexOverflow)
+{
+    spscRingInit(&ring, storage, RING_SIZE);
+    // free running indexes just before they wrap
+    ring.head = ring.tail = UINT32_MAX - 2;
+
+    uint8_t data[6] = { 1, 2, 3, 4, 5, 6 };
+    EXPECT_EQ(6, spscRingWrite(&ring, data, sizeof(data)));
+    EXPECT_EQ(6, spscRingUsed(&ring));
+    EXPECT_EQ(RING_SIZE - 6, spscRingFree(&ring));
+
+    uint8_t out[6];
+    EXPECT_EQ(6, spscRingRead(&ring, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(data, out, sizeof(data)));
+}
@@ -0,0 +1,283 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "build/debug.h"
+    #include "io/vtx_transport.h"
+
+    uint8_t debugMode = 0;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Simulated VTX: answers every frame with its command code after a fixed delay,
+// unless it is told to ignore a number of frames first.
+#define SIM_MAX_FRAMES 32
+
+static struct {
+    timeMs_t now;
+    timeMs_t replyDelayMs;
+    int ignoreFrames;
+    bool replyPending;
+    uint8_t replyCode;
+    timeMs_t replyAtMs;
+    int frameCount;
+    uint8_t frames[SIM_MAX_FRAMES][2];  // command code and parameter of every frame on the wire
+} simVtx;
+
+static void simVtxSend(const uint8_t *frame, uint8_t len)
+{
+    EXPECT_EQ(2, len);
+    if (simVtx.frameCount < SIM_MAX_FRAMES) {
+        memcpy(simVtx.frames[simVtx.frameCount], frame, 2);
+    }
+    simVtx.frameCount++;
+    if (simVtx.ignoreFrames > 0) {
+        simVtx.ignoreFrames--;
+        return;
+    }
+    simVtx.replyPending = true;
+    simVtx.replyCode = frame[0];
+    simVtx.replyAtMs = simVtx.now + simVtx.replyDelayMs;
+}
+
+static const vtxTransportPolicy_t simPolicy = {
+    .send = simVtxSend,
+    .replyMatches = NULL,
+    .timeoutMs = 100,
+    .guardMs = 0,
+    .maxRetries = 2,
+    .queueDepth = 4,
+};
+
+static vtxTransport_t transport;
+
+static void resetSim(timeMs_t replyDelayMs)
+{
+    memset(&simVtx, 0, sizeof(simVtx));
+    simVtx.replyDelayMs = replyDelayMs;
+    vtxTransportInit(&transport, &simPolicy);
+}
+
+static void queueCmd(vtxCommandKind_e kind, uint8_t code, uint8_t param, bool expectReply = true)
+{
+    const uint8_t frame[2] = { code, param };
+    EXPECT_TRUE(vtxTransportQueue(&transport, kind, frame, sizeof(frame), expectReply ? code : VTX_TRANSPORT_REPLY_NONE));
+}
+
+// runs the transport like the vtx task would, in steps of stepMs
+static void runFor(timeMs_t durationMs, timeMs_t stepMs = 10)
+{
+    const timeMs_t end = simVtx.now + durationMs;
+    while (simVtx.now < end) {
+        if (simVtx.replyPending && simVtx.now >= simVtx.replyAtMs) {
+            simVtx.replyPending = false;
+            vtxTransportReply(&transport, simVtx.replyCode, simVtx.now);
+        }
+        vtxTransportProcess(&transport, simVtx.now);
+        simVtx.now += stepMs;
+    }
+}
+
+TEST(VtxTransportTest, SendsCommandsInOrder)
+{
+    resetSim(20);
+    queueCmd(VTX_CMD_FREQUENCY, 'F', 1);
+    queueCmd(VTX_CMD_POWER, 'P', 2);
+    queueCmd(VTX_CMD_MODE, 'M', 3);
+
+    runFor(500);
+
+    EXPECT_EQ(3, simVtx.frameCount);
+    EXPECT_EQ('F', simVtx.frames[0][0]);
+    EXPECT_EQ('P', simVtx.frames[1][0]);
+    EXPECT_EQ('M', simVtx.frames[2][0]);
+    EXPECT_EQ(3, transport.stats.acked);
+    EXPECT_TRUE(vtxTransportIsIdle(&transport));
+}
+
+TEST(VtxTransportTest, CoalescesSupersededSettings)
+{
+    resetSim(60);
+    queueCmd(VTX_CMD_QUERY, 'Q', 0);
+    vtxTransportProcess(&transport, simVtx.now); // query is now on the wire
+
+    // user scrolls through channels and power levels while the query is outstanding
+    for (int i = 1; i <= 8; i++) {
+        queueCmd(VTX_CMD_FREQUENCY, 'F', i);
+        queueCmd(VTX_CMD_POWER, 'P', 10 + i);
+    }
+    EXPECT_EQ(14, transport.stats.coalesced);
+
+    runFor(1000);
+
+    // only the last setting of each kind goes out
+    ASSERT_EQ(3, simVtx.frameCount);
+    EXPECT_EQ('Q', simVtx.frames[0][0]);
+    EXPECT_EQ('F', simVtx.frames[1][0]);
+    EXPECT_EQ(8, simVtx.frames[1][1]);
+    EXPECT_EQ('P', simVtx.frames[2][0]);
+    EXPECT_EQ(18, simVtx.frames[2][1]);
+}
+
+TEST(VtxTransportTest, OtherCommandsAreNotCoalesced)
+{
+    resetSim(20);
+    queueCmd(VTX_CMD_OTHER, 'X', 1);
+    queueCmd(VTX_CMD_OTHER, 'X', 2);
+
+    runFor(500);
+
+    EXPECT_EQ(2, simVtx.frameCount);
+    EXPECT_EQ(0, transport.stats.coalesced);
+}
+
+TEST(VtxTransportTest, RetriesThenGivesUp)
+{
+    resetSim(20);
+    simVtx.ignoreFrames = 100;
+    queueCmd(VTX_CMD_FREQUENCY, 'F', 1);
+    queueCmd(VTX_CMD_POWER, 'P', 2);
+
+    runFor(2000);
+
+    // each command is sent once plus maxRetries resends, then dropped
+    EXPECT_EQ(6, simVtx.frameCount);
+    EXPECT_EQ(4, transport.stats.resent);
+    EXPECT_EQ(2, transport.stats.dropped);
+    EXPECT_EQ(0, transport.stats.acked);
+    EXPECT_TRUE(vtxTransportIsIdle(&transport));
+}
+
+TEST(VtxTransportTest, RecoversFromLostFrame)
+{
+    resetSim(30);
+    simVtx.ignoreFrames = 1;
+    queueCmd(VTX_CMD_FREQUENCY, 'F', 1);
+
+    runFor(1000);
+
+    EXPECT_EQ(2, simVtx.frameCount);
+    EXPECT_EQ(1, transport.stats.resent);
+    EXPECT_EQ(1, transport.stats.acked);
+    // latency is measured from the first transmission and includes the resend
+    EXPECT_GT(transport.stats.latencyMs[VTX_CMD_FREQUENCY], simPolicy.timeoutMs);
+}
+
+TEST(VtxTransportTest, SupersededCommandIsNotResent)
+{
+    resetSim(20);
+    simVtx.ignoreFrames = 1;
+    queueCmd(VTX_CMD_FREQUENCY, 'F', 1);
+    vtxTransportProcess(&transport, simVtx.now);
+    queueCmd(VTX_CMD_FREQUENCY, 'F', 2);
+
+    runFor(1000);
+
+    // the lost 'F 1' times out and is replaced by 'F 2', which is not a failure
+    ASSERT_EQ(2, simVtx.frameCount);
+    EXPECT_EQ(1, simVtx.frames[0][1]);
+    EXPECT_EQ(2, simVtx.frames[1][1]);
+    EXPECT_EQ(0, transport.stats.resent);
+    EXPECT_EQ(1, transport.stats.acked);
+    EXPECT_EQ(0, transport.stats.dropped);
+    EXPECT_EQ(1, transport.stats.coalesced);
+}
+
+TEST(VtxTransportTest, RecordsRoundTripLatency)
+{
+    resetSim(60);
+    queueCmd(VTX_CMD_POWER, 'P', 1);
+    runFor(500);
+    EXPECT_EQ(60, transport.stats.latencyMs[VTX_CMD_POWER]);
+
+    simVtx.replyDelayMs = 80;
+    queueCmd(VTX_CMD_MODE, 'M', 1);
+    runFor(500);
+    EXPECT_EQ(80, transport.stats.latencyMs[VTX_CMD_MODE]);
+    EXPECT_EQ(60, transport.stats.latencyMs[VTX_CMD_POWER]);
+    EXPECT_EQ(80, transport.stats.maxLatencyMs);
+}
+
+TEST(VtxTransportTest, UnansweredCommandsCompleteWhenSent)
+{
+    resetSim(20);
+    simVtx.ignoreFrames = 100;
+    queueCmd(VTX_CMD_FREQUENCY, 'F', 1, false);
+    queueCmd(VTX_CMD_POWER, 'P', 2, false);
+
+    vtxTransportProcess(&transport, 0);
+    vtxTransportProcess(&transport, 10);
+
+    EXPECT_EQ(2, simVtx.frameCount);
+    EXPECT_TRUE(vtxTransportIsIdle(&transport));
+}
+
+TEST(VtxTransportTest, HonoursGuardTime)
+{
+    static const vtxTransportPolicy_t guardPolicy = {
+        .send = simVtxSend,
+        .replyMatches = NULL,
+        .timeoutMs = 100,
+        .guardMs = 50,
+        .maxRetries = 0,
+        .queueDepth = 4,
+    };
+    resetSim(0);
+    vtxTransportInit(&transport, &guardPolicy);
+    queueCmd(VTX_CMD_FREQUENCY, 'F', 1, false);
+    queueCmd(VTX_CMD_POWER, 'P', 2, false);
+
+    vtxTransportProcess(&transport, 100);
+    vtxTransportProcess(&transport, 120);
+    EXPECT_EQ(1, simVtx.frameCount);
+    vtxTransportProcess(&transport, 150);
+    EXPECT_EQ(2, simVtx.frameCount);
+}
+
+TEST(VtxTransportTest, RejectsWhenFull)
+{
+    resetSim(20);
+    for (int i = 0; i < simPolicy.queueDepth - 1; i++) {
+        queueCmd(VTX_CMD_OTHER, 'X', i);
+    }
+    queueCmd(VTX_CMD_POWER, 'P', 1);
+
+    const uint8_t frame[2] = { 'X', 9 };
+    EXPECT_FALSE(vtxTransportQueue(&transport, VTX_CMD_OTHER, frame, sizeof(frame), 'X'));
+    // a superseding setting still fits
+    const uint8_t powerFrame[2] = { 'P', 2 };
+    EXPECT_TRUE(vtxTransportQueue(&transport, VTX_CMD_POWER, powerFrame, sizeof(powerFrame), 'P'));
+}
+
+TEST(VtxTransportTest, IgnoresUnexpectedReplies)
+{
+    resetSim(20);
+    queueCmd(VTX_CMD_POWER, 'P', 1);
+    vtxTransportProcess(&transport, 0);
+
+    EXPECT_FALSE(vtxTransportReply(&transport, 'F', 10));
+    EXPECT_EQ(1, transport.stats.unexpected);
+    EXPECT_FALSE(vtxTransportIsIdle(&transport));
+    EXPECT_TRUE(vtxTransportReply(&transport, 'P', 20));
+    EXPECT_TRUE(vtxTransportIsIdle(&transport));
+}